@@ -417,8 +417,14 @@ class HIperfClient::Impl {
               << std::right << std::setw(width) << "Bandwidth[Mbps]";
           getOutputStream() << std::right << std::setw(width) << "Retr[pkt]";
           getOutputStream() << std::right << std::setw(width) << "Cwnd[Int]";
-          getOutputStream()
-              << std::right << std::setw(width) << "AvgRtt[ms]" << std::endl;
+          getOutputStream() << std::right << std::setw(width) << "AvgRtt[ms]";
+          if (configuration_.transport_protocol_ == BBR) {
+            getOutputStream()
+                << std::right << std::setw(width) << "BtlBw[Mbps]";
+            getOutputStream() << std::right << std::setw(width) << "MinRtt[ms]";
+            getOutputStream() << std::right << std::setw(width) << "State";
+          }
+          getOutputStream() << std::endl;
 
           first_ = false;
         }
@@ -431,8 +437,23 @@ class HIperfClient::Impl {
         getOutputStream() << std::right << std::setw(width)
                           << stats.getRetxCount();
         getOutputStream() << std::right << std::setw(width) << window.str();
-        getOutputStream() << std::right << std::setw(width) << avg_rtt.str()
-                          << std::endl;
+        getOutputStream() << std::right << std::setw(width) << avg_rtt.str();
+        if (configuration_.transport_protocol_ == BBR) {
+          std::stringstream btl_bw;
+          btl_bw << std::fixed << std::setprecision(3)
+                 << stats.getBottleneckBandwidth() / 1000000.0
+                 << std::setfill(separator);
+
+          std::stringstream min_rtt;
+          min_rtt << std::fixed << std::setprecision(3) << stats.getMinRtt()
+                  << std::setfill(separator);
+
+          getOutputStream() << std::right << std::setw(width) << btl_bw.str();
+          getOutputStream() << std::right << std::setw(width) << min_rtt.str();
+          getOutputStream() << std::right << std::setw(width)
+                            << stats.getCCStatus();
+        }
+        getOutputStream() << std::endl;
       }
 
       saved_stats_.total_duration_milliseconds_ +=
@@ -609,6 +630,15 @@ class HIperfClient::Impl {
       return ERROR_SUCCESS;
     }
 
+    int setupBBRSocket() {
+      configuration_.transport_protocol_ = BBR;
+
+      consumer_socket_ =
+          std::make_unique<ConsumerSocket>(configuration_.transport_protocol_);
+
+      return ERROR_SUCCESS;
+    }
+
     int setupCBRSocket() {
       configuration_.transport_protocol_ = CBR;
 
@@ -625,6 +655,8 @@ class HIperfClient::Impl {
 
       if (configuration_.rtc_) {
         ret = setupRTCSocket();
+      } else if (configuration_.transport_protocol_ == BBR) {
+        ret = setupBBRSocket();
       } else if (configuration_.window_ < 0) {
         ret = setupRAAQMSocket();
       } else {
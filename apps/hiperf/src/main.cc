@@ -134,6 +134,9 @@ void usage() {
   LoggerInfo() << "-W\t<window_size>\t\t\t"
                << "Use a fixed congestion window "
                   "for retrieving the data.";
+  LoggerInfo() << "-Q\t\t\t\t\t"
+               << "Use the BBR-style model based congestion control "
+                  "instead of RAAQM.";
   LoggerInfo() << "-i\t<stats_interval>\t\t"
                << "Show the statistics every <stats_interval> milliseconds.";
   LoggerInfo()
@@ -218,7 +221,7 @@ int main(int argc, char *argv[]) {
   // Please keep in alphabetical order.
   while (
       (opt = getopt(argc, argv,
-                    "A:B:CDE:F:G:HIJ:K:L:M:NP:RST:U:W:X:ab:c:d:e:f:g:hi:j:k:lm:"
+                    "A:B:CDE:F:G:HIJ:K:L:M:NP:QRST:U:W:X:ab:c:d:e:f:g:hi:j:k:lm:"
                     "n:op:qrs:tu:vw:xy:z:")) != -1) {
     switch (opt) {
       // Common
@@ -341,6 +344,11 @@ int main(int argc, char *argv[]) {
         options = 1;
         break;
       }
+      case 'Q': {
+        client_configuration.transport_protocol_ = BBR;
+        options = 1;
+        break;
+      }
       case 'M': {
         client_configuration.receive_buffer_size_ = std::stoull(optarg);
         options = 1;
@@ -202,9 +202,11 @@ int hc_wldr_set(hc_sock_t *s /* XXX */);
 
 /* Object */
 
-#define MAXSZ_HC_OBJECT                                                       \
-  MAX8(MAXSZ_HC_CONNECTION, MAXSZ_HC_LISTENER, MAXSZ_HC_ROUTE, MAXSZ_HC_FACE, \
-       MAXSZ_HC_PUNTING, MAXSZ_HC_STRATEGY, MAXSZ_HC_POLICY, MAXSZ_HC_STATS)
+#define MAXSZ_HC_OBJECT                                                     \
+  MAX2(MAX8(MAXSZ_HC_CONNECTION, MAXSZ_HC_LISTENER, MAXSZ_HC_ROUTE,         \
+            MAXSZ_HC_FACE, MAXSZ_HC_PUNTING, MAXSZ_HC_STRATEGY,             \
+            MAXSZ_HC_POLICY, MAXSZ_HC_STATS),                               \
+       MAXSZ_HC_PROFILE)
 
 typedef struct {
   hc_action_t action;
@@ -322,5 +324,18 @@ int hc_stats_list(hc_sock_t *s, hc_data_t **pdata);
 int hc_stats_snprintf(char *s, size_t size, const hc_stats_t *stats);
 int hc_face_stats_list(hc_sock_t *s, hc_data_t **pdata);
 int hc_face_stats_snprintf(char *s, size_t size, const hc_face_stats_t *stats);
+int hc_profile_list(hc_sock_t *s, hc_data_t **pdata);
+int hc_profile_snprintf(char *s, size_t size, const hc_profile_t *profile);
+
+/**
+ * \brief Apply a batch of route and connection operations
+ * \param [in] s - hICN socket
+ * \param [in] batch - Operations to apply, in order
+ * \return Error code
+ *
+ * The batch is applied atomically by the forwarder: in case of error, none of
+ * the operations has been applied.
+ */
+int hc_batch_execute(hc_sock_t *s, hc_batch_t *batch);
 
 #endif /* HICNTRL_API */
@@ -92,7 +92,9 @@ typedef enum {
   _(subscription_add, SUBSCRIPTION_ADD)                   \
   _(subscription_remove, SUBSCRIPTION_REMOVE)             \
   _(stats_list, STATS_LIST)                               \
-  _(face_stats_list, FACE_STATS_LIST)
+  _(face_stats_list, FACE_STATS_LIST)                     \
+  _(batch, BATCH)                                         \
+  _(profile_list, PROFILE_LIST)
 
 typedef enum {
   COMMAND_TYPE_UNDEFINED,
@@ -346,8 +348,59 @@ typedef struct {
   void *_;
 } cmd_face_stats_list_t;
 
+// Receive path profiling
+typedef struct {
+  void *_;
+} cmd_profile_list_t;
+
 typedef void *cmd_active_interface_update_t;
 
+/* Batch */
+
+/*
+ * A batch carries route and connection operations that hicn-light stages and
+ * applies atomically once the message flagged as COMMIT is received. Large
+ * batches are split over several messages, the first one being flagged as
+ * BEGIN; a batch fitting in a single message carries both flags.
+ */
+#define BATCH_FLAG_BEGIN 0x01
+#define BATCH_FLAG_COMMIT 0x02
+
+/* Batch messages fit in the default receive buffer of the forwarder */
+#define BATCH_MAX_MSG_SIZE 2048
+
+typedef struct {
+  uint8_t command_id; /* ROUTE_ADD, ROUTE_REMOVE, CONNECTION_ADD/REMOVE */
+  uint8_t __pad[3];
+  union {
+    cmd_route_add_t route_add;
+    cmd_route_remove_t route_remove;
+    cmd_connection_add_t connection_add;
+    cmd_connection_remove_t connection_remove;
+  };
+} cmd_batch_item_t;
+
+/* Size of the batch payload fields preceding the items */
+#define BATCH_HDR_SIZE 4
+
+#define BATCH_MAX_ITEMS                                           \
+  ((BATCH_MAX_MSG_SIZE - sizeof(cmd_header_t) - BATCH_HDR_SIZE) / \
+   sizeof(cmd_batch_item_t))
+
+/*
+ * The number of items is carried in the payload as the header length is
+ * overwritten when the message is turned into an ack.
+ */
+typedef struct {
+  uint16_t n_items;
+  uint8_t flags;
+  uint8_t __pad;
+  cmd_batch_item_t items[BATCH_MAX_ITEMS];
+} cmd_batch_t;
+
+/* Size of a batch payload holding N items */
+#define cmd_batch_get_size(N) (BATCH_HDR_SIZE + (N) * sizeof(cmd_batch_item_t))
+
 /* Full messages */
 
 #define _(l, u)          \
@@ -518,6 +571,16 @@ typedef struct {
   cmd_face_stats_list_item_t payload;
 } msg_face_stats_list_reply_t;
 
+// Receive path profiling
+typedef struct {
+  hc_profile_t profile;
+} cmd_profile_list_item_t;
+
+typedef struct {
+  cmd_header_t header;
+  cmd_profile_list_item_t payload;
+} msg_profile_list_reply_t;
+
 //===== size of commands ======
 // REMINDER: when a new_command is added, the following switch has to be
 // updated.
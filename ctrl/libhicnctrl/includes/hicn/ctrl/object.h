@@ -33,12 +33,14 @@ typedef union {
   hc_punting_t punting;
   hc_stats_t stats;
   hc_face_stats_t face_stats;
+  hc_profile_t profile;
   hc_strategy_t strategy;
   hc_policy_t policy;
   hc_subscription_t subscription;
   hc_cache_t cache;
   hc_mapme_t mapme;
   hc_active_interface_t active_interface;
+  hc_batch_t batch;
   uint8_t as_uint8;
 } hc_object_t;
 
@@ -39,6 +39,8 @@
   _(ACTIVE_INTERFACE)       \
   _(STATS)                  \
   _(FACE_STATS)             \
+  _(BATCH)                  \
+  _(PROFILE)                \
   _(N)
 
 typedef enum {
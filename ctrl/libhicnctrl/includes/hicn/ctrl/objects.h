@@ -13,5 +13,6 @@
 #include <hicn/ctrl/objects/cache.h>
 #include <hicn/ctrl/objects/mapme.h>
 #include <hicn/ctrl/objects/active_interface.h>
+#include <hicn/ctrl/objects/batch.h>
 
 #endif /* HICNCTRL_OBJECTS_H */
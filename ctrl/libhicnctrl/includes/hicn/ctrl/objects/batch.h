@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file objects/batch.h
+ * \brief Batch of route and connection operations.
+ *
+ * A batch is applied atomically by the forwarder: either all operations
+ * succeed, or none of them is applied.
+ */
+
+#ifndef HICNCTRL_OBJECTS_BATCH_H
+#define HICNCTRL_OBJECTS_BATCH_H
+
+#include <hicn/ctrl/action.h>
+#include <hicn/ctrl/object_type.h>
+#include <hicn/ctrl/objects/connection.h>
+#include <hicn/ctrl/objects/route.h>
+
+typedef struct {
+  hc_action_t action;           /* ACTION_CREATE or ACTION_DELETE */
+  hc_object_type_t object_type; /* OBJECT_TYPE_ROUTE or OBJECT_TYPE_CONNECTION */
+  union {
+    hc_route_t route;
+    hc_connection_t connection;
+  };
+} hc_batch_item_t;
+
+typedef struct {
+  hc_batch_item_t *items;
+  size_t n_items;
+  size_t max_items; /* Allocated size */
+  size_t pos;       /* Index of the next item to send to the forwarder */
+} hc_batch_t;
+
+#define MAXSZ_HC_BATCH 64
+
+hc_batch_t *hc_batch_create();
+void hc_batch_free(hc_batch_t *batch);
+
+int hc_batch_add_route(hc_batch_t *batch, hc_action_t action,
+                       const hc_route_t *route);
+int hc_batch_add_connection(hc_batch_t *batch, hc_action_t action,
+                            const hc_connection_t *connection);
+size_t hc_batch_get_len(const hc_batch_t *batch);
+
+int hc_batch_snprintf(char *s, size_t size, const hc_batch_t *batch);
+int hc_batch_validate(const hc_batch_t *batch, bool allow_partial);
+
+#endif /* HICNCTRL_OBJECTS_BATCH_H */
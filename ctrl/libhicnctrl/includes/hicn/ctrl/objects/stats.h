@@ -22,8 +22,10 @@
 #define HICNCTRL_OBJECTS_STATS_H
 
 #define MAXSZ_HC_STATS 600
+#define MAXSZ_HC_PROFILE 2048
 
 typedef hicn_light_stats_t hc_stats_t;
 typedef connection_stats_t hc_face_stats_t;
+typedef hicn_light_profile_t hc_profile_t;
 
 #endif /* HICNCTRL_OBJECTS_STATS_H */
@@ -68,9 +68,17 @@ int on_listener_create(hc_listener_t* listener) {
     case FACE_TYPE_HICN:
       listener->type = FACE_TYPE_HICN_LISTENER;
       break;
+    case FACE_TYPE_SHM:
+      listener->type = FACE_TYPE_SHM_LISTENER;
+      break;
+    case FACE_TYPE_XDP:
+      listener->type = FACE_TYPE_XDP_LISTENER;
+      break;
     case FACE_TYPE_UDP_LISTENER:
     case FACE_TYPE_TCP_LISTENER:
     case FACE_TYPE_HICN_LISTENER:
+    case FACE_TYPE_SHM_LISTENER:
+    case FACE_TYPE_XDP_LISTENER:
       break;
     case FACE_TYPE_UNDEFINED:
     case FACE_TYPE_N:
@@ -16,3 +16,10 @@ static const command_parser_t command_face_stats_list = {
     .nparams = 0,
 };
 COMMAND_REGISTER(command_face_stats_list);
+
+static const command_parser_t command_profile_list = {
+    .action = ACTION_LIST,
+    .object_type = OBJECT_TYPE_PROFILE,
+    .nparams = 0,
+};
+COMMAND_REGISTER(command_profile_list);
@@ -20,6 +20,7 @@
 #include <ctype.h>  // isalpha isalnum
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>  // strtok_r
 #include <unistd.h>  // getopt
 
 #include <hicn/ctrl.h>
@@ -181,10 +182,20 @@ void usage_connection(const char *prog, bool header, bool verbose) {
   usage_connection_list(prog, header, verbose);
 }
 
+void usage_batch(const char *prog, bool header, bool verbose) {
+  if (header) usage_header();
+  fprintf(stderr, "%s -b FILE\n", prog);
+  if (verbose)
+    fprintf(stderr,
+            "    Apply route and connection commands read from FILE, one per "
+            "line (eg. -r 1 b001::/16 1, -dc conn0), as a single "
+            "transaction.\n");
+}
+
 void usage(const char *prog) {
   fprintf(stderr,
           "Usage: %s [ -z forwarder (hicnlight | vpp) ] [ [-d] [-f|-l|-c|-r] "
-          "PARAMETERS | [-F|-L|-C|-R] ]\n",
+          "PARAMETERS | [-F|-L|-C|-R] | -b FILE ]\n",
           prog);
   fprintf(stderr, "\n");
   fprintf(stderr, "High-level commands\n");
@@ -192,6 +203,7 @@ void usage(const char *prog) {
   usage_face(prog, false, true);
   usage_route(prog, false, true);
   usage_forwarding_strategy(prog, false, true);
+  usage_batch(prog, false, true);
   fprintf(stderr, "\n");
   fprintf(stderr, "Low level commands (hicn-light specific)\n");
   fprintf(stderr, "\n");
@@ -216,13 +228,16 @@ void usage(const char *prog) {
   } while (0)
 
 int parse_options(int argc, char *argv[], hc_command_t *command,
-                  forwarder_type_t *forwarder) {
+                  forwarder_type_t *forwarder, const char **batch_file) {
   command->object_type = OBJECT_TYPE_UNDEFINED;
   command->action = ACTION_CREATE;
   int opt;
 
-  while ((opt = getopt(argc, argv, "cCdDfFlLrRsShz:")) != -1) {
+  while ((opt = getopt(argc, argv, "b:cCdDfFlLrRsShz:")) != -1) {
     switch (opt) {
+      case 'b':
+        *batch_file = optarg;
+        break;
       case 'z':
         *forwarder = forwarder_type_from_str(optarg);
         if (*forwarder == FORWARDER_TYPE_UNDEFINED) goto USAGE;
@@ -269,6 +284,14 @@ int parse_options(int argc, char *argv[], hc_command_t *command,
     }
   }
 
+  /* Commands are read from the batch file */
+  if (*batch_file) {
+    if ((command->object_type != OBJECT_TYPE_UNDEFINED) ||
+        (command->action != ACTION_CREATE) || (optind != argc))
+      goto USAGE;
+    return 0;
+  }
+
   // XXX The rest could be made a single parse function
 
   /* A default action is always defined, let's verify we have an object type,
@@ -321,6 +344,103 @@ USAGE:
   exit(EXIT_FAILURE);
 }
 
+#define MAX_BATCH_LINE_ARGS 16
+
+/*
+ * Parse a line of a batch file, which follows the syntax of the command line
+ * for route and connection creation and deletion, eg. '-dr 1 b001::/16'.
+ */
+int parse_batch_line(char *line, hc_command_t *command) {
+  char *argv[MAX_BATCH_LINE_ARGS];
+  int argc = 0;
+  char *saveptr;
+
+  for (char *token = strtok_r(line, " \t\r\n", &saveptr); token;
+       token = strtok_r(NULL, " \t\r\n", &saveptr)) {
+    if (argc == MAX_BATCH_LINE_ARGS) return -1;
+    argv[argc++] = token;
+  }
+
+  command->action = ACTION_CREATE;
+  command->object_type = OBJECT_TYPE_UNDEFINED;
+  memset(&command->object, 0, sizeof(hc_object_t));
+
+  int pos = 0;
+  for (; (pos < argc) && (argv[pos][0] == '-'); pos++) {
+    for (const char *c = argv[pos] + 1; *c; c++) {
+      switch (*c) {
+        case 'd':
+          command->action = ACTION_DELETE;
+          break;
+        case 'r':
+          command->object_type = OBJECT_TYPE_ROUTE;
+          break;
+        case 'c':
+          command->object_type = OBJECT_TYPE_CONNECTION;
+          break;
+        default:
+          return -1;
+      }
+    }
+  }
+  if (command->object_type == OBJECT_TYPE_UNDEFINED) return -1;
+
+  const command_parser_t *parser =
+      command_search(command->action, command->object_type, argc - pos);
+  if (!parser) return -1;
+
+  return parse_getopt_args(parser, argc - pos, argv + pos, command);
+}
+
+hc_batch_t *load_batch(const char *filename) {
+  hc_command_t command;
+  char *line = NULL;
+  size_t len = 0;
+  unsigned lineno = 0;
+  int rc = 0;
+
+  FILE *f = fopen(filename, "r");
+  if (!f) {
+    ERROR("Could not open batch file '%s'", filename);
+    return NULL;
+  }
+
+  hc_batch_t *batch = hc_batch_create();
+  if (!batch) goto ERR_BATCH;
+
+  while (getline(&line, &len, f) != -1) {
+    lineno++;
+
+    /* Skip empty lines and comments */
+    char *start = line;
+    while (isspace(*start)) start++;
+    if ((*start == '\0') || (*start == '#')) continue;
+
+    if (parse_batch_line(start, &command) < 0) {
+      ERROR("Invalid command in %s:%u", filename, lineno);
+      goto ERR_PARSE;
+    }
+
+    if (command.object_type == OBJECT_TYPE_ROUTE)
+      rc = hc_batch_add_route(batch, command.action, &command.object.route);
+    else
+      rc = hc_batch_add_connection(batch, command.action,
+                                   &command.object.connection);
+    if (rc < 0) goto ERR_PARSE;
+  }
+
+  free(line);
+  fclose(f);
+  return batch;
+
+ERR_PARSE:
+  hc_batch_free(batch);
+ERR_BATCH:
+  free(line);
+  fclose(f);
+  return NULL;
+}
+
 int main(int argc, char *argv[]) {
   int rc = 1;
   hc_command_t command = {0};
@@ -329,16 +449,32 @@ int main(int argc, char *argv[]) {
   log_conf.log_level = LOG_INFO;
 
   forwarder_type_t forwarder = FORWARDER_TYPE_HICNLIGHT;
+  const char *batch_file = NULL;
+  hc_batch_t *batch = NULL;
 
-  if (parse_options(argc, argv, &command, &forwarder) < 0)
+  if (parse_options(argc, argv, &command, &forwarder, &batch_file) < 0)
     die(OPTIONS, "Bad arguments");
 
+  if (batch_file) {
+    batch = load_batch(batch_file);
+    if (!batch) die(OPTIONS, "Bad batch file");
+  }
+
   hc_sock_t *s = hc_sock_create(forwarder, /* url= */ NULL);
   if (!s) die(SOCKET, "Error creating socket.");
 
   if (hc_sock_connect(s) < 0)
     die(CONNECT, "Error connecting to the forwarder.");
 
+  if (batch) {
+    if (hc_batch_execute(s, batch) < 0)
+      die(COMMAND, "Error executing batch, no command has been applied.");
+    printf("Success: applied %zu commands\n", hc_batch_get_len(batch));
+    hc_batch_free(batch);
+    hc_sock_free(s);
+    return EXIT_SUCCESS;
+  }
+
   hc_data_t *data = NULL;
 
   rc = hc_execute(s, command.action, command.object_type, &command.object,
@@ -393,6 +529,7 @@ ERR_COMMAND:
 ERR_CONNECT:
   hc_sock_free(s);
 ERR_SOCKET:
+  if (batch) hc_batch_free(batch);
 ERR_OPTIONS:
   printf("Error.\n");
   return EXIT_FAILURE;
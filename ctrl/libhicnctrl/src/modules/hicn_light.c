@@ -47,6 +47,7 @@
 #include "hicn_light.h"
 
 #include "hicn_light/base.h"
+#include "hicn_light/batch.h"
 #include "hicn_light/connection.h"
 #include "hicn_light/listener.h"
 #include "hicn_light/face.h"
@@ -501,15 +502,20 @@ NEXT:
         case FACE_TYPE_HICN:
         case FACE_TYPE_TCP:
         case FACE_TYPE_UDP:
+        case FACE_TYPE_XDP:
           hc_request_set_state(current_request,
                                REQUEST_STATE_FACE_CREATE_CONNECTION_CREATE);
           goto NEXT;
         case FACE_TYPE_HICN_LISTENER:
         case FACE_TYPE_TCP_LISTENER:
         case FACE_TYPE_UDP_LISTENER:
+        case FACE_TYPE_SHM_LISTENER:
+        case FACE_TYPE_XDP_LISTENER:
           hc_request_set_state(current_request,
                                REQUEST_STATE_FACE_CREATE_LISTENER_CREATE);
           goto NEXT;
+        /* Shared memory faces are created by applications */
+        case FACE_TYPE_SHM:
         case FACE_TYPE_UNDEFINED:
         case FACE_TYPE_N:
           return -99;  // Not implemented
@@ -622,12 +628,16 @@ NEXT:
         case FACE_TYPE_HICN:
         case FACE_TYPE_TCP:
         case FACE_TYPE_UDP:
+        case FACE_TYPE_SHM:
+        case FACE_TYPE_XDP:
           hc_request_set_state(current_request,
                                REQUEST_STATE_FACE_DELETE_CONNECTION_DELETE);
           goto NEXT;
         case FACE_TYPE_HICN_LISTENER:
         case FACE_TYPE_TCP_LISTENER:
         case FACE_TYPE_UDP_LISTENER:
+        case FACE_TYPE_SHM_LISTENER:
+        case FACE_TYPE_XDP_LISTENER:
         case FACE_TYPE_UNDEFINED:
         case FACE_TYPE_N:
           return -99;  // Not implemented
@@ -1151,6 +1161,70 @@ NEXT:
   return 0;
 }
 
+static ssize_t hicnlight_prepare_batch(hc_sock_t *sock, hc_request_t *request,
+                                       uint8_t **buffer) {
+  hc_request_t *current_request = hc_request_get_current(request);
+
+  hc_action_t action = hc_request_get_action(current_request);
+  hc_object_type_t object_type = hc_request_get_object_type(current_request);
+  hc_object_t *object = hc_request_get_object(current_request);
+
+  _ASSERT(action == ACTION_CREATE);
+  _ASSERT(object_type == OBJECT_TYPE_BATCH);
+
+  hc_data_t *data = hc_request_get_data(current_request);
+  hc_batch_t *batch = &object->batch;
+  size_t n;
+
+  hc_request_state_t state;
+
+NEXT:
+  state = hc_request_get_state(current_request);
+  DEBUG("hicnlight_prepare_batch > %s", hc_request_state_str(state));
+
+  switch (state) {
+    case REQUEST_STATE_INIT:
+      batch->pos = 0;
+      hc_request_set_state(current_request, REQUEST_STATE_BATCH_SEND);
+      goto NEXT;
+
+    case REQUEST_STATE_BATCH_SEND:
+      /*
+       * The batch is split in as many messages as needed, each of them being
+       * acked by the forwarder before the next one is sent. The reply to the
+       * last message is the result of the whole batch.
+       */
+      n = batch->n_items - batch->pos;
+      if (n > BATCH_MAX_ITEMS) n = BATCH_MAX_ITEMS;
+      hc_request_set_state_count(current_request, (unsigned)n);
+      hc_request_set_state(current_request, batch->pos + n < batch->n_items
+                                                ? REQUEST_STATE_BATCH_CHECK
+                                                : REQUEST_STATE_COMPLETE);
+      hc_request_reset_data(current_request);
+      return hicnlight_prepare_generic(sock, request, buffer);
+
+    case REQUEST_STATE_BATCH_CHECK:
+      if (!data) return -1;
+      /* The forwarder has discarded the batch, return the nack */
+      if (!hc_data_get_result(data)) {
+        hc_request_set_state(current_request, REQUEST_STATE_COMPLETE);
+        goto NEXT;
+      }
+      batch->pos += hc_request_get_state_count(current_request);
+      hc_request_set_state(current_request, REQUEST_STATE_BATCH_SEND);
+      goto NEXT;
+
+    case REQUEST_STATE_COMPLETE:
+      if (!data) return -1;
+      hc_data_set_complete(data);
+      break;
+
+    default:
+      return -1;
+  }
+  return 0;
+}
+
 static int hicnlight_recv(hc_sock_t *sock) {
   hc_sock_light_data_t *s = (hc_sock_light_data_t *)sock->data;
   int rc;
@@ -1254,6 +1328,8 @@ static ssize_t hicnlight_prepare(hc_sock_t *sock, hc_request_t *request,
           /* Connection could have no corresponging listener, or no local info
            * provided */
           return hicnlight_prepare_connection_create(sock, request, buffer);
+        case OBJECT_TYPE_BATCH:
+          return hicnlight_prepare_batch(sock, request, buffer);
         default:
           break;
       }
@@ -1404,10 +1480,12 @@ int hc_sock_initialize_module(hc_sock_t *s) {
   hc_sock_light.object_vft[OBJECT_TYPE_STATS] = hicnlight_stats_module_ops;
   hc_sock_light.object_vft[OBJECT_TYPE_FACE_STATS] =
       hicnlight_face_stats_module_ops;
+  hc_sock_light.object_vft[OBJECT_TYPE_PROFILE] = hicnlight_profile_module_ops;
   hc_sock_light.object_vft[OBJECT_TYPE_STRATEGY] =
       hicnlight_strategy_module_ops;
   hc_sock_light.object_vft[OBJECT_TYPE_SUBSCRIPTION] =
       hicnlight_subscription_module_ops;
+  hc_sock_light.object_vft[OBJECT_TYPE_BATCH] = hicnlight_batch_module_ops;
 
   if (s) s->ops = hc_sock_light;
   return 0;
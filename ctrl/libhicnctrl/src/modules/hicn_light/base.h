@@ -31,7 +31,8 @@
   _(mapme_activator)           \
   _(mapme_timing)              \
   _(subscription_add)          \
-  _(subscription_remove)
+  _(subscription_remove)       \
+  _(batch)
 
 typedef union {
 #define _(x) cmd_##x##_t x;
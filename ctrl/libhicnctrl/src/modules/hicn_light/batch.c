@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file modules/hicn_light/batch.c
+ * \brief Implementation of batch object VFT for hicn_light.
+ */
+
+#include <string.h>
+
+#include <hicn/ctrl/api.h>
+#include <hicn/ctrl/hicn-light.h>
+#include <hicn/util/log.h>
+
+#include "base.h"
+#include "batch.h"
+#include "connection.h"
+#include "route.h"
+
+/*
+ * Items are serialized through the route and connection VFTs, and the payload
+ * of the resulting command is embedded into the batch message.
+ */
+static int hicnlight_batch_serialize_item(const hc_batch_item_t *item,
+                                          cmd_batch_item_t *cmd) {
+  const hc_module_object_ops_t *vft;
+  hc_object_t object;
+  hc_msg_t msg;
+
+  memset(&object, 0, sizeof(hc_object_t));
+  switch (item->object_type) {
+    case OBJECT_TYPE_ROUTE:
+      vft = &hicnlight_route_module_ops;
+      object.route = item->route;
+      break;
+    case OBJECT_TYPE_CONNECTION:
+      vft = &hicnlight_connection_module_ops;
+      object.connection = item->connection;
+      break;
+    default:
+      return -1;
+  }
+
+  if ((item->action != ACTION_CREATE) && (item->action != ACTION_DELETE))
+    return -1;
+  if (vft->serialize[item->action](&object, (uint8_t *)&msg) < 0) return -1;
+
+  memset(cmd, 0, sizeof(cmd_batch_item_t));
+  cmd->command_id = msg.header.command_id;
+  switch (cmd->command_id) {
+    case COMMAND_TYPE_ROUTE_ADD:
+      cmd->route_add = msg.payload.route_add;
+      break;
+    case COMMAND_TYPE_ROUTE_REMOVE:
+      cmd->route_remove = msg.payload.route_remove;
+      break;
+    case COMMAND_TYPE_CONNECTION_ADD:
+      cmd->connection_add = msg.payload.connection_add;
+      break;
+    case COMMAND_TYPE_CONNECTION_REMOVE:
+      cmd->connection_remove = msg.payload.connection_remove;
+      break;
+    default:
+      return -1;
+  }
+  return 0;
+}
+
+/* BATCH CREATE */
+
+/*
+ * Serializes as many items as fit in a message, starting at the current
+ * position in the batch. The first message opens the batch on the forwarder,
+ * and the one holding the last item commits it.
+ */
+int hicnlight_batch_serialize_create(const hc_object_t *object,
+                                     uint8_t *packet) {
+  const hc_batch_t *batch = &object->batch;
+  if (batch->pos >= batch->n_items) return -1;
+
+  size_t n = batch->n_items - batch->pos;
+  if (n > BATCH_MAX_ITEMS) n = BATCH_MAX_ITEMS;
+
+  msg_batch_t *msg = (msg_batch_t *)packet;
+  msg->header = (cmd_header_t){
+      .message_type = REQUEST_LIGHT,
+      .command_id = COMMAND_TYPE_BATCH,
+      .length = 1,
+      .seq_num = 0,
+  };
+  msg->payload.n_items = (uint16_t)n;
+  msg->payload.flags = 0;
+  msg->payload.__pad = 0;
+  if (batch->pos == 0) msg->payload.flags |= BATCH_FLAG_BEGIN;
+  if (batch->pos + n == batch->n_items) msg->payload.flags |= BATCH_FLAG_COMMIT;
+
+  for (size_t i = 0; i < n; i++) {
+    if (hicnlight_batch_serialize_item(&batch->items[batch->pos + i],
+                                       &msg->payload.items[i]) < 0) {
+      ERROR("[hicnlight_batch_serialize_create] Could not serialize item #%zu",
+            batch->pos + i);
+      return -1;
+    }
+  }
+
+  return (int)(sizeof(cmd_header_t) + cmd_batch_get_size(n));
+}
+
+int hicnlight_batch_serialize_delete(const hc_object_t *object,
+                                     uint8_t *packet) {
+  return -1;
+}
+
+int hicnlight_batch_serialize_list(const hc_object_t *object, uint8_t *packet) {
+  return -1;
+}
+
+int hicnlight_batch_serialize_set(const hc_object_t *object, uint8_t *packet) {
+  return -1;
+}
+
+/* Batches are only ever acked, there is no object to parse in replies */
+const hc_module_object_ops_t hicnlight_batch_module_ops = {
+    .parse = NULL,
+    .serialized_size = 0,
+    .execute =
+        {
+            [ACTION_CREATE] = NULL,
+            [ACTION_DELETE] = NULL,
+            [ACTION_LIST] = NULL,
+            [ACTION_SET] = NULL,
+        },
+    .serialize = {
+        [ACTION_CREATE] = hicnlight_batch_serialize_create,
+        [ACTION_DELETE] = hicnlight_batch_serialize_delete,
+        [ACTION_LIST] = hicnlight_batch_serialize_list,
+        [ACTION_SET] = hicnlight_batch_serialize_set,
+    }};
@@ -111,3 +111,49 @@ int hicnlight_face_stats_serialize_set(const hc_object_t *object,
 }
 
 DECLARE_MODULE_OBJECT_OPS(hicnlight, face_stats);
+
+/* RECEIVE PATH PROFILING */
+
+int hicnlight_profile_parse(const uint8_t *buffer, size_t size,
+                            hc_profile_t *profile) {
+  if (size != sizeof(cmd_profile_list_item_t)) return -1;
+
+  cmd_profile_list_item_t *item = (cmd_profile_list_item_t *)buffer;
+  *profile = item->profile;
+  return 0;
+}
+
+int _hicnlight_profile_parse(const uint8_t *buffer, size_t size,
+                             hc_object_t *object) {
+  return hicnlight_profile_parse(buffer, size, &object->profile);
+}
+
+int hicnlight_profile_serialize_create(const hc_object_t *object,
+                                       uint8_t *packet) {
+  return -1;
+}
+
+int hicnlight_profile_serialize_delete(const hc_object_t *object,
+                                       uint8_t *packet) {
+  return -1;
+}
+
+int hicnlight_profile_serialize_list(const hc_object_t *object,
+                                     uint8_t *packet) {
+  msg_profile_list_t *msg = (msg_profile_list_t *)packet;
+  *msg = (msg_profile_list_t){.header = {
+                                  .message_type = REQUEST_LIGHT,
+                                  .command_id = COMMAND_TYPE_PROFILE_LIST,
+                                  .length = 0,
+                                  .seq_num = 0,
+                              }};
+
+  return sizeof(msg_header_t);  // Do not use msg_profile_list_t
+}
+
+int hicnlight_profile_serialize_set(const hc_object_t *object,
+                                    uint8_t *packet) {
+  return -1;
+}
+
+DECLARE_MODULE_OBJECT_OPS(hicnlight, profile);
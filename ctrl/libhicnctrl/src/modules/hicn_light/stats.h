@@ -20,5 +20,6 @@
 
 DECLARE_MODULE_OBJECT_OPS_H(hicnlight, stats);
 DECLARE_MODULE_OBJECT_OPS_H(hicnlight, face_stats);
+DECLARE_MODULE_OBJECT_OPS_H(hicnlight, profile);
 
 #endif /* HICNCTRL_MODULE_HICNLIGHT_STATS_H */
@@ -8,6 +8,7 @@
 #include "objects/strategy.h"
 #include "objects/subscription.h"
 #include "objects/active_interface.h"
+#include "objects/batch.h"
 
 const hc_object_ops_t *object_vft[] = {
     [OBJECT_TYPE_LISTENER] = &hc_listener_ops,
@@ -16,7 +17,9 @@ const hc_object_ops_t *object_vft[] = {
     [OBJECT_TYPE_FACE] = &hc_face_ops,
     [OBJECT_TYPE_FACE_STATS] = &hc_face_stats_ops,
     [OBJECT_TYPE_STATS] = &hc_stats_ops,
+    [OBJECT_TYPE_PROFILE] = &hc_profile_ops,
     [OBJECT_TYPE_STRATEGY] = &hc_strategy_ops,
     [OBJECT_TYPE_SUBSCRIPTION] = &hc_subscription_ops,
     [OBJECT_TYPE_ACTIVE_INTERFACE] = &hc_active_interface_ops,
+    [OBJECT_TYPE_BATCH] = &hc_batch_ops,
 };
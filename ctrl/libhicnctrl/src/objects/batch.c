@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file batch.c
+ * \brief Implementation of batch object.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hicn/ctrl/api.h>
+#include <hicn/ctrl/object.h>
+#include <hicn/ctrl/objects/batch.h>
+#include <hicn/util/log.h>
+
+#include "../object_vft.h"
+#include "connection.h"  // hc_connection_has_local
+#include "route.h"       // hc_route_has_face
+#include "base.h"
+
+#define HC_BATCH_INIT_SIZE 64
+
+hc_batch_t *hc_batch_create() {
+  hc_batch_t *batch = malloc(sizeof(hc_batch_t));
+  if (!batch) return NULL;
+  memset(batch, 0, sizeof(hc_batch_t));
+  return batch;
+}
+
+void hc_batch_free(hc_batch_t *batch) {
+  free(batch->items);
+  free(batch);
+}
+
+static hc_batch_item_t *hc_batch_get_free(hc_batch_t *batch) {
+  if (batch->n_items == batch->max_items) {
+    size_t max_items =
+        batch->max_items ? 2 * batch->max_items : HC_BATCH_INIT_SIZE;
+    hc_batch_item_t *items =
+        realloc(batch->items, max_items * sizeof(hc_batch_item_t));
+    if (!items) return NULL;
+    batch->items = items;
+    batch->max_items = max_items;
+  }
+  return &batch->items[batch->n_items];
+}
+
+int hc_batch_add_route(hc_batch_t *batch, hc_action_t action,
+                       const hc_route_t *route) {
+  hc_batch_item_t *item = hc_batch_get_free(batch);
+  if (!item) return -1;
+
+  memset(item, 0, sizeof(hc_batch_item_t));
+  item->action = action;
+  item->object_type = OBJECT_TYPE_ROUTE;
+  item->route = *route;
+  batch->n_items++;
+  return 0;
+}
+
+int hc_batch_add_connection(hc_batch_t *batch, hc_action_t action,
+                            const hc_connection_t *connection) {
+  hc_batch_item_t *item = hc_batch_get_free(batch);
+  if (!item) return -1;
+
+  memset(item, 0, sizeof(hc_batch_item_t));
+  item->action = action;
+  item->object_type = OBJECT_TYPE_CONNECTION;
+  item->connection = *connection;
+  batch->n_items++;
+  return 0;
+}
+
+size_t hc_batch_get_len(const hc_batch_t *batch) { return batch->n_items; }
+
+/* BATCH VALIDATE */
+
+static int hc_batch_item_validate(const hc_batch_item_t *item) {
+  if ((item->action != ACTION_CREATE) && (item->action != ACTION_DELETE))
+    return -1;
+
+  switch (item->object_type) {
+    case OBJECT_TYPE_ROUTE:
+      /* Faces cannot be created as part of a batch */
+      if (hc_route_has_face(&item->route)) return -1;
+      return hc_route_validate(&item->route, false);
+
+    case OBJECT_TYPE_CONNECTION:
+      /* Connections are deleted by name or ID */
+      if (item->action == ACTION_DELETE)
+        return (isempty(item->connection.name) && item->connection.id == 0)
+                   ? -1
+                   : 0;
+      /* Local information is required as no listener lookup is done */
+      if (!hc_connection_has_local(&item->connection)) return -1;
+      return hc_connection_validate(&item->connection, false);
+
+    default:
+      return -1;
+  }
+}
+
+int hc_batch_validate(const hc_batch_t *batch, bool allow_partial) {
+  if (!batch->items || batch->n_items == 0) return -1;
+
+  for (size_t i = 0; i < batch->n_items; i++) {
+    if (hc_batch_item_validate(&batch->items[i]) < 0) {
+      ERROR("[hc_batch_validate] Invalid item #%zu", i);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int _hc_batch_validate(const hc_object_t *object, bool allow_partial) {
+  return hc_batch_validate(&object->batch, allow_partial);
+}
+
+/* BATCH CMP */
+
+int _hc_batch_cmp(const hc_object_t *object1, const hc_object_t *object2) {
+  ERROR("[_hc_batch_cmp] Not implemented");
+  return -1;
+}
+
+/* BATCH SNPRINTF */
+
+int hc_batch_snprintf(char *s, size_t size, const hc_batch_t *batch) {
+  return snprintf(s, size, "%zu items (%zu sent)", batch->n_items, batch->pos);
+}
+
+int _hc_batch_snprintf(char *s, size_t size, const hc_object_t *object) {
+  return hc_batch_snprintf(s, size, &object->batch);
+}
+
+int hc_batch_execute(hc_sock_t *s, hc_batch_t *batch) {
+  hc_object_t object;
+  hc_data_t *data = NULL;
+  int rc;
+
+  memset(&object, 0, sizeof(hc_object_t));
+  object.batch = *batch;
+  rc = hc_execute(s, ACTION_CREATE, OBJECT_TYPE_BATCH, &object, &data);
+  if (rc < 0) return -1;
+
+  /* The forwarder returns a single ack or nack for the whole batch */
+  rc = (data && hc_data_get_result(data)) ? 0 : -1;
+  if (data) hc_data_free(data);
+  return rc;
+}
+
+DECLARE_OBJECT_OPS(OBJECT_TYPE_BATCH, batch);
@@ -106,8 +106,12 @@ int hc_face_snprintf(char *s, size_t size, const hc_face_t *face) {
       break;
     case FACE_TYPE_TCP:
     case FACE_TYPE_UDP:
+    case FACE_TYPE_SHM:
+    case FACE_TYPE_XDP:
     case FACE_TYPE_TCP_LISTENER:
     case FACE_TYPE_UDP_LISTENER:
+    case FACE_TYPE_SHM_LISTENER:
+    case FACE_TYPE_XDP_LISTENER:
       rc = url_snprintf(local, MAXSZ_URL, &face->local_addr, face->local_port);
       if (rc >= MAXSZ_URL)
         WARN("[hc_face_snprintf] Unexpected truncation of URL string");
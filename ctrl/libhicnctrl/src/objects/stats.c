@@ -40,6 +40,11 @@ int _hc_stats_snprintf(char *s, size_t size, const hc_object_t *object) {
 }
 
 int hc_stats_snprintf(char *s, size_t size, const hc_stats_t *stats) {
+  uint32_t n_cs_lookups =
+      stats->pkt_cache.n_cs_hits + stats->pkt_cache.n_cs_misses;
+  double cs_hit_ratio =
+      n_cs_lookups ? 100.0 * stats->pkt_cache.n_cs_hits / n_cs_lookups : 0;
+
   return snprintf(
       s, size,
       "*** STATS ***\nreceived = %u (interest = %u, data = %u)\ndropped = %u "
@@ -48,8 +53,12 @@ int hc_stats_snprintf(char *s, size_t size, const hc_stats_t *stats) {
       "send_failure = %u, no_route_in_fib = %u }\ninterest processing = { "
       "aggregated = %u, retransmitted = %u, satisfied_from_cs = %u, "
       "expired_interests = %u, expired_data = %u }\ndata processing = { "
-      "no_reverse_path = %u }\npacket cache = {PIT size = %u, CS size = %u, "
-      "eviction = %u}",
+      "no_reverse_path = %u }\nfib cache = { hits = %u, misses = %u }"
+      "\npacket cache = {PIT size = %u, CS size = %u, "
+      "eviction = %u, hits = %u, misses = %u, hit_ratio = %.2f%%, "
+      "reclaimed_interests = %u, reclaimed_data = %u, "
+      "pit_full_drops = %u, pit_quota_drops = %u, pit_replacements = %u, "
+      "disk_entries = %u, disk_demotions = %u, disk_promotions = %u}",
       stats->forwarder.countReceived, stats->forwarder.countInterestsReceived,
       stats->forwarder.countObjectsReceived, stats->forwarder.countDropped,
       stats->forwarder.countInterestsDropped,
@@ -63,8 +72,15 @@ int hc_stats_snprintf(char *s, size_t size, const hc_stats_t *stats) {
       stats->forwarder.countInterestsSatisfiedFromStore,
       stats->forwarder.countInterestsExpired, stats->forwarder.countDataExpired,
       stats->forwarder.countDroppedNoReversePath,
+      stats->forwarder.countFibCacheHits, stats->forwarder.countFibCacheMisses,
       stats->pkt_cache.n_pit_entries, stats->pkt_cache.n_cs_entries,
-      stats->pkt_cache.n_lru_evictions);
+      stats->pkt_cache.n_lru_evictions, stats->pkt_cache.n_cs_hits,
+      stats->pkt_cache.n_cs_misses, cs_hit_ratio,
+      stats->pkt_cache.n_pit_reclaimed,
+      stats->pkt_cache.n_cs_reclaimed, stats->pkt_cache.n_pit_full_drops,
+      stats->pkt_cache.n_pit_quota_drops, stats->pkt_cache.n_pit_replacements,
+      stats->pkt_cache.n_cs_disk_entries, stats->pkt_cache.n_cs_disk_demotions,
+      stats->pkt_cache.n_cs_disk_promotions);
 }
 
 int hc_stats_list(hc_sock_t *s, hc_data_t **pdata) {
@@ -90,19 +106,101 @@ int _hc_face_stats_snprintf(char *s, size_t size, const hc_object_t *object) {
 }
 
 int hc_face_stats_snprintf(char *s, size_t size, const hc_face_stats_t *stats) {
+  uint32_t tx_pkts = stats->interests.tx_pkts + stats->data.tx_pkts;
+  double avg_batch =
+      stats->tx_batches ? (double)tx_pkts / stats->tx_batches : 0.0;
+
   return snprintf(
       s, size,
       "conn #%u:\tinterests =\t{ rx packets = %u, rx bytes = %u,  "
       "tx packets = %u,  tx bytes = %u }\n\t\tdata =\t\t{ rx packets "
       "= %u, rx bytes = %u,  "
-      "tx packets = %u,  tx bytes = %u }",
+      "tx packets = %u,  tx bytes = %u }\n\t\ttx batches =\t{ count = %u, "
+      "average size = %.2f,  gso = %u }",
       stats->conn_id, stats->interests.rx_pkts, stats->interests.rx_bytes,
       stats->interests.tx_pkts, stats->interests.tx_bytes, stats->data.rx_pkts,
-      stats->data.rx_bytes, stats->data.tx_pkts, stats->data.tx_bytes);
+      stats->data.rx_bytes, stats->data.tx_pkts, stats->data.tx_bytes,
+      stats->tx_batches, avg_batch, stats->tx_gso_batches);
 }
 
 int hc_face_stats_list(hc_sock_t *s, hc_data_t **pdata) {
   return hc_execute(s, ACTION_LIST, OBJECT_TYPE_FACE_STATS, NULL, pdata);
 }
 
-DECLARE_OBJECT_OPS(OBJECT_TYPE_FACE_STATS, face_stats);
\ No newline at end of file
+DECLARE_OBJECT_OPS(OBJECT_TYPE_FACE_STATS, face_stats);
+/* RECEIVE PATH PROFILING */
+
+int _hc_profile_validate(const hc_object_t *object, bool allow_partial) {
+  // Nothing to validate
+  return 0;
+}
+
+int _hc_profile_cmp(const hc_object_t *object1, const hc_object_t *object2) {
+  ERROR("[_hc_profile_cmp] Not implemented");
+  return -1;
+}
+
+int _hc_profile_snprintf(char *s, size_t size, const hc_object_t *object) {
+  return hc_profile_snprintf(s, size, &object->profile);
+}
+
+static const char *_hc_profile_stage_str[] = {
+#define _(x, y) [PROFILE_STAGE_##x] = #y,
+    foreach_profile_stage
+#undef _
+};
+
+static const char *_hc_profile_verdict_str[] = {
+#define _(x) [PKT_CACHE_VERDICT_##x] = #x,
+    foreach_kh_verdict
+#undef _
+};
+
+int hc_profile_snprintf(char *s, size_t size, const hc_profile_t *profile) {
+  if (!profile->enabled)
+    return snprintf(s, size,
+                    "*** PROFILE ***\nprofiling disabled (hicn-light not "
+                    "built with WITH_PROFILING)");
+
+  char *cur = s;
+  int rc;
+
+#define _SNPRINTF(...)                                               \
+  do {                                                               \
+    rc = snprintf(cur, s + size - cur, __VA_ARGS__);                 \
+    if (rc < 0) return rc;                                           \
+    if (rc >= s + size - cur) return (int)(cur - s) + rc;            \
+    cur += rc;                                                       \
+  } while (0)
+
+  _SNPRINTF("*** PROFILE ***\nstage durations (cycles, %u cycles/us)",
+            profile->cycles_per_usec);
+  for (unsigned i = 0; i < PROFILE_STAGE_N; i++) {
+    const histogram_t *histogram = &profile->stages[i];
+    _SNPRINTF(
+        "\n  %-9s = { count = %lu, mean = %lu, min = %lu, p50 = %lu, "
+        "p90 = %lu, p99 = %lu, max = %lu }",
+        _hc_profile_stage_str[i], (unsigned long)histogram->count,
+        (unsigned long)histogram_mean(histogram),
+        (unsigned long)histogram->min,
+        (unsigned long)histogram_percentile(histogram, 50),
+        (unsigned long)histogram_percentile(histogram, 90),
+        (unsigned long)histogram_percentile(histogram, 99),
+        (unsigned long)histogram->max);
+  }
+  _SNPRINTF("\npacket cache verdicts = {");
+  for (unsigned i = 0; i < PKT_CACHE_N_VERDICTS; i++)
+    _SNPRINTF("%s %s = %u", i == 0 ? "" : ",", _hc_profile_verdict_str[i],
+              profile->verdicts[i]);
+  _SNPRINTF(" }");
+
+#undef _SNPRINTF
+
+  return (int)(cur - s);
+}
+
+int hc_profile_list(hc_sock_t *s, hc_data_t **pdata) {
+  return hc_execute(s, ACTION_LIST, OBJECT_TYPE_PROFILE, NULL, pdata);
+}
+
+DECLARE_OBJECT_OPS(OBJECT_TYPE_PROFILE, profile);
@@ -25,5 +25,6 @@
 
 DECLARE_OBJECT_OPS_H(OBJECT_TYPE_STATS, stats);
 DECLARE_OBJECT_OPS_H(OBJECT_TYPE_FACE_STATS, face_stats);
+DECLARE_OBJECT_OPS_H(OBJECT_TYPE_PROFILE, profile);
 
 #endif /* HICNCTRL_IMPL_OBJECTS_STATS_H */
\ No newline at end of file
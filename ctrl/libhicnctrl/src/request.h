@@ -58,6 +58,8 @@ typedef int (*HC_PARSE)(const uint8_t *, uint8_t *);
   _(ROUTE_CREATE_FACE_CHECK)            \
   _(ROUTE_CREATE)                       \
   _(GET_LIST)                           \
+  _(BATCH_SEND)                         \
+  _(BATCH_CHECK)                        \
   _(COMPLETE)                           \
   _(N)
 
@@ -38,7 +38,18 @@ typedef struct {
 typedef struct loop_s loop_t;
 typedef struct event_s event_t;
 
-extern loop_t *MAIN_LOOP;
+/*
+ * The main loop is thread-local so that each data plane worker (see
+ * core/worker.h) transparently registers its listeners, connections and timers
+ * on its own event loop.
+ */
+#ifdef _WIN32
+#define LOOP_THREAD_LOCAL __declspec(thread)
+#else
+#define LOOP_THREAD_LOCAL __thread
+#endif
+
+extern LOOP_THREAD_LOCAL loop_t *MAIN_LOOP;
 
 /**
  * \brief Creates a main loop
@@ -30,6 +30,7 @@
 
 #include "logo.h"
 #include "../core/forwarder.h"
+#include "../core/worker.h"
 #include "../config/configuration.h"  // XXX needed ?
 #include "../config/configuration_file.h"
 
@@ -40,7 +41,13 @@ static void usage(const char *prog) {
       " [--daemon]"
 #endif
       " [--capacity objectStoreSize] [--log level]"
-      "[--log-file filename] [--config file]\n",
+      "[--log-file filename] [--config file] [--workers n]\n"
+      " [--pit-size n] [--pit-size-per-connection n]"
+      " [--pit-full-policy drop|replace]\n"
+      " [--cs-policy lru|slru|arc|tinylfu] [--cs-disk file]"
+      " [--cs-disk-size MB]\n"
+      " [--flush-batch n] [--flush-latency ms]"
+      " [--max-packet-size bytes]\n",
       prog);
   printf("\n");
   printf(
@@ -86,6 +93,54 @@ static void usage(const char *prog) {
   printf("%-30s = file to write log messages to  (required in daemon mode)\n",
          "--log-file <output_logfile>");
   printf("%-30s = configuration filename\n", "--config <config_path>");
+  printf(
+      "%-30s = number of data plane threads. Listeners are shared with "
+      "SO_REUSEPORT and the content store is sharded by name.\n",
+      "--workers <n>");
+  printf("%-30s   Default value for n is 1\n", "");
+  printf(
+      "%-30s = maximum number of pending interests (0 = unbounded). The limit "
+      "is split across workers.\n",
+      "--pit-size <n>");
+  printf(
+      "%-30s = maximum number of pending interests created by each ingress "
+      "connection (0 = unbounded)\n",
+      "--pit-size-per-connection <n>");
+  printf(
+      "%-30s = action taken on new interests when the PIT is full: drop them, "
+      "or replace the oldest pending interest\n",
+      "--pit-full-policy <policy>");
+  printf("%-30s   Default value for policy is drop\n", "");
+  printf(
+      "%-30s = replacement policy of the content store: lru, segmented lru, "
+      "adaptive replacement cache, or window tinylfu\n",
+      "--cs-policy <policy>");
+  printf("%-30s   Default value for policy is lru\n", "");
+  printf(
+      "%-30s = file backing a second tier of the content store, to which "
+      "evicted data packets are demoted. With several workers, each of them "
+      "uses its own file, suffixed with its id.\n",
+      "--cs-disk <file>");
+  printf(
+      "%-30s = size of the second tier of the content store in MB. The size "
+      "is split across workers.\n",
+      "--cs-disk-size <MB>");
+  printf("%-30s   Default value for size is %lu MB\n", "",
+         CS_DISK_DEFAULT_SIZE >> 20);
+  printf(
+      "%-30s = number of packets queued on a connection that triggers its "
+      "flush (0 = none)\n",
+      "--flush-batch <n>");
+  printf(
+      "%-30s = maximum time packets are held on a connection to be sent in "
+      "larger batches (0 = flush after each batch of received packets)\n",
+      "--flush-latency <ms>");
+  printf("%-30s   Default value for both is 0\n", "");
+  printf(
+      "%-30s = size of the largest packet expected on the links, eg. 9000 "
+      "for jumbo frames (at most %d)\n",
+      "--max-packet-size <bytes>", MSGBUF_MAX_SIZE);
+  printf("%-30s   Default value is the MTU (%d bytes)\n", "", MTU);
   printf("\n");
 }
 
@@ -232,6 +287,74 @@ configuration_t *parse_commandline(int argc, const char *argv[]) {
         const char *logfile = argv[i + 1];
         configuration_set_logfile(configuration, logfile);
         i++;
+      } else if (strcmp(argv[i], "--workers") == 0) {
+        int n_workers = atoi(argv[i + 1]);
+        if (n_workers < 1) {
+          fprintf(stderr, "Invalid number of workers: %s\n", argv[i + 1]);
+          usage(argv[0]);
+          exit(EXIT_FAILURE);
+        }
+        configuration_set_n_workers(configuration, n_workers);
+        i++;
+      } else if (strcmp(argv[i], "--pit-size") == 0) {
+        size_t pit_size = strtoul(argv[i + 1], NULL, 10);
+        configuration_set_pit_size(
+            configuration, pit_size,
+            configuration_get_pit_size_per_connection(configuration));
+        i++;
+      } else if (strcmp(argv[i], "--pit-size-per-connection") == 0) {
+        size_t pit_size_per_connection = strtoul(argv[i + 1], NULL, 10);
+        configuration_set_pit_size(configuration,
+                                   configuration_get_pit_size(configuration),
+                                   pit_size_per_connection);
+        i++;
+      } else if (strcmp(argv[i], "--pit-full-policy") == 0) {
+        pit_full_policy_t policy = pit_full_policy_from_str(argv[i + 1]);
+        if (!PIT_FULL_POLICY_VALID(policy)) {
+          fprintf(stderr, "Invalid PIT full policy: %s\n", argv[i + 1]);
+          usage(argv[0]);
+          exit(EXIT_FAILURE);
+        }
+        configuration_set_pit_full_policy(configuration, policy);
+        i++;
+      } else if (strcmp(argv[i], "--cs-policy") == 0) {
+        cs_type_t type = cs_type_from_str(argv[i + 1]);
+        if (!CS_TYPE_VALID(type)) {
+          fprintf(stderr, "Invalid CS policy: %s\n", argv[i + 1]);
+          usage(argv[0]);
+          exit(EXIT_FAILURE);
+        }
+        configuration_set_cs_type(configuration, type);
+        i++;
+      } else if (strcmp(argv[i], "--cs-disk") == 0) {
+        size_t size = configuration_get_cs_disk_size(configuration);
+        configuration_set_cs_disk(configuration, argv[i + 1], size);
+        i++;
+      } else if (strcmp(argv[i], "--cs-disk-size") == 0) {
+        const char *path = configuration_get_cs_disk_path(configuration);
+        size_t size = strtoul(argv[i + 1], NULL, 10) << 20;
+        configuration_set_cs_disk(configuration, path ? path : "", size);
+        i++;
+      } else if (strcmp(argv[i], "--flush-batch") == 0) {
+        unsigned batch_size = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        configuration_set_flush_policy(
+            configuration, batch_size,
+            configuration_get_flush_latency(configuration));
+        i++;
+      } else if (strcmp(argv[i], "--flush-latency") == 0) {
+        unsigned latency = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        configuration_set_flush_policy(
+            configuration, configuration_get_flush_batch_size(configuration),
+            latency);
+        i++;
+      } else if (strcmp(argv[i], "--max-packet-size") == 0) {
+        size_t size = strtoul(argv[i + 1], NULL, 10);
+        if (configuration_set_max_packet_size(configuration, size) < 0) {
+          fprintf(stderr, "Invalid maximum packet size: %s\n", argv[i + 1]);
+          usage(argv[0]);
+          exit(EXIT_FAILURE);
+        }
+        i++;
       } else {
         usage(argv[0]);
         exit(EXIT_FAILURE);
@@ -291,6 +414,17 @@ int main(int argc, const char *argv[]) {
        configuration_get_port(configuration),
        configuration_get_configuration_port(configuration));
 
+  /* Additional data plane workers, the main thread being worker 0 */
+  workers_t *workers = NULL;
+  unsigned n_workers = configuration_get_n_workers(configuration);
+  if (n_workers > 1) {
+    workers = workers_create(forwarder, n_workers);
+    if (!workers) {
+      ERROR("Failed to start %u workers", n_workers);
+      return EXIT_FAILURE;
+    }
+  }
+
   /* Main loop */
   if (loop_dispatch(MAIN_LOOP) < 0) {
     ERROR("Failed to run main loop");
@@ -298,6 +432,7 @@ int main(int argc, const char *argv[]) {
   }
 
   INFO("loop stopped");
+  if (workers) workers_free(workers);
   forwarder_free(forwarder);
   loop_free(MAIN_LOOP);
   MAIN_LOOP = NULL;
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file batch.c
+ * @brief Implementation of the staging area for batched commands.
+ */
+
+#include <stdlib.h>
+
+#include <hicn/util/vector.h>
+
+#include "../core/connection.h"  // CONNECTION_ID_UNDEFINED
+#include "../core/ticks.h"
+#include "batch.h"
+
+struct batch_s {
+  bool open;
+  unsigned owner;
+  Ticks last_used;
+  cmd_batch_item_t *items; /* vector */
+};
+
+batch_t *batch_create() {
+  batch_t *batch = malloc(sizeof(batch_t));
+  if (!batch) return NULL;
+
+  batch->open = false;
+  batch->owner = CONNECTION_ID_UNDEFINED;
+  batch->last_used = 0;
+  if (vector_init(batch->items, 0, BATCH_MAX_STAGED_ITEMS) < 0) {
+    free(batch);
+    return NULL;
+  }
+  return batch;
+}
+
+void batch_free(batch_t *batch) {
+  vector_free(batch->items);
+  free(batch);
+}
+
+void batch_begin(batch_t *batch, unsigned owner) {
+  vector_reset(batch->items);
+  batch->open = true;
+  batch->owner = owner;
+  batch->last_used = ticks_now();
+}
+
+void batch_reset(batch_t *batch) {
+  vector_reset(batch->items);
+  batch->open = false;
+  batch->owner = CONNECTION_ID_UNDEFINED;
+}
+
+bool batch_is_open(const batch_t *batch, unsigned owner) {
+  return batch->open && (batch->owner == owner);
+}
+
+bool batch_is_busy(const batch_t *batch, unsigned owner) {
+  return batch->open && (batch->owner != owner) &&
+         (ticks_now() - batch->last_used < BATCH_IDLE_TIMEOUT);
+}
+
+int batch_stage(batch_t *batch, const cmd_batch_item_t *items, size_t n) {
+  if (!batch->open) return -1;
+  if (vector_len(batch->items) + n > BATCH_MAX_STAGED_ITEMS) return -1;
+
+  for (size_t i = 0; i < n; i++)
+    if (vector_push(batch->items, items[i]) < 0) return -1;
+  batch->last_used = ticks_now();
+  return 0;
+}
+
+size_t batch_get_len(const batch_t *batch) { return vector_len(batch->items); }
+
+cmd_batch_item_t *batch_get_items(batch_t *batch) { return batch->items; }
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file batch.h
+ * @brief Staging area for batched configuration commands.
+ *
+ * Items received in BATCH messages are accumulated here until the message
+ * flagged as COMMIT is received, at which point they are applied at once (see
+ * configuration_on_batch).
+ */
+
+#ifndef HICNLIGHT_BATCH_H
+#define HICNLIGHT_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <hicn/ctrl/hicn-light.h>
+
+/* Upper bound on the number of items staged for a single batch */
+#define BATCH_MAX_STAGED_ITEMS (1 << 21)
+
+/*
+ * Time after which a batch left open by a connection that stopped sending
+ * items can be taken over by another one (in ms)
+ */
+#define BATCH_IDLE_TIMEOUT 5000
+
+typedef struct batch_s batch_t;
+
+batch_t *batch_create();
+
+void batch_free(batch_t *batch);
+
+/**
+ * @brief Discard any staged item and open a new batch.
+ *
+ * @param[in] batch The batch staging area.
+ * @param[in] owner The connection the batch is received from.
+ */
+void batch_begin(batch_t *batch, unsigned owner);
+
+/**
+ * @brief Discard any staged item and close the batch.
+ */
+void batch_reset(batch_t *batch);
+
+/**
+ * @brief Check whether a batch opened by the specified connection is pending.
+ */
+bool batch_is_open(const batch_t *batch, unsigned owner);
+
+/**
+ * @brief Check whether a batch opened by another connection is still pending,
+ * ie. it has received items for less than BATCH_IDLE_TIMEOUT.
+ */
+bool batch_is_busy(const batch_t *batch, unsigned owner);
+
+/**
+ * @brief Append items to the currently open batch.
+ *
+ * @return 0 in case of success, -1 otherwise (eg. too many items staged).
+ */
+int batch_stage(batch_t *batch, const cmd_batch_item_t *items, size_t n);
+
+size_t batch_get_len(const batch_t *batch);
+
+cmd_batch_item_t *batch_get_items(batch_t *batch);
+
+#endif /* HICNLIGHT_BATCH_H */
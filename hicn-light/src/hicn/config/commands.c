@@ -146,10 +146,14 @@ uint8_t *configuration_on_listener_add(forwarder_t *forwarder, uint8_t *packet,
     case FACE_TYPE_UDP_LISTENER:
     case FACE_TYPE_TCP_LISTENER:
     case FACE_TYPE_HICN_LISTENER:
+    case FACE_TYPE_SHM_LISTENER:
+    case FACE_TYPE_XDP_LISTENER:
       break;
     case FACE_TYPE_UDP:
     case FACE_TYPE_TCP:
     case FACE_TYPE_HICN:
+    case FACE_TYPE_SHM:
+    case FACE_TYPE_XDP:
       ERROR("Wrong listener type");
       goto NACK;
   }
@@ -389,10 +393,15 @@ uint8_t *configuration_on_connection_add(forwarder_t *forwarder,
     case FACE_TYPE_UDP:
     case FACE_TYPE_TCP:
     case FACE_TYPE_HICN:
+    case FACE_TYPE_XDP:
       break;
     case FACE_TYPE_UDP_LISTENER:
     case FACE_TYPE_TCP_LISTENER:
     case FACE_TYPE_HICN_LISTENER:
+    /* Shared memory connections are initiated by applications */
+    case FACE_TYPE_SHM:
+    case FACE_TYPE_SHM_LISTENER:
+    case FACE_TYPE_XDP_LISTENER:
     case FACE_TYPE_UNDEFINED:
     case FACE_TYPE_N:
       goto NACK;
@@ -1126,6 +1135,32 @@ NACK:
   return (uint8_t *)msg;
 }
 
+uint8_t *configuration_on_profile_list(forwarder_t *forwarder, uint8_t *packet,
+                                       unsigned ingress_id,
+                                       size_t *reply_size) {
+  assert(forwarder && packet);
+  INFO("CMD: profile list (ingress=%d)", ingress_id);
+
+  size_t n = 1;
+  msg_profile_list_t *msg_received = (msg_profile_list_t *)packet;
+  uint8_t command_id = msg_received->header.command_id;
+  uint32_t seq_num = msg_received->header.seq_num;
+
+  msg_profile_list_reply_t *msg = NULL;
+  msg_malloc_list(msg, command_id, n, seq_num);
+  if (!msg) goto NACK;
+
+  msg->payload.profile = forwarder_get_profile(forwarder);
+
+  *reply_size = sizeof(msg->header) + n * sizeof(msg->payload);
+  return (uint8_t *)msg;
+
+NACK:
+  *reply_size = sizeof(msg_header_t);
+  make_nack(msg);
+  return (uint8_t *)msg;
+}
+
 /* WLDR */
 
 uint8_t *configuration_on_wldr_set(forwarder_t *forwarder, uint8_t *packet,
@@ -1538,6 +1573,264 @@ uint8_t *configuration_on_active_interface_update(forwarder_t *forwarder,
   return (uint8_t *)msg;
 }
 
+/* Batch */
+
+static bool _batch_route_exists(forwarder_t *forwarder,
+                                const hicn_ip_prefix_t *prefix,
+                                unsigned conn_id) {
+  hicn_prefix_t name_prefix = HICN_PREFIX_EMPTY;
+  hicn_prefix_create_from_ip_address_len(&prefix->address, prefix->len,
+                                         &name_prefix);
+  fib_entry_t *entry = fib_contains(forwarder_get_fib(forwarder), &name_prefix);
+  if (!entry) return false;
+  return nexthops_contains(fib_entry_get_nexthops(entry), conn_id);
+}
+
+/*
+ * Apply (or undo) a single route or connection addition item. The undo flag
+ * is set upon success if the item has modified the forwarder state and should
+ * be reverted in case of a later failure.
+ */
+static int _batch_apply_item(forwarder_t *forwarder, cmd_batch_item_t *item,
+                             unsigned ingress_id, bool *undo) {
+  unsigned conn_id;
+  hicn_ip_prefix_t prefix;
+  size_t reply_size;
+
+  switch (item->command_id) {
+    case COMMAND_TYPE_ROUTE_ADD:
+      conn_id = symbolic_to_conn_id_self(
+          forwarder, item->route_add.symbolic_or_connid, ingress_id);
+      if (!connection_id_is_valid(conn_id)) return -1;
+      prefix = (hicn_ip_prefix_t){.family = item->route_add.family,
+                                  .address = item->route_add.address,
+                                  .len = item->route_add.len};
+      *undo = !_batch_route_exists(forwarder, &prefix, conn_id);
+      if (!forwarder_add_or_update_route(forwarder, &prefix, conn_id))
+        return -1;
+      return 0;
+
+    case COMMAND_TYPE_ROUTE_REMOVE:
+      conn_id =
+          symbolic_to_conn_id(forwarder, item->route_remove.symbolic_or_connid);
+      if (!connection_id_is_valid(conn_id)) return -1;
+      prefix = (hicn_ip_prefix_t){.family = item->route_remove.family,
+                                  .address = item->route_remove.address,
+                                  .len = item->route_remove.len};
+      *undo = _batch_route_exists(forwarder, &prefix, conn_id);
+      if (!forwarder_remove_route(forwarder, &prefix, conn_id)) return -1;
+      return 0;
+
+    case COMMAND_TYPE_CONNECTION_ADD: {
+      msg_connection_add_t msg = {.header = {.message_type = REQUEST_LIGHT,
+                                             .command_id =
+                                                 COMMAND_TYPE_CONNECTION_ADD,
+                                             .length = 1},
+                                  .payload = item->connection_add};
+      configuration_on_connection_add(forwarder, (uint8_t *)&msg, ingress_id,
+                                      &reply_size);
+      if (msg.header.message_type != ACK_LIGHT) return -1;
+      *undo = true;
+      return 0;
+    }
+
+    default:
+      return -1;
+  }
+}
+
+static void _batch_undo_item(forwarder_t *forwarder, cmd_batch_item_t *item,
+                             unsigned ingress_id) {
+  unsigned conn_id;
+  hicn_ip_prefix_t prefix;
+
+  switch (item->command_id) {
+    case COMMAND_TYPE_ROUTE_ADD:
+      conn_id = symbolic_to_conn_id_self(
+          forwarder, item->route_add.symbolic_or_connid, ingress_id);
+      prefix = (hicn_ip_prefix_t){.family = item->route_add.family,
+                                  .address = item->route_add.address,
+                                  .len = item->route_add.len};
+      forwarder_remove_route(forwarder, &prefix, conn_id);
+      break;
+
+    case COMMAND_TYPE_ROUTE_REMOVE:
+      conn_id =
+          symbolic_to_conn_id(forwarder, item->route_remove.symbolic_or_connid);
+      prefix = (hicn_ip_prefix_t){.family = item->route_remove.family,
+                                  .address = item->route_remove.address,
+                                  .len = item->route_remove.len};
+      forwarder_add_or_update_route(forwarder, &prefix, conn_id);
+      break;
+
+    case COMMAND_TYPE_CONNECTION_ADD:
+      conn_id = symbolic_to_conn_id(forwarder, item->connection_add.symbolic);
+      if (connection_id_is_valid(conn_id))
+        forwarder_remove_connection(forwarder, conn_id, true);
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*
+ * Apply all staged items, or none of them. Connection removals cannot be
+ * reverted (routes through the connection are flushed), they are thus
+ * validated first and applied once all other items have succeeded.
+ *
+ * Returns the index of the failing item, or -1 if the batch was applied.
+ */
+static ssize_t _batch_commit(forwarder_t *forwarder, cmd_batch_item_t *items,
+                             size_t n, unsigned ingress_id) {
+  bool *undo = NULL;
+  size_t i;
+
+  for (i = 0; i < n; i++) {
+    if (items[i].command_id != COMMAND_TYPE_CONNECTION_REMOVE) continue;
+    const char *symbolic = items[i].connection_remove.symbolic_or_connid;
+    if (strcmp(symbolic, "SELF") == 0) return i;
+    unsigned conn_id = symbolic_to_conn_id(forwarder, symbolic);
+    if (!connection_id_is_valid(conn_id) || conn_id == ingress_id) return i;
+  }
+
+  undo = calloc(n, sizeof(bool));
+  if (!undo) return 0;
+
+  for (i = 0; i < n; i++) {
+    if (items[i].command_id == COMMAND_TYPE_CONNECTION_REMOVE) continue;
+    if (_batch_apply_item(forwarder, &items[i], ingress_id, &undo[i]) < 0)
+      goto ROLLBACK;
+  }
+
+  for (i = 0; i < n; i++) {
+    if (items[i].command_id != COMMAND_TYPE_CONNECTION_REMOVE) continue;
+    unsigned conn_id = symbolic_to_conn_id(
+        forwarder, items[i].connection_remove.symbolic_or_connid);
+    if (forwarder_remove_connection(forwarder, conn_id, true) < 0)
+      ERROR("[batch] Failed to remove connection id=%u", conn_id);
+  }
+
+  free(undo);
+  return -1;
+
+ROLLBACK:
+  for (size_t j = i; j-- > 0;)
+    if (undo[j]) _batch_undo_item(forwarder, &items[j], ingress_id);
+  free(undo);
+  return i;
+}
+
+uint8_t *configuration_on_batch(forwarder_t *forwarder, uint8_t *packet,
+                                unsigned ingress_id, size_t *reply_size) {
+  assert(forwarder);
+  assert(packet);
+
+  *reply_size = sizeof(msg_header_t);
+  msg_batch_t *msg = (msg_batch_t *)packet;
+  cmd_batch_t *control = &msg->payload;
+  batch_t *batch = forwarder_get_batch(forwarder);
+
+  DEBUG("CMD: batch (ingress=%d, items=%u, flags=%u)", ingress_id,
+        control->n_items, control->flags);
+
+  if (control->flags & BATCH_FLAG_BEGIN) {
+    if (batch_is_busy(batch, ingress_id)) {
+      ERROR("A batch is pending for another connection");
+      goto NACK;
+    }
+    INFO("CMD: batch begin (ingress=%d)", ingress_id);
+    batch_begin(batch, ingress_id);
+  } else if (!batch_is_open(batch, ingress_id)) {
+    ERROR("No pending batch for connection id=%u", ingress_id);
+    goto NACK;
+  }
+
+  if (control->n_items > BATCH_MAX_ITEMS) goto ABORT;
+
+  for (unsigned i = 0; i < control->n_items; i++) {
+    cmd_batch_item_t *item = &control->items[i];
+    switch (item->command_id) {
+      case COMMAND_TYPE_CONNECTION_ADD:
+        /* Names have been generated by command_prepare() */
+        if (item->connection_add.symbolic[0] == '\0') goto ABORT;
+        break;
+      case COMMAND_TYPE_ROUTE_ADD:
+        /*
+         * SELF designates the connection the batch is received from, which
+         * is not necessarily the one committing it.
+         */
+        if (strcmp(item->route_add.symbolic_or_connid, "SELF") != 0) break;
+        if (!connection_id_is_valid(ingress_id)) goto ABORT;
+        snprintf(item->route_add.symbolic_or_connid, SYMBOLIC_NAME_LEN, "%u",
+                 ingress_id);
+        break;
+      case COMMAND_TYPE_CONNECTION_REMOVE:
+      case COMMAND_TYPE_ROUTE_REMOVE:
+        break;
+      default:
+        ERROR("Unsupported command in batch: %d", item->command_id);
+        goto ABORT;
+    }
+  }
+
+  if (batch_stage(batch, control->items, control->n_items) < 0) {
+    ERROR("Could not stage batch items");
+    goto ABORT;
+  }
+
+  if (!(control->flags & BATCH_FLAG_COMMIT)) goto ACK;
+
+  size_t n = batch_get_len(batch);
+  ssize_t failed =
+      _batch_commit(forwarder, batch_get_items(batch), n, ingress_id);
+  batch_reset(batch);
+  if (failed >= 0) {
+    ERROR("Batch rejected at item %zd/%zu", failed, n);
+    goto NACK;
+  }
+  INFO("CMD: batch commit (ingress=%d, items=%zu)", ingress_id, n);
+
+ACK:
+  make_ack(msg);
+  return (uint8_t *)msg;
+
+ABORT:
+  batch_reset(batch);
+NACK:
+  make_nack(msg);
+  return (uint8_t *)msg;
+}
+
+void command_prepare(forwarder_t *forwarder, uint8_t *packet) {
+  connection_table_t *table = forwarder_get_connection_table(forwarder);
+  cmd_connection_add_t *connection_add;
+
+  switch (((msg_header_t *)packet)->header.command_id) {
+    case COMMAND_TYPE_CONNECTION_ADD:
+      connection_add = &((msg_connection_add_t *)packet)->payload;
+      if (connection_add->symbolic[0] == '\0')
+        connection_table_get_random_name(table, connection_add->symbolic);
+      break;
+
+    case COMMAND_TYPE_BATCH: {
+      cmd_batch_t *control = &((msg_batch_t *)packet)->payload;
+      if (control->n_items > BATCH_MAX_ITEMS) break;
+      for (unsigned i = 0; i < control->n_items; i++) {
+        if (control->items[i].command_id != COMMAND_TYPE_CONNECTION_ADD)
+          continue;
+        connection_add = &control->items[i].connection_add;
+        if (connection_add->symbolic[0] == '\0')
+          connection_table_get_random_name(table, connection_add->symbolic);
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
 uint8_t *command_process(forwarder_t *forwarder, uint8_t *packet,
                          unsigned ingress_id, size_t *reply_size) {
   uint8_t *reply = NULL;
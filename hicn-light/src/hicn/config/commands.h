@@ -31,6 +31,14 @@
 #include <hicn/ctrl/api.h>
 #include <hicn/ctrl/hicn-light.h>
 
+/**
+ * @brief Generate the parameters of a request left for the forwarder to
+ * choose (eg. connection names), so that the request replicated to other
+ * workers has the same effect on all of them. Failures are reported when the
+ * request is processed.
+ */
+void command_prepare(forwarder_t *forwarder, uint8_t *packet);
+
 uint8_t *command_process(forwarder_t *forwarder, uint8_t *packet,
                          unsigned ingress_id, size_t *reply_size);
 
@@ -151,6 +159,13 @@ uint8_t *configuration_on_policy_list(forwarder_t *forwarder, uint8_t *packet,
 uint8_t *configuration_on_stats_list(forwarder_t *forwarder, uint8_t *packet,
                                      unsigned ingress_id, size_t *reply_size);
 
+uint8_t *configuration_on_batch(forwarder_t *forwarder, uint8_t *packet,
+                                unsigned ingress_id, size_t *reply_size);
+
+uint8_t *configuration_on_profile_list(forwarder_t *forwarder, uint8_t *packet,
+                                       unsigned ingress_id,
+                                       size_t *reply_size);
+
 void commands_notify_connection(const forwarder_t *forwarder,
                                 connection_event_t event,
                                 const connection_t *connection);
@@ -26,6 +26,7 @@
 #include <unistd.h>
 #endif
 #include <ctype.h>
+#include <limits.h>
 #include <hicn/hicn-light/config.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -56,6 +57,7 @@
 #define DEFAULT_PORT 1234
 #define DEFAULT_LOGLEVEL "info"
 #define DEFAULT_CS_CAPACITY 100000
+#define DEFAULT_N_WORKERS 1
 
 #define msg_malloc_list(msg, N, seq_number)                           \
   do {                                                                \
@@ -74,6 +76,15 @@ struct configuration_s {
   uint16_t port;
   uint16_t configuration_port;
   size_t cs_capacity;
+  cs_type_t cs_type;
+  char cs_disk_path[PATH_MAX]; /* Empty if disabled */
+  size_t cs_disk_size;
+  size_t pit_size;
+  size_t pit_size_per_connection;
+  pit_full_policy_t pit_full_policy;
+  unsigned flush_batch_size;
+  unsigned flush_latency;
+  size_t max_packet_size;
   int loglevel;
   const char *logfile;
   int logfile_fd;
@@ -84,6 +95,8 @@ struct configuration_s {
 
   size_t n_suffixes_per_split;
   int_manifest_split_strategy_t split_strategy;
+
+  unsigned n_workers;
 };
 
 configuration_t *configuration_create() {
@@ -94,6 +107,15 @@ configuration_t *configuration_create() {
   config->port = PORT_NUMBER;
   config->configuration_port = 2001;  // TODO(eloparco): What is this?
   config->cs_capacity = DEFAULT_CS_CAPACITY;
+  config->cs_type = DEFAULT_CS_TYPE;
+  config->cs_disk_path[0] = '\0';
+  config->cs_disk_size = CS_DISK_DEFAULT_SIZE;
+  config->pit_size = 0;
+  config->pit_size_per_connection = 0;
+  config->pit_full_policy = DEFAULT_PIT_FULL_POLICY;
+  config->flush_batch_size = 0;
+  config->flush_latency = 0;
+  config->max_packet_size = 0;
   config->logfile = NULL;
   config->logfile_fd = -1;
 #ifndef _WIN32
@@ -107,10 +129,28 @@ configuration_t *configuration_create() {
   config->prefix_keys = slab_create(prefix_key_t, SLAB_INIT_SIZE);
   config->n_suffixes_per_split = DEFAULT_N_SUFFIXES_PER_SPLIT;
   config->split_strategy = DEFAULT_DISAGGREGATION_STRATEGY;
+  config->n_workers = DEFAULT_N_WORKERS;
 
   return config;
 }
 
+configuration_t *configuration_clone(const configuration_t *config) {
+  assert(config);
+
+  configuration_t *clone = malloc(sizeof(configuration_t));
+  if (!clone) return NULL;
+
+  /*
+   * Scalar parameters are shared, while per-prefix strategies are rebuilt from
+   * the commands processed by the forwarder owning the clone.
+   */
+  *clone = *config;
+  clone->strategy_map = kh_init_strategy_map();
+  clone->prefix_keys = slab_create(prefix_key_t, SLAB_INIT_SIZE);
+
+  return clone;
+}
+
 void configuration_free(configuration_t *config) {
   assert(config);
 
@@ -128,6 +168,79 @@ void configuration_set_cs_size(configuration_t *config, size_t size) {
   config->cs_capacity = size;
 }
 
+void configuration_set_cs_type(configuration_t *config, cs_type_t type) {
+  config->cs_type = type;
+}
+
+cs_type_t configuration_get_cs_type(const configuration_t *config) {
+  return config->cs_type;
+}
+
+void configuration_set_cs_disk(configuration_t *config, const char *path,
+                               size_t size) {
+  // The path can be the one returned by configuration_get_cs_disk_path()
+  if (path != config->cs_disk_path)
+    snprintf(config->cs_disk_path, PATH_MAX, "%s", path);
+  config->cs_disk_size = size;
+}
+
+const char *configuration_get_cs_disk_path(const configuration_t *config) {
+  return config->cs_disk_path[0] != '\0' ? config->cs_disk_path : NULL;
+}
+
+size_t configuration_get_cs_disk_size(const configuration_t *config) {
+  return config->cs_disk_size;
+}
+
+void configuration_set_pit_size(configuration_t *config, size_t size,
+                                size_t size_per_connection) {
+  config->pit_size = size;
+  config->pit_size_per_connection = size_per_connection;
+}
+
+size_t configuration_get_pit_size(const configuration_t *config) {
+  return config->pit_size;
+}
+
+size_t configuration_get_pit_size_per_connection(
+    const configuration_t *config) {
+  return config->pit_size_per_connection;
+}
+
+void configuration_set_pit_full_policy(configuration_t *config,
+                                       pit_full_policy_t policy) {
+  config->pit_full_policy = policy;
+}
+
+pit_full_policy_t configuration_get_pit_full_policy(
+    const configuration_t *config) {
+  return config->pit_full_policy;
+}
+
+void configuration_set_flush_policy(configuration_t *config,
+                                    unsigned batch_size, unsigned latency_ms) {
+  config->flush_batch_size = batch_size;
+  config->flush_latency = latency_ms;
+}
+
+unsigned configuration_get_flush_batch_size(const configuration_t *config) {
+  return config->flush_batch_size;
+}
+
+unsigned configuration_get_flush_latency(const configuration_t *config) {
+  return config->flush_latency;
+}
+
+int configuration_set_max_packet_size(configuration_t *config, size_t size) {
+  if (size > MSGBUF_MAX_SIZE) return -1;
+  config->max_packet_size = size;
+  return 0;
+}
+
+size_t configuration_get_max_packet_size(const configuration_t *config) {
+  return config->max_packet_size;
+}
+
 const char *configuration_get_fn_config(const configuration_t *config) {
   return config->fn_config;
 }
@@ -156,6 +269,14 @@ int_manifest_split_strategy_t configuration_get_split_strategy(
   return config->split_strategy;
 }
 
+void configuration_set_n_workers(configuration_t *config, unsigned n_workers) {
+  config->n_workers = n_workers;
+}
+
+unsigned configuration_get_n_workers(const configuration_t *config) {
+  return config->n_workers;
+}
+
 void configuration_set_port(configuration_t *config, uint16_t port) {
   config->port = port;
 }
@@ -27,7 +27,9 @@
 #define HICNLIGHT_CONFIGURATION_H
 
 #include <hicn/util/khash.h>
+#include "../core/content_store.h"
 #include "../core/msgbuf.h"
+#include "../core/pit.h"
 #include "../core/strategy.h"
 #include <hicn/ctrl/api.h>
 #include <hicn/ctrl/hicn-light.h>
@@ -69,6 +71,19 @@ configuration_t *configuration_create();
  */
 void configuration_free(configuration_t *config);
 
+/**
+ * Creates a copy of the configuration to be owned by another forwarder
+ * instance (e.g. a data plane worker).
+ *
+ * Per-prefix strategies are not copied: they are populated again when the
+ * corresponding commands are processed by the new owner.
+ *
+ * @param [in] config - Configuration to copy
+ *
+ * @retval The newly allocated configuration, or NULL in case of error
+ */
+configuration_t *configuration_clone(const configuration_t *config);
+
 /**
  * Returns the configured size of the content store
  *
@@ -99,6 +114,78 @@ size_t configuration_get_cs_size(const configuration_t *config);
  */
 void configuration_set_cs_size(configuration_t *config, size_t size);
 
+/**
+ * Sets the replacement policy of the content store
+ *
+ * Must be set before starting the forwarder
+ */
+void configuration_set_cs_type(configuration_t *config, cs_type_t type);
+
+cs_type_t configuration_get_cs_type(const configuration_t *config);
+
+/**
+ * Enables the second tier of the content store, backed by the specified file
+ * of the specified size (in bytes)
+ *
+ * Must be set before starting the forwarder
+ */
+void configuration_set_cs_disk(configuration_t *config, const char *path,
+                               size_t size);
+
+/**
+ * Returns the path of the file backing the second tier of the content store,
+ * or NULL if disabled
+ */
+const char *configuration_get_cs_disk_path(const configuration_t *config);
+
+size_t configuration_get_cs_disk_size(const configuration_t *config);
+
+/**
+ * Sets the maximum number of PIT entries, overall and for each ingress
+ * connection (0 = unbounded)
+ *
+ * Must be set before starting the forwarder
+ */
+void configuration_set_pit_size(configuration_t *config, size_t size,
+                                size_t size_per_connection);
+
+size_t configuration_get_pit_size(const configuration_t *config);
+
+size_t configuration_get_pit_size_per_connection(
+    const configuration_t *config);
+
+/**
+ * Sets the policy applied when an interest would create a new entry in a full
+ * PIT
+ */
+void configuration_set_pit_full_policy(configuration_t *config,
+                                       pit_full_policy_t policy);
+
+pit_full_policy_t configuration_get_pit_full_policy(
+    const configuration_t *config);
+
+/**
+ * Sets the egress flush policy: queued packets are flushed to a connection as
+ * soon as batch_size of them are pending (0 = no threshold), and otherwise
+ * held for at most latency_ms milliseconds to coalesce larger batches (0 =
+ * flush at the end of each batch of received packets)
+ */
+void configuration_set_flush_policy(configuration_t *config,
+                                    unsigned batch_size, unsigned latency_ms);
+
+unsigned configuration_get_flush_batch_size(const configuration_t *config);
+
+unsigned configuration_get_flush_latency(const configuration_t *config);
+
+/**
+ * Sets the size of the largest packet expected on the links, which selects
+ * the size class of the buffers packets are received into (0 = MTU). Sizes
+ * larger than MSGBUF_MAX_SIZE are rejected.
+ */
+int configuration_set_max_packet_size(configuration_t *config, size_t size);
+
+size_t configuration_get_max_packet_size(const configuration_t *config);
+
 const char *configuration_get_fn_config(const configuration_t *config);
 
 void configuration_set_fn_config(configuration_t *config,
@@ -116,6 +203,15 @@ void configuration_set_split_strategy(
 int_manifest_split_strategy_t configuration_get_split_strategy(
     const configuration_t *config);
 
+/**
+ * Sets the number of data plane workers (1 = single-threaded forwarder)
+ *
+ * Must be set before starting the forwarder
+ */
+void configuration_set_n_workers(configuration_t *config, unsigned n_workers);
+
+unsigned configuration_get_n_workers(const configuration_t *config);
+
 void configuration_set_port(configuration_t *config, uint16_t port);
 
 uint16_t configuration_get_port(const configuration_t *config);
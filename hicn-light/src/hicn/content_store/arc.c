@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <hicn/util/khash.h>
+#include <hicn/util/log.h>
+#include <hicn/util/pool.h>
+
+#include <hicn/core/packet_cache.h>
+#include "arc.h"
+#include "segments.h"
+
+/******************************************************************************
+ * Ghost lists (B1, B2)
+ *
+ * Ghosts only hold the hash of the name of evicted entries. They are
+ * allocated in a pool, chained in LRU order and indexed by hash.
+ ******************************************************************************/
+
+#define GHOST_INVALID_ID (~0u)
+
+KHASH_MAP_INIT_INT(cs_arc_ghost, unsigned);
+
+typedef struct {
+  uint32_t hash;
+  uint8_t list;
+  unsigned prev;
+  unsigned next;
+} cs_arc_ghost_t;
+
+typedef struct {
+  unsigned head;
+  unsigned tail;
+  size_t len;
+} cs_arc_ghost_list_t;
+
+struct cs_arc_ghosts_s {
+  cs_arc_ghost_t *pool;
+  cs_arc_ghost_list_t lists[CS_ARC_N_LISTS];
+  kh_cs_arc_ghost_t *index;
+};
+
+#define _ghost_len(ghosts, list) ((ghosts)->lists[list].len)
+
+static cs_arc_ghosts_t *_ghosts_create() {
+  cs_arc_ghosts_t *ghosts = malloc(sizeof(cs_arc_ghosts_t));
+  if (!ghosts) return NULL;
+
+  pool_init(ghosts->pool, DEFAULT_CS_SIZE, 0);
+  for (unsigned i = 0; i < CS_ARC_N_LISTS; i++)
+    ghosts->lists[i] = (cs_arc_ghost_list_t){
+        .head = GHOST_INVALID_ID, .tail = GHOST_INVALID_ID, .len = 0};
+  ghosts->index = kh_init_cs_arc_ghost();
+  return ghosts;
+}
+
+static void _ghosts_free(cs_arc_ghosts_t *ghosts) {
+  kh_destroy_cs_arc_ghost(ghosts->index);
+  pool_free(ghosts->pool);
+  free(ghosts);
+}
+
+static void _ghosts_remove(cs_arc_ghosts_t *ghosts, unsigned id) {
+  cs_arc_ghost_t *ghost = &ghosts->pool[id];
+  cs_arc_ghost_list_t *list = &ghosts->lists[ghost->list];
+
+  if (ghost->prev != GHOST_INVALID_ID)
+    ghosts->pool[ghost->prev].next = ghost->next;
+  else
+    list->head = ghost->next;
+
+  if (ghost->next != GHOST_INVALID_ID)
+    ghosts->pool[ghost->next].prev = ghost->prev;
+  else
+    list->tail = ghost->prev;
+  list->len--;
+
+  khiter_t k = kh_get_cs_arc_ghost(ghosts->index, ghost->hash);
+  assert(k != kh_end(ghosts->index));
+  kh_del_cs_arc_ghost(ghosts->index, k);
+
+  pool_put(ghosts->pool, ghost);
+}
+
+/* Returns the list holding the ghost with the specified hash, or -1 */
+static int _ghosts_lookup(const cs_arc_ghosts_t *ghosts, uint32_t hash,
+                          unsigned *id) {
+  khiter_t k = kh_get_cs_arc_ghost(ghosts->index, hash);
+  if (k == kh_end(ghosts->index)) return -1;
+
+  *id = kh_val(ghosts->index, k);
+  return ghosts->pool[*id].list;
+}
+
+static void _ghosts_push(cs_arc_ghosts_t *ghosts, cs_arc_list_t list_id,
+                         uint32_t hash) {
+  // Names with colliding hashes share a ghost
+  unsigned id;
+  if (_ghosts_lookup(ghosts, hash, &id) >= 0) _ghosts_remove(ghosts, id);
+
+  cs_arc_ghost_t *ghost;
+  id = (unsigned)pool_get(ghosts->pool, ghost);
+
+  cs_arc_ghost_list_t *list = &ghosts->lists[list_id];
+  ghost->hash = hash;
+  ghost->list = list_id;
+  ghost->prev = GHOST_INVALID_ID;
+  ghost->next = list->head;
+  if (list->head != GHOST_INVALID_ID)
+    ghosts->pool[list->head].prev = id;
+  else
+    list->tail = id;
+  list->head = id;
+  list->len++;
+
+  int res;
+  khiter_t k = kh_put_cs_arc_ghost(ghosts->index, hash, &res);
+  kh_val(ghosts->index, k) = id;
+}
+
+static void _ghosts_pop(cs_arc_ghosts_t *ghosts, cs_arc_list_t list_id) {
+  unsigned tail = ghosts->lists[list_id].tail;
+  if (tail != GHOST_INVALID_ID) _ghosts_remove(ghosts, tail);
+}
+
+/******************************************************************************
+ * Cached entries (T1, T2)
+ ******************************************************************************/
+
+#define _entry_hash(pkt_cache, entry_id) \
+  hicn_name_get_hash(&pkt_cache_entry_at((pkt_cache), (entry_id))->name)
+
+static void _cs_arc_push(pkt_cache_t *pkt_cache, cs_arc_state_t *arc,
+                         cs_arc_list_t list, off_t entry_id) {
+  cs_segment_push(pkt_cache, &arc->lists[list], list, entry_id);
+  arc->len[list]++;
+}
+
+static void _cs_arc_remove(pkt_cache_t *pkt_cache, cs_arc_state_t *arc,
+                           off_t entry_id) {
+  uint8_t list = cs_segment_entry_at(pkt_cache, entry_id)->segment;
+  assert(list < CS_ARC_N_LISTS);
+
+  cs_segment_remove(pkt_cache, &arc->lists[list], entry_id);
+  arc->len[list]--;
+}
+
+/*
+ * Evict the tail of T1 or T2 depending on the target size of T1, and remember
+ * it in the corresponding ghost list (REPLACE in the ARC paper).
+ */
+static off_t _cs_arc_replace(pkt_cache_t *pkt_cache, cs_arc_state_t *arc,
+                             bool is_ghost_hit_frequency) {
+  size_t len1 = arc->len[CS_ARC_T1];
+  cs_arc_list_t list = CS_ARC_T2;
+  if (len1 > 0 && (len1 > arc->p || arc->len[CS_ARC_T2] == 0 ||
+                   (is_ghost_hit_frequency && len1 == arc->p)))
+    list = CS_ARC_T1;
+
+  off_t victim_id = arc->lists[list].tail;
+  _cs_arc_remove(pkt_cache, arc, victim_id);
+  _ghosts_push(arc->ghosts, list, _entry_hash(pkt_cache, victim_id));
+  return victim_id;
+}
+
+/******************************************************************************
+ * Content store policy
+ ******************************************************************************/
+
+static int cs_arc_initialize(cs_t *cs) {
+  cs_arc_state_t *arc = &cs->arc;
+
+  for (unsigned i = 0; i < CS_ARC_N_LISTS; i++) {
+    arc->lists[i].head = INVALID_ENTRY_ID;
+    arc->lists[i].tail = INVALID_ENTRY_ID;
+    arc->len[i] = 0;
+  }
+  arc->p = 0;
+  arc->ghosts = _ghosts_create();
+  if (!arc->ghosts) return -1;
+
+  cs->stats.arc = (cs_arc_stats_t){0};
+  return 0;
+}
+
+static void cs_arc_finalize(cs_t *cs) { _ghosts_free(cs->arc.ghosts); }
+
+static int cs_arc_resize(cs_t *cs) {
+  // The target size of T1 never exceeds the capacity
+  if (cs->arc.p > cs->max_size) cs->arc.p = cs->max_size;
+  return 0;
+}
+
+static int cs_arc_add_entry(pkt_cache_t *pkt_cache, off_t entry_id,
+                            off_t *evicted_id) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs_arc_state_t *arc = &cs->arc;
+  cs_arc_ghosts_t *ghosts = arc->ghosts;
+  size_t c = cs->max_size;
+  bool is_full = cs->num_entries > c;
+
+  cs->stats.lru.countAdds++;
+  *evicted_id = INVALID_ENTRY_ID;
+
+  size_t b1 = _ghost_len(ghosts, CS_ARC_T1);
+  size_t b2 = _ghost_len(ghosts, CS_ARC_T2);
+  size_t delta;
+  unsigned ghost_id;
+  int ghost_list = _ghosts_lookup(ghosts, _entry_hash(pkt_cache, entry_id),
+                                  &ghost_id);
+  switch (ghost_list) {
+    case CS_ARC_T1:
+      // Recently evicted from T1: favor recency
+      delta = b2 > b1 ? b2 / b1 : 1;
+      arc->p = arc->p + delta < c ? arc->p + delta : c;
+      _ghosts_remove(ghosts, ghost_id);
+      cs->stats.arc.countGhostHitsRecency++;
+      break;
+
+    case CS_ARC_T2:
+      // Recently evicted from T2: favor frequency
+      delta = b1 > b2 ? b1 / b2 : 1;
+      arc->p = arc->p > delta ? arc->p - delta : 0;
+      _ghosts_remove(ghosts, ghost_id);
+      cs->stats.arc.countGhostHitsFrequency++;
+      break;
+
+    default:
+      // Bound the size of the ghost lists
+      if (arc->len[CS_ARC_T1] + b1 >= c) {
+        if (arc->len[CS_ARC_T1] < c) {
+          _ghosts_pop(ghosts, CS_ARC_T1);
+        } else if (is_full) {
+          // B1 is empty, evict from T1 without remembering the entry
+          *evicted_id = arc->lists[CS_ARC_T1].tail;
+          _cs_arc_remove(pkt_cache, arc, *evicted_id);
+        }
+      } else if (arc->len[CS_ARC_T1] + arc->len[CS_ARC_T2] + b1 + b2 >=
+                 2 * c) {
+        _ghosts_pop(ghosts, CS_ARC_T2);
+      }
+      break;
+  }
+
+  if (is_full && *evicted_id == INVALID_ENTRY_ID)
+    *evicted_id = _cs_arc_replace(pkt_cache, arc, ghost_list == CS_ARC_T2);
+
+  _cs_arc_push(pkt_cache, arc, ghost_list >= 0 ? CS_ARC_T2 : CS_ARC_T1,
+               entry_id);
+
+  if (!is_full) return LRU_SUCCESS;
+  cs->stats.lru.countLruEvictions++;
+  return LRU_EVICTION;
+}
+
+static void cs_arc_hit_entry(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
+
+  _cs_arc_remove(pkt_cache, &cs->arc, entry_id);
+  _cs_arc_push(pkt_cache, &cs->arc, CS_ARC_T2, entry_id);
+}
+
+static void cs_arc_update_entry(pkt_cache_t *pkt_cache,
+                                pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs->stats.lru.countUpdates++;
+  cs_arc_hit_entry(pkt_cache, entry);
+}
+
+static int cs_arc_remove_entry(pkt_cache_t *pkt_cache,
+                               pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  _cs_arc_remove(pkt_cache, &cs->arc,
+                 pkt_cache_get_entry_id(pkt_cache, entry));
+  cs->stats.lru.countLruDeletions++;
+  return LRU_SUCCESS;
+}
+
+DECLARE_CS(arc);
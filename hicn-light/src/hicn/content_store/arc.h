@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file arc.h
+ * @brief Adaptive Replacement Cache (ARC) content store policy
+ *
+ * Cached entries are split between a recency list (T1, entries hit once) and
+ * a frequency list (T2, entries hit at least twice). The names of the entries
+ * evicted from each list are remembered in two ghost lists (B1 and B2), and
+ * hits in those lists adapt the target size of T1 to the workload.
+ *
+ * Reference: N. Megiddo, D. Modha, "ARC: A Self-Tuning, Low Overhead
+ * Replacement Cache", USENIX FAST 2003.
+ */
+
+#ifndef HICNLIGHT_CS_ARC_H
+#define HICNLIGHT_CS_ARC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lru.h"
+
+typedef enum {
+  CS_ARC_T1,
+  CS_ARC_T2,
+  CS_ARC_N_LISTS,
+} cs_arc_list_t;
+
+/* Ghost lists, private to the implementation */
+typedef struct cs_arc_ghosts_s cs_arc_ghosts_t;
+
+typedef struct {
+  cs_lru_state_t lists[CS_ARC_N_LISTS];
+  size_t len[CS_ARC_N_LISTS];
+  /* Target size of T1 */
+  size_t p;
+  cs_arc_ghosts_t *ghosts;
+} cs_arc_state_t;
+
+/**
+ * @brief Count the number of hits in the ghost lists, i.e. of objects that
+ * have been requested again shortly after their eviction.
+ */
+typedef struct {
+  uint64_t countGhostHitsRecency;
+  uint64_t countGhostHitsFrequency;
+} cs_arc_stats_t;
+
+#endif /* HICNLIGHT_CS_ARC_H */
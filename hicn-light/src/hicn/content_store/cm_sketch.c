@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "cm_sketch.h"
+
+#define MIN_WIDTH 16
+
+/* Row i uses the index h1 + i * h2 (double hashing) */
+#define _second_hash(hash) ((((hash) >> 16) | ((hash) << 16)) * 0x9e3779b1u | 1)
+
+#define _counter_index(sketch, row, h1, h2) \
+  ((row) * (sketch)->width + (((h1) + (row) * (h2)) & ((sketch)->width - 1)))
+
+#define _counter_get(sketch, i) \
+  (((sketch)->counters[(i) >> 1] >> (((i)&1) * 4)) & 0xf)
+
+static size_t _cm_sketch_width(size_t n_elements) {
+  size_t width = MIN_WIDTH;
+  while (width < n_elements) width <<= 1;
+  return width;
+}
+
+int cm_sketch_init(cm_sketch_t *sketch, size_t n_elements) {
+  assert(sketch);
+
+  size_t width = _cm_sketch_width(n_elements);
+
+  /* Two counters per byte */
+  sketch->counters = calloc(CM_SKETCH_DEPTH * width / 2, sizeof(uint8_t));
+  if (!sketch->counters) return -1;
+
+  sketch->width = width;
+  sketch->n_samples = 0;
+  sketch->sample_size = CM_SKETCH_SAMPLE_FACTOR * width;
+  return 0;
+}
+
+void cm_sketch_finalize(cm_sketch_t *sketch) {
+  assert(sketch);
+  free(sketch->counters);
+  sketch->counters = NULL;
+}
+
+int cm_sketch_resize(cm_sketch_t *sketch, size_t n_elements) {
+  assert(sketch);
+
+  if (_cm_sketch_width(n_elements) == sketch->width) return 0;
+
+  cm_sketch_t resized;
+  if (cm_sketch_init(&resized, n_elements) < 0) return -1;
+  cm_sketch_finalize(sketch);
+  *sketch = resized;
+  return 0;
+}
+
+/* Halve all counters */
+static void _cm_sketch_age(cm_sketch_t *sketch) {
+  for (size_t i = 0; i < CM_SKETCH_DEPTH * sketch->width / 2; i++)
+    sketch->counters[i] = (sketch->counters[i] >> 1) & 0x77;
+  sketch->n_samples /= 2;
+}
+
+void cm_sketch_increment(cm_sketch_t *sketch, uint32_t hash) {
+  assert(sketch);
+
+  uint32_t h2 = _second_hash(hash);
+  for (unsigned row = 0; row < CM_SKETCH_DEPTH; row++) {
+    size_t i = _counter_index(sketch, row, hash, h2);
+    if (_counter_get(sketch, i) < CM_SKETCH_MAX_COUNT)
+      sketch->counters[i >> 1] += 1 << ((i & 1) * 4);
+  }
+
+  if (++sketch->n_samples >= sketch->sample_size) _cm_sketch_age(sketch);
+}
+
+unsigned cm_sketch_estimate(const cm_sketch_t *sketch, uint32_t hash) {
+  assert(sketch);
+
+  uint32_t h2 = _second_hash(hash);
+  unsigned min = CM_SKETCH_MAX_COUNT;
+  for (unsigned row = 0; row < CM_SKETCH_DEPTH; row++) {
+    size_t i = _counter_index(sketch, row, hash, h2);
+    unsigned count = _counter_get(sketch, i);
+    if (count < min) min = count;
+  }
+  return min;
+}
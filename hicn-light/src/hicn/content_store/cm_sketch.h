@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file cm_sketch.h
+ * @brief Count-min sketch estimating the frequency of recent requests
+ *
+ * Counters are 4-bit wide (saturating at 15) and packed two per byte. They
+ * are all halved once the number of increments reaches a sample size
+ * proportional to the number of tracked elements, so that the estimates
+ * reflect the recent popularity of the elements.
+ */
+
+#ifndef HICNLIGHT_CM_SKETCH_H
+#define HICNLIGHT_CM_SKETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CM_SKETCH_DEPTH 4
+#define CM_SKETCH_MAX_COUNT 15
+
+/* Number of increments between two agings, per tracked element */
+#define CM_SKETCH_SAMPLE_FACTOR 10
+
+typedef struct {
+  uint8_t *counters; /* CM_SKETCH_DEPTH rows of width 4-bit counters */
+  size_t width;      /* Power of 2 */
+  size_t n_samples;
+  size_t sample_size;
+} cm_sketch_t;
+
+/**
+ * @brief Initialize a sketch.
+ *
+ * @param[in] sketch The sketch to initialize
+ * @param[in] n_elements Expected number of tracked elements
+ *
+ * @return int 0 if successful, -1 otherwise
+ */
+int cm_sketch_init(cm_sketch_t *sketch, size_t n_elements);
+
+void cm_sketch_finalize(cm_sketch_t *sketch);
+
+/**
+ * @brief Size a sketch for a new number of tracked elements. Counters are
+ * reset if the width of the sketch changes.
+ *
+ * @return int 0 if successful, -1 otherwise (the sketch is left unchanged)
+ */
+int cm_sketch_resize(cm_sketch_t *sketch, size_t n_elements);
+
+/**
+ * @brief Record a request for the element with the specified hash.
+ */
+void cm_sketch_increment(cm_sketch_t *sketch, uint32_t hash);
+
+/**
+ * @brief Estimate the number of recent requests for the element with the
+ * specified hash.
+ */
+unsigned cm_sketch_estimate(const cm_sketch_t *sketch, uint32_t hash);
+
+#endif /* HICNLIGHT_CM_SKETCH_H */
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file disk.c
+ * \brief Implementation of the memory-mapped second tier of the content store
+ *
+ * A slot is in use if and only if the index maps the name it holds to its
+ * position. Slots never written read as zeros (the file is sparse), and slots
+ * whose packet has been removed keep their stale content: in both cases the
+ * index lookup fails or returns another slot, so no per-slot flag needs to
+ * be maintained (nor cleared) in the file.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <hicn/util/log.h>
+
+#include "disk.h"
+
+static_assert(sizeof(cs_disk_slot_t) + MTU <= CS_DISK_SLOT_SIZE,
+              "A slot must be able to hold a full packet");
+
+#define _slot_at(disk, id) \
+  ((cs_disk_slot_t *)((disk)->base + (size_t)(id)*CS_DISK_SLOT_SIZE))
+
+static const hicn_name_t *_cs_disk_get_name(const void *context, unsigned id) {
+  const cs_disk_t *disk = (const cs_disk_t *)context;
+  return &_slot_at(disk, id)->name;
+}
+
+static bool _cs_disk_slot_in_use(const cs_disk_t *disk, size_t id) {
+  return name_index_get(disk->index, &_slot_at(disk, id)->name) == id;
+}
+
+cs_disk_t *cs_disk_create(const char *path, size_t size) {
+  assert(path);
+
+  size_t n_slots = size / CS_DISK_SLOT_SIZE;
+  /* Slots are identified by an unsigned in the index */
+  if (n_slots == 0 || n_slots >= NAME_INDEX_INVALID_ID) {
+    ERROR("[cs_disk] Invalid size for the second tier: %zu bytes", size);
+    goto ERR_SIZE;
+  }
+
+  cs_disk_t *disk = malloc(sizeof(cs_disk_t));
+  if (!disk) goto ERR_MALLOC;
+
+  disk->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (disk->fd < 0) goto ERR_OPEN;
+
+  size = n_slots * CS_DISK_SLOT_SIZE;
+  if (ftruncate(disk->fd, (off_t)size) < 0) goto ERR_TRUNCATE;
+
+  disk->base =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, disk->fd, 0);
+  if (disk->base == MAP_FAILED) goto ERR_TRUNCATE;
+
+  /* Packets are read back in no particular order, readahead is useless */
+  madvise(disk->base, size, MADV_RANDOM);
+
+  disk->index = name_index_create(_cs_disk_get_name, disk);
+  if (!disk->index) goto ERR_INDEX;
+
+  disk->n_slots = n_slots;
+  disk->head = 0;
+  disk->stats = (cs_disk_stats_t){0};
+
+  INFO("[cs_disk] Second tier of %zu slots backed by %s", n_slots, path);
+  return disk;
+
+ERR_INDEX:
+  munmap(disk->base, size);
+ERR_TRUNCATE:
+  close(disk->fd);
+ERR_OPEN:
+  ERROR("[cs_disk] Could not map %s: (%d) %s", path, errno, strerror(errno));
+  free(disk);
+ERR_MALLOC:
+ERR_SIZE:
+  return NULL;
+}
+
+void cs_disk_free(cs_disk_t *disk) {
+  if (!disk) return;
+
+  name_index_free(disk->index);
+  munmap(disk->base, disk->n_slots * CS_DISK_SLOT_SIZE);
+  close(disk->fd);
+  free(disk);
+}
+
+int cs_disk_put(cs_disk_t *disk, const hicn_name_t *name,
+                const uint8_t *packet, size_t len, Ticks expire_ts) {
+  assert(disk);
+  assert(name);
+  assert(packet);
+
+  if (len > MTU) return -1;
+
+  cs_disk_remove(disk, name);
+
+  size_t id = disk->head;
+  cs_disk_slot_t *slot = _slot_at(disk, id);
+  if (_cs_disk_slot_in_use(disk, id)) {
+    name_index_remove(disk->index, &slot->name);
+    disk->stats.countOverwrites++;
+  }
+
+  slot->name = *name;
+  slot->expire_ts = expire_ts;
+  slot->len = (uint16_t)len;
+  memcpy(slot->packet, packet, len);
+
+  if (name_index_put(disk->index, name, (unsigned)id) < 0) return -1;
+
+  disk->head = (id + 1) % disk->n_slots;
+  disk->stats.countDemotions++;
+  return 0;
+}
+
+const cs_disk_slot_t *cs_disk_get(cs_disk_t *disk, const hicn_name_t *name,
+                                  Ticks now) {
+  assert(disk);
+  assert(name);
+
+  unsigned id = name_index_get(disk->index, name);
+  if (id == NAME_INDEX_INVALID_ID) return NULL;
+
+  const cs_disk_slot_t *slot = _slot_at(disk, id);
+  if (slot->expire_ts <= now) {
+    name_index_remove(disk->index, name);
+    disk->stats.countExpired++;
+    return NULL;
+  }
+
+  disk->stats.countPromotions++;
+  return slot;
+}
+
+void cs_disk_remove(cs_disk_t *disk, const hicn_name_t *name) {
+  assert(disk);
+  assert(name);
+
+  name_index_remove(disk->index, name);
+}
+
+int cs_disk_clear(cs_disk_t *disk) {
+  assert(disk);
+
+  name_index_t *index = name_index_create(_cs_disk_get_name, disk);
+  if (!index) return -1;
+
+  name_index_free(disk->index);
+  disk->index = index;
+  disk->head = 0;
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file disk.h
+ * @brief Memory-mapped second tier of the content store
+ *
+ * Data packets evicted from the in-memory content store can be demoted to a
+ * much larger second tier, backed by a memory-mapped file. The file is managed
+ * as a circular log of fixed-size slots, each holding a packet together with
+ * its name and expiry time: demotions are appended at the head of the log,
+ * overwriting the oldest slot, so that the file is written sequentially and
+ * no allocator is needed.
+ *
+ * Slots are indexed by name in memory, the index being the only authority on
+ * which slots are in use. It is not persisted, and the file is thus truncated
+ * when the tier is created.
+ *
+ * The tier is exclusive: a hit promotes the packet back to the in-memory
+ * content store and removes it from the tier.
+ */
+
+#ifndef HICNLIGHT_CS_DISK_H
+#define HICNLIGHT_CS_DISK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hicn/name.h>
+#include "../core/msgbuf.h"
+#include "../core/name_index.h"
+#include "../core/ticks.h"
+
+#define CS_DISK_SLOT_SIZE 2048
+
+/* 1 GB */
+#define CS_DISK_DEFAULT_SIZE (1ul << 30)
+
+typedef struct {
+  hicn_name_t name;
+  Ticks expire_ts;
+  uint16_t len;
+  uint8_t packet[];
+} cs_disk_slot_t;
+
+typedef struct {
+  uint64_t countDemotions;
+  uint64_t countPromotions;
+  uint64_t countOverwrites; /* Entries lost when the log wraps around */
+  uint64_t countExpired;
+  uint64_t countOversized; /* Jumbo packets, which do not fit in a slot */
+} cs_disk_stats_t;
+
+typedef struct {
+  int fd;
+  uint8_t *base;
+  size_t n_slots;
+  size_t head; /* Next slot to write */
+
+  name_index_t *index;
+  cs_disk_stats_t stats;
+} cs_disk_t;
+
+/**
+ * @brief Create a second tier backed by the specified file, which is created
+ * if needed and truncated.
+ *
+ * @param[in] path Path of the backing file
+ * @param[in] size Size of the file in bytes, rounded down to a whole number
+ * of slots
+ *
+ * @return cs_disk_t* The newly created tier, or NULL in case of error
+ */
+cs_disk_t *cs_disk_create(const char *path, size_t size);
+
+void cs_disk_free(cs_disk_t *disk);
+
+/**
+ * @brief Store a packet in the tier, replacing any previous packet with the
+ * same name. The oldest slot is overwritten when the tier is full.
+ *
+ * @return int 0 in case of success, -1 otherwise
+ */
+int cs_disk_put(cs_disk_t *disk, const hicn_name_t *name,
+                const uint8_t *packet, size_t len, Ticks expire_ts);
+
+/**
+ * @brief Retrieve the packet with the specified name.
+ *
+ * The returned slot points into the mapping and is only valid until the next
+ * call modifying the tier. Expired packets are removed and not returned.
+ *
+ * @return const cs_disk_slot_t* The slot holding the packet, or NULL if not
+ * found
+ */
+const cs_disk_slot_t *cs_disk_get(cs_disk_t *disk, const hicn_name_t *name,
+                                  Ticks now);
+
+/**
+ * @brief Remove the packet with the specified name, if any.
+ */
+void cs_disk_remove(cs_disk_t *disk, const hicn_name_t *name);
+
+/**
+ * @brief Remove all packets from the tier.
+ *
+ * @return int 0 in case of success, -1 otherwise
+ */
+int cs_disk_clear(cs_disk_t *disk);
+
+#define cs_disk_get_num_entries(disk) ((disk)->index->n_elts)
+
+#define cs_disk_get_num_slots(disk) ((disk)->n_slots)
+
+#endif /* HICNLIGHT_CS_DISK_H */
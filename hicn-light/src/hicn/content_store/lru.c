@@ -24,17 +24,24 @@
 
 #include <hicn/core/packet_cache.h>
 #include "lru.h"
+#include "segments.h"
 
-void cs_lru_initialize(cs_t *cs) {
+int cs_lru_initialize(cs_t *cs) {
   /* We start with an empty double-linked list */
   cs->lru.head = INVALID_ENTRY_ID;
   cs->lru.tail = INVALID_ENTRY_ID;
+  return 0;
 }
 
 void cs_lru_finalize(cs_t *cs) {
   // Nothing to do
 }
 
+int cs_lru_resize(cs_t *cs) {
+  // Nothing to do
+  return 0;
+}
+
 cs_entry_t *_cs_entry_at(pkt_cache_t *pkt_cache, off_t entry_id) {
   pkt_cache_entry_t *entry = pkt_cache_entry_at(pkt_cache, entry_id);
   assert(entry->entry_type == PKT_CACHE_CS_TYPE);
@@ -84,13 +91,15 @@ static int cs_lru_remove_entry(pkt_cache_t *pkt_cache,
  * @param[in] entry_id Identifier of the entry in the content store entry pool.
  * @param[in] is_update Boolean value to distinguish update from add operations
  * since an update involves removing an entry and adding it again
+ * @param[out] evicted_id Identifier of the evicted entry, if any.
  *
  * @return int Error code : 0 if succesful, a negative value otherwise.
  *
  * NOTE:
  *  - We insert the new element at the head of the double-linked list.
  */
-int _cs_lru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id, bool is_update) {
+int _cs_lru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id, bool is_update,
+                      off_t *evicted_id) {
   assert(pkt_cache);
 
   cs_t *cs = pkt_cache_get_cs(pkt_cache);
@@ -122,6 +131,7 @@ int _cs_lru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id, bool is_update) {
     cs->stats.lru.countLruEvictions++;
 
     // Remove from LRU tail
+    *evicted_id = cs->lru.tail;
     pkt_cache_entry_t *tail = pkt_cache_entry_at(pkt_cache, cs->lru.tail);
     cs_lru_remove_entry(pkt_cache, tail);
     return LRU_EVICTION;
@@ -135,14 +145,16 @@ int _cs_lru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id, bool is_update) {
  * store.
  * @param[in] cs Content store.
  * @param[in] entry_id Identifier of the entry in the content store entry pool.
+ * @param[out] evicted_id Identifier of the evicted entry, if any.
  *
  * @return int Error code : 0 if succesful, a negative value otherwise.
  *
  * NOTE:
  *  - We insert the new element at the head of the double-linked list.
  */
-static int cs_lru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id) {
-  return _cs_lru_add_entry(pkt_cache, entry_id, false);
+static int cs_lru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id,
+                            off_t *evicted_id) {
+  return _cs_lru_add_entry(pkt_cache, entry_id, false, evicted_id);
 }
 
 /**
@@ -159,9 +171,26 @@ static void cs_lru_update_entry(pkt_cache_t *pkt_cache,
   // Remove from LRU
   cs_lru_remove_entry(pkt_cache, entry);
 
-  // Attach at the LRU head
+  // Attach at the LRU head (the number of entries is unchanged, so that there
+  // is no eviction)
   off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
-  _cs_lru_add_entry(pkt_cache, entry_id, true);
+  off_t evicted_id;
+  _cs_lru_add_entry(pkt_cache, entry_id, true, &evicted_id);
+}
+
+/**
+ * Move a cs_entry_t to the LRU head upon a CS hit.
+ */
+static void cs_lru_hit_entry(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry) {
+  assert(pkt_cache);
+  assert(entry);
+
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
+  if (cs->lru.head == entry_id) return;
+
+  cs_segment_remove(pkt_cache, &cs->lru, entry_id);
+  cs_segment_push(pkt_cache, &cs->lru, 0, entry_id);
 }
 
 DECLARE_CS(lru);
@@ -39,10 +39,9 @@ typedef struct {
  *   (because an already-existing CS entry has been updated)
  * - LRU evictions
  *
- * 'countExpiryEvictions' is not collected since an entry is never evicted
- * because of expiration. An expired CS entry is only detected when
- * a data packet with the same name is received, causing an update
- * (NOT an actual eviction).
+ * Expired CS entries are reclaimed by the packet cache timer wheel (see
+ * pkt_cache_expire) and counted there as 'n_cs_reclaimed'; from the LRU point
+ * of view they are plain deletions.
  */
 typedef struct {
   uint64_t countHits;
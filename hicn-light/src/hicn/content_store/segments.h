@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file segments.h
+ * @brief Helpers shared by the content store policies
+ *
+ * Policies keep CS entries in one or several doubly-linked lists (segments)
+ * threaded through cs_entry_t.lru, from the most recently used entry (head) to
+ * the least recently used one (tail). The segment holding an entry is stored
+ * in cs_entry_t.segment.
+ */
+
+#ifndef HICNLIGHT_CS_SEGMENTS_H
+#define HICNLIGHT_CS_SEGMENTS_H
+
+#include <hicn/core/packet_cache.h>
+
+#define cs_segment_entry_at(pkt_cache, entry_id) \
+  (&pkt_cache_entry_at((pkt_cache), (entry_id))->u.cs_entry)
+
+/**
+ * @brief Insert an entry at the head of a segment.
+ */
+static inline void cs_segment_push(pkt_cache_t *pkt_cache,
+                                   cs_lru_state_t *segment, uint8_t id,
+                                   off_t entry_id) {
+  cs_entry_t *entry = cs_segment_entry_at(pkt_cache, entry_id);
+
+  entry->segment = id;
+  entry->lru.prev = INVALID_ENTRY_ID;
+  entry->lru.next = segment->head;
+  if (segment->head != INVALID_ENTRY_ID)
+    cs_segment_entry_at(pkt_cache, segment->head)->lru.prev = entry_id;
+  else
+    segment->tail = entry_id;
+  segment->head = entry_id;
+}
+
+/**
+ * @brief Remove an entry from the segment holding it.
+ */
+static inline void cs_segment_remove(pkt_cache_t *pkt_cache,
+                                     cs_lru_state_t *segment, off_t entry_id) {
+  cs_entry_t *entry = cs_segment_entry_at(pkt_cache, entry_id);
+
+  if (entry->lru.prev != INVALID_ENTRY_ID)
+    cs_segment_entry_at(pkt_cache, entry->lru.prev)->lru.next = entry->lru.next;
+  else
+    segment->head = entry->lru.next;
+
+  if (entry->lru.next != INVALID_ENTRY_ID)
+    cs_segment_entry_at(pkt_cache, entry->lru.next)->lru.prev = entry->lru.prev;
+  else
+    segment->tail = entry->lru.prev;
+
+  entry->lru.prev = INVALID_ENTRY_ID;
+  entry->lru.next = INVALID_ENTRY_ID;
+}
+
+/*
+ * Segmented LRU, used both as a policy on its own and as the main area of
+ * W-TinyLFU (see slru.c)
+ */
+
+void cs_slru_state_init(cs_slru_state_t *slru);
+
+/**
+ * @brief Insert a new entry in the probationary segment.
+ */
+void cs_slru_insert(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    off_t entry_id);
+
+/**
+ * @brief Handle a hit on an entry: it is moved to the head of the protected
+ * segment, possibly demoting the tail of the latter to the probationary one.
+ */
+void cs_slru_access(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    off_t entry_id, size_t protected_size,
+                    cs_slru_stats_t *stats);
+
+/**
+ * @brief Demote the tail of the protected segment to the probationary one
+ * until the former holds at most protected_size entries.
+ */
+void cs_slru_demote(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    size_t protected_size, cs_slru_stats_t *stats);
+
+void cs_slru_remove(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    off_t entry_id);
+
+/**
+ * @brief Return the next entry to evict (tail of the probationary segment, or
+ * of the protected one if the former is empty), or INVALID_ENTRY_ID.
+ */
+off_t cs_slru_victim(const cs_slru_state_t *slru);
+
+#define cs_slru_len(slru) \
+  ((slru)->len[CS_SLRU_PROBATION] + (slru)->len[CS_SLRU_PROTECTED])
+
+#endif /* HICNLIGHT_CS_SEGMENTS_H */
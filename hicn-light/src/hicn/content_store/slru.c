@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <hicn/util/log.h>
+
+#include <hicn/core/packet_cache.h>
+#include "segments.h"
+#include "slru.h"
+
+/******************************************************************************
+ * Segmented LRU (shared with W-TinyLFU)
+ ******************************************************************************/
+
+void cs_slru_state_init(cs_slru_state_t *slru) {
+  for (unsigned i = 0; i < CS_SLRU_N_SEGMENTS; i++) {
+    slru->segments[i].head = INVALID_ENTRY_ID;
+    slru->segments[i].tail = INVALID_ENTRY_ID;
+    slru->len[i] = 0;
+  }
+}
+
+void cs_slru_insert(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    off_t entry_id) {
+  cs_segment_push(pkt_cache, &slru->segments[CS_SLRU_PROBATION],
+                  CS_SLRU_PROBATION, entry_id);
+  slru->len[CS_SLRU_PROBATION]++;
+}
+
+void cs_slru_access(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    off_t entry_id, size_t protected_size,
+                    cs_slru_stats_t *stats) {
+  cs_entry_t *entry = cs_segment_entry_at(pkt_cache, entry_id);
+  uint8_t segment = entry->segment;
+  assert(segment < CS_SLRU_N_SEGMENTS);
+
+  cs_segment_remove(pkt_cache, &slru->segments[segment], entry_id);
+  slru->len[segment]--;
+  cs_segment_push(pkt_cache, &slru->segments[CS_SLRU_PROTECTED],
+                  CS_SLRU_PROTECTED, entry_id);
+  slru->len[CS_SLRU_PROTECTED]++;
+  if (segment == CS_SLRU_PROTECTED) return;
+  stats->countPromotions++;
+
+  // Make room in the protected segment
+  cs_slru_demote(pkt_cache, slru, protected_size, stats);
+}
+
+void cs_slru_demote(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    size_t protected_size, cs_slru_stats_t *stats) {
+  while (slru->len[CS_SLRU_PROTECTED] > protected_size) {
+    off_t tail_id = slru->segments[CS_SLRU_PROTECTED].tail;
+    cs_segment_remove(pkt_cache, &slru->segments[CS_SLRU_PROTECTED], tail_id);
+    slru->len[CS_SLRU_PROTECTED]--;
+    cs_segment_push(pkt_cache, &slru->segments[CS_SLRU_PROBATION],
+                    CS_SLRU_PROBATION, tail_id);
+    slru->len[CS_SLRU_PROBATION]++;
+    stats->countDemotions++;
+  }
+}
+
+void cs_slru_remove(pkt_cache_t *pkt_cache, cs_slru_state_t *slru,
+                    off_t entry_id) {
+  uint8_t segment = cs_segment_entry_at(pkt_cache, entry_id)->segment;
+  assert(segment < CS_SLRU_N_SEGMENTS);
+
+  cs_segment_remove(pkt_cache, &slru->segments[segment], entry_id);
+  slru->len[segment]--;
+}
+
+off_t cs_slru_victim(const cs_slru_state_t *slru) {
+  if (slru->segments[CS_SLRU_PROBATION].tail != INVALID_ENTRY_ID)
+    return slru->segments[CS_SLRU_PROBATION].tail;
+  return slru->segments[CS_SLRU_PROTECTED].tail;
+}
+
+/******************************************************************************
+ * Content store policy
+ ******************************************************************************/
+
+#define _protected_size(cs) ((cs)->max_size * CS_SLRU_PROTECTED_RATIO / 100)
+
+static int cs_slru_initialize(cs_t *cs) {
+  cs_slru_state_init(&cs->slru);
+  cs->stats.slru = (cs_slru_stats_t){0};
+  return 0;
+}
+
+static void cs_slru_finalize(cs_t *cs) {
+  // Nothing to do
+}
+
+static int cs_slru_resize(cs_t *cs) {
+  // The protected segment is brought back to its share as entries are added
+  return 0;
+}
+
+static int cs_slru_add_entry(pkt_cache_t *pkt_cache, off_t entry_id,
+                             off_t *evicted_id) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+
+  // The protected segment exceeds its share if the CS has been shrunk. Once
+  // brought back to it, the probationary segment holds at least one entry
+  // besides the one inserted at its head, which is thus never the victim
+  cs_slru_demote(pkt_cache, &cs->slru, _protected_size(cs), &cs->stats.slru);
+  cs_slru_insert(pkt_cache, &cs->slru, entry_id);
+  cs->stats.lru.countAdds++;
+
+  if (cs->num_entries <= cs->max_size) return LRU_SUCCESS;
+
+  *evicted_id = cs_slru_victim(&cs->slru);
+  assert(*evicted_id != entry_id);
+  cs_slru_remove(pkt_cache, &cs->slru, *evicted_id);
+  cs->stats.lru.countLruEvictions++;
+  return LRU_EVICTION;
+}
+
+static void cs_slru_hit_entry(pkt_cache_t *pkt_cache,
+                              pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs_slru_access(pkt_cache, &cs->slru, pkt_cache_get_entry_id(pkt_cache, entry),
+                 _protected_size(cs), &cs->stats.slru);
+}
+
+static void cs_slru_update_entry(pkt_cache_t *pkt_cache,
+                                 pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs->stats.lru.countUpdates++;
+  cs_slru_hit_entry(pkt_cache, entry);
+}
+
+static int cs_slru_remove_entry(pkt_cache_t *pkt_cache,
+                                pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs_slru_remove(pkt_cache, &cs->slru,
+                 pkt_cache_get_entry_id(pkt_cache, entry));
+  cs->stats.lru.countLruDeletions++;
+  return LRU_SUCCESS;
+}
+
+DECLARE_CS(slru);
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file slru.h
+ * @brief Segmented LRU content store policy
+ *
+ * Entries are first inserted in a probationary segment, and promoted to a
+ * protected segment when they are hit. Entries overflowing the protected
+ * segment are demoted back to the probationary one, from which evictions take
+ * place. Objects requested only once (e.g. bulk downloads) thus never push
+ * frequently requested ones out of the content store.
+ */
+
+#ifndef HICNLIGHT_CS_SLRU_H
+#define HICNLIGHT_CS_SLRU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lru.h"
+
+/* Share of the capacity reserved to the protected segment (percent) */
+#define CS_SLRU_PROTECTED_RATIO 80
+
+typedef enum {
+  CS_SLRU_PROBATION,
+  CS_SLRU_PROTECTED,
+  CS_SLRU_N_SEGMENTS,
+} cs_slru_segment_t;
+
+typedef struct {
+  cs_lru_state_t segments[CS_SLRU_N_SEGMENTS];
+  size_t len[CS_SLRU_N_SEGMENTS];
+} cs_slru_state_t;
+
+/**
+ * @brief Count the number of entries promoted to the protected segment, and
+ * demoted from it.
+ */
+typedef struct {
+  uint64_t countPromotions;
+  uint64_t countDemotions;
+} cs_slru_stats_t;
+
+#endif /* HICNLIGHT_CS_SLRU_H */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <hicn/util/log.h>
+
+#include <hicn/core/packet_cache.h>
+#include "segments.h"
+#include "tinylfu.h"
+
+#define _entry_hash(pkt_cache, entry_id) \
+  hicn_name_get_hash(&pkt_cache_entry_at((pkt_cache), (entry_id))->name)
+
+static size_t _window_size(const cs_t *cs) {
+  size_t size = cs->max_size * CS_TINYLFU_WINDOW_RATIO / 100;
+  return size > 0 ? size : 1;
+}
+
+static size_t _protected_size(const cs_t *cs) {
+  size_t window_size = _window_size(cs);
+  size_t main_size =
+      cs->max_size > window_size ? cs->max_size - window_size : 0;
+  return main_size * CS_SLRU_PROTECTED_RATIO / 100;
+}
+
+static int cs_tinylfu_initialize(cs_t *cs) {
+  cs_tinylfu_state_t *tinylfu = &cs->tinylfu;
+
+  tinylfu->window.head = INVALID_ENTRY_ID;
+  tinylfu->window.tail = INVALID_ENTRY_ID;
+  tinylfu->window_len = 0;
+  cs_slru_state_init(&tinylfu->main);
+  if (cm_sketch_init(&tinylfu->sketch, cs->max_size) < 0) return -1;
+
+  cs->stats.tinylfu = (cs_tinylfu_stats_t){0};
+  return 0;
+}
+
+static void cs_tinylfu_finalize(cs_t *cs) {
+  cm_sketch_finalize(&cs->tinylfu.sketch);
+}
+
+static int cs_tinylfu_resize(cs_t *cs) {
+  // The sketch is sized after the capacity. Window and segment sizes are
+  // derived from it, and adjusted as entries are added
+  return cm_sketch_resize(&cs->tinylfu.sketch, cs->max_size);
+}
+
+static int cs_tinylfu_add_entry(pkt_cache_t *pkt_cache, off_t entry_id,
+                                off_t *evicted_id) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs_tinylfu_state_t *tinylfu = &cs->tinylfu;
+
+  cs->stats.lru.countAdds++;
+  cm_sketch_increment(&tinylfu->sketch, _entry_hash(pkt_cache, entry_id));
+
+  cs_segment_push(pkt_cache, &tinylfu->window, CS_TINYLFU_WINDOW, entry_id);
+  tinylfu->window_len++;
+
+  // The window holds at least one entry, so the candidate leaving it is never
+  // the one just inserted
+  off_t candidate_id = INVALID_ENTRY_ID;
+  if (tinylfu->window_len > _window_size(cs)) {
+    candidate_id = tinylfu->window.tail;
+    cs_segment_remove(pkt_cache, &tinylfu->window, candidate_id);
+    tinylfu->window_len--;
+  }
+
+  if (cs->num_entries <= cs->max_size) {
+    if (candidate_id != INVALID_ENTRY_ID)
+      cs_slru_insert(pkt_cache, &tinylfu->main, candidate_id);
+    return LRU_SUCCESS;
+  }
+
+  cs->stats.lru.countLruEvictions++;
+  // Victims are taken from the probationary segment even if the CS has been
+  // shrunk below the size of the protected one
+  cs_slru_demote(pkt_cache, &tinylfu->main, _protected_size(cs),
+                 &cs->stats.tinylfu.main);
+  off_t victim_id = cs_slru_victim(&tinylfu->main);
+
+  if (candidate_id == INVALID_ENTRY_ID) {
+    // Only possible if the capacity has been reduced
+    if (victim_id != INVALID_ENTRY_ID) {
+      cs_slru_remove(pkt_cache, &tinylfu->main, victim_id);
+    } else {
+      victim_id = tinylfu->window.tail;
+      cs_segment_remove(pkt_cache, &tinylfu->window, victim_id);
+      tinylfu->window_len--;
+    }
+    *evicted_id = victim_id;
+    return LRU_EVICTION;
+  }
+
+  // Admission: the candidate replaces the victim only if it is more popular
+  if (victim_id != INVALID_ENTRY_ID &&
+      cm_sketch_estimate(&tinylfu->sketch,
+                         _entry_hash(pkt_cache, candidate_id)) >
+          cm_sketch_estimate(&tinylfu->sketch,
+                             _entry_hash(pkt_cache, victim_id))) {
+    cs_slru_remove(pkt_cache, &tinylfu->main, victim_id);
+    cs_slru_insert(pkt_cache, &tinylfu->main, candidate_id);
+    cs->stats.tinylfu.countAdmissions++;
+    *evicted_id = victim_id;
+  } else {
+    cs->stats.tinylfu.countRejections++;
+    *evicted_id = candidate_id;
+  }
+  return LRU_EVICTION;
+}
+
+static void cs_tinylfu_hit_entry(pkt_cache_t *pkt_cache,
+                                 pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs_tinylfu_state_t *tinylfu = &cs->tinylfu;
+  off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
+
+  cm_sketch_increment(&tinylfu->sketch, hicn_name_get_hash(&entry->name));
+
+  if (entry->u.cs_entry.segment == CS_TINYLFU_WINDOW) {
+    cs_segment_remove(pkt_cache, &tinylfu->window, entry_id);
+    cs_segment_push(pkt_cache, &tinylfu->window, CS_TINYLFU_WINDOW, entry_id);
+    return;
+  }
+
+  cs_slru_access(pkt_cache, &tinylfu->main, entry_id, _protected_size(cs),
+                 &cs->stats.tinylfu.main);
+}
+
+static void cs_tinylfu_update_entry(pkt_cache_t *pkt_cache,
+                                    pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs->stats.lru.countUpdates++;
+  cs_tinylfu_hit_entry(pkt_cache, entry);
+}
+
+static int cs_tinylfu_remove_entry(pkt_cache_t *pkt_cache,
+                                   pkt_cache_entry_t *entry) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  cs_tinylfu_state_t *tinylfu = &cs->tinylfu;
+  off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
+
+  if (entry->u.cs_entry.segment == CS_TINYLFU_WINDOW) {
+    cs_segment_remove(pkt_cache, &tinylfu->window, entry_id);
+    tinylfu->window_len--;
+  } else {
+    cs_slru_remove(pkt_cache, &tinylfu->main, entry_id);
+  }
+  cs->stats.lru.countLruDeletions++;
+  return LRU_SUCCESS;
+}
+
+DECLARE_CS(tinylfu);
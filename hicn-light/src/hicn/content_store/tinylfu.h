@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file tinylfu.h
+ * @brief Window TinyLFU content store policy
+ *
+ * New entries are inserted in a small LRU window. Entries leaving the window
+ * are admitted in the main segmented LRU only if they have been requested more
+ * frequently than the entry they would replace, as estimated by a count-min
+ * sketch of the recent requests.
+ *
+ * Reference: G. Einziger, R. Friedman, B. Manes, "TinyLFU: A Highly Efficient
+ * Cache Admission Policy", ACM Transactions on Storage, 2017.
+ */
+
+#ifndef HICNLIGHT_CS_TINYLFU_H
+#define HICNLIGHT_CS_TINYLFU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cm_sketch.h"
+#include "lru.h"
+#include "slru.h"
+
+/* Share of the capacity reserved to the window (percent, at least 1 entry) */
+#define CS_TINYLFU_WINDOW_RATIO 1
+
+/* Segment of the entries in the window, after those of the main SLRU */
+#define CS_TINYLFU_WINDOW CS_SLRU_N_SEGMENTS
+
+typedef struct {
+  cs_lru_state_t window;
+  size_t window_len;
+  cs_slru_state_t main;
+  cm_sketch_t sketch;
+} cs_tinylfu_state_t;
+
+/**
+ * @brief Count the number of entries admitted to the main segment and rejected
+ * by the admission policy, in addition to the promotions and demotions within
+ * the main segment.
+ */
+typedef struct {
+  uint64_t countAdmissions;
+  uint64_t countRejections;
+  cs_slru_stats_t main;
+} cs_tinylfu_stats_t;
+
+#endif /* HICNLIGHT_CS_TINYLFU_H */
@@ -48,7 +48,14 @@ connection_t *connection_create(face_type_t type, const char *name,
       break;
     case FACE_TYPE_HICN:
       return NULL; /* Not implemented */
+    case FACE_TYPE_SHM:
+      return NULL; /* Created upon accept by the listener */
+    case FACE_TYPE_XDP:
+      listener_type = FACE_TYPE_XDP_LISTENER;
+      break;
     case FACE_TYPE_HICN_LISTENER:
+    case FACE_TYPE_SHM_LISTENER:
+    case FACE_TYPE_XDP_LISTENER:
     case FACE_TYPE_UDP_LISTENER:
     case FACE_TYPE_TCP_LISTENER:
     case FACE_TYPE_UNDEFINED:
@@ -156,6 +163,8 @@ int connection_initialize(connection_t *connection, face_type_t type,
 
       .listener = listener,
       .closed = false,
+      .n_queued = 0,
+      .queue_ts = 0,
 
       /* WLDR */
       .wldr = NULL,
@@ -187,6 +196,8 @@ int connection_initialize(connection_t *connection, face_type_t type,
   }
 #endif
 
+  if (!connection_vft[get_protocol(connection->type)]) goto ERR_DATA;
+
   connection->data =
       malloc(connection_vft[get_protocol(connection->type)]->data_size);
   if (!connection->data) goto ERR_DATA;
@@ -239,12 +250,10 @@ int connection_finalize(connection_t *connection) {
   assert(connection);
   assert(connection_has_valid_type(connection));
 
+  /* Unconnected connections share the socket of their listener */
   if (connection->connected) {
     loop_event_unregister(connection->event_data);
     loop_event_free(connection->event_data);
-  }
-
-  if (connection->fd != 0) {  // Only if connected socket
 #ifndef _WIN32
     close(connection->fd);
 #else
@@ -282,6 +291,7 @@ bool _connection_send(connection_t *connection, msgbuf_t *msgbuf, bool queue) {
 }
 
 bool connection_flush(connection_t *connection) {
+  connection->n_queued = 0;
   return connection_vft[get_protocol(connection->type)]->flush(connection);
 }
 
@@ -304,7 +314,10 @@ bool connection_send(connection_t *connection, off_t msgbuf_id, bool queue) {
     msgbuf_reset_wldr_label(msgbuf);
 #endif
 
-  return _connection_send(connection, msgbuf, queue);
+  if (!_connection_send(connection, msgbuf, queue)) return false;
+
+  if (queue && connection->n_queued++ == 0) connection->queue_ts = ticks_now();
+  return true;
 }
 
 /*
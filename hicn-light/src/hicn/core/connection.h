@@ -26,6 +26,7 @@
 #include "address_pair.h"
 #include "listener.h"
 #include "msgbuf.h"
+#include "ticks.h"
 
 #ifdef WITH_POLICY
 #include <hicn/policy.h>
@@ -78,6 +79,10 @@ typedef struct {
   // struct forwarder_s * forwarder; // recv only
   bool closed;
 
+  /* Packets queued since the last flush, and time at which the first was */
+  unsigned n_queued;
+  Ticks queue_ts;
+
   /* WLDR */
 
   bool wldr_autostart;
@@ -216,10 +221,26 @@ int connection_finalize(connection_t* connection);
 bool connection_send_packet(const connection_t* connection,
                             const uint8_t* packet, size_t size);
 
+/**
+ * @brief Transmit the packets queued on the connection.
+ */
 bool connection_flush(connection_t* connection);
 
+/**
+ * @brief Send a packet, or queue it until the next call to connection_flush()
+ * if queue is true.
+ */
 bool connection_send(connection_t* connection, off_t msgbuf_id, bool queue);
 
+static inline unsigned connection_get_num_queued(
+    const connection_t* connection) {
+  return connection->n_queued;
+}
+
+static inline Ticks connection_get_queue_ts(const connection_t* connection) {
+  return connection->queue_ts;
+}
+
 size_t connection_process_buffer(connection_t* connection,
                                  const uint8_t* buffer, size_t size);
 
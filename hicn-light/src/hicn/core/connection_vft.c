@@ -22,14 +22,22 @@
 
 #ifdef __linux
 extern connection_ops_t connection_hicn;
+extern connection_ops_t connection_shm;
+#endif
+#if defined(__linux__) && defined(WITH_AF_XDP)
+extern connection_ops_t connection_xdp;
 #endif
 
 extern connection_ops_t connection_tcp;
 extern connection_ops_t connection_udp;
 
-const connection_ops_t *connection_vft[] = {
+const connection_ops_t *connection_vft[FACE_PROTOCOL_UNKNOWN] = {
 #ifdef __linux
     [FACE_PROTOCOL_HICN] = &connection_hicn,
+    [FACE_PROTOCOL_SHM] = &connection_shm,
+#endif
+#if defined(__linux__) && defined(WITH_AF_XDP)
+    [FACE_PROTOCOL_XDP] = &connection_xdp,
 #endif
 
     [FACE_PROTOCOL_TCP] = &connection_tcp,
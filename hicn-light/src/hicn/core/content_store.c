@@ -18,15 +18,39 @@
  * \brief Implementation of hICN content_store
  */
 
+#include <strings.h>
+
 #include "content_store.h"
 #include "packet_cache.h"
 
 extern const cs_ops_t cs_lru;
+extern const cs_ops_t cs_slru;
+extern const cs_ops_t cs_arc;
+extern const cs_ops_t cs_tinylfu;
 
 const cs_ops_t *const cs_vft[] = {
     [CS_TYPE_LRU] = &cs_lru,
+    [CS_TYPE_SLRU] = &cs_slru,
+    [CS_TYPE_ARC] = &cs_arc,
+    [CS_TYPE_TINYLFU] = &cs_tinylfu,
+};
+
+const char *cs_type_str[] = {
+#define _(x) [CS_TYPE_##x] = #x,
+    foreach_cs_type
+#undef _
 };
 
+cs_type_t cs_type_from_str(const char *str) {
+#define _(x)                    \
+  if (strcasecmp(str, #x) == 0) \
+    return CS_TYPE_##x;         \
+  else
+  foreach_cs_type
+#undef _
+      return CS_TYPE_UNDEFINED;
+}
+
 cs_t *_cs_create(cs_type_t type, size_t max_size) {
   if (!CS_TYPE_VALID(type)) {
     ERROR("[cs_create] Invalid content store type");
@@ -41,10 +65,14 @@ cs_t *_cs_create(cs_type_t type, size_t max_size) {
   cs->type = type;
   cs->num_entries = 0;
   cs->max_size = max_size;
-  cs_vft[type]->initialize(cs);
   cs->stats.lru = (cs_lru_stats_t){0};
+  if (cs_vft[type]->initialize(cs) < 0) goto ERR_INITIALIZE;
 
   return cs;
+
+ERR_INITIALIZE:
+  free(cs);
+  return NULL;
 }
 
 void cs_free(cs_t *cs) {
@@ -77,12 +105,32 @@ void cs_miss(cs_t *cs) {
 
 void cs_log(cs_t *cs) {
   DEBUG(
-      "Content store: size = %u, capacity = %u, hits = %u, misses = %u, adds = "
-      "%u, updates = %u, deletions = %u (with evictions = %u)",
-      cs->num_entries, cs->max_size, cs->stats.lru.countHits,
-      cs->stats.lru.countMisses, cs->stats.lru.countAdds,
-      cs->stats.lru.countUpdates, cs->stats.lru.countLruDeletions,
-      cs->stats.lru.countLruEvictions);
+      "Content store (%s): size = %u, capacity = %u, hits = %u, misses = %u, "
+      "adds = %u, updates = %u, deletions = %u (with evictions = %u)",
+      cs_type_str(cs->type), cs->num_entries, cs->max_size,
+      cs->stats.lru.countHits, cs->stats.lru.countMisses,
+      cs->stats.lru.countAdds, cs->stats.lru.countUpdates,
+      cs->stats.lru.countLruDeletions, cs->stats.lru.countLruEvictions);
+
+  switch (cs->type) {
+    case CS_TYPE_SLRU:
+      DEBUG("SLRU: promotions = %u, demotions = %u",
+            cs->stats.slru.countPromotions, cs->stats.slru.countDemotions);
+      break;
+    case CS_TYPE_ARC:
+      DEBUG("ARC: ghost hits = %u (recency) / %u (frequency), target = %u",
+            cs->stats.arc.countGhostHitsRecency,
+            cs->stats.arc.countGhostHitsFrequency, cs->arc.p);
+      break;
+    case CS_TYPE_TINYLFU:
+      DEBUG("TinyLFU: admissions = %u, rejections = %u, promotions = %u",
+            cs->stats.tinylfu.countAdmissions,
+            cs->stats.tinylfu.countRejections,
+            cs->stats.tinylfu.main.countPromotions);
+      break;
+    default:
+      break;
+  }
 }
 
 cs_lru_stats_t cs_get_lru_stats(cs_t *cs) { return cs->stats.lru; }
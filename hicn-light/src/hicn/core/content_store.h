@@ -3,6 +3,9 @@
 
 #include <hicn/util/pool.h>
 #include "../content_store/lru.h"
+#include "../content_store/slru.h"
+#include "../content_store/arc.h"
+#include "../content_store/tinylfu.h"
 #include "msgbuf_pool.h"
 
 #define INVALID_ENTRY_ID ~0ul /* off_t */
@@ -14,18 +17,36 @@ typedef struct {
     off_t prev;
     off_t next;
   } lru;
+  /* List holding the entry, for policies managing several of them */
+  uint8_t segment;
 } cs_entry_t;
 
 #define cs_entry_get_msgbuf_id(entry) ((entry)->msgbuf_id)
 
+#define foreach_cs_type \
+  _(LRU)                \
+  _(SLRU)               \
+  _(ARC)                \
+  _(TINYLFU)
+
 typedef enum {
   CS_TYPE_UNDEFINED,
-  CS_TYPE_LRU,
-  CS_TYPE_N,
+#define _(x) CS_TYPE_##x,
+  foreach_cs_type
+#undef _
+      CS_TYPE_N,
 } cs_type_t;
 
 #define CS_TYPE_VALID(type) (type != CS_TYPE_UNDEFINED) && (type != CS_TYPE_N)
 
+#define DEFAULT_CS_TYPE CS_TYPE_LRU
+
+extern const char *cs_type_str[];
+
+#define cs_type_str(x) cs_type_str[x]
+
+cs_type_t cs_type_from_str(const char *cs_type_str);
+
 typedef struct {
   /* The maximum allowed expiry time (will never be exceeded). */
   uint64_t max_expiry_time;  // XXX part of lru ?
@@ -37,7 +58,18 @@ typedef struct {
   size_t max_size;
   cs_lru_state_t lru;
   union {
+    cs_slru_state_t slru;
+    cs_arc_state_t arc;
+    cs_tinylfu_state_t tinylfu;
+  };
+  struct {
+    /* Counters common to all policies */
     cs_lru_stats_t lru;
+    union {
+      cs_slru_stats_t slru;
+      cs_arc_stats_t arc;
+      cs_tinylfu_stats_t tinylfu;
+    };
   } stats;
 } cs_t;
 
@@ -58,7 +90,7 @@ cs_t *_cs_create(cs_type_t type, size_t max_size);
  *
  * @return cs_t* - The newly created content store
  */
-#define cs_create(size) _cs_create(CS_TYPE_LRU, (size))
+#define cs_create(size) _cs_create(DEFAULT_CS_TYPE, (size))
 
 /**
  * @brief Free a content store data structure.
@@ -15,8 +15,10 @@
 
 #include <hicn/hicn-light/config.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <hicn/core/fib.h>
+#include <hicn/core/fib_mtrie.h>
 
 typedef struct fib_node_s {
   struct fib_node_s *child[2]; /* 0: left, 1: right */
@@ -53,26 +55,65 @@ static void fib_node_free(fib_node_t *node) {
 
 /******************************************************************************/
 
+/*
+ * Direct-mapped cache of lookup results per name prefix, since consecutive
+ * packets mostly share a few prefixes. The cache is flushed by increasing the
+ * generation upon any change in the FIB, slots of older generations being
+ * invalid.
+ */
+#define FIB_CACHE_SIZE 256
+
+typedef struct {
+  hicn_name_prefix_t prefix;
+  fib_entry_t *entry; /* NULL if no prefix matches */
+  uint32_t generation;
+} fib_cache_slot_t;
+
 struct fib_s {
   void *forwarder;
   fib_node_t *root;
   unsigned size;
+
+  /* Index of the used entries, NULL unless FIB_TYPE_MTRIE */
+  fib_mtrie_t *mtrie;
+
+  fib_cache_slot_t cache[FIB_CACHE_SIZE];
+  uint32_t generation;
+  fib_cache_stats_t cache_stats;
 };
 
-fib_t *fib_create(void *forwarder) {
+fib_t *_fib_create(fib_type_t type, void *forwarder) {
+  assert(FIB_TYPE_VALID(type));
+
   fib_t *fib = malloc(sizeof(fib_t));
-  if (!fib) return NULL;
+  if (!fib) goto ERR_MALLOC;
 
   fib->forwarder = forwarder;
   fib->root = NULL;
   fib->size = 0;
 
+  memset(fib->cache, 0, sizeof(fib->cache));
+  fib->generation = 1;
+  fib->cache_stats = (fib_cache_stats_t){0};
+
+  fib->mtrie = NULL;
+  if (type == FIB_TYPE_MTRIE) {
+    fib->mtrie = fib_mtrie_create();
+    if (!fib->mtrie) goto ERR_MTRIE;
+  }
+
   return fib;
+
+ERR_MTRIE:
+  free(fib);
+ERR_MALLOC:
+  return NULL;
 }
 
 void fib_free(fib_t *fib) {
   assert(fib);
 
+  fib_mtrie_free(fib->mtrie);
   fib_node_free(fib->root);
 
   free(fib);
@@ -83,6 +124,19 @@ size_t fib_get_size(const fib_t *fib) {
   return fib->size;
 }
 
+fib_cache_stats_t fib_get_cache_stats(const fib_t *fib) {
+  assert(fib);
+  return fib->cache_stats;
+}
+
+static void _fib_cache_flush(fib_t *fib) {
+  if (++fib->generation != 0) return;
+
+  /* Slots of the previous cycle would become valid again */
+  memset(fib->cache, 0, sizeof(fib->cache));
+  fib->generation = 1;
+}
+
 /*
  * This struct will hold various information related to the returned node such
  * as its parent and grandparent if any, as well as some already computed
@@ -92,6 +146,8 @@ typedef struct {
   /* Result node ancestors (NULL if not applicable) */
   fib_node_t *parent;
   fib_node_t *gparent;
+  /* Deepest used ancestor (NULL if not applicable) */
+  fib_node_t *used_ancestor;
   /* Information related to the result node */
   hicn_prefix_t *prefix;
   uint32_t prefix_len;
@@ -134,6 +190,7 @@ fib_node_t *fib_search(const fib_t *fib, const hicn_prefix_t *prefix,
 
   fib_node_t *parent = NULL;
   fib_node_t *gparent = NULL;
+  fib_node_t *used_ancestor = NULL;
   fib_node_t *curr = fib->root;
   while (curr) {
     const hicn_prefix_t *curr_prefix = fib_entry_get_prefix(curr->entry);
@@ -149,6 +206,7 @@ fib_node_t *fib_search(const fib_t *fib, const hicn_prefix_t *prefix,
 
     gparent = parent;
     parent = curr;
+    if (curr->is_used) used_ancestor = curr;
 
     /* The following lookup won't fail since curr_len < prefix_len */
     uint8_t next_bit = hicn_prefix_get_bit(prefix, curr_len);
@@ -158,6 +216,7 @@ fib_node_t *fib_search(const fib_t *fib, const hicn_prefix_t *prefix,
   if (search) {
     search->parent = parent;
     search->gparent = gparent;
+    search->used_ancestor = used_ancestor;
     if (curr) {
       search->prefix_len = curr_len;
       search->match_len = match_len;
@@ -166,6 +225,26 @@ fib_node_t *fib_search(const fib_t *fib, const hicn_prefix_t *prefix,
   return curr;
 }
 
+/*
+ * Helpers: keep the multibit trie index, if any, in sync with the used nodes.
+ *
+ * Should the index fail to allocate memory, it is dropped and lookups fall
+ * back to the binary trie.
+ */
+static void _fib_index_add(fib_t *fib, fib_entry_t *entry) {
+  if (!fib->mtrie) return;
+  if (fib_mtrie_add(fib->mtrie, fib_entry_get_prefix(entry), entry) < 0) {
+    ERROR("[fib] Could not update the multibit trie, disabling it");
+    fib_mtrie_free(fib->mtrie);
+    fib->mtrie = NULL;
+  }
+}
+
+static void _fib_index_remove(fib_t *fib, fib_entry_t *entry) {
+  if (!fib->mtrie) return;
+  fib_mtrie_remove(fib->mtrie, fib_entry_get_prefix(entry));
+}
+
 /*
  * Helper: insert a new node between parent and child.
  *
@@ -193,7 +272,10 @@ fib_node_t *_fib_insert(fib_t *fib, fib_entry_t *entry, fib_node_t *parent,
     new_node->child[next_bit] = child;
   }
 
-  if (is_used) fib->size++;
+  if (is_used) {
+    fib->size++;
+    _fib_index_add(fib, entry);
+  }
   return new_node;
 }
 
@@ -214,7 +296,12 @@ void _fib_remove(fib_t *fib, fib_node_t *curr, fib_node_t *parent) {
     else
       parent->child[ONE] = child;
   }
-  if (curr->is_used) fib->size--;
+  if (curr->is_used) {
+    fib->size--;
+    _fib_index_remove(fib, curr->entry);
+  }
+  /* The child, if any, has been reattached and must not be released */
+  curr->child[ZERO] = curr->child[ONE] = NULL;
   fib_node_free(curr);
 }
 
@@ -328,6 +415,7 @@ void fib_add(fib_t *fib, fib_entry_t *entry) {
       if (curr->entry) fib_entry_free(curr->entry);
       curr->entry = entry;
       fib->size++;
+      _fib_index_add(fib, entry);
     } else {
       const nexthops_t *nexthops = fib_entry_get_nexthops(entry);
       nexthops_foreach(nexthops, nexthop,
@@ -357,10 +445,10 @@ void fib_add(fib_t *fib, fib_entry_t *entry) {
   _fib_insert(fib, entry, new_node, NULL, true);
 
 END:
+  _fib_cache_flush(fib);
 #if 0
   fib_dump(fib);
 #endif
-    ; /* required by clang */
 }
 
 /*
@@ -439,7 +527,7 @@ fib_entry_t *fib_contains(const fib_t *fib, const hicn_prefix_t *prefix) {
  * b) parent is unused.
  *
  * Assuming curr is the left child, then parent must have a
- * right child, and the grand-parent must be used.
+ * right child, which replaces it.
  *
  *               gp                    gp                        gp
  *             /                     /                         /
@@ -475,6 +563,8 @@ static void fib_node_remove(fib_t *fib, const hicn_prefix_t *prefix) {
    */
   if (!curr || !curr->is_used || (search.prefix_len != prefix_len)) return;
 
+  _fib_cache_flush(fib);
+
   uint8_t N = 0;
   if (curr->child[ZERO]) N++;
   if (curr->child[ONE]) N++;
@@ -482,6 +572,8 @@ static void fib_node_remove(fib_t *fib, const hicn_prefix_t *prefix) {
   switch (N) {
     case 2:
       curr->is_used = false;
+      fib->size--;
+      _fib_index_remove(fib, curr->entry);
       break;
 
     case 1:
@@ -556,7 +648,7 @@ void fib_remove_connection(fib_t *fib, unsigned conn_id,
   free(array);
 }
 
-fib_entry_t *fib_match_msgbuf(const fib_t *fib, const msgbuf_t *msgbuf) {
+fib_entry_t *fib_match_msgbuf(fib_t *fib, const msgbuf_t *msgbuf) {
   assert(fib);
   assert(msgbuf);
 
@@ -571,31 +663,50 @@ fib_entry_t *fib_match_msgbuf(const fib_t *fib, const msgbuf_t *msgbuf) {
  * - if we have an exact match (curr_len == key_prefix_len), then we
  *   return curr unless is_used is false, in which case we return the parent.
  * - otherwise, the parent is the longest prefix match
+ *
+ * The parent might be an inner node, in which case the match is its deepest
+ * used ancestor.
  */
 fib_entry_t *fib_match_prefix(const fib_t *fib, const hicn_prefix_t *prefix) {
   assert(fib);
   assert(prefix);
 
+  if (fib->mtrie) return fib_mtrie_match(fib->mtrie, prefix);
+
   fib_search_t search;
   fib_node_t *curr = fib_search(fib, prefix, &search);
 
-  if (!curr) {
-    /* This can happen with an empty FIB for instance */
-    if (!search.parent) return NULL;
-    return search.parent->entry;
-  }
-  if ((search.prefix_len == search.match_len) && curr->is_used)
+  if (curr && (search.prefix_len == search.match_len) && curr->is_used)
     return curr->entry;
-  if (search.parent) return search.parent->entry;
-  return NULL;
+
+  /* This can happen with an empty FIB for instance */
+  if (!search.used_ancestor) return NULL;
+  return search.used_ancestor->entry;
 }
 
-fib_entry_t *fib_match_name(const fib_t *fib, const hicn_name_t *name) {
-  hicn_prefix_t prefix;
+fib_entry_t *fib_match_name(fib_t *fib, const hicn_name_t *name) {
   const hicn_name_prefix_t *name_prefix = hicn_name_get_prefix(name);
+
+  fib_cache_slot_t *slot =
+      &fib->cache[hicn_name_prefix_get_hash(name_prefix) % FIB_CACHE_SIZE];
+  if (slot->generation == fib->generation &&
+      hicn_name_prefix_equals(&slot->prefix, name_prefix)) {
+    fib->cache_stats.n_hits++;
+    return slot->entry;
+  }
+  fib->cache_stats.n_misses++;
+
+  hicn_prefix_t prefix;
   prefix.name = *name_prefix;
   prefix.len = hicn_name_prefix_get_len_bits(name_prefix);
-  return fib_match_prefix(fib, &prefix);
+  fib_entry_t *entry = fib_match_prefix(fib, &prefix);
+
+  *slot = (fib_cache_slot_t){
+      .prefix = *name_prefix,
+      .entry = entry,
+      .generation = fib->generation,
+  };
+  return entry;
 }
 
 static size_t fib_node_collect_entries(fib_node_t *node, fib_entry_t **array,
@@ -622,6 +733,9 @@ size_t fib_get_entry_array(const fib_t *fib, fib_entry_t ***array_p) {
 bool _fib_is_valid(const fib_node_t *node) {
   if (!node) return true;
 
+  /* Inner nodes exist only to join two branches */
+  if (!node->is_used && !(node->child[ZERO] && node->child[ONE])) return false;
+
   const hicn_prefix_t *prefix = fib_entry_get_prefix(node->entry);
   uint32_t prefix_len = hicn_prefix_get_len(prefix);
 
@@ -632,7 +746,6 @@ bool _fib_is_valid(const fib_node_t *node) {
 
     uint32_t match_len = hicn_prefix_lpm(prefix, child_prefix);
     if (match_len != prefix_len) return false;
-    if (!node->is_used && !child->is_used) return false;
     if (hicn_prefix_get_bit(child_prefix, match_len) != i) return false;
     if (!_fib_is_valid(child)) return false;
   }
@@ -641,8 +754,8 @@ bool _fib_is_valid(const fib_node_t *node) {
 
 /*
  * @brief Check that the structure of the FIB is correct : prefixes are
- * correctly nested, 0 are on the left, 1 on the right, and that we have no
- * more than 1 unused prefix as parents.
+ * correctly nested, 0 are on the left, 1 on the right, and that unused
+ * prefixes are inner nodes with two children.
  */
 bool fib_is_valid(const fib_t *fib) { return _fib_is_valid(fib->root); }
 
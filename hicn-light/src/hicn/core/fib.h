@@ -24,12 +24,47 @@
 
 typedef struct fib_s fib_t;
 
-fib_t *fib_create(void *forwarder);
+/*
+ * The binary trie always holds the FIB entries. With FIB_TYPE_MTRIE, longest
+ * prefix matches are served by a path-compressed multibit trie (see
+ * fib_mtrie.h) maintained alongside it. The default type can be changed at
+ * build time with WITH_MTRIE_FIB.
+ */
+typedef enum {
+  FIB_TYPE_UNDEFINED,
+  FIB_TYPE_TRIE,  /* Binary trie */
+  FIB_TYPE_MTRIE, /* Multibit trie index for lookups */
+  FIB_TYPE_N,
+} fib_type_t;
+
+#define FIB_TYPE_VALID(type) \
+  (type != FIB_TYPE_UNDEFINED) && (type != FIB_TYPE_N)
+
+#ifdef WITH_MTRIE_FIB
+#define DEFAULT_FIB_TYPE FIB_TYPE_MTRIE
+#else
+#define DEFAULT_FIB_TYPE FIB_TYPE_TRIE
+#endif
+
+fib_t *_fib_create(fib_type_t type, void *forwarder);
+
+#define fib_create(forwarder) _fib_create(DEFAULT_FIB_TYPE, (forwarder))
 
 void fib_free(fib_t *fib);
 
 size_t fib_get_size(const fib_t *fib);
 
+typedef struct {
+  size_t n_hits;
+  size_t n_misses;
+} fib_cache_stats_t;
+
+/**
+ * @brief Return the statistics of the lookup cache of fib_match_name and
+ * fib_match_msgbuf.
+ */
+fib_cache_stats_t fib_get_cache_stats(const fib_t *fib);
+
 void fib_add(fib_t *fib, fib_entry_t *node);
 
 fib_entry_t *fib_contains(const fib_t *fib, const hicn_prefix_t *prefix);
@@ -48,11 +83,11 @@ void fib_remove_connection(fib_t *fib, unsigned conn_id,
                            fib_entry_t ***removed_entries,
                            size_t *num_removed_entries);
 
-fib_entry_t *fib_match_msgbuf(const fib_t *fib, const msgbuf_t *msgbuf);
+fib_entry_t *fib_match_msgbuf(fib_t *fib, const msgbuf_t *msgbuf);
 
 fib_entry_t *fib_match_prefix(const fib_t *fib, const hicn_prefix_t *prefix);
 
-fib_entry_t *fib_match_name(const fib_t *fib, const hicn_name_t *name);
+fib_entry_t *fib_match_name(fib_t *fib, const hicn_name_t *name);
 
 size_t fib_get_entry_array(const fib_t *fib, fib_entry_t ***array_p);
 
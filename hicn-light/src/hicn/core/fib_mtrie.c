@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file fib_mtrie.c
+ * \brief Implementation of the path-compressed multibit trie
+ *
+ * The root node has depth 0 and always exists. Any other node holds at least
+ * one prefix or two children, and is otherwise removed or spliced out so that
+ * its only child is attached to its parent directly.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fib_mtrie.h"
+
+#define FIB_MTRIE_STRIDE 8
+#define FIB_MTRIE_MAX_DEPTH 16 /* Bytes in an address */
+#define FIB_MTRIE_BITMAP_WORDS 4
+
+typedef struct fib_mtrie_node_s {
+  /* Bytes leading to the node, masked to its depth */
+  uint64_t key[2];
+  uint64_t mask[2];
+
+  uint64_t prefix_bitmap[FIB_MTRIE_BITMAP_WORDS];
+  uint64_t child_bitmap[FIB_MTRIE_BITMAP_WORDS];
+  fib_entry_t **entries;
+  struct fib_mtrie_node_s **children;
+
+  uint8_t depth; /* In bytes */
+} fib_mtrie_node_t;
+
+struct fib_mtrie_s {
+  fib_mtrie_node_t *root;
+  size_t n_prefixes;
+  size_t n_nodes;
+};
+
+/* Bitmap helpers */
+
+static inline bool _bitmap_test(const uint64_t *bitmap, unsigned pos) {
+  return (bitmap[pos / 64] >> (pos % 64)) & 1;
+}
+
+static inline void _bitmap_set(uint64_t *bitmap, unsigned pos) {
+  bitmap[pos / 64] |= 1ull << (pos % 64);
+}
+
+static inline void _bitmap_clear(uint64_t *bitmap, unsigned pos) {
+  bitmap[pos / 64] &= ~(1ull << (pos % 64));
+}
+
+/* Number of bits set strictly below pos */
+static inline unsigned _bitmap_rank(const uint64_t *bitmap, unsigned pos) {
+  unsigned rank = 0;
+  for (unsigned i = 0; i < pos / 64; i++)
+    rank += __builtin_popcountll(bitmap[i]);
+  return rank +
+         __builtin_popcountll(bitmap[pos / 64] & ((1ull << (pos % 64)) - 1));
+}
+
+static inline unsigned _bitmap_count(const uint64_t *bitmap) {
+  unsigned count = 0;
+  for (unsigned i = 0; i < FIB_MTRIE_BITMAP_WORDS; i++)
+    count += __builtin_popcountll(bitmap[i]);
+  return count;
+}
+
+/*
+ * Position of a prefix of length len in the bitmap of the node of depth
+ * len / 8, given the value of the byte at that depth: prefixes are ordered by
+ * length, then by value of their len % 8 remaining bits.
+ */
+static inline unsigned _prefix_pos(unsigned len, uint8_t byte) {
+  unsigned l = len % FIB_MTRIE_STRIDE;
+  return (1u << l) - 1 + (byte >> (FIB_MTRIE_STRIDE - l));
+}
+
+static inline const uint8_t *_prefix_bytes(const hicn_prefix_t *prefix) {
+  return prefix->name.v6.as_u8;
+}
+
+static inline bool _node_matches(const fib_mtrie_node_t *node,
+                                 const hicn_prefix_t *prefix) {
+  uint64_t words[2];
+  memcpy(words, prefix->name.v6.as_u64, sizeof(words));
+  return (((words[0] & node->mask[0]) ^ node->key[0]) |
+          ((words[1] & node->mask[1]) ^ node->key[1])) == 0;
+}
+
+/* Node helpers */
+
+static fib_mtrie_node_t *_node_create(fib_mtrie_t *mtrie, uint8_t depth,
+                                      const hicn_prefix_t *path) {
+  fib_mtrie_node_t *node = calloc(1, sizeof(fib_mtrie_node_t));
+  if (!node) return NULL;
+
+  uint8_t mask[FIB_MTRIE_MAX_DEPTH] = {0};
+  memset(mask, 0xff, depth);
+  memcpy(node->mask, mask, sizeof(mask));
+  for (unsigned i = 0; i < 2; i++)
+    node->key[i] = path->name.v6.as_u64[i] & node->mask[i];
+  node->depth = depth;
+
+  mtrie->n_nodes++;
+  return node;
+}
+
+static void _node_free(fib_mtrie_t *mtrie, fib_mtrie_node_t *node) {
+  unsigned n_children = _bitmap_count(node->child_bitmap);
+  for (unsigned i = 0; i < n_children; i++)
+    _node_free(mtrie, node->children[i]);
+  free(node->children);
+  free(node->entries);
+  free(node);
+  mtrie->n_nodes--;
+}
+
+static inline uint8_t _node_key_byte(const fib_mtrie_node_t *node,
+                                     unsigned i) {
+  return ((const uint8_t *)node->key)[i];
+}
+
+/*
+ * Insert an element at position pos of a compressed array of n elements,
+ * whose bitmap is updated accordingly.
+ */
+static int _array_insert(void ***array, uint64_t *bitmap, unsigned pos,
+                         void *elt) {
+  unsigned n = _bitmap_count(bitmap);
+  unsigned rank = _bitmap_rank(bitmap, pos);
+
+  void **new_array = realloc(*array, (n + 1) * sizeof(void *));
+  if (!new_array) return -1;
+  memmove(&new_array[rank + 1], &new_array[rank],
+          (n - rank) * sizeof(void *));
+  new_array[rank] = elt;
+
+  *array = new_array;
+  _bitmap_set(bitmap, pos);
+  return 0;
+}
+
+static void _array_remove(void ***array, uint64_t *bitmap, unsigned pos) {
+  unsigned n = _bitmap_count(bitmap);
+  unsigned rank = _bitmap_rank(bitmap, pos);
+
+  memmove(&(*array)[rank], &(*array)[rank + 1],
+          (n - rank - 1) * sizeof(void *));
+  _bitmap_clear(bitmap, pos);
+
+  if (n == 1) {
+    free(*array);
+    *array = NULL;
+    return;
+  }
+  /* Shrinking cannot fail in practice, and is harmless if it does */
+  void **new_array = realloc(*array, (n - 1) * sizeof(void *));
+  if (new_array) *array = new_array;
+}
+
+/* Return 1 if the prefix is new, 0 if its entry is replaced, -1 on error */
+static int _node_add_prefix(fib_mtrie_node_t *node,
+                            const hicn_prefix_t *prefix, fib_entry_t *entry) {
+  uint8_t byte = node->depth < FIB_MTRIE_MAX_DEPTH
+                     ? _prefix_bytes(prefix)[node->depth]
+                     : 0;
+  unsigned pos = _prefix_pos(prefix->len, byte);
+
+  if (_bitmap_test(node->prefix_bitmap, pos)) {
+    node->entries[_bitmap_rank(node->prefix_bitmap, pos)] = entry;
+    return 0;
+  }
+
+  if (_array_insert((void ***)&node->entries, node->prefix_bitmap, pos,
+                    entry) < 0)
+    return -1;
+  return 1;
+}
+
+static int _node_add_child(fib_mtrie_node_t *node, fib_mtrie_node_t *child) {
+  return _array_insert((void ***)&node->children, node->child_bitmap,
+                       _node_key_byte(child, node->depth), child);
+}
+
+/* Create a node holding only the specified prefix */
+static fib_mtrie_node_t *_leaf_create(fib_mtrie_t *mtrie,
+                                      const hicn_prefix_t *prefix,
+                                      fib_entry_t *entry) {
+  fib_mtrie_node_t *leaf =
+      _node_create(mtrie, prefix->len / FIB_MTRIE_STRIDE, prefix);
+  if (!leaf) return NULL;
+  if (_node_add_prefix(leaf, prefix, entry) < 0) {
+    _node_free(mtrie, leaf);
+    return NULL;
+  }
+  return leaf;
+}
+
+/******************************************************************************/
+
+fib_mtrie_t *fib_mtrie_create(void) {
+  fib_mtrie_t *mtrie = malloc(sizeof(fib_mtrie_t));
+  if (!mtrie) goto ERR_MALLOC;
+
+  mtrie->n_prefixes = 0;
+  mtrie->n_nodes = 0;
+
+  hicn_prefix_t empty = {0};
+  mtrie->root = _node_create(mtrie, 0, &empty);
+  if (!mtrie->root) goto ERR_ROOT;
+
+  return mtrie;
+
+ERR_ROOT:
+  free(mtrie);
+ERR_MALLOC:
+  return NULL;
+}
+
+void fib_mtrie_free(fib_mtrie_t *mtrie) {
+  if (!mtrie) return;
+
+  _node_free(mtrie, mtrie->root);
+  free(mtrie);
+}
+
+int fib_mtrie_add(fib_mtrie_t *mtrie, const hicn_prefix_t *prefix,
+                  fib_entry_t *entry) {
+  assert(mtrie);
+  assert(prefix);
+  assert(entry);
+
+  const uint8_t *bytes = _prefix_bytes(prefix);
+  unsigned depth = prefix->len / FIB_MTRIE_STRIDE;
+
+  /*
+   * Descend as long as the path of the nodes is a prefix of the inserted one.
+   * We stop either on the node of the prefix, or on a node with no child in
+   * the direction of the prefix, or with a child whose path diverges from it
+   * (in which case slot and child are set, and common is the number of bytes
+   * they have in common).
+   */
+  fib_mtrie_node_t *node = mtrie->root;
+  fib_mtrie_node_t **slot = NULL;
+  fib_mtrie_node_t *child = NULL;
+  unsigned common = 0;
+
+  while (node->depth < depth) {
+    uint8_t byte = bytes[node->depth];
+    if (!_bitmap_test(node->child_bitmap, byte)) break;
+
+    slot = &node->children[_bitmap_rank(node->child_bitmap, byte)];
+    child = *slot;
+
+    unsigned max_common = child->depth < depth ? child->depth : depth;
+    for (common = node->depth + 1; common < max_common; common++)
+      if (bytes[common] != _node_key_byte(child, common)) break;
+    if (common < child->depth) break;
+
+    node = child;
+    slot = NULL;
+    child = NULL;
+  }
+
+  if (node->depth == depth) {
+    int rc = _node_add_prefix(node, prefix, entry);
+    if (rc < 0) return -1;
+    mtrie->n_prefixes += rc;
+    return 0;
+  }
+
+  fib_mtrie_node_t *leaf = _leaf_create(mtrie, prefix, entry);
+  if (!leaf) goto ERR_LEAF;
+
+  if (!child) {
+    if (_node_add_child(node, leaf) < 0) goto ERR_ATTACH;
+    goto END;
+  }
+
+  if (common == depth) {
+    /* The prefix is inserted on the path of the child */
+    if (_node_add_child(leaf, child) < 0) goto ERR_ATTACH;
+    *slot = leaf;
+    goto END;
+  }
+
+  /* The prefix and the child branch from a new inner node */
+  fib_mtrie_node_t *inner = _node_create(mtrie, common, prefix);
+  if (!inner) goto ERR_ATTACH;
+  if (_node_add_child(inner, leaf) < 0) goto ERR_INNER;
+  if (_node_add_child(inner, child) < 0) goto ERR_INNER_LEAF;
+  *slot = inner;
+
+END:
+  mtrie->n_prefixes++;
+  return 0;
+
+ERR_INNER_LEAF:
+  /* The leaf is freed together with the inner node */
+  _node_free(mtrie, inner);
+  return -1;
+ERR_INNER:
+  _node_free(mtrie, inner);
+ERR_ATTACH:
+  _node_free(mtrie, leaf);
+ERR_LEAF:
+  return -1;
+}
+
+void fib_mtrie_remove(fib_mtrie_t *mtrie, const hicn_prefix_t *prefix) {
+  assert(mtrie);
+  assert(prefix);
+
+  const uint8_t *bytes = _prefix_bytes(prefix);
+  unsigned depth = prefix->len / FIB_MTRIE_STRIDE;
+
+  /* Slots holding the node and its parent, NULL for the root */
+  fib_mtrie_node_t **slot = NULL;
+  fib_mtrie_node_t **parent_slot = NULL;
+  fib_mtrie_node_t *parent = NULL;
+  fib_mtrie_node_t *node = mtrie->root;
+
+  while (node->depth < depth) {
+    uint8_t byte = bytes[node->depth];
+    if (!_bitmap_test(node->child_bitmap, byte)) return;
+
+    fib_mtrie_node_t **child_slot =
+        &node->children[_bitmap_rank(node->child_bitmap, byte)];
+    fib_mtrie_node_t *child = *child_slot;
+    if (child->depth > depth || !_node_matches(child, prefix)) return;
+
+    parent_slot = slot;
+    parent = node;
+    slot = child_slot;
+    node = child;
+  }
+
+  uint8_t byte = depth < FIB_MTRIE_MAX_DEPTH ? bytes[depth] : 0;
+  unsigned pos = _prefix_pos(prefix->len, byte);
+  if (!_bitmap_test(node->prefix_bitmap, pos)) return;
+
+  _array_remove((void ***)&node->entries, node->prefix_bitmap, pos);
+  mtrie->n_prefixes--;
+
+  /* The root is never removed */
+  if (!slot || _bitmap_count(node->prefix_bitmap) > 0) return;
+
+  switch (_bitmap_count(node->child_bitmap)) {
+    case 0:
+      _array_remove((void ***)&parent->children, parent->child_bitmap,
+                    _node_key_byte(node, parent->depth));
+      _node_free(mtrie, node);
+
+      /* The parent might be left with a single child to splice */
+      if (!parent_slot || _bitmap_count(parent->prefix_bitmap) > 0 ||
+          _bitmap_count(parent->child_bitmap) != 1)
+        return;
+      slot = parent_slot;
+      node = parent;
+      break;
+    case 1:
+      break;
+    default:
+      return;
+  }
+
+  /* Splice the node out */
+  *slot = node->children[0];
+  free(node->children);
+  node->children = NULL;
+  memset(node->child_bitmap, 0, sizeof(node->child_bitmap));
+  _node_free(mtrie, node);
+}
+
+fib_entry_t *fib_mtrie_match(const fib_mtrie_t *mtrie,
+                             const hicn_prefix_t *prefix) {
+  assert(mtrie);
+  assert(prefix);
+
+  const uint8_t *bytes = _prefix_bytes(prefix);
+  unsigned len = prefix->len;
+  fib_entry_t *match = NULL;
+
+  const fib_mtrie_node_t *node = mtrie->root;
+  for (;;) {
+    unsigned base = node->depth * FIB_MTRIE_STRIDE;
+    if (base > len || !_node_matches(node, prefix)) break;
+
+    if (node->depth == FIB_MTRIE_MAX_DEPTH) {
+      if (_bitmap_test(node->prefix_bitmap, 0)) match = node->entries[0];
+      break;
+    }
+
+    /* Longest prefix within the node, not longer than the searched one */
+    uint8_t byte = bytes[node->depth];
+    unsigned max_len = len - base < FIB_MTRIE_STRIDE - 1
+                           ? len - base
+                           : FIB_MTRIE_STRIDE - 1;
+    for (int l = (int)max_len; l >= 0; l--) {
+      unsigned pos = _prefix_pos(base + l, byte);
+      if (_bitmap_test(node->prefix_bitmap, pos)) {
+        match = node->entries[_bitmap_rank(node->prefix_bitmap, pos)];
+        break;
+      }
+    }
+
+    if (!_bitmap_test(node->child_bitmap, byte)) break;
+    node = node->children[_bitmap_rank(node->child_bitmap, byte)];
+  }
+
+  return match;
+}
+
+size_t fib_mtrie_get_num_prefixes(const fib_mtrie_t *mtrie) {
+  return mtrie->n_prefixes;
+}
+
+size_t fib_mtrie_get_num_nodes(const fib_mtrie_t *mtrie) {
+  return mtrie->n_nodes;
+}
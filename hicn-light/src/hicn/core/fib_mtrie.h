@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file fib_mtrie.h
+ * @brief Path-compressed multibit trie for longest prefix match
+ *
+ * The binary trie of the FIB (see fib.c) visits one node per branching bit,
+ * each visit being a pointer dereference followed by a full prefix
+ * comparison. This index consumes the address one byte at a time instead:
+ *
+ *  - a node at depth d (in bytes) holds the prefixes whose length lies in
+ *    [8d, 8d + 7], in a 255-bit bitmap laid out as an implicit binary tree
+ *    over the first bits of byte d, and up to 256 children indexed by the
+ *    value of byte d. Both arrays are compressed: only present elements are
+ *    stored, and their position is the population count of the bitmap below
+ *    their bit;
+ *  - nodes with neither prefixes nor more than one child are skipped (path
+ *    compression), so that a lookup visits at most one node per byte in
+ *    which prefixes diverge. The bytes skipped are verified against the path
+ *    stored in the node with a single masked comparison of two 64-bit words.
+ *
+ * A lookup thus costs at most 17 node visits for IPv6, and in practice a
+ * handful, each touching two cache lines. The index only references FIB
+ * entries, which remain owned by the FIB.
+ */
+
+#ifndef HICNLIGHT_FIB_MTRIE_H
+#define HICNLIGHT_FIB_MTRIE_H
+
+#include <hicn/name.h>
+#include "fib_entry.h"
+
+typedef struct fib_mtrie_s fib_mtrie_t;
+
+fib_mtrie_t *fib_mtrie_create(void);
+
+void fib_mtrie_free(fib_mtrie_t *mtrie);
+
+/**
+ * @brief Associate an entry to a prefix, replacing any previous one.
+ *
+ * @return int 0 in case of success, -1 otherwise
+ */
+int fib_mtrie_add(fib_mtrie_t *mtrie, const hicn_prefix_t *prefix,
+                  fib_entry_t *entry);
+
+/**
+ * @brief Remove a prefix from the index, if present.
+ */
+void fib_mtrie_remove(fib_mtrie_t *mtrie, const hicn_prefix_t *prefix);
+
+/**
+ * @brief Retrieve the entry associated to the longest prefix of the
+ * specified one (including itself).
+ *
+ * @return fib_entry_t* The matching entry, or NULL if none matches
+ */
+fib_entry_t *fib_mtrie_match(const fib_mtrie_t *mtrie,
+                             const hicn_prefix_t *prefix);
+
+size_t fib_mtrie_get_num_prefixes(const fib_mtrie_t *mtrie);
+
+size_t fib_mtrie_get_num_nodes(const fib_mtrie_t *mtrie);
+
+#endif /* HICNLIGHT_FIB_MTRIE_H */
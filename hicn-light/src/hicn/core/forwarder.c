@@ -32,6 +32,13 @@
 /* Batch sending: only if the previous option is undefined */
 #define USE_QUEUE true
 
+/*
+ * Period of the packet cache expiry timer, and maximum number of entries
+ * reclaimed at each period to bound the time stolen from packet processing.
+ */
+#define PKT_CACHE_EXPIRY_INTERVAL 10 /* ms */
+#define PKT_CACHE_EXPIRY_BUDGET 1024
+
 #ifndef _WIN32
 #include <arpa/inet.h>
 #include <sys/socket.h>
@@ -59,6 +66,8 @@
 #include "msgbuf.h"
 #include "msgbuf_pool.h"
 #include "packet_cache.h"
+#include "profile.h"
+#include "worker.h"
 #include "../config/configuration.h"
 // #include "../config/configuration_file.h"
 #include "../config/commands.h"
@@ -83,6 +92,7 @@ struct forwarder_s {
   configuration_t *config;
 
   pkt_cache_t *pkt_cache;
+  event_t *pkt_cache_timer;
   fib_t *fib;
   msgbuf_pool_t *msgbuf_pool;
 
@@ -94,6 +104,7 @@ struct forwarder_s {
   bool serve_from_cs;
 
   forwarder_stats_t stats;
+  profile_t profile;
 #ifdef WITH_POLICY_STATS
   policy_stats_mgr_t policy_stats_mgr;
 #endif /* WITH_POLICY_STATS */
@@ -104,10 +115,26 @@ struct forwarder_s {
    */
   unsigned *pending_conn;
 
+  /*
+   * Flush policy: a connection is flushed as soon as flush_batch_size packets
+   * are queued, and otherwise kept pending for up to flush_latency ms after
+   * its first queued packet (see forwarder_flush_connections)
+   */
+  unsigned flush_batch_size;
+  unsigned flush_latency;
+  event_t *flush_timer; /* NULL if flush_latency is 0 */
+
   subscription_table_t *subscriptions;
 
+  // Staging area for batched configuration commands
+  batch_t *batch;
+
   // Used to store the msgbufs that need to be released
   off_t *acquired_msgbuf_ids;
+
+  // Data plane workers (NULL when running single-threaded)
+  workers_t *workers;
+  unsigned worker_id;
 };
 
 /**
@@ -139,6 +166,41 @@ static void forwarder_seed(forwarder_t *forwarder) {
 #endif
 }
 
+/**
+ * Periodically reclaim expired packet cache entries, so that memory does not
+ * depend on further packets being received with the same names.
+ */
+static int forwarder_on_pkt_cache_timeout(void *forwarder_arg, int fd,
+                                          unsigned id, void *data) {
+  forwarder_t *forwarder = forwarder_arg;
+  assert(forwarder);
+
+  pkt_cache_expire(forwarder->pkt_cache, forwarder->msgbuf_pool, ticks_now(),
+                   PKT_CACHE_EXPIRY_BUDGET);
+
+  if (loop_timer_register(forwarder->pkt_cache_timer,
+                          PKT_CACHE_EXPIRY_INTERVAL) < 0) {
+    ERROR("Error re-registering packet cache expiry timer");
+    return -1;
+  }
+  return 0;
+}
+
+static void _forwarder_flush_connections(forwarder_t *forwarder, bool force);
+
+/**
+ * Flush the connections whose packets have been held for the maximum latency
+ * without new packets being received.
+ */
+static int forwarder_on_flush_timeout(void *forwarder_arg, int fd, unsigned id,
+                                      void *data) {
+  forwarder_t *forwarder = forwarder_arg;
+  assert(forwarder);
+
+  _forwarder_flush_connections(forwarder, true);
+  return 0;
+}
+
 forwarder_t *forwarder_create(configuration_t *configuration) {
   forwarder_t *forwarder = malloc(sizeof(forwarder_t));
   if (!forwarder) goto ERR_MALLOC;
@@ -160,13 +222,50 @@ forwarder_t *forwarder_create(configuration_t *configuration) {
   forwarder->msgbuf_pool = msgbuf_pool_create();
   if (!forwarder->msgbuf_pool) goto ERR_PACKET_POOL;
 
+  size_t max_packet_size = configuration_get_max_packet_size(configuration);
+  if (max_packet_size > MTU)
+    msgbuf_pool_set_rx_class(forwarder->msgbuf_pool,
+                             msgbuf_class_fit(max_packet_size));
+
   size_t objectStoreSize = configuration_get_cs_size(configuration);
   forwarder->pkt_cache = pkt_cache_create(objectStoreSize);
   if (!forwarder->pkt_cache) goto ERR_PKT_CACHE;
+  if (pkt_cache_set_cs_type(forwarder->pkt_cache,
+                            configuration_get_cs_type(configuration)) < 0)
+    goto ERR_CS_TYPE;
+  if (pkt_cache_set_cs_disk(forwarder->pkt_cache,
+                            configuration_get_cs_disk_path(configuration),
+                            configuration_get_cs_disk_size(configuration)) < 0)
+    goto ERR_CS_DISK;
+
+  pit_t *pit = pkt_cache_get_pit(forwarder->pkt_cache);
+  pit_set_max_size(pit, configuration_get_pit_size(configuration),
+                   configuration_get_pit_size_per_connection(configuration));
+  pit_set_full_policy(pit, configuration_get_pit_full_policy(configuration));
+
+  loop_timer_create(&forwarder->pkt_cache_timer, MAIN_LOOP, forwarder,
+                    forwarder_on_pkt_cache_timeout, NULL);
+  if (!forwarder->pkt_cache_timer) goto ERR_PKT_CACHE_TIMER;
+  if (loop_timer_register(forwarder->pkt_cache_timer,
+                          PKT_CACHE_EXPIRY_INTERVAL) < 0)
+    goto ERR_PKT_CACHE_TIMER_REGISTER;
+
+  forwarder->flush_batch_size =
+      configuration_get_flush_batch_size(configuration);
+  forwarder->flush_latency = configuration_get_flush_latency(configuration);
+  forwarder->flush_timer = NULL;
+  if (forwarder->flush_latency > 0) {
+    loop_timer_create(&forwarder->flush_timer, MAIN_LOOP, forwarder,
+                      forwarder_on_flush_timeout, NULL);
+    if (!forwarder->flush_timer) goto ERR_FLUSH_TIMER;
+  }
 
   forwarder->subscriptions = subscription_table_create();
   if (!forwarder->subscriptions) goto ERR_SUBSCRIPTION;
 
+  forwarder->batch = batch_create();
+  if (!forwarder->batch) goto ERR_BATCH;
+
   // the two flags for the cs are set to true by default. If the cs
   // is active it always work as expected unless the use modifies this
   // values using controller
@@ -186,6 +285,9 @@ forwarder_t *forwarder_create(configuration_t *configuration) {
 #endif /* WITH_POLICY_STATS */
 
   memset(&forwarder->stats, 0, sizeof(forwarder_stats_t));
+  profile_initialize(&forwarder->profile);
+  forwarder->workers = NULL;
+  forwarder->worker_id = 0;
   vector_init(forwarder->pending_conn, MAX_MSG, 0);
   vector_init(forwarder->acquired_msgbuf_ids, MAX_MSG, 0);
 
@@ -200,9 +302,18 @@ ERR_MGR:
 #ifdef WITH_MAPME
 ERR_MAPME:
 #endif /* WITH_MAPME */
-
+  batch_free(forwarder->batch);
+ERR_BATCH:
 ERR_SUBSCRIPTION:
   subscription_table_free(forwarder->subscriptions);
+  if (forwarder->flush_timer) loop_event_free(forwarder->flush_timer);
+ERR_FLUSH_TIMER:
+  loop_event_unregister(forwarder->pkt_cache_timer);
+ERR_PKT_CACHE_TIMER_REGISTER:
+  loop_event_free(forwarder->pkt_cache_timer);
+ERR_PKT_CACHE_TIMER:
+ERR_CS_DISK:
+ERR_CS_TYPE:
 ERR_PKT_CACHE:
   pkt_cache_free(forwarder->pkt_cache);
 
@@ -228,12 +339,17 @@ void forwarder_free(forwarder_t *forwarder) {
   mapme_free(forwarder->mapme);
 #endif /* WITH_MAPME */
 
+  loop_event_unregister(forwarder->pkt_cache_timer);
+  loop_event_free(forwarder->pkt_cache_timer);
+  if (forwarder->flush_timer) loop_event_free(forwarder->flush_timer);
   pkt_cache_free(forwarder->pkt_cache);
-  msgbuf_pool_free(forwarder->msgbuf_pool);
   fib_free(forwarder->fib);
+  /* Connections release the packets still queued for transmission */
   connection_table_free(forwarder->connection_table);
   listener_table_free(forwarder->listener_table);
+  msgbuf_pool_free(forwarder->msgbuf_pool);
   subscription_table_free(forwarder->subscriptions);
+  batch_free(forwarder->batch);
   configuration_free(forwarder->config);
   vector_free(forwarder->pending_conn);
   vector_free(forwarder->acquired_msgbuf_ids);
@@ -347,6 +463,10 @@ int forwarder_remove_connection(const forwarder_t *forwarder,
   connection_table_remove_by_id(table, connection_id);
   if (finalize) connection_finalize(connection);
 
+  /* Drop the items staged by the connection */
+  if (batch_is_open(forwarder->batch, connection_id))
+    batch_reset(forwarder->batch);
+
   return 0;
 }
 
@@ -411,6 +531,10 @@ subscription_table_t *forwarder_get_subscriptions(
   return forwarder->subscriptions;
 }
 
+batch_t *forwarder_get_batch(const forwarder_t *forwarder) {
+  return forwarder->batch;
+}
+
 connection_table_t *forwarder_get_connection_table(
     const forwarder_t *forwarder) {
   assert(forwarder);
@@ -447,6 +571,14 @@ bool forwarder_cs_get_serve(forwarder_t *forwarder) {
   return forwarder->serve_from_cs;
 }
 
+void forwarder_pit_set_size(forwarder_t *forwarder, size_t size,
+                            size_t size_per_connection) {
+  assert(forwarder);
+
+  pit_set_max_size(pkt_cache_get_pit(forwarder->pkt_cache), size,
+                   size_per_connection);
+}
+
 void forwarder_cs_set_size(forwarder_t *forwarder, size_t size) {
   assert(forwarder);
 
@@ -465,6 +597,12 @@ size_t forwarder_cs_get_size(forwarder_t *forwarder) {
   return pkt_cache_get_cs_size(forwarder->pkt_cache);
 }
 
+int forwarder_cs_set_disk(forwarder_t *forwarder, const char *path,
+                          size_t size) {
+  assert(forwarder);
+  return pkt_cache_set_cs_disk(forwarder->pkt_cache, path, size);
+}
+
 size_t forwarder_cs_get_num_stale_entries(forwarder_t *forwarder) {
   assert(forwarder);
   return pkt_cache_get_num_cs_stale_entries(forwarder->pkt_cache);
@@ -546,8 +684,10 @@ static ssize_t forwarder_forward_via_connection(forwarder_t *forwarder,
   if (msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_DATA)
     msgbuf_update_pathlabel(msgbuf, connection_get_id(conn));
 
+  PROFILE_START(send_start);
   bool success = connection_send_packet(conn, msgbuf_get_packet(msgbuf),
                                         msgbuf_get_len(msgbuf));
+  PROFILE_STOP(&forwarder->profile, SEND, send_start);
 #else
 
   // In this case we cannot update the path label even if it is need because
@@ -557,7 +697,9 @@ static ssize_t forwarder_forward_via_connection(forwarder_t *forwarder,
   // associated to the last connection used. For this reason the path label
   // update must be done before the packet is actually sent inside the different
   // IO implementations.
+  PROFILE_START(send_start);
   bool success = connection_send(conn, msgbuf_id, USE_QUEUE);
+  PROFILE_STOP(&forwarder->profile, SEND, send_start);
 
 #endif
 
@@ -565,6 +707,16 @@ static ssize_t forwarder_forward_via_connection(forwarder_t *forwarder,
   if (!vector_contains(forwarder->pending_conn, conn_id))
     vector_push(forwarder->pending_conn, conn_id);
 
+#if !defined(USE_SEND_PACKET) && defined(__linux__)
+  /* Large enough batches do not wait for the end of the processing */
+  if (forwarder->flush_batch_size > 0 &&
+      connection_get_num_queued(conn) >= forwarder->flush_batch_size) {
+    PROFILE_START(flush_start);
+    connection_flush(conn);
+    PROFILE_STOP(&forwarder->profile, FLUSH, flush_start);
+  }
+#endif
+
   if (!success) {
     forwarder->stats.countSendFailures++;
 
@@ -633,7 +785,9 @@ static bool forwarder_forward_via_fib(forwarder_t *forwarder, off_t msgbuf_id,
   msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
   assert(msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_INTEREST);
 
+  PROFILE_START(fib_start);
   fib_entry_t *fib_entry = fib_match_msgbuf(forwarder->fib, msgbuf);
+  PROFILE_STOP(&forwarder->profile, FIB, fib_start);
   if (!fib_entry) return false;
 
   nexthops_t *nexthops = fib_entry_get_nexthops(fib_entry);
@@ -643,7 +797,9 @@ static bool forwarder_forward_via_fib(forwarder_t *forwarder, off_t msgbuf_id,
   size_t cur_len = nexthops_get_curlen(nexthops);
 
   /* This affects the nexthops */
+  PROFILE_START(strategy_start);
   nexthops = strategy_lookup_nexthops(&fib_entry->strategy, nexthops, msgbuf);
+  PROFILE_STOP(&forwarder->profile, STRATEGY, strategy_start);
 
   if (nexthops_get_curlen(nexthops) == 0) {
     ERROR("Message %p returned an empty next hop set", msgbuf);
@@ -807,7 +963,9 @@ int _forwarder_forward_aggregated_interest(
 
   int ret = -1;
 
+  PROFILE_START(fib_start);
   fib_entry_t *fib_entry = fib_match_msgbuf(forwarder->fib, msgbuf);
+  PROFILE_STOP(&forwarder->profile, FIB, fib_start);
   if (!fib_entry) goto END;
 
   nexthops_t *nexthops = fib_entry_get_nexthops(fib_entry);
@@ -886,8 +1044,10 @@ int _forwarder_forward_aggregated_interest(
          */
         nexthops->flags = flags;
         nexthops->cur_elts = cur_len;
+        PROFILE_START(strategy_start);
         nexthops =
             strategy_lookup_nexthops(&fib_entry->strategy, nexthops, msgbuf);
+        PROFILE_STOP(&forwarder->profile, STRATEGY, strategy_start);
 
         if (nexthops_get_curlen(nexthops) == 0) {
           ERROR("Message %p returned an empty next hop set", msgbuf);
@@ -944,9 +1104,16 @@ static ssize_t forwarder_process_single_interest(forwarder_t *forwarder,
   pkt_cache_entry_t *entry = NULL;
 
   // Update packet cache
+  PROFILE_START(pkt_cache_start);
   pkt_cache_on_interest(forwarder->pkt_cache, msgbuf_pool, msgbuf_id, &verdict,
                         &data_msgbuf_id, &entry, msgbuf_get_name(msgbuf),
                         forwarder->serve_from_cs);
+  PROFILE_STOP(&forwarder->profile, PKT_CACHE, pkt_cache_start);
+  PROFILE_VERDICT(&forwarder->profile, verdict);
+
+  // PIT full or connection quota exhausted, no entry has been created
+  if (verdict == PKT_CACHE_VERDICT_DROP_INTEREST)
+    return forwarder_drop(forwarder, msgbuf_id);
 
   _forwarder_update_interest_stats(forwarder, verdict, msgbuf,
                                    entry->has_expire_ts, entry->expire_ts);
@@ -963,41 +1130,52 @@ static ssize_t forwarder_process_single_interest(forwarder_t *forwarder,
 static ssize_t forwarder_process_aggregated_interest(
     forwarder_t *forwarder, interest_manifest_header_t *int_manifest_header,
     msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf, off_t msgbuf_id) {
-  pkt_cache_verdict_t verdict = PKT_CACHE_VERDICT_ERROR;
-  off_t data_msgbuf_id = INVALID_MSGBUF_ID;
-  pkt_cache_entry_t *entry = NULL;
   // Save PIT entries to avoid re-doing pkt cache lookup in
   // `_forwarder_forward_aggregated_interest()`
-  pkt_cache_entry_t *entries[BITMAP_SIZE * WORD_WIDTH];
+  pkt_cache_entry_t *entries[MAX_SUFFIXES_IN_MANIFEST];
+  pkt_cache_verdict_t verdicts[MAX_SUFFIXES_IN_MANIFEST];
+  off_t data_msgbuf_ids[MAX_SUFFIXES_IN_MANIFEST];
 
   int n_suffixes_to_fwd = 0;
 
-  hicn_name_t name_copy = HICN_NAME_EMPTY;
-  hicn_name_copy(&name_copy, msgbuf_get_name(msgbuf));
-
-  // Suffixes in interest manifest also contains suffix in main name. We can
-  // then just iterate the interest manifest and update the suffix in the name
-  // struct
-  hicn_name_suffix_t *suffix;
-  unsigned long pos;
-  interest_manifest_foreach_suffix(int_manifest_header, suffix, pos) {
-    // Update name
-    hicn_name_set_suffix(&name_copy, *suffix);
+  // Update packet cache for all the suffixes at once. Suffixes in interest
+  // manifest also contains suffix in main name.
+  PROFILE_START(pkt_cache_start);
+  pkt_cache_on_interest_manifest(forwarder->pkt_cache, msgbuf_pool, msgbuf_id,
+                                 int_manifest_header, msgbuf_get_name(msgbuf),
+                                 verdicts, data_msgbuf_ids, entries,
+                                 forwarder->serve_from_cs);
+  PROFILE_STOP(&forwarder->profile, PKT_CACHE, pkt_cache_start);
+
+  for (size_t pos = 0; pos < int_manifest_header->n_suffixes; pos++) {
+    if (!bitmap_is_set_no_check(int_manifest_header->request_bitmap, pos))
+      continue;
+
+    pkt_cache_verdict_t verdict = verdicts[pos];
+    pkt_cache_entry_t *entry = entries[pos];
+    PROFILE_VERDICT(&forwarder->profile, verdict);
+
+    // PIT full or connection quota exhausted, skip this suffix
+    if (verdict == PKT_CACHE_VERDICT_DROP_INTEREST) {
+      forwarder->stats.countInterestsDropped++;
+      bitmap_unset_no_check(int_manifest_header->request_bitmap, pos);
+      continue;
+    }
 
-    // Update packet cache
-    pkt_cache_on_interest(forwarder->pkt_cache, msgbuf_pool, msgbuf_id,
-                          &verdict, &data_msgbuf_id, &entry, &name_copy,
-                          forwarder->serve_from_cs);
+    // Entry removed while processing the next suffixes
+    if (!entry) {
+      bitmap_unset_no_check(int_manifest_header->request_bitmap, pos);
+      continue;
+    }
 
-    entries[pos] = entry;
     _forwarder_update_interest_stats(forwarder, verdict, msgbuf,
                                      entry->has_expire_ts, entry->expire_ts);
 
     // Here only data forwarding is performed, interest forwarding is done
     // in '_forwarder_forward_aggregated_interest()'
-    int rc =
-        _forwarder_forward_upon_interest(forwarder, msgbuf_pool, data_msgbuf_id,
-                                         msgbuf_id, entry, verdict, true);
+    int rc = _forwarder_forward_upon_interest(forwarder, msgbuf_pool,
+                                              data_msgbuf_ids[pos], msgbuf_id,
+                                              entry, verdict, true);
 
     // No route when trying to forward interest, remove from PIT
     if (rc == -1) pkt_cache_pit_remove_entry(forwarder->pkt_cache, entry);
@@ -1013,7 +1191,7 @@ static ssize_t forwarder_process_aggregated_interest(
 
     WITH_DEBUG({
       char buf[MAXSZ_HICN_PREFIX];
-      int rc = hicn_name_snprintf(buf, MAXSZ_HICN_NAME, &name_copy);
+      int rc = hicn_name_snprintf(buf, MAXSZ_HICN_NAME, &entry->name);
       if (rc < 0 || rc >= MAXSZ_HICN_PREFIX)
         snprintf(buf, MAXSZ_HICN_PREFIX, "(error)");
       DEBUG("Next in manifest: %s", buf);
@@ -1158,9 +1336,12 @@ static ssize_t forwarder_process_data(forwarder_t *forwarder, off_t msgbuf_id) {
 
   pkt_cache_verdict_t verdict = PKT_CACHE_VERDICT_ERROR;
   bool wrong_egress;
+  PROFILE_START(pkt_cache_start);
   nexthops_t *ingressSetUnion = pkt_cache_on_data(
       forwarder->pkt_cache, msgbuf_pool, msgbuf_id, forwarder->store_in_cs,
       connection_is_local(conn), &wrong_egress, &verdict);
+  PROFILE_STOP(&forwarder->profile, PKT_CACHE, pkt_cache_start);
+  PROFILE_VERDICT(&forwarder->profile, verdict);
 
   _forwarder_log_on_data(forwarder, verdict);
 
@@ -1190,23 +1371,57 @@ static ssize_t forwarder_process_data(forwarder_t *forwarder, off_t msgbuf_id) {
   return msgbuf_get_len(msgbuf);
 }
 
-void forwarder_flush_connections(forwarder_t *forwarder) {
+/*
+ * Unless forced, connections whose first queued packet is younger than the
+ * latency bound are kept pending, and the flush timer is armed to bound the
+ * time they wait for further packets.
+ */
+static void _forwarder_flush_connections(forwarder_t *forwarder, bool force) {
   // DEBUG("[forwarder_flush_connections]");
+  PROFILE_START(flush_start);
   const connection_table_t *table = forwarder_get_connection_table(forwarder);
+  Ticks now = force ? 0 : ticks_now();
 
   unsigned num_pending_conn = (unsigned)vector_len(forwarder->pending_conn);
+  unsigned num_held_conn = 0;
   for (unsigned i = 0; i < num_pending_conn; i++) {
     unsigned conn_id = forwarder->pending_conn[i];
-    connection_t *conn = connection_table_at(table, conn_id);
+    /* Held connections might have been removed in the meantime */
+    connection_t *conn = connection_table_get_by_id(table, conn_id);
+    if (!conn) continue;
+    if (!force && forwarder->flush_latency > 0 &&
+        connection_get_num_queued(conn) > 0 &&
+        now - connection_get_queue_ts(conn) < forwarder->flush_latency) {
+      forwarder->pending_conn[num_held_conn++] = conn_id;
+      continue;
+    }
     if (!connection_flush(conn)) {
       WARN("Could not flush connection queue");
       // XXX keep track of non flushed connections...
     }
   }
-  vector_reset(forwarder->pending_conn);
+  vector_len(forwarder->pending_conn) = num_held_conn;
+
+  if (num_held_conn > 0) {
+    if (!loop_timer_is_enabled(forwarder->flush_timer))
+      loop_timer_register(forwarder->flush_timer, forwarder->flush_latency);
+  }
+
+  /* Wake up the workers to which packets have been handed off */
+  if (forwarder->workers)
+    workers_flush(forwarder->workers, forwarder->worker_id);
+
+  /* Do not account the (frequent) flushes with nothing to send */
+  if (num_pending_conn > 0) {
+    PROFILE_STOP(&forwarder->profile, FLUSH, flush_start);
+  }
   // DEBUG("[forwarder_flush_connections] done");
 }
 
+void forwarder_flush_connections(forwarder_t *forwarder) {
+  _forwarder_flush_connections(forwarder, false);
+}
+
 #if WITH_WLDR
 // XXX move to wldr file, worst case in connection.
 void forwarder_apply_wldr(const forwarder_t *forwarder, const msgbuf_t *msgbuf,
@@ -1416,6 +1631,37 @@ void forwarder_acquired_msgbuf_ids_push(const forwarder_t *forwarder,
   vector_push(forwarder->acquired_msgbuf_ids, msgbuf_id);
 }
 
+void forwarder_set_workers(forwarder_t *forwarder, struct workers_s *workers,
+                           unsigned worker_id) {
+  assert(forwarder);
+  forwarder->workers = workers;
+  forwarder->worker_id = worker_id;
+}
+
+unsigned forwarder_get_worker_id(const forwarder_t *forwarder) {
+  assert(forwarder);
+  return forwarder->worker_id;
+}
+
+/*
+ * With multiple workers, interest and data packets are processed by the worker
+ * owning the packet cache shard of their name. Returns true if the packet has
+ * been handed off to (or dropped on its way to) another worker.
+ */
+static bool _forwarder_handoff(forwarder_t *forwarder, listener_t *listener,
+                               const address_pair_t *pair, msgbuf_t *msgbuf,
+                               const hicn_name_t *name) {
+  if (!forwarder->workers || !listener) return false;
+
+  unsigned owner = workers_get_shard(forwarder->workers, name);
+  if (owner == forwarder->worker_id) return false;
+
+  if (workers_handoff(forwarder->workers, forwarder->worker_id, owner,
+                      listener, pair, msgbuf) < 0)
+    forwarder->stats.countDropped++;
+  return true;
+}
+
 // =======================================================
 
 fib_t *forwarder_get_fib(const forwarder_t *forwarder) {
@@ -1453,24 +1699,75 @@ static void _forwarder_finalize_connection_if_self(connection_t *conn,
     connection_finalize(conn);
 }
 
-ssize_t forwarder_receive(forwarder_t *forwarder, listener_t *listener,
-                          off_t msgbuf_id, address_pair_t *pair, Ticks now) {
-  assert(forwarder);
-  /* listener can be NULL */
-  assert(msgbuf_id_is_valid(msgbuf_id));
-  assert(pair);
-
+/*
+ * First stage of the receive pipeline: initialize the msgbuf from the received
+ * packet, detect its type and, for interests and data, extract its name.
+ */
+static void _forwarder_parse(forwarder_t *forwarder, msgbuf_t *msgbuf,
+                             Ticks now) {
   hicn_name_t name;
+  PROFILE_START(parse_start);
+
+  forwarder->stats.countReceived++;
+
+  /* Initialize packet buffer stored in msgbuf through libhicn */
+  msgbuf_initialize_from_packet(msgbuf);
+
+  /* Detect packet type */
+  hicn_packet_analyze(msgbuf_get_pkbuf(msgbuf));
+
+  msgbuf->recv_ts = now;
+
+  switch (msgbuf_get_type(msgbuf)) {
+    case HICN_PACKET_TYPE_INTEREST:
+      hicn_interest_get_name(msgbuf_get_pkbuf(msgbuf), &name);
+      msgbuf_set_name(msgbuf, &name);
+      break;
+    case HICN_PACKET_TYPE_DATA:
+      /* This include probes */
+      hicn_data_get_name(msgbuf_get_pkbuf(msgbuf), &name);
+      msgbuf_set_name(msgbuf, &name);
+      break;
+    default:
+      break;
+  }
+
+  PROFILE_STOP(&forwarder->profile, PARSE, parse_start);
+}
+
+/*
+ * Returns true if the packet is an interest or data that will be looked up in
+ * the local packet cache, and is thus worth prefetching.
+ */
+static bool _forwarder_is_local_lookup(const forwarder_t *forwarder,
+                                       const msgbuf_t *msgbuf) {
+  hicn_packet_type_t type = msgbuf_get_type(msgbuf);
+  if (type != HICN_PACKET_TYPE_INTEREST && type != HICN_PACKET_TYPE_DATA)
+    return false;
+  if (!forwarder->workers) return true;
+  return workers_get_shard(forwarder->workers, msgbuf_get_name(msgbuf)) ==
+         forwarder->worker_id;
+}
+
+/*
+ * Second stage of the receive pipeline: process the (parsed) packet according
+ * to its type.
+ */
+static ssize_t _forwarder_dispatch(forwarder_t *forwarder,
+                                   listener_t *listener, off_t msgbuf_id,
+                                   address_pair_t *pair) {
   msgbuf_pool_t *msgbuf_pool = forwarder_get_msgbuf_pool(forwarder);
   msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
   assert(msgbuf);
 
   size_t size = msgbuf_get_len(msgbuf);
 
-  const connection_table_t *table =
-      forwarder_get_connection_table(listener->forwarder);
+  const connection_table_t *table = forwarder_get_connection_table(forwarder);
 
-  /* Connection lookup */
+  /*
+   * Connection lookup. This is done here and not while parsing so that
+   * several packets from a new peer within a batch share the same connection.
+   */
   if (msgbuf_get_connection_id(msgbuf) == CONNECTION_ID_UNDEFINED) {
     connection_t *connection = connection_table_get_by_pair(table, pair);
     unsigned conn_id =
@@ -1482,20 +1779,14 @@ ssize_t forwarder_receive(forwarder_t *forwarder, listener_t *listener,
     msgbuf->connection_id = conn_id;
   }
 
-  forwarder->stats.countReceived++;
-
-  /* Initialize packet buffer stored in msgbuf through libhicn */
-  msgbuf_initialize_from_packet(msgbuf);
-
-  /* Detect packet type */
-  hicn_packet_analyze(msgbuf_get_pkbuf(msgbuf));
-
-  msgbuf->recv_ts = now;
-
 RETRY:
 
   switch (msgbuf_get_type(msgbuf)) {
     case HICN_PACKET_TYPE_INTEREST:
+      if (_forwarder_handoff(forwarder, listener, pair, msgbuf,
+                             msgbuf_get_name(msgbuf)))
+        return size;
+
       if (!connection_id_is_valid(msgbuf->connection_id)) {
         char conn_name[SYMBOLIC_NAME_LEN];
         int rc = connection_table_get_random_name(table, conn_name);
@@ -1513,8 +1804,6 @@ RETRY:
         msgbuf->connection_id = connection_id;
       }
       msgbuf->path_label = 0;  // not used for interest packets
-      hicn_interest_get_name(msgbuf_get_pkbuf(msgbuf), &name);
-      msgbuf_set_name(msgbuf, &name);
 #ifdef WITH_WLDR
       forwarder_apply_wldr(forwarder, msgbuf, connection);
 #endif /* WITH_WLDR */
@@ -1524,14 +1813,15 @@ RETRY:
       break;
 
     case HICN_PACKET_TYPE_DATA:
-      /* This include probes */
+      if (_forwarder_handoff(forwarder, listener, pair, msgbuf,
+                             msgbuf_get_name(msgbuf)))
+        return size;
+
       if (!connection_id_is_valid(msgbuf->connection_id)) {
         ERROR("Invalid connection for data packet");
         goto DROP;
       }
       msgbuf_init_pathlabel(msgbuf);
-      hicn_data_get_name(msgbuf_get_pkbuf(msgbuf), &name);
-      msgbuf_set_name(msgbuf, &name);
 #ifdef WITH_WLDR
       forwarder_apply_wldr(forwarder, msgbuf, connection);
 #endif /* WITH_WLDR */
@@ -1574,6 +1864,14 @@ RETRY:
       break;
 
     case HICN_PACKET_TYPE_COMMAND:
+      // The control plane runs on worker 0
+      if (forwarder->workers && forwarder->worker_id != 0 && listener) {
+        if (workers_handoff(forwarder->workers, forwarder->worker_id, 0,
+                            listener, pair, msgbuf) < 0)
+          goto DROP;
+        return size;
+      }
+
       // Create the connection to send the ack back
       if (!connection_id_is_valid(msgbuf->connection_id)) {
         char conn_name[SYMBOLIC_NAME_LEN];
@@ -1605,7 +1903,27 @@ RETRY:
        */
       connection_t *connection =
           connection_table_get_by_id(table, msgbuf_get_connection_id(msgbuf));
+
+      /*
+       * The request is turned into the reply while being processed: keep a
+       * copy to replicate it to other workers once acknowledged.
+       */
+      command_prepare(forwarder, msgbuf_get_packet(msgbuf));
+      uint8_t *request = NULL;
+      size_t request_len = msgbuf_get_len(msgbuf);
+      if (forwarder->workers) {
+        request = malloc(request_len);
+        if (request) memcpy(request, msgbuf_get_packet(msgbuf), request_len);
+      }
+
       size = command_process_msgbuf(forwarder, msgbuf);
+
+      if (request) {
+        if (msg->header.message_type == ACK_LIGHT)
+          workers_replicate_command(forwarder->workers, msgbuf->command.type,
+                                    listener, pair, request, request_len);
+        free(request);
+      }
       if (msgbuf->command.type == COMMAND_TYPE_CONNECTION_REMOVE)
         _forwarder_finalize_connection_if_self(connection, msgbuf);
       return size;
@@ -1626,6 +1944,62 @@ DROP:
   return 0;
 }
 
+ssize_t forwarder_receive(forwarder_t *forwarder, listener_t *listener,
+                          off_t msgbuf_id, address_pair_t *pair, Ticks now) {
+  assert(forwarder);
+  /* listener can be NULL */
+  assert(msgbuf_id_is_valid(msgbuf_id));
+  assert(pair);
+
+  msgbuf_pool_t *msgbuf_pool = forwarder_get_msgbuf_pool(forwarder);
+  msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
+  assert(msgbuf);
+
+  _forwarder_parse(forwarder, msgbuf, now);
+  return _forwarder_dispatch(forwarder, listener, msgbuf_id, pair);
+}
+
+ssize_t forwarder_receive_batch(forwarder_t *forwarder, listener_t *listener,
+                                const off_t *msgbuf_ids, address_pair_t *pairs,
+                                size_t n, Ticks now) {
+  assert(forwarder);
+  assert(msgbuf_ids);
+  assert(pairs);
+
+  msgbuf_pool_t *msgbuf_pool = forwarder_get_msgbuf_pool(forwarder);
+  ssize_t total = 0;
+
+  /* Parse all packets of the batch */
+  for (size_t i = 0; i < n; i++)
+    _forwarder_parse(forwarder, msgbuf_pool_at(msgbuf_pool, msgbuf_ids[i]),
+                     now);
+
+  /*
+   * Prefetch the packet cache buckets used by the lookups of the batch: first
+   * the prefix ones, then the suffix ones (whose location depends on the
+   * former), so that cache misses of different packets overlap.
+   */
+  for (size_t i = 0; i < n; i++) {
+    const msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_ids[i]);
+    if (_forwarder_is_local_lookup(forwarder, msgbuf))
+      pkt_cache_prefetch_prefix(forwarder->pkt_cache, msgbuf_get_name(msgbuf));
+  }
+  for (size_t i = 0; i < n; i++) {
+    const msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_ids[i]);
+    if (_forwarder_is_local_lookup(forwarder, msgbuf))
+      pkt_cache_prefetch_suffix(forwarder->pkt_cache, msgbuf_get_name(msgbuf));
+  }
+
+  /* Process packets; outgoing packets are queued until the batch is flushed */
+  for (size_t i = 0; i < n; i++) {
+    ssize_t size =
+        _forwarder_dispatch(forwarder, listener, msgbuf_ids[i], &pairs[i]);
+    if (size > 0) total += size;
+  }
+
+  return total;
+}
+
 void forwarder_log(forwarder_t *forwarder) {
   DEBUG(
       "Forwarder: received = %u (interest = %u, data = %u), dropped = %u "
@@ -1655,5 +2029,12 @@ void forwarder_log(forwarder_t *forwarder) {
 }
 
 forwarder_stats_t forwarder_get_stats(forwarder_t *forwarder) {
+  fib_cache_stats_t fib_cache_stats = fib_get_cache_stats(forwarder->fib);
+  forwarder->stats.countFibCacheHits = (uint32_t)fib_cache_stats.n_hits;
+  forwarder->stats.countFibCacheMisses = (uint32_t)fib_cache_stats.n_misses;
   return forwarder->stats;
 }
+
+hicn_light_profile_t forwarder_get_profile(const forwarder_t *forwarder) {
+  return profile_get(&forwarder->profile);
+}
@@ -36,6 +36,7 @@
 #include "msgbuf.h"
 #include "msgbuf_pool.h"
 #include "../config/configuration.h"
+#include "../config/batch.h"
 #include "subscription.h"
 
 #ifdef WITH_MAPME
@@ -76,6 +77,8 @@ configuration_t *forwarder_get_configuration(forwarder_t *forwarder);
 
 subscription_table_t *forwarder_get_subscriptions(const forwarder_t *forwarder);
 
+batch_t *forwarder_get_batch(const forwarder_t *forwarder);
+
 /**
  * Returns the set of currently active listeners
  *
@@ -108,6 +111,13 @@ void forwarder_cs_set_serve(forwarder_t *forwarder, bool val);
 
 bool forwarder_cs_get_serve(forwarder_t *forwarder);
 
+/**
+ * Sets the maximum number of entries in the PIT, overall and for each ingress
+ * connection (0 means unlimited)
+ */
+void forwarder_pit_set_size(forwarder_t *forwarder, size_t size,
+                            size_t size_per_connection);
+
 /**
  * Sets the maximum number of content objects in the content store
  *
@@ -116,6 +126,13 @@ bool forwarder_cs_get_serve(forwarder_t *forwarder);
 void forwarder_cs_set_size(forwarder_t *forwarder, size_t size);
 
 size_t forwarder_cs_get_size(forwarder_t *forwarder);
+
+/**
+ * Replaces the second tier of the content store with a new one backed by the
+ * specified file (or disables it if path is NULL), wiping its content.
+ */
+int forwarder_cs_set_disk(forwarder_t *forwarder, const char *path,
+                          size_t size);
 size_t forwarder_cs_get_num_stale_entries(forwarder_t *forwarder);
 void forwarder_cs_clear(forwarder_t *forwarder);
 
@@ -233,8 +250,27 @@ const policy_stats_mgr_t *forwarder_get_policy_stats_mgr(
     const forwarder_t *forwarder);
 #endif /* WITH_POLICY_STATS */
 
+/**
+ * @brief Transmit the packets queued on connections, according to the flush
+ * policy of the configuration: connections whose packets were queued less
+ * than the flush latency ago stay pending until a later call, or until the
+ * latency expires.
+ */
 void forwarder_flush_connections(forwarder_t *forwarder);
 
+struct workers_s;
+
+/**
+ * @brief Attach the forwarder to a set of data plane workers.
+ * @param[in] forwarder - Pointer to the forwarder.
+ * @param[in] workers - Set of workers (NULL to detach the forwarder).
+ * @param[in] worker_id - Identifier of the worker running the forwarder.
+ */
+void forwarder_set_workers(forwarder_t *forwarder, struct workers_s *workers,
+                           unsigned worker_id);
+
+unsigned forwarder_get_worker_id(const forwarder_t *forwarder);
+
 /**
  * @brief Handles a newly received packet from a listener.
  *
@@ -244,6 +280,27 @@ void forwarder_flush_connections(forwarder_t *forwarder);
 ssize_t forwarder_receive(forwarder_t *forwarder, listener_t *listener,
                           off_t msgbuf_id, address_pair_t *pair, Ticks now);
 
+/**
+ * @brief Handles a batch of newly received packets from a listener.
+ *
+ * Packets go through the pipeline stage by stage: they are all parsed first,
+ * then the packet cache buckets needed for their lookups are prefetched, and
+ * they are finally processed in order. Outgoing packets are queued on their
+ * egress connections until forwarder_flush_connections() is called.
+ *
+ * @param[in] forwarder - Pointer to the forwarder.
+ * @param[in] listener - Listener on which the packets were received.
+ * @param[in] msgbuf_ids - Identifiers of the received msgbufs.
+ * @param[in] pairs - Address pairs on which each packet was received.
+ * @param[in] n - Number of packets in the batch.
+ * @param[in] now - Reception timestamp.
+ *
+ * @return Total number of bytes processed.
+ */
+ssize_t forwarder_receive_batch(forwarder_t *forwarder, listener_t *listener,
+                                const off_t *msgbuf_ids, address_pair_t *pairs,
+                                size_t n, Ticks now);
+
 /**
  * @brief Log forwarder statistics, e.g. info about packets processed, packets
  * dropped, packets forwarded, errors while forwarding, interest and data
@@ -255,4 +312,13 @@ void forwarder_log(forwarder_t *forwarder);
 
 forwarder_stats_t forwarder_get_stats(forwarder_t *forwarder);
 
+/**
+ * @brief Returns the receive path profiling data (per-stage cycle histograms
+ * and packet cache verdict counters). Everything but the counter frequency is
+ * left to zero unless hicn-light is built with WITH_PROFILING.
+ *
+ * @param forwarder Pointer to the forwarder data structure to use
+ */
+hicn_light_profile_t forwarder_get_profile(const forwarder_t *forwarder);
+
 #endif  // HICNLIGHT_FORWARDER_H
@@ -87,6 +87,8 @@ int listener_initialize(listener_t *listener, face_type_t type,
 
   face_protocol_t face_protocol = get_protocol(listener->type);
   if (face_protocol == FACE_PROTOCOL_UNKNOWN) goto ERR_VFT;
+  /* Some face types are only available on some platforms or builds */
+  if (!listener_vft[face_protocol]) goto ERR_VFT;
 
   listener->data = malloc(listener_vft[face_protocol]->data_size);
   if (!listener->data) goto ERR_DATA;
@@ -199,6 +201,13 @@ unsigned listener_create_connection(listener_t *listener,
     case FACE_TYPE_TCP_LISTENER:
       connection_type = FACE_TYPE_TCP;
       break;
+    case FACE_TYPE_XDP_LISTENER:
+      connection_type = FACE_TYPE_XDP;
+      break;
+    /* Shared memory connections are created upon accept (see io/shm.c) */
+    case FACE_TYPE_SHM_LISTENER:
+    case FACE_TYPE_SHM:
+    case FACE_TYPE_XDP:
     case FACE_TYPE_HICN:
     case FACE_TYPE_HICN_LISTENER:
     case FACE_TYPE_UDP:
@@ -222,6 +231,20 @@ unsigned listener_create_connection(listener_t *listener,
 #else
   int fd = 0;  // means listener->fd;
 #endif
+  return listener_add_connection(listener, connection_type, connection_name,
+                                 pair, fd);
+}
+
+/*
+ * Common part of connection creation, for listeners that have set up the
+ * connection socket themselves (0 to share the one of the listener).
+ */
+unsigned listener_add_connection(listener_t *listener, face_type_t type,
+                                 const char *connection_name,
+                                 const address_pair_t *pair, int fd) {
+  assert(listener);
+  assert(pair);
+
   bool local = address_is_local(address_pair_get_local(pair));
 
   connection_table_t *table =
@@ -231,7 +254,7 @@ unsigned listener_create_connection(listener_t *listener,
   unsigned connection_id =
       (unsigned int)connection_table_get_connection_id(table, connection);
 
-  int rc = connection_initialize(connection, connection_type, connection_name,
+  int rc = connection_initialize(connection, type, connection_name,
                                  listener->interface_name, fd, pair, local,
                                  connection_id, listener);
   if (rc < 0) {
@@ -276,8 +299,8 @@ ssize_t listener_read_single(listener_t *listener, int fd,
 
   // Preapare the msgbuf
   msgbuf_t *msgbuf = NULL;
-  off_t msgbuf_id = msgbuf_pool_get(msgbuf_pool, &msgbuf);
-  if (!msgbuf_id_is_valid(msgbuf_id)) return -1;
+  if (msgbuf_pool_getn(msgbuf_pool, &msgbuf, 1) < 0) return -1;
+  off_t msgbuf_id = msgbuf_pool_get_id(msgbuf_pool, msgbuf);
 
   // Prepare the address pair
   address_pair_t pair;
@@ -292,6 +315,9 @@ ssize_t listener_read_single(listener_t *listener, int fd,
     return -1;
   }
 
+  // The packet is kept in the receive buffer if it cannot be moved
+  msgbuf_pool_fitn(msgbuf_pool, &msgbuf, &msgbuf_id, 1);
+
   msgbuf_pool_acquire(msgbuf);
   msgbuf_set_connection_id(msgbuf, connection_id);
 
@@ -352,6 +378,10 @@ ssize_t listener_read_batch(listener_t *listener, int fd,
     num_msg_received = listener_vft[get_protocol(listener->type)]->read_batch(
         fd, msgbufs, address_remote, MAX_MSG);
 
+    // Move small packets out of the receive buffers, which are then reused
+    if (num_msg_received > 0)
+      msgbuf_pool_fitn(msgbuf_pool, msgbufs, msgbuf_ids, num_msg_received);
+
     for (int i = 0; i < MAX_MSG; i++) {
       // Release unused msg buffers
       if (i >= num_msg_received) {
@@ -367,13 +397,9 @@ ssize_t listener_read_batch(listener_t *listener, int fd,
     if (num_msg_received < 0) break;
     TRACE("[listener_read_batch] batch size = %d", num_msg_received);
 
-    for (unsigned i = 0; i < num_msg_received; i++) {
-      size_t processed_bytes = forwarder_receive(
-          forwarder, listener, msgbuf_ids[i], &pair[i], ticks_now());
-      forwarder_log(listener->forwarder);
-
-      total_processed_bytes += processed_bytes;
-    }
+    total_processed_bytes += forwarder_receive_batch(
+        forwarder, listener, msgbuf_ids, pair, num_msg_received, ticks_now());
+    forwarder_log(listener->forwarder);
   } while (num_msg_received ==
            MAX_MSG); /* backpressure based on queue size ? */
 
@@ -408,6 +434,9 @@ ssize_t listener_read_callback(listener_t *listener, int fd,
    */
   // assert(fd == listener->fd);
 
+  const listener_ops_t *ops = listener_vft[get_protocol(listener->type)];
+  if (fd == listener->fd && ops->accept) return ops->accept(listener);
+
   if (listener_vft[get_protocol(listener->type)]->read_batch)
     return listener_read_batch(listener, fd, connection_id);
 
@@ -422,4 +451,14 @@ void listener_setup_local(forwarder_t *forwarder, uint16_t port) {
   address_t localhost_ipv6_addr = ADDRESS6_LOCALHOST(port);
   listener_create(FACE_TYPE_UDP_LISTENER, &localhost_ipv6_addr, "lo", "lo_udp6",
                   forwarder);
+
+#ifdef __linux__
+  /*
+   * The shared memory listener is bound to a name which cannot be shared, it
+   * is only created for the first worker.
+   */
+  if (forwarder_get_worker_id(forwarder) == 0)
+    listener_create(FACE_TYPE_SHM_LISTENER, &localhost_ipv4_addr, "lo",
+                    "lo_shm", forwarder);
+#endif /* __linux__ */
 }
@@ -110,6 +110,17 @@ int listener_get_socket(const listener_t *listener, const address_t *local,
 unsigned listener_create_connection(listener_t *listener, const char *name,
                                     const address_pair_t *pair);
 
+/**
+ * @brief Create a connection on a socket set up by the listener itself.
+ *
+ * @param[in] fd - Socket of the connection, or 0 to use the listener one.
+ *
+ * @return The identifier of the connection, or CONNECTION_ID_UNDEFINED.
+ */
+unsigned listener_add_connection(listener_t *listener, face_type_t type,
+                                 const char *name, const address_pair_t *pair,
+                                 int fd);
+
 void listener_setup_local(struct forwarder_s *forwarder, uint16_t port);
 
 void listener_process_packet(const listener_t *listener, const uint8_t *packet,
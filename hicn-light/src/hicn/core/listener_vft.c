@@ -22,13 +22,21 @@
 
 #ifdef __linux__
 extern listener_ops_t listener_hicn;
+extern listener_ops_t listener_shm;
+#endif
+#if defined(__linux__) && defined(WITH_AF_XDP)
+extern listener_ops_t listener_xdp;
 #endif
 extern listener_ops_t listener_tcp;
 extern listener_ops_t listener_udp;
 
-const listener_ops_t* listener_vft[] = {
+const listener_ops_t* listener_vft[FACE_PROTOCOL_UNKNOWN] = {
 #ifdef __linux__
     [FACE_PROTOCOL_HICN] = &listener_hicn,
+    [FACE_PROTOCOL_SHM] = &listener_shm,
+#endif
+#if defined(__linux__) && defined(WITH_AF_XDP)
+    [FACE_PROTOCOL_XDP] = &listener_xdp,
 #endif
 
     [FACE_PROTOCOL_TCP] = &listener_tcp,
@@ -39,6 +39,8 @@ typedef struct {
   ssize_t (*read_single)(int fd, msgbuf_t* msgbuf, address_t* address);
   ssize_t (*read_batch)(int fd, msgbuf_t** msgbuf, address_t** address,
                         size_t len);
+  /* Optional, for listeners with connection-oriented sockets */
+  ssize_t (*accept)(listener_t* listener);
   size_t data_size;
 } listener_ops_t;
 
@@ -27,13 +27,15 @@ int msgbuf_initialize(msgbuf_t *msgbuf) {
    * manipulate
    */
   hicn_packet_buffer_t *pkbuf = msgbuf_get_pkbuf(msgbuf);
-  hicn_packet_set_buffer(pkbuf, msgbuf->packet, MTU, 0);
+  hicn_packet_set_buffer(pkbuf, msgbuf->packet,
+                         msgbuf_get_buffer_size(msgbuf), 0);
   hicn_packet_init_header(pkbuf, 0);
   return 0;
 }
 
 int msgbuf_initialize_from_packet(msgbuf_t *msgbuf) {
-  hicn_packet_set_buffer(msgbuf_get_pkbuf(msgbuf), msgbuf->packet, MTU,
+  hicn_packet_set_buffer(msgbuf_get_pkbuf(msgbuf), msgbuf->packet,
+                         msgbuf_get_buffer_size(msgbuf),
                          msgbuf_get_len(msgbuf));
   return 0;
 }
@@ -29,6 +29,58 @@
 #define MTU 1500
 #define INVALID_MSGBUF_ID ~0ul
 
+/*
+ * Size classes of the packet buffers: NAME, SIZE (bytes) and the ratio between
+ * the initial size of the msgbuf pool and the initial number of buffers of the
+ * class. Packets are stored in the smallest class they fit in: interests in
+ * the small one, Ethernet frames in the default one, and the jumbo class is
+ * only used on links configured for 9000-byte frames. The default class comes
+ * first so that the ids of its msgbufs are plain pool indices.
+ */
+#define foreach_msgbuf_class \
+  _(DEFAULT, 2048, 1)        \
+  _(SMALL, 256, 1)           \
+  _(JUMBO, 9216, 8)
+
+typedef enum {
+#define _(NAME, SIZE, RATIO) MSGBUF_CLASS_##NAME,
+  foreach_msgbuf_class
+#undef _
+  MSGBUF_CLASS_N,
+} msgbuf_class_t;
+
+/* Largest packet a msgbuf can hold */
+#define MSGBUF_MAX_SIZE 9216
+
+static inline size_t msgbuf_class_get_size(msgbuf_class_t size_class) {
+  switch (size_class) {
+#define _(NAME, SIZE, RATIO) \
+  case MSGBUF_CLASS_##NAME:  \
+    return SIZE;
+    foreach_msgbuf_class
+#undef _
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Return the smallest class holding packets of the given length, or
+ * MSGBUF_CLASS_N if the packet is too large for any class.
+ */
+static inline msgbuf_class_t msgbuf_class_fit(size_t len) {
+  msgbuf_class_t fit = MSGBUF_CLASS_N;
+  size_t fit_size = MSGBUF_MAX_SIZE + 1;
+  for (unsigned i = 0; i < MSGBUF_CLASS_N; i++) {
+    size_t size = msgbuf_class_get_size((msgbuf_class_t)i);
+    if (len <= size && size < fit_size) {
+      fit = (msgbuf_class_t)i;
+      fit_size = size;
+    }
+  }
+  return fit;
+}
+
 #define msgbuf_id_is_valid(msgbuf_id) \
   ((unsigned long)msgbuf_id != INVALID_MSGBUF_ID)
 
@@ -38,6 +90,7 @@ typedef struct {
   Ticks recv_ts;           // timestamp
   unsigned refs;           // refcount
   unsigned path_label;     // XXX what is this ?
+  msgbuf_class_t size_class;
 
   // XXX Cache storage
   union {
@@ -51,7 +104,8 @@ typedef struct {
       command_type_t type;
     } command;
   };
-  uint8_t packet[MTU];
+  /* Storage of msgbuf_class_get_size(size_class) bytes, see msgbuf_pool.h */
+  uint8_t packet[];
 } msgbuf_t;
 
 int msgbuf_initialize(msgbuf_t *msgbuf);
@@ -78,6 +132,7 @@ static inline const hicn_name_t *msgbuf_get_name(const msgbuf_t *msgbuf) {
 #define msgbuf_get_connection_id(M) ((M)->connection_id)
 #define msgbuf_set_connection_id(M, ID) (M)->connection_id = (ID)
 #define msgbuf_get_packet(M) ((M)->packet)
+#define msgbuf_get_buffer_size(M) msgbuf_class_get_size((M)->size_class)
 #define msgbuf_get_command_type(M) ((M)->command.type)
 #if WITH_WLDR
 #define msgbuf_has_wldr(M) (messageHandler_HasWldr((M)->packet))
@@ -22,46 +22,126 @@
 #include <hicn/util/log.h>
 #include "msgbuf_pool.h"
 
+/* The class of a msgbuf is stored in the upper bits of its id */
+#define MSGBUF_ID_CLASS_SHIFT 56
+#define MSGBUF_ID_INDEX_MASK ((1ull << MSGBUF_ID_CLASS_SHIFT) - 1)
+
+#define msgbuf_id_make(size_class, index) \
+  ((off_t)(((uint64_t)(size_class) << MSGBUF_ID_CLASS_SHIFT) | (index)))
+#define msgbuf_id_get_class(id) \
+  ((msgbuf_class_t)((uint64_t)(id) >> MSGBUF_ID_CLASS_SHIFT))
+#define msgbuf_id_get_index(id) ((uint64_t)(id)&MSGBUF_ID_INDEX_MASK)
+
+/*
+ * Pool elements hold the msgbuf metadata followed by the packet, and are
+ * rounded to a multiple of the cache line size.
+ */
+#define MSGBUF_ELT_ALIGN 64
+
+static inline size_t msgbuf_class_get_elt_size(msgbuf_class_t size_class) {
+  return (sizeof(msgbuf_t) + msgbuf_class_get_size(size_class) +
+          MSGBUF_ELT_ALIGN - 1) &
+         ~(size_t)(MSGBUF_ELT_ALIGN - 1);
+}
+
+static inline size_t msgbuf_class_get_ratio(msgbuf_class_t size_class) {
+  switch (size_class) {
+#define _(NAME, SIZE, RATIO) \
+  case MSGBUF_CLASS_##NAME:  \
+    return RATIO;
+    foreach_msgbuf_class
+#undef _
+    default:
+      return 1;
+  }
+}
+
 msgbuf_pool_t *_msgbuf_pool_create(size_t init_size, size_t max_size) {
   msgbuf_pool_t *msgbuf_pool = malloc(sizeof(msgbuf_pool_t));
+  if (!msgbuf_pool) goto ERR_MALLOC;
 
   if (init_size == 0) init_size = PACKET_POOL_DEFAULT_INIT_SIZE;
 
-  pool_init(msgbuf_pool->buffers, init_size, 0);
+  for (unsigned i = 0; i < MSGBUF_CLASS_N; i++) {
+    size_t class_init_size = init_size / msgbuf_class_get_ratio(i);
+    if (class_init_size == 0) class_init_size = 1;
+
+    _pool_init(&msgbuf_pool->buffers[i], msgbuf_class_get_elt_size(i),
+               class_init_size, max_size);
+    if (!msgbuf_pool->buffers[i]) {
+      for (unsigned j = 0; j < i; j++) _pool_free(&msgbuf_pool->buffers[j]);
+      goto ERR_POOL;
+    }
+  }
+  msgbuf_pool->rx_class = MSGBUF_CLASS_DEFAULT;
 
   return msgbuf_pool;
+
+ERR_POOL:
+  free(msgbuf_pool);
+ERR_MALLOC:
+  return NULL;
 }
 
 void msgbuf_pool_free(msgbuf_pool_t *msgbuf_pool) {
-  pool_free(msgbuf_pool->buffers);
+  for (unsigned i = 0; i < MSGBUF_CLASS_N; i++)
+    _pool_free(&msgbuf_pool->buffers[i]);
   free(msgbuf_pool);
 }
 
-off_t msgbuf_pool_get(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf) {
-  off_t id = pool_get(msgbuf_pool->buffers, *msgbuf);
+void msgbuf_pool_set_rx_class(msgbuf_pool_t *msgbuf_pool,
+                              msgbuf_class_t size_class) {
+  assert(size_class < MSGBUF_CLASS_N);
+  msgbuf_pool->rx_class = size_class;
+}
+
+/*
+ * Make sure n msgbufs of a class can be taken from the pool without resizing
+ * it, as a resize invalidates the pointers to the msgbufs of the class.
+ */
+static int msgbuf_pool_reserve(msgbuf_pool_t *msgbuf_pool,
+                               msgbuf_class_t size_class, size_t n) {
+  void **pool = &msgbuf_pool->buffers[size_class];
+
+  while (pool_get_free_indices_size(*pool) < n) {
+    pool_hdr_t *ph = pool_hdr(*pool);
+    if (ph->max_size && ph->alloc_size * 2 > ph->max_size) return -1;
+    _pool_resize(pool, msgbuf_class_get_elt_size(size_class));
+    if (!*pool) return -1;
+  }
+  return 0;
+}
+
+off_t _msgbuf_pool_get(msgbuf_pool_t *msgbuf_pool, msgbuf_class_t size_class,
+                       msgbuf_t **msgbuf) {
+  assert(size_class < MSGBUF_CLASS_N);
+  if (msgbuf_pool_reserve(msgbuf_pool, size_class, 1) < 0)
+    return INVALID_MSGBUF_ID;
+
+  off_t index = _pool_get(&msgbuf_pool->buffers[size_class], (void **)msgbuf,
+                          msgbuf_class_get_elt_size(size_class));
+  (*msgbuf)->size_class = size_class;
   (*msgbuf)->refs = 0;
-  return id;
+  return msgbuf_id_make(size_class, index);
 }
 
 void msgbuf_pool_put(msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf) {
-  pool_put(msgbuf_pool->buffers, msgbuf);
+  msgbuf_class_t size_class = msgbuf->size_class;
+  _pool_put(&msgbuf_pool->buffers[size_class], (void **)&msgbuf,
+            msgbuf_class_get_elt_size(size_class));
 }
 
 int msgbuf_pool_getn(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf, size_t n) {
   // CAVEAT: Resize at the beginning otherwise the resize can be
   // triggered by an intermediate msgbuf_pool_put, making the
   // buffers previously retrieved invalid
-  uint64_t remaining_pool_space =
-      pool_get_free_indices_size(msgbuf_pool->buffers);
-  while (remaining_pool_space < n) {
-    _pool_resize((void **)&(msgbuf_pool->buffers), sizeof(msgbuf_t));
-
-    remaining_pool_space = pool_get_free_indices_size(msgbuf_pool->buffers);
-  }
+  if (msgbuf_pool_reserve(msgbuf_pool, msgbuf_pool->rx_class, n) < 0)
+    return -1;
 
   for (unsigned i = 0; i < n; i++) {
     // If not able to get the msgbuf
-    if (msgbuf_pool_get(msgbuf_pool, &msgbuf[i]) < 0) {
+    if (!msgbuf_id_is_valid(
+            _msgbuf_pool_get(msgbuf_pool, msgbuf_pool->rx_class, &msgbuf[i]))) {
       // Release all the msgbufs retrieved so far
       for (unsigned j = 0; j < i; j++) {
         msgbuf_pool_put(msgbuf_pool, msgbuf[j]);
@@ -72,13 +152,57 @@ int msgbuf_pool_getn(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf, size_t n) {
   return 0;
 }
 
+int msgbuf_pool_fitn(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf,
+                     off_t *msgbuf_ids, size_t n) {
+  size_t count[MSGBUF_CLASS_N] = {0};
+
+  for (unsigned i = 0; i < n; i++) {
+    assert(msgbuf_get_len(msgbuf[i]) <= msgbuf_get_buffer_size(msgbuf[i]));
+    msgbuf_class_t size_class = msgbuf_class_fit(msgbuf_get_len(msgbuf[i]));
+    if (size_class != msgbuf[i]->size_class) count[size_class]++;
+  }
+
+  /*
+   * Only classes smaller than the ones of the msgbufs are reserved, so that
+   * the msgbufs remain valid, as do the copies made so far
+   */
+  for (unsigned i = 0; i < MSGBUF_CLASS_N; i++)
+    if (count[i] > 0 && msgbuf_pool_reserve(msgbuf_pool, i, count[i]) < 0)
+      return -1;
+
+  for (unsigned i = 0; i < n; i++) {
+    size_t len = msgbuf_get_len(msgbuf[i]);
+    msgbuf_class_t size_class = msgbuf_class_fit(len);
+    if (size_class == msgbuf[i]->size_class) continue;
+
+    msgbuf_t *new_msgbuf;
+    off_t new_msgbuf_id =
+        _msgbuf_pool_get(msgbuf_pool, size_class, &new_msgbuf);
+    memcpy(new_msgbuf, msgbuf[i], sizeof(msgbuf_t) + len);
+    new_msgbuf->size_class = size_class;
+
+    msgbuf_pool_put(msgbuf_pool, msgbuf[i]);
+    msgbuf[i] = new_msgbuf;
+    msgbuf_ids[i] = new_msgbuf_id;
+  }
+  return 0;
+}
+
 off_t msgbuf_pool_get_id(msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf) {
-  return msgbuf - msgbuf_pool->buffers;
+  msgbuf_class_t size_class = msgbuf->size_class;
+  size_t offset =
+      (uint8_t *)msgbuf - (uint8_t *)msgbuf_pool->buffers[size_class];
+  return msgbuf_id_make(size_class,
+                        offset / msgbuf_class_get_elt_size(size_class));
 }
 
 msgbuf_t *msgbuf_pool_at(const msgbuf_pool_t *msgbuf_pool, off_t id) {
   assert(msgbuf_id_is_valid(id));
-  return msgbuf_pool->buffers + id;
+  msgbuf_class_t size_class = msgbuf_id_get_class(id);
+  assert(size_class < MSGBUF_CLASS_N);
+  return (msgbuf_t *)((uint8_t *)msgbuf_pool->buffers[size_class] +
+                      msgbuf_id_get_index(id) *
+                          msgbuf_class_get_elt_size(size_class));
 }
 
 void msgbuf_pool_acquire(msgbuf_t *msgbuf) { msgbuf->refs++; };
@@ -115,9 +239,16 @@ void msgbuf_pool_release(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf_ptr) {
 
 off_t msgbuf_pool_clone(msgbuf_pool_t *msgbuf_pool, msgbuf_t **new_msgbuf,
                         off_t orginal_msg_id) {
+  // Take the new msgbuf first, as it might resize the pool of the original one
+  msgbuf_class_t size_class = msgbuf_id_get_class(orginal_msg_id);
+  off_t offset = _msgbuf_pool_get(msgbuf_pool, size_class, new_msgbuf);
+  if (!msgbuf_id_is_valid(offset)) return offset;
+
   msgbuf_t *original_msgbuf = msgbuf_pool_at(msgbuf_pool, orginal_msg_id);
-  off_t offset = pool_get(msgbuf_pool->buffers, *new_msgbuf);
-  memcpy(*new_msgbuf, original_msgbuf, sizeof(msgbuf_t));
+  size_t len = msgbuf_get_len(original_msgbuf);
+  if (len > msgbuf_get_buffer_size(original_msgbuf))
+    len = msgbuf_get_buffer_size(original_msgbuf);
+  memcpy(*new_msgbuf, original_msgbuf, sizeof(msgbuf_t) + len);
   (*new_msgbuf)->refs = 0;
   return offset;
 }
@@ -33,6 +33,13 @@
  * It might even be better to store references to msgbuf's as they might hold
  * additional information of interest about the packet... a bit like a skbuff in
  * linux. Is this relevant for the packet cache ?
+ *
+ * Buffers are split into size classes (see foreach_msgbuf_class), each stored
+ * in its own pool. Packets are received into buffers of the receive class,
+ * large enough for any packet expected on the links, and then moved to the
+ * smallest class they fit in (see msgbuf_pool_fitn), so that small interests
+ * do not hold a full frame worth of memory while they sit in the PIT. The
+ * class is encoded in the upper bits of msgbuf ids.
  */
 
 #ifndef HICNLIGHT_MSGBUF_POOL_H
@@ -44,7 +51,10 @@
 #define PACKET_POOL_DEFAULT_INIT_SIZE 1024
 
 typedef struct {
-  msgbuf_t *buffers;
+  /* One pool per size class */
+  void *buffers[MSGBUF_CLASS_N];
+  /* Class of the buffers used to receive packets */
+  msgbuf_class_t rx_class;
 } msgbuf_pool_t;
 
 /**
@@ -57,6 +67,8 @@ typedef struct {
  * @note
  *  - 0 for init size means a default value (of 1024)
  *  - 0 for max_size means no limit
+ *  - both sizes apply to each size class, and the initial size is further
+ *    divided by the ratio of the class
  */
 msgbuf_pool_t *_msgbuf_pool_create(size_t init_size, size_t max_size);
 
@@ -74,6 +86,28 @@ msgbuf_pool_t *_msgbuf_pool_create(size_t init_size, size_t max_size);
  */
 void msgbuf_pool_free(msgbuf_pool_t *msgbuf_pool);
 
+/**
+ * @brief Set the size class of the buffers used to receive packets.
+ *
+ * @param[in] msgbuf_pool Pointer to the msgbuf pool data structure to use.
+ * @param[in] size_class Class of the buffers returned by msgbuf_pool_getn.
+ */
+void msgbuf_pool_set_rx_class(msgbuf_pool_t *msgbuf_pool,
+                              msgbuf_class_t size_class);
+
+/**
+ * @brief Get a free msgbuf of a given size class from the msgbuf pool data
+ * structure (helper).
+ *
+ * @param[in] msgbuf_pool Pointer to the msgbuf pool data structure to use.
+ * @param[in] size_class Size class of the msgbuf.
+ * @param[in, out] msgbuf Empty msgbuf that will be used to return the
+ * allocated one from the msgbuf pool.
+ * @return off_t ID of the msgbuf requested.
+ */
+off_t _msgbuf_pool_get(msgbuf_pool_t *msgbuf_pool, msgbuf_class_t size_class,
+                       msgbuf_t **msgbuf);
+
 /**
  * @brief Get a free msgbuf from the msgbuf pool data structure.
  *
@@ -82,7 +116,8 @@ void msgbuf_pool_free(msgbuf_pool_t *msgbuf_pool);
  * allocated one from the msgbuf pool.
  * @return off_t ID of the msgbuf requested.
  */
-off_t msgbuf_pool_get(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf);
+#define msgbuf_pool_get(msgbuf_pool, msgbuf) \
+  _msgbuf_pool_get((msgbuf_pool), MSGBUF_CLASS_DEFAULT, (msgbuf))
 
 /**
  * @brief Release a msgbuf previously obtained, making it available to the
@@ -94,7 +129,8 @@ off_t msgbuf_pool_get(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf);
 void msgbuf_pool_put(msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf);
 
 /**
- * @brief Get multiple free msgbufs from the msgbuf pool data structure.
+ * @brief Get multiple free msgbufs of the receive class from the msgbuf pool
+ * data structure.
  *
  * @param[in] msgbuf_pool Pointer to the msgbuf pool data structure to use.
  * @param[in, out] msgbuf Pointer to the first empty msgbuf that will be used to
@@ -105,6 +141,23 @@ void msgbuf_pool_put(msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf);
  */
 int msgbuf_pool_getn(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf, size_t n);
 
+/**
+ * @brief Move received packets to the smallest size class they fit in.
+ *
+ * The msgbufs are expected to hold a packet of length msgbuf_get_len, but
+ * not to have been acquired yet. Those moved are put back into the pool, and
+ * replaced by their copy in both arrays.
+ *
+ * @param[in] msgbuf_pool Pointer to the msgbuf pool data structure to use.
+ * @param[in, out] msgbuf Array of msgbufs to fit.
+ * @param[in, out] msgbuf_ids IDs of the msgbufs to fit.
+ * @param[in] n Number of msgbufs in the arrays.
+ * @retval 0 Success.
+ * @retval -1 Error, in which case the msgbufs are left untouched.
+ */
+int msgbuf_pool_fitn(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf,
+                     off_t *msgbuf_ids, size_t n);
+
 /**
  * @brief Get the ID corresponding to the msgbuf requested.
  *
@@ -142,8 +195,8 @@ void msgbuf_pool_acquire(msgbuf_t *msgbuf);
 void msgbuf_pool_release(msgbuf_pool_t *msgbuf_pool, msgbuf_t **msgbuf_ptr);
 
 /**
- * @brief Copy the original msgbuf in new msgbuf taken from the pool. The ref
- * count on new msgbuf is set to 0
+ * @brief Copy the original msgbuf in new msgbuf of the same size class taken
+ * from the pool. The ref count on new msgbuf is set to 0
  *
  * @param[in] msgbuf_pool Pointer to the msgbuf pool data structure to use
  * @param[in,out] new__msgbuf Pointer that holds the replicatate msgbuf
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file name_index.c
+ * \brief Implementation of the flat name index
+ *
+ * Tags follow the Swiss table conventions: a full slot holds the 7 most
+ * significant bits of the hash (MSB cleared), while empty and deleted slots
+ * have their MSB set. Unused tag lanes (past NAME_INDEX_BUCKET_SLOTS) are
+ * permanently set to TAG_UNUSED and masked out.
+ *
+ * Buckets are probed with a triangular sequence, which visits all buckets
+ * since their number is a power of 2. A lookup stops at the first bucket
+ * having an empty slot: this is correct because a deleted slot is only turned
+ * into an empty one when its bucket already has an empty slot, so no element
+ * can have been inserted past it.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "name_index.h"
+
+#define TAG_EMPTY 0x80
+#define TAG_DELETED 0xfe
+#define TAG_UNUSED 0xff
+
+#define CACHE_LINE_SIZE 64
+
+#define SLOTS_MASK ((1u << NAME_INDEX_BUCKET_SLOTS) - 1)
+
+/* Maximum load factor (including deleted slots) is 7/8 */
+#define max_elts(n_buckets) ((n_buckets)*NAME_INDEX_BUCKET_SLOTS * 7 / 8)
+
+static_assert(sizeof(name_index_bucket_t) == CACHE_LINE_SIZE,
+              "Buckets are expected to fit in a cache line");
+
+/******************************************************************************
+ * Tag matching (helpers)
+ ******************************************************************************/
+
+/* Returns a bitmask of the slots whose tag equals the specified one */
+static inline unsigned _bucket_match(const name_index_bucket_t *bucket,
+                                     uint8_t tag) {
+#ifdef __SSE2__
+  __m128i tags = _mm_load_si128((const __m128i *)bucket->tags);
+  __m128i cmp = _mm_cmpeq_epi8(tags, _mm_set1_epi8((char)tag));
+  return (unsigned)_mm_movemask_epi8(cmp) & SLOTS_MASK;
+#else
+  unsigned mask = 0;
+  for (unsigned i = 0; i < NAME_INDEX_BUCKET_SLOTS; i++)
+    if (bucket->tags[i] == tag) mask |= 1u << i;
+  return mask;
+#endif
+}
+
+/* Returns a bitmask of the slots which are either empty or deleted */
+static inline unsigned _bucket_match_free(const name_index_bucket_t *bucket) {
+#ifdef __SSE2__
+  __m128i tags = _mm_load_si128((const __m128i *)bucket->tags);
+  return (unsigned)_mm_movemask_epi8(tags) & SLOTS_MASK;
+#else
+  unsigned mask = 0;
+  for (unsigned i = 0; i < NAME_INDEX_BUCKET_SLOTS; i++)
+    if (bucket->tags[i] & 0x80) mask |= 1u << i;
+  return mask;
+#endif
+}
+
+#define _bucket_match_empty(bucket) _bucket_match((bucket), TAG_EMPTY)
+
+#define _first_slot(mask) ((unsigned)__builtin_ctz(mask))
+
+/******************************************************************************
+ * Hashing and probing (helpers)
+ ******************************************************************************/
+
+/* Names are hashed with the fixed-width hash of libhicn */
+#define _name_hash(name) hicn_name_hash(name)
+
+static inline bool _name_equals(const hicn_name_t *n1, const hicn_name_t *n2) {
+  return (n1->suffix == n2->suffix) &&
+         (memcmp(&n1->prefix, &n2->prefix, sizeof(n1->prefix)) == 0);
+}
+
+#define _hash_tag(hash) ((uint8_t)((hash) >> 25))
+
+#define _probe_start(index, hash) ((size_t)(hash) & ((index)->n_buckets - 1))
+
+#define _probe_next(index, i, step) \
+  (((i) + (step)) & ((index)->n_buckets - 1))
+
+static int _name_index_alloc(name_index_t *index, size_t n_buckets) {
+  void *mem = malloc(n_buckets * sizeof(name_index_bucket_t) + CACHE_LINE_SIZE);
+  if (!mem) return -1;
+
+  name_index_bucket_t *buckets =
+      (name_index_bucket_t *)(((uintptr_t)mem + CACHE_LINE_SIZE - 1) &
+                              ~(uintptr_t)(CACHE_LINE_SIZE - 1));
+  for (size_t i = 0; i < n_buckets; i++) {
+    memset(buckets[i].tags, TAG_EMPTY, NAME_INDEX_BUCKET_SLOTS);
+    memset(buckets[i].tags + NAME_INDEX_BUCKET_SLOTS, TAG_UNUSED,
+           sizeof(buckets[i].tags) - NAME_INDEX_BUCKET_SLOTS);
+  }
+
+  index->buckets_mem = mem;
+  index->buckets = buckets;
+  index->n_buckets = n_buckets;
+  index->n_elts = 0;
+  index->n_deleted = 0;
+  return 0;
+}
+
+/*
+ * Insert an element known not to be present in the index, using the first free
+ * slot of its probe sequence.
+ */
+static void _name_index_insert(name_index_t *index, uint32_t hash,
+                               unsigned id) {
+  size_t i = _probe_start(index, hash);
+  for (size_t step = 1;; step++) {
+    name_index_bucket_t *bucket = &index->buckets[i];
+    unsigned mask = _bucket_match_free(bucket);
+    if (mask) {
+      unsigned slot = _first_slot(mask);
+      if (bucket->tags[slot] == TAG_DELETED) index->n_deleted--;
+      bucket->tags[slot] = _hash_tag(hash);
+      bucket->ids[slot] = id;
+      index->n_elts++;
+      return;
+    }
+    i = _probe_next(index, i, step);
+  }
+}
+
+/*
+ * Rebuild the index with the specified number of buckets, which also purges
+ * deleted slots.
+ */
+static int _name_index_resize(name_index_t *index, size_t n_buckets) {
+  name_index_bucket_t *old_buckets = index->buckets;
+  void *old_mem = index->buckets_mem;
+  size_t old_n_buckets = index->n_buckets;
+
+  if (_name_index_alloc(index, n_buckets) < 0) return -1;
+
+  for (size_t i = 0; i < old_n_buckets; i++) {
+    name_index_bucket_t *bucket = &old_buckets[i];
+    for (unsigned slot = 0; slot < NAME_INDEX_BUCKET_SLOTS; slot++) {
+      if (bucket->tags[slot] & 0x80) continue;
+      unsigned id = bucket->ids[slot];
+      const hicn_name_t *name = index->get_name(index->context, id);
+      _name_index_insert(index, _name_hash(name), id);
+    }
+  }
+
+  free(old_mem);
+  return 0;
+}
+
+/*
+ * Returns the bucket and slot holding the specified name, or NULL if not
+ * found.
+ */
+static name_index_bucket_t *_name_index_find(const name_index_t *index,
+                                             const hicn_name_t *name,
+                                             uint32_t hash, unsigned *slot) {
+  uint8_t tag = _hash_tag(hash);
+  size_t i = _probe_start(index, hash);
+  for (size_t step = 1; step <= index->n_buckets; step++) {
+    name_index_bucket_t *bucket = &index->buckets[i];
+    unsigned mask = _bucket_match(bucket, tag);
+    while (mask) {
+      unsigned s = _first_slot(mask);
+      if (_name_equals(index->get_name(index->context, bucket->ids[s]),
+                       name)) {
+        *slot = s;
+        return bucket;
+      }
+      mask &= mask - 1;
+    }
+    if (_bucket_match_empty(bucket)) return NULL;
+    i = _probe_next(index, i, step);
+  }
+  return NULL;
+}
+
+/******************************************************************************
+ * Public API
+ ******************************************************************************/
+
+name_index_t *_name_index_create(name_index_get_name_t get_name,
+                                 const void *context, size_t n_buckets) {
+  assert(get_name);
+
+  name_index_t *index = malloc(sizeof(name_index_t));
+  if (!index) goto ERR_MALLOC;
+
+  /* Round up to a power of 2 */
+  size_t n = 1;
+  while (n < n_buckets) n <<= 1;
+
+  if (_name_index_alloc(index, n) < 0) goto ERR_ALLOC;
+
+  index->get_name = get_name;
+  index->context = context;
+
+  return index;
+
+ERR_ALLOC:
+  free(index);
+ERR_MALLOC:
+  return NULL;
+}
+
+void name_index_free(name_index_t *index) {
+  if (!index) return;
+  free(index->buckets_mem);
+  free(index);
+}
+
+unsigned name_index_get(const name_index_t *index, const hicn_name_t *name) {
+  return name_index_get_hashed(index, name, _name_hash(name));
+}
+
+unsigned name_index_get_hashed(const name_index_t *index,
+                               const hicn_name_t *name, uint32_t hash) {
+  assert(index);
+  assert(name);
+  assert(hash == _name_hash(name));
+
+  unsigned slot;
+  name_index_bucket_t *bucket = _name_index_find(index, name, hash, &slot);
+  if (!bucket) return NAME_INDEX_INVALID_ID;
+  return bucket->ids[slot];
+}
+
+int name_index_put(name_index_t *index, const hicn_name_t *name, unsigned id) {
+  assert(index);
+  assert(name);
+
+  uint32_t hash = _name_hash(name);
+
+  unsigned slot;
+  name_index_bucket_t *bucket = _name_index_find(index, name, hash, &slot);
+  if (bucket) {
+    bucket->ids[slot] = id;
+    return 0;
+  }
+
+  if (index->n_elts + index->n_deleted + 1 > max_elts(index->n_buckets)) {
+    /* Grow if needed, otherwise just purge deleted slots */
+    size_t n_buckets = index->n_buckets;
+    if (index->n_elts + 1 > max_elts(n_buckets) / 2) n_buckets <<= 1;
+    if (_name_index_resize(index, n_buckets) < 0) return -1;
+  }
+
+  _name_index_insert(index, hash, id);
+  return 0;
+}
+
+int name_index_remove(name_index_t *index, const hicn_name_t *name) {
+  assert(index);
+  assert(name);
+
+  unsigned slot;
+  name_index_bucket_t *bucket =
+      _name_index_find(index, name, _name_hash(name), &slot);
+  if (!bucket) return -1;
+
+  if (_bucket_match_empty(bucket)) {
+    bucket->tags[slot] = TAG_EMPTY;
+  } else {
+    bucket->tags[slot] = TAG_DELETED;
+    index->n_deleted++;
+  }
+  index->n_elts--;
+  return 0;
+}
+
+void name_index_prefetch(const name_index_t *index, const hicn_name_t *name) {
+  name_index_prefetch_hashed(index, _name_hash(name));
+}
+
+void name_index_prefetch_hashed(const name_index_t *index, uint32_t hash) {
+  size_t i = _probe_start(index, hash);
+  __builtin_prefetch(&index->buckets[i]);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file name_index.h
+ * @brief Flat open-addressing index of full hICN names
+ *
+ * The index maps a full name (prefix + suffix) to an unsigned identifier
+ * (typically the position of an element in a pool) with a single hash probe
+ * sequence, as opposed to the two-level prefix/suffix khash structure.
+ *
+ * The table is made of buckets of exactly one cache line. Each bucket holds
+ * NAME_INDEX_BUCKET_SLOTS identifiers together with a one-byte tag per slot
+ * (7 bits of the name hash, or an empty/deleted marker). A lookup loads the
+ * tags of a bucket and compares them all at once (with SSE2 when available),
+ * and only dereferences the candidates whose tag matches.
+ *
+ * Names are not stored in the index: the owner provides a callback returning
+ * the name associated with an identifier, so that the only memory accessed
+ * beside the bucket is the element itself, which the caller is about to use
+ * anyway.
+ */
+
+#ifndef HICNLIGHT_NAME_INDEX_H
+#define HICNLIGHT_NAME_INDEX_H
+
+#include <stddef.h>
+#include <hicn/name.h>
+
+#define NAME_INDEX_BUCKET_SLOTS 12
+#define NAME_INDEX_INVALID_ID (~0u)
+
+/* Number of buckets allocated by default */
+#define NAME_INDEX_DEFAULT_SIZE 16
+
+/**
+ * @brief Returns the name associated to an identifier stored in the index.
+ */
+typedef const hicn_name_t *(*name_index_get_name_t)(const void *context,
+                                                     unsigned id);
+
+typedef struct {
+  /* Tags, only the first NAME_INDEX_BUCKET_SLOTS are used */
+  uint8_t tags[16];
+  unsigned ids[NAME_INDEX_BUCKET_SLOTS];
+} name_index_bucket_t;
+
+typedef struct {
+  name_index_bucket_t *buckets; /* Cache line aligned */
+  void *buckets_mem;            /* Allocated memory backing buckets */
+  size_t n_buckets;             /* Always a power of 2 */
+  size_t n_elts;
+  size_t n_deleted;
+
+  name_index_get_name_t get_name;
+  const void *context;
+} name_index_t;
+
+/**
+ * @brief Create a name index (extended parameters).
+ *
+ * @param[in] get_name Callback used to retrieve the name of stored elements
+ * @param[in] context Opaque context passed to the callback
+ * @param[in] n_buckets Initial number of buckets (rounded to a power of 2)
+ *
+ * @return name_index_t* The newly created index, or NULL in case of error
+ */
+name_index_t *_name_index_create(name_index_get_name_t get_name,
+                                 const void *context, size_t n_buckets);
+
+#define name_index_create(get_name, context) \
+  _name_index_create((get_name), (context), NAME_INDEX_DEFAULT_SIZE)
+
+void name_index_free(name_index_t *index);
+
+/**
+ * @brief Retrieve the identifier associated to a name.
+ *
+ * @return The identifier, or NAME_INDEX_INVALID_ID if the name is not found
+ */
+unsigned name_index_get(const name_index_t *index, const hicn_name_t *name);
+
+/**
+ * @brief Same as name_index_get(), with the hash of the name already computed
+ * by hicn_name_hash() or hicn_name_suffix_mix().
+ */
+unsigned name_index_get_hashed(const name_index_t *index,
+                               const hicn_name_t *name, uint32_t hash);
+
+/**
+ * @brief Add a name to the index, or update the associated identifier if the
+ * name is already present.
+ *
+ * The get_name callback must return the name for the new identifier at the
+ * time of the call.
+ *
+ * @return 0 in case of success, -1 otherwise
+ */
+int name_index_put(name_index_t *index, const hicn_name_t *name, unsigned id);
+
+/**
+ * @brief Remove a name from the index.
+ *
+ * @return 0 in case of success, -1 if the name was not found
+ */
+int name_index_remove(name_index_t *index, const hicn_name_t *name);
+
+/**
+ * @brief Prefetch the first bucket probed by a lookup of the specified name.
+ */
+void name_index_prefetch(const name_index_t *index, const hicn_name_t *name);
+
+void name_index_prefetch_hashed(const name_index_t *index, uint32_t hash);
+
+#define name_index_len(index) ((index)->n_elts)
+
+#endif /* HICNLIGHT_NAME_INDEX_H */
@@ -64,10 +64,19 @@
  *
  * pkt_cache_try_aggregate_in_pit
  *
+ * pkt_cache_expire : reclaim expired entries from the timer wheel
+ *
+ * ----
+ *
+ * With PKT_CACHE_INDEX_TYPE_FLAT, the two-level structure is not used and the
+ * index operations above are performed on a name_index_t keyed on the full
+ * name of the entries.
+ *
  *
  *
  */
 
+#include "connection.h"
 #include "packet_cache.h"
 
 const char *_pkt_cache_verdict_str[] = {
@@ -206,6 +215,9 @@ unsigned _get_suffix_from_name(kh_pkt_cache_prefix_t *prefixes,
 
 void pkt_cache_save_suffixes_for_prefix(pkt_cache_t *pkt_cache,
                                         const hicn_name_prefix_t *prefix) {
+  // A single lookup is always performed with the flat index
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) return;
+
   // Cached prefix matches the current one
   if (hicn_name_prefix_equals(&pkt_cache->cached_prefix, prefix)) return;
 
@@ -229,7 +241,39 @@ void pkt_cache_reset_suffixes_for_prefix(pkt_cache_t *pkt_cache) {
  * Public API
  ******************************************************************************/
 
-pkt_cache_t *pkt_cache_create(size_t cs_size) {
+/**
+ * Return the name of an entry to the flat index (helper)
+ */
+static const hicn_name_t *_pkt_cache_entry_get_name(const void *context,
+                                                    unsigned id) {
+  const pkt_cache_t *pkt_cache = (const pkt_cache_t *)context;
+  return &pkt_cache_at(pkt_cache, id)->name;
+}
+
+/**
+ * Return the timer wheel node of an entry (helper)
+ */
+static timer_wheel_node_t *_pkt_cache_entry_get_timer(void *context,
+                                                      unsigned id) {
+  pkt_cache_t *pkt_cache = (pkt_cache_t *)context;
+  return &pkt_cache_at(pkt_cache, id)->timer;
+}
+
+/**
+ * (Re)schedule the expiry of an entry after its expire_ts has been set
+ * (helper)
+ */
+static void _pkt_cache_schedule_expiry(pkt_cache_t *pkt_cache,
+                                       pkt_cache_entry_t *entry) {
+  timer_wheel_schedule(pkt_cache->timer_wheel,
+                       (unsigned)pkt_cache_get_entry_id(pkt_cache, entry),
+                       entry->expire_ts);
+}
+
+pkt_cache_t *_pkt_cache_create(pkt_cache_index_type_t index_type,
+                               size_t cs_size) {
+  assert(PKT_CACHE_INDEX_TYPE_VALID(index_type));
+
   pkt_cache_t *pkt_cache = (pkt_cache_t *)malloc(sizeof(pkt_cache_t));
 
   pkt_cache->pit = pit_create();
@@ -237,12 +281,28 @@ pkt_cache_t *pkt_cache_create(size_t cs_size) {
   pkt_cache->cs = cs_create(cs_size);
   if (!pkt_cache->cs) return NULL;
 
+  pkt_cache->index_type = index_type;
   pkt_cache->prefix_to_suffixes = kh_init_pkt_cache_prefix();
   pkt_cache->prefix_keys = slab_create(hicn_name_prefix_t, SLAB_INIT_SIZE);
+  pkt_cache->name_index = NULL;
+  if (index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+    pkt_cache->name_index =
+        _name_index_create(_pkt_cache_entry_get_name, pkt_cache,
+                           DEFAULT_PKT_CACHE_SIZE / NAME_INDEX_BUCKET_SLOTS);
+    if (!pkt_cache->name_index) return NULL;
+  }
   pool_init(pkt_cache->entries, DEFAULT_PKT_CACHE_SIZE, 0);
 
+  pkt_cache->timer_wheel =
+      timer_wheel_create(_pkt_cache_entry_get_timer, pkt_cache, ticks_now());
+  if (!pkt_cache->timer_wheel) return NULL;
+  pkt_cache->n_pit_reclaimed = 0;
+  pkt_cache->n_cs_reclaimed = 0;
+  pkt_cache->cs_disk = NULL;
+
   pkt_cache->cached_prefix = HICN_NAME_PREFIX_EMPTY;
   pkt_cache->cached_suffixes = NULL;
+  pkt_cache->index_version = 0;
 
   return pkt_cache;
 }
@@ -253,11 +313,14 @@ void pkt_cache_free(pkt_cache_t *pkt_cache) {
   // Free prefix hash table and pool
   _prefix_map_free(pkt_cache->prefix_to_suffixes);
   slab_free(pkt_cache->prefix_keys);
+  name_index_free(pkt_cache->name_index);
+  timer_wheel_free(pkt_cache->timer_wheel);
   pool_free(pkt_cache->entries);
 
   // Free PIT and CS
   pit_free(pkt_cache->pit);
   cs_free(pkt_cache->cs);
+  cs_disk_free(pkt_cache->cs_disk);
 
   free(pkt_cache);
 }
@@ -274,6 +337,7 @@ pkt_cache_entry_t *pkt_cache_allocate(pkt_cache_t *pkt_cache) {
   pkt_cache_entry_t *entry = NULL;
   pool_get(pkt_cache->entries, entry);
   assert(entry);
+  timer_wheel_node_init(&entry->timer);
   return entry;
 }
 
@@ -286,7 +350,11 @@ void pkt_cache_add_to_index(const pkt_cache_t *pkt_cache,
    */
   const hicn_name_t *name = &entry->name;
 
-  if (pkt_cache->cached_suffixes) {
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+    int rc = name_index_put(pkt_cache->name_index, name, (unsigned)id);
+    assert(rc == 0);
+    _unused(rc);
+  } else if (pkt_cache->cached_suffixes) {
     __add_suffix(pkt_cache->cached_suffixes, hicn_name_get_suffix(name),
                  (unsigned int)id);
   } else {
@@ -301,6 +369,13 @@ void pkt_cache_add_to_index(const pkt_cache_t *pkt_cache,
  */
 void pkt_cache_remove_from_index(const pkt_cache_t *pkt_cache,
                                  const hicn_name_t *name) {
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+    int rc = name_index_remove(pkt_cache->name_index, name);
+    assert(rc == 0);
+    _unused(rc);
+    return;
+  }
+
   _remove_suffix(pkt_cache->prefix_to_suffixes, hicn_name_get_prefix(name),
                  hicn_name_get_suffix(name), pkt_cache->prefix_keys);
 
@@ -316,6 +391,22 @@ pit_t *pkt_cache_get_pit(pkt_cache_t *pkt_cache) { return pkt_cache->pit; }
 
 cs_t *pkt_cache_get_cs(pkt_cache_t *pkt_cache) { return pkt_cache->cs; }
 
+/**
+ * Return the lookup result corresponding to an entry found in the index
+ * (helper)
+ */
+static pkt_cache_lookup_t _pkt_cache_entry_get_lookup_result(
+    const pkt_cache_entry_t *entry, Ticks now) {
+  bool expired = entry->has_expire_ts && now >= entry->expire_ts;
+
+  if (entry->entry_type == PKT_CACHE_CS_TYPE)
+    return expired ? PKT_CACHE_LU_DATA_EXPIRED : PKT_CACHE_LU_DATA_NOT_EXPIRED;
+
+  // PKT_CACHE_PIT_TYPE
+  return expired ? PKT_CACHE_LU_INTEREST_EXPIRED
+                 : PKT_CACHE_LU_INTEREST_NOT_EXPIRED;
+}
+
 pkt_cache_entry_t *pkt_cache_lookup(pkt_cache_t *pkt_cache,
                                     const hicn_name_t *name,
                                     msgbuf_pool_t *msgbuf_pool,
@@ -323,7 +414,10 @@ pkt_cache_entry_t *pkt_cache_lookup(pkt_cache_t *pkt_cache,
                                     off_t *entry_id,
                                     bool is_serve_from_cs_enabled) {
   unsigned index = HICN_INVALID_SUFFIX;
-  if (pkt_cache->cached_suffixes) {
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+    index = name_index_get(pkt_cache->name_index, name);
+    if (index == NAME_INDEX_INVALID_ID) index = HICN_INVALID_SUFFIX;
+  } else if (pkt_cache->cached_suffixes) {
     index =
         __get_suffix(pkt_cache->cached_suffixes, hicn_name_get_suffix(name));
   } else {
@@ -338,25 +432,141 @@ pkt_cache_entry_t *pkt_cache_lookup(pkt_cache_t *pkt_cache,
 
   pkt_cache_entry_t *entry = pkt_cache_at(pkt_cache, index);
   assert(entry);
-  bool expired = false;
-  if (entry->has_expire_ts && ticks_now() >= entry->expire_ts) {
-    expired = true;
+  *lookup_result = _pkt_cache_entry_get_lookup_result(entry, ticks_now());
+
+  *entry_id = index;
+  return entry;
+}
+
+/**
+ * Prefetch the bucket of a khash table that would be probed first for the
+ * given hash (helper)
+ */
+#define _kh_prefetch(h, hash)                                    \
+  do {                                                           \
+    if ((h)->n_buckets == 0) break;                              \
+    khint_t __i = (khint_t)(hash) & ((h)->n_buckets - 1);        \
+    __builtin_prefetch(&(h)->flags[__i >> 4]);                   \
+    __builtin_prefetch(&(h)->keys[__i]);                         \
+    __builtin_prefetch(&(h)->vals[__i]);                         \
+  } while (0)
+
+void pkt_cache_prefetch_prefix(const pkt_cache_t *pkt_cache,
+                               const hicn_name_t *name) {
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+    name_index_prefetch(pkt_cache->name_index, name);
+    return;
   }
 
-  if (entry->entry_type == PKT_CACHE_CS_TYPE) {
-    if (expired)
-      *lookup_result = PKT_CACHE_LU_DATA_EXPIRED;
-    else
-      *lookup_result = PKT_CACHE_LU_DATA_NOT_EXPIRED;
-  } else {  // PKT_CACHE_PIT_TYPE
-    if (expired)
-      *lookup_result = PKT_CACHE_LU_INTEREST_EXPIRED;
-    else
-      *lookup_result = PKT_CACHE_LU_INTEREST_NOT_EXPIRED;
+  _kh_prefetch(pkt_cache->prefix_to_suffixes,
+               hicn_name_prefix_get_hash(hicn_name_get_prefix(name)));
+}
+
+void pkt_cache_prefetch_suffix(const pkt_cache_t *pkt_cache,
+                               const hicn_name_t *name) {
+  // Single level index, already prefetched
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) return;
+
+  /*
+   * No lookup here: only the prefix slot probed first, which has been
+   * prefetched by pkt_cache_prefetch_prefix, is read to locate the suffix
+   * table. Its key is not compared, so that a collision merely prefetches the
+   * suffixes of another prefix. The cached suffixes cannot be used either as
+   * they refer to the prefix of the last processed packet.
+   */
+  const kh_pkt_cache_prefix_t *prefixes = pkt_cache->prefix_to_suffixes;
+  if (prefixes->n_buckets == 0) return;
+  khint_t i = (khint_t)hicn_name_prefix_get_hash(hicn_name_get_prefix(name)) &
+              (prefixes->n_buckets - 1);
+  if (__ac_iseither(prefixes->flags, i)) return;
+
+  _kh_prefetch(prefixes->vals[i], hicn_name_get_suffix(name));
+}
+
+/**
+ * Account a new PIT entry to its owner connection and append it to the
+ * admission order (helper)
+ */
+static void _pkt_cache_pit_link(pkt_cache_t *pkt_cache,
+                                pkt_cache_entry_t *entry, unsigned owner) {
+  pit_t *pit = pkt_cache->pit;
+  pit_entry_t *pit_entry = &entry->u.pit_entry;
+  off_t id = pkt_cache_get_entry_id(pkt_cache, entry);
+
+  pit_entry->owner = owner;
+  pit_entry->seq = pit->next_seq++;
+  pit_entry->prev = pit->tail;
+  pit_entry->next = INVALID_ENTRY_ID;
+  if (pit->tail != INVALID_ENTRY_ID)
+    pkt_cache_entry_at(pkt_cache, pit->tail)->u.pit_entry.next = id;
+  else
+    pit->head = id;
+  pit->tail = id;
+
+  pit_on_entry_added(pit, owner);
+}
+
+/**
+ * Release a PIT entry, before it is removed or converted to a CS entry
+ * (helper)
+ */
+static void _pkt_cache_pit_unlink(pkt_cache_t *pkt_cache,
+                                  pkt_cache_entry_t *entry) {
+  pit_t *pit = pkt_cache->pit;
+  pit_entry_t *pit_entry = &entry->u.pit_entry;
+
+  if (pit_entry->prev != INVALID_ENTRY_ID)
+    pkt_cache_entry_at(pkt_cache, pit_entry->prev)->u.pit_entry.next =
+        pit_entry->next;
+  else
+    pit->head = pit_entry->next;
+
+  if (pit_entry->next != INVALID_ENTRY_ID)
+    pkt_cache_entry_at(pkt_cache, pit_entry->next)->u.pit_entry.prev =
+        pit_entry->prev;
+  else
+    pit->tail = pit_entry->prev;
+
+  pit_on_entry_removed(pit, pit_entry->owner);
+}
+
+/**
+ * Check whether an interest from the specified connection can create a new
+ * PIT entry. If the PIT is full and the policy allows it, the oldest entry is
+ * removed to make room for the new one, unless it has been admitted by the
+ * interest manifest being processed, and the strategy is notified of its
+ * timeout (helper)
+ */
+static bool _pkt_cache_pit_admit(pkt_cache_t *pkt_cache,
+                                 unsigned connection_id) {
+  pit_t *pit = pkt_cache->pit;
+
+  if (pit_is_over_quota(pit, connection_id)) {
+    pit->stats.n_quota_drops++;
+    return false;
   }
 
-  *entry_id = index;
-  return entry;
+  if (!pit_is_full(pit)) return true;
+
+  if (pit->full_policy != PIT_FULL_POLICY_REPLACE ||
+      pit->head == INVALID_ENTRY_ID)
+    goto DROP;
+
+  pkt_cache_entry_t *entry = pkt_cache_entry_at(pkt_cache, pit->head);
+  pit_entry_t *pit_entry = &entry->u.pit_entry;
+  if (pit_entry->seq >= pit->protected_seq) goto DROP;
+
+  fib_entry_t *fib_entry = pit_entry_get_fib_entry(pit_entry);
+  if (fib_entry)
+    fib_entry_on_timeout(fib_entry, pit_entry_get_egress(pit_entry));
+
+  pkt_cache_pit_remove_entry(pkt_cache, entry);
+  pit->stats.n_replacements++;
+  return true;
+
+DROP:
+  pit->stats.n_full_drops++;
+  return false;
 }
 
 void pkt_cache_cs_remove_entry(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
@@ -369,14 +579,15 @@ void pkt_cache_cs_remove_entry(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
   msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
 
   // XXX const hicn_name_t *name = msgbuf_get_name(msgbuf);
-  _remove_suffix(pkt_cache->prefix_to_suffixes,
-                 hicn_name_get_prefix(&entry->name),
-                 hicn_name_get_suffix(&entry->name), pkt_cache->prefix_keys);
+  pkt_cache_remove_from_index(pkt_cache, &entry->name);
+  pkt_cache->index_version++;
 
   // Do not update the LRU cache for evicted entries
   if (!is_evicted) cs_vft[pkt_cache->cs->type]->remove_entry(pkt_cache, entry);
 
   pkt_cache->cs->num_entries--;
+  timer_wheel_cancel(pkt_cache->timer_wheel,
+                     (unsigned)pkt_cache_get_entry_id(pkt_cache, entry));
   pool_put(pkt_cache->entries, entry);
 
   WITH_DEBUG({
@@ -397,9 +608,12 @@ void pkt_cache_pit_remove_entry(pkt_cache_t *pkt_cache,
   assert(entry->entry_type == PKT_CACHE_PIT_TYPE);
 
   const hicn_name_t *name = &entry->name;
-  _remove_suffix(pkt_cache->prefix_to_suffixes, hicn_name_get_prefix(name),
-                 hicn_name_get_suffix(name), pkt_cache->prefix_keys);
+  pkt_cache_remove_from_index(pkt_cache, name);
+  pkt_cache->index_version++;
 
+  _pkt_cache_pit_unlink(pkt_cache, entry);
+  timer_wheel_cancel(pkt_cache->timer_wheel,
+                     (unsigned)pkt_cache_get_entry_id(pkt_cache, entry));
   pool_put(pkt_cache->entries, entry);
 
   WITH_DEBUG({
@@ -411,6 +625,65 @@ void pkt_cache_pit_remove_entry(pkt_cache_t *pkt_cache,
   })
 }
 
+/**
+ * Copy a CS entry evicted from memory to the second tier, unless it has
+ * already expired (helper)
+ */
+static void _pkt_cache_demote(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
+                              msgbuf_pool_t *msgbuf_pool) {
+  if (entry->has_expire_ts && entry->expire_ts <= ticks_now()) return;
+
+  const msgbuf_t *msgbuf =
+      msgbuf_pool_at(msgbuf_pool, entry->u.cs_entry.msgbuf_id);
+  // Slots are sized for the MTU, jumbo packets are simply evicted
+  if (msgbuf_get_len(msgbuf) > MTU) {
+    pkt_cache->cs_disk->stats.countOversized++;
+    return;
+  }
+  if (cs_disk_put(pkt_cache->cs_disk, &entry->name, msgbuf_get_packet(msgbuf),
+                  msgbuf_get_len(msgbuf), entry->expire_ts) < 0)
+    WARN("Could not demote CS entry to the second tier");
+}
+
+/**
+ * Promote a packet from the second tier back to the in-memory CS, into a newly
+ * allocated msgbuf (helper)
+ *
+ * @return pkt_cache_entry_t* The new CS entry, or NULL if the packet is not
+ * found in the second tier
+ */
+static pkt_cache_entry_t *_pkt_cache_promote(pkt_cache_t *pkt_cache,
+                                             msgbuf_pool_t *msgbuf_pool,
+                                             const hicn_name_t *name) {
+  Ticks now = ticks_now();
+  const cs_disk_slot_t *slot = cs_disk_get(pkt_cache->cs_disk, name, now);
+  if (!slot) return NULL;
+
+  msgbuf_t *msgbuf;
+  off_t msgbuf_id =
+      _msgbuf_pool_get(msgbuf_pool, msgbuf_class_fit(slot->len), &msgbuf);
+  if (!msgbuf_id_is_valid(msgbuf_id)) return NULL;
+
+  // Same initialization as a received packet
+  memcpy(msgbuf_get_packet(msgbuf), slot->packet, slot->len);
+  msgbuf_set_len(msgbuf, slot->len);
+  msgbuf_initialize_from_packet(msgbuf);
+  hicn_packet_analyze(msgbuf_get_pkbuf(msgbuf));
+  msgbuf_set_name(msgbuf, name);
+  msgbuf_set_connection_id(msgbuf, CONNECTION_ID_UNDEFINED);
+  msgbuf->recv_ts = now;
+  Ticks expire_ts = slot->expire_ts;
+
+  // Also removes the packet from the second tier
+  pkt_cache_entry_t *entry =
+      pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf, msgbuf_id);
+
+  // Keep the remaining lifetime rather than restarting it
+  entry->expire_ts = expire_ts;
+  _pkt_cache_schedule_expiry(pkt_cache, entry);
+  return entry;
+}
+
 void _pkt_cache_add_to_cs(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
                           msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf,
                           off_t msgbuf_id, off_t entry_id) {
@@ -422,20 +695,27 @@ void _pkt_cache_add_to_cs(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
   entry->expire_ts = now + msgbuf_get_data_expiry_time(msgbuf);
   entry->has_expire_ts = true;
   entry->entry_type = PKT_CACHE_CS_TYPE;
+  _pkt_cache_schedule_expiry(pkt_cache, entry);
 
   pkt_cache->cs->num_entries++;
 
-  int tail_id = (int)(pkt_cache->cs->lru.tail);
-  int result = cs_vft[pkt_cache->cs->type]->add_entry(pkt_cache, entry_id);
-  if (result == LRU_EVICTION) {
-    // Remove tail (already removed from LRU cache)
-    pkt_cache_entry_t *tail = pkt_cache_entry_at(pkt_cache, tail_id);
-    assert(tail->entry_type == PKT_CACHE_CS_TYPE);
-    pkt_cache_cs_remove_entry(pkt_cache, tail, msgbuf_pool, true);
-  }
+  // The second tier is exclusive, any copy there is now stale
+  if (pkt_cache->cs_disk) cs_disk_remove(pkt_cache->cs_disk, &entry->name);
 
   // Acquired by CS
   msgbuf_pool_acquire(msgbuf);
+
+  off_t evicted_id;
+  int result =
+      cs_vft[pkt_cache->cs->type]->add_entry(pkt_cache, entry_id, &evicted_id);
+  if (result == LRU_EVICTION) {
+    // Remove the victim (already removed from the CS policy)
+    assert(evicted_id != entry_id);
+    pkt_cache_entry_t *evicted = pkt_cache_entry_at(pkt_cache, evicted_id);
+    assert(evicted->entry_type == PKT_CACHE_CS_TYPE);
+    if (pkt_cache->cs_disk) _pkt_cache_demote(pkt_cache, evicted, msgbuf_pool);
+    pkt_cache_cs_remove_entry(pkt_cache, evicted, msgbuf_pool, true);
+  }
 }
 
 void pkt_cache_pit_to_cs(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
@@ -445,6 +725,7 @@ void pkt_cache_pit_to_cs(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
   assert(entry);
   assert(entry->entry_type == PKT_CACHE_PIT_TYPE);
 
+  _pkt_cache_pit_unlink(pkt_cache, entry);
   _pkt_cache_add_to_cs(pkt_cache, entry, msgbuf_pool, msgbuf, msgbuf_id,
                        entry_id);
 }
@@ -461,11 +742,13 @@ void _pkt_cache_add_to_pit(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
       .fib_entry = NULL,
   };
   pit_entry_ingress_add(&entry->u.pit_entry, msgbuf_get_connection_id(msgbuf));
+  _pkt_cache_pit_link(pkt_cache, entry, msgbuf_get_connection_id(msgbuf));
 
   entry->create_ts = ticks_now();
   entry->expire_ts = ticks_now() + msgbuf_get_interest_lifetime(msgbuf);
   entry->has_expire_ts = true;
   entry->entry_type = PKT_CACHE_PIT_TYPE;
+  _pkt_cache_schedule_expiry(pkt_cache, entry);
 }
 
 void pkt_cache_cs_to_pit(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
@@ -502,6 +785,7 @@ void pkt_cache_update_cs(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
   entry->create_ts = ticks_now();
   entry->expire_ts = ticks_now() + msgbuf_get_data_expiry_time(msgbuf);
   entry->has_expire_ts = true;
+  _pkt_cache_schedule_expiry(pkt_cache, entry);
 
   cs_vft[pkt_cache->cs->type]->update_entry(pkt_cache, entry);
 }
@@ -544,6 +828,8 @@ void pkt_cache_update_pit(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry,
   if (fib_entry)
     fib_entry_on_timeout(fib_entry, pit_entry_get_egress(pit_entry));
 
+  // The entry is accounted again to the connection of the new interest
+  _pkt_cache_pit_unlink(pkt_cache, entry);
   _pkt_cache_add_to_pit(pkt_cache, entry, msgbuf);
 }
 
@@ -557,7 +843,8 @@ bool pkt_cache_try_aggregate_in_pit(pkt_cache_t *pkt_cache,
 
   pit_entry_t *pit_entry = &entry->u.pit_entry;
 
-  // Extend entry lifetime
+  // Extend entry lifetime; the timer wheel is not updated here but when the
+  // previous expiry time is reached (see _pkt_cache_on_expiry)
   Ticks expire_ts = ticks_now() + msgbuf_get_interest_lifetime(msgbuf);
   if (expire_ts > entry->expire_ts) entry->expire_ts = expire_ts;
 
@@ -688,22 +975,16 @@ nexthops_t *pkt_cache_on_data(pkt_cache_t *pkt_cache,
   }
 }
 
-void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
-                           off_t msgbuf_id, pkt_cache_verdict_t *verdict,
-                           off_t *data_msgbuf_id, pkt_cache_entry_t **entry_ptr,
-                           const hicn_name_t *name,
-                           bool is_serve_from_cs_enabled) {
-  assert(pkt_cache);
-  assert(msgbuf_id_is_valid(msgbuf_id));
-
-  msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
-  assert(msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_INTEREST);
-
-  off_t entry_id;
-  pkt_cache_lookup_t lookup_result;
-  pkt_cache_entry_t *entry =
-      pkt_cache_lookup(pkt_cache, name, msgbuf_pool, &lookup_result, &entry_id,
-                       is_serve_from_cs_enabled);
+/**
+ * Update the packet cache for an interest, given the result of the lookup of
+ * its name (helper)
+ */
+static void _pkt_cache_on_interest_lookup(
+    pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool, msgbuf_t *msgbuf,
+    off_t msgbuf_id, const hicn_name_t *name, pkt_cache_lookup_t lookup_result,
+    pkt_cache_entry_t *entry, off_t entry_id, pkt_cache_verdict_t *verdict,
+    off_t *data_msgbuf_id, pkt_cache_entry_t **entry_ptr,
+    bool is_serve_from_cs_enabled) {
   *entry_ptr = entry;
 
   cs_entry_t *cs_entry = NULL;
@@ -711,6 +992,24 @@ void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
   bool is_aggregated;
   switch (lookup_result) {
     case PKT_CACHE_LU_NONE:
+      if (is_serve_from_cs_enabled && pkt_cache->cs_disk) {
+        entry = _pkt_cache_promote(pkt_cache, msgbuf_pool, name);
+        if (entry) {
+          *entry_ptr = entry;
+          cs_entry = &entry->u.cs_entry;
+          *data_msgbuf_id = cs_entry->msgbuf_id;
+          *verdict = PKT_CACHE_VERDICT_FORWARD_DATA;
+          is_cs_miss = false;
+          break;
+        }
+      }
+
+      if (!_pkt_cache_pit_admit(pkt_cache,
+                                msgbuf_get_connection_id(msgbuf))) {
+        *verdict = PKT_CACHE_VERDICT_DROP_INTEREST;
+        break;
+      }
+
       entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, name);
       *entry_ptr = entry;
 
@@ -722,6 +1021,7 @@ void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
 
       cs_entry = &entry->u.cs_entry;
       *data_msgbuf_id = cs_entry->msgbuf_id;
+      cs_vft[pkt_cache->cs->type]->hit_entry(pkt_cache, entry);
 
       *verdict = PKT_CACHE_VERDICT_FORWARD_DATA;
       is_cs_miss = false;
@@ -743,6 +1043,13 @@ void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
 
     case PKT_CACHE_LU_DATA_EXPIRED:
     PKT_CACHE_LU_DATA_EXPIRED:
+      if (!_pkt_cache_pit_admit(pkt_cache,
+                                msgbuf_get_connection_id(msgbuf))) {
+        *entry_ptr = NULL;
+        *verdict = PKT_CACHE_VERDICT_DROP_INTEREST;
+        break;
+      }
+
       pkt_cache_cs_to_pit(pkt_cache, entry, msgbuf_pool, msgbuf, msgbuf_id,
                           entry_id);
 
@@ -755,26 +1062,285 @@ void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
   is_cs_miss ? cs_miss(pkt_cache->cs) : cs_hit(pkt_cache->cs);
 }
 
+void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
+                           off_t msgbuf_id, pkt_cache_verdict_t *verdict,
+                           off_t *data_msgbuf_id, pkt_cache_entry_t **entry_ptr,
+                           const hicn_name_t *name,
+                           bool is_serve_from_cs_enabled) {
+  assert(pkt_cache);
+  assert(msgbuf_id_is_valid(msgbuf_id));
+
+  msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
+  assert(msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_INTEREST);
+
+  off_t entry_id;
+  pkt_cache_lookup_t lookup_result;
+  pkt_cache_entry_t *entry =
+      pkt_cache_lookup(pkt_cache, name, msgbuf_pool, &lookup_result, &entry_id,
+                       is_serve_from_cs_enabled);
+
+  _pkt_cache_on_interest_lookup(pkt_cache, msgbuf_pool, msgbuf, msgbuf_id,
+                                name, lookup_result, entry, entry_id, verdict,
+                                data_msgbuf_id, entry_ptr,
+                                is_serve_from_cs_enabled);
+}
+
+/*
+ * Suffixes of a manifest already seen during its resolution, used to detect
+ * duplicates: open addressing on twice as many slots as suffixes.
+ */
+#define MANIFEST_SUFFIX_SET_BITS 9
+#define MANIFEST_SUFFIX_SET_SIZE (1 << MANIFEST_SUFFIX_SET_BITS)
+static_assert(MANIFEST_SUFFIX_SET_SIZE >= 2 * MAX_SUFFIXES_IN_MANIFEST,
+              "Manifest suffix set is too small");
+
+typedef struct {
+  hicn_uword used[MANIFEST_SUFFIX_SET_SIZE / WORD_WIDTH];
+  hicn_name_suffix_t suffixes[MANIFEST_SUFFIX_SET_SIZE];
+} manifest_suffix_set_t;
+
+/**
+ * Add a suffix to the set, returning false if it was already present (helper)
+ */
+static bool _manifest_suffix_set_add(manifest_suffix_set_t *set,
+                                     hicn_name_suffix_t suffix) {
+  unsigned i = (uint32_t)(suffix * 2654435761u) >>
+               (32 - MANIFEST_SUFFIX_SET_BITS);
+  while (bitmap_is_set_no_check(set->used, i)) {
+    if (set->suffixes[i] == suffix) return false;
+    i = (i + 1) & (MANIFEST_SUFFIX_SET_SIZE - 1);
+  }
+  bitmap_set_no_check(set->used, i);
+  set->suffixes[i] = suffix;
+  return true;
+}
+
+void pkt_cache_on_interest_manifest(
+    pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool, off_t msgbuf_id,
+    const interest_manifest_header_t *manifest, const hicn_name_t *name,
+    pkt_cache_verdict_t *verdicts, off_t *data_msgbuf_ids,
+    pkt_cache_entry_t **entries, bool is_serve_from_cs_enabled) {
+  assert(pkt_cache);
+  assert(msgbuf_id_is_valid(msgbuf_id));
+  assert(manifest->n_suffixes <= MAX_SUFFIXES_IN_MANIFEST);
+
+  msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
+  assert(msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_INTEREST);
+
+  const hicn_name_suffix_t *suffixes =
+      (const hicn_name_suffix_t *)(manifest + 1);
+  const hicn_uword *bitmap = manifest->request_bitmap;
+  size_t n = manifest->n_suffixes;
+
+  hicn_name_t name_copy = HICN_NAME_EMPTY;
+  hicn_name_copy(&name_copy, name);
+
+  // All suffixes share the same prefix, so that its suffix table is only
+  // looked up once
+  kh_pkt_cache_suffix_t *suffix_table = NULL;
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_KHASH) {
+    const hicn_name_prefix_t *prefix = hicn_name_get_prefix(name);
+    if (pkt_cache->cached_suffixes &&
+        hicn_name_prefix_equals(&pkt_cache->cached_prefix, prefix))
+      suffix_table = pkt_cache->cached_suffixes;
+    else
+      suffix_table = _get_suffixes(pkt_cache->prefix_to_suffixes, prefix,
+                                   false, pkt_cache->prefix_keys);
+  }
+
+  /*
+   * First pass: prefetch the buckets of all suffixes so that the memory
+   * accesses of the lookups overlap, and flag duplicate suffixes whose lookup
+   * will be invalidated by the processing of the first occurrence.
+   */
+  manifest_suffix_set_t seen;
+  memset(seen.used, 0, sizeof(seen.used));
+  hicn_uword duplicates[BITMAP_SIZE] = {0};
+  // The prefix is hashed once, and each suffix is mixed into its hash
+  uint32_t prefix_hash = hicn_name_prefix_hash(hicn_name_get_prefix(name));
+  uint32_t hashes[MAX_SUFFIXES_IN_MANIFEST];
+  for (size_t i = 0; i < n; i++) {
+    if (!bitmap_is_set_no_check(bitmap, i)) continue;
+    if (!_manifest_suffix_set_add(&seen, suffixes[i]))
+      bitmap_set_no_check(duplicates, i);
+
+    if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+      hashes[i] = hicn_name_suffix_mix(prefix_hash, suffixes[i]);
+      name_index_prefetch_hashed(pkt_cache->name_index, hashes[i]);
+    } else if (suffix_table) {
+      _kh_prefetch(suffix_table, suffixes[i]);
+    }
+  }
+
+  // Second pass: resolve the entry of each suffix
+  unsigned entry_ids[MAX_SUFFIXES_IN_MANIFEST];
+  for (size_t i = 0; i < n; i++) {
+    if (!bitmap_is_set_no_check(bitmap, i)) continue;
+
+    if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+      hicn_name_set_suffix(&name_copy, suffixes[i]);
+      entry_ids[i] =
+          name_index_get_hashed(pkt_cache->name_index, &name_copy, hashes[i]);
+      if (entry_ids[i] == NAME_INDEX_INVALID_ID)
+        entry_ids[i] = HICN_INVALID_SUFFIX;
+    } else {
+      entry_ids[i] = suffix_table ? __get_suffix(suffix_table, suffixes[i])
+                                  : HICN_INVALID_SUFFIX;
+    }
+  }
+
+  /*
+   * Third pass: apply the verdicts. Entry ids are stable across additions to
+   * the packet cache, but not across removals (eg. PIT replacement, CS
+   * eviction upon promotion from the second tier), after which the remaining
+   * suffixes are looked up again. PIT entries admitted for the manifest are
+   * not replaced to make room for the next suffixes.
+   */
+  Ticks now = ticks_now();
+  unsigned index_version = pkt_cache->index_version;
+  pkt_cache->pit->protected_seq = pkt_cache->pit->next_seq;
+  for (size_t i = 0; i < n; i++) {
+    if (!bitmap_is_set_no_check(bitmap, i)) continue;
+    hicn_name_set_suffix(&name_copy, suffixes[i]);
+
+    off_t entry_id = INVALID_ENTRY_ID;
+    pkt_cache_lookup_t lookup_result;
+    pkt_cache_entry_t *entry;
+    if (pkt_cache->index_version != index_version ||
+        bitmap_is_set_no_check(duplicates, i)) {
+      entry = pkt_cache_lookup(pkt_cache, &name_copy, msgbuf_pool,
+                               &lookup_result, &entry_id,
+                               is_serve_from_cs_enabled);
+    } else if (entry_ids[i] == HICN_INVALID_SUFFIX) {
+      entry = NULL;
+      lookup_result = PKT_CACHE_LU_NONE;
+    } else {
+      entry_id = entry_ids[i];
+      entry = pkt_cache_at(pkt_cache, entry_id);
+      lookup_result = _pkt_cache_entry_get_lookup_result(entry, now);
+    }
+
+    _pkt_cache_on_interest_lookup(pkt_cache, msgbuf_pool, msgbuf, msgbuf_id,
+                                  &name_copy, lookup_result, entry, entry_id,
+                                  &verdicts[i], &data_msgbuf_ids[i],
+                                  &entries[i], is_serve_from_cs_enabled);
+
+    // Entries might move when the packet cache grows, keep their id instead
+    entry_ids[i] = entries[i] ? (unsigned)pkt_cache_get_entry_id(pkt_cache,
+                                                                 entries[i])
+                              : HICN_INVALID_SUFFIX;
+  }
+  pkt_cache->pit->protected_seq = UINT64_MAX;
+
+  /*
+   * The entry of a suffix might also have been removed while processing the
+   * next ones, in which case it is not returned.
+   */
+  bool check = pkt_cache->index_version != index_version;
+  for (size_t i = 0; i < n; i++) {
+    if (!bitmap_is_set_no_check(bitmap, i)) continue;
+    if (entry_ids[i] == HICN_INVALID_SUFFIX) {
+      entries[i] = NULL;
+      continue;
+    }
+    entries[i] = pkt_cache_at(pkt_cache, entry_ids[i]);
+    if (!check) continue;
+
+    off_t entry_id;
+    pkt_cache_lookup_t lookup_result;
+    hicn_name_set_suffix(&name_copy, suffixes[i]);
+    if (pkt_cache_lookup(pkt_cache, &name_copy, msgbuf_pool, &lookup_result,
+                         &entry_id, is_serve_from_cs_enabled) != entries[i])
+      entries[i] = NULL;
+  }
+}
+
+typedef struct {
+  msgbuf_pool_t *msgbuf_pool;
+  Ticks now;
+} pkt_cache_expiry_t;
+
+/**
+ * Reclaim an entry whose expiry time has been reached in the timer wheel
+ * (helper)
+ */
+static void _pkt_cache_on_expiry(void *context, unsigned id, void *data) {
+  pkt_cache_t *pkt_cache = (pkt_cache_t *)context;
+  pkt_cache_expiry_t *expiry = (pkt_cache_expiry_t *)data;
+  pkt_cache_entry_t *entry = pkt_cache_entry_at(pkt_cache, id);
+
+  // The lifetime of the entry has been extended in the meantime
+  if (entry->expire_ts > expiry->now) {
+    _pkt_cache_schedule_expiry(pkt_cache, entry);
+    return;
+  }
+
+  if (entry->entry_type == PKT_CACHE_CS_TYPE) {
+    pkt_cache_cs_remove_entry(pkt_cache, entry, expiry->msgbuf_pool, false);
+    pkt_cache->n_cs_reclaimed++;
+    return;
+  }
+
+  pit_entry_t *pit_entry = &entry->u.pit_entry;
+  fib_entry_t *fib_entry = pit_entry_get_fib_entry(pit_entry);
+  if (fib_entry)
+    fib_entry_on_timeout(fib_entry, pit_entry_get_egress(pit_entry));
+
+  pkt_cache_pit_remove_entry(pkt_cache, entry);
+  pkt_cache->n_pit_reclaimed++;
+}
+
+size_t pkt_cache_expire(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
+                        Ticks now, size_t budget) {
+  assert(pkt_cache);
+  assert(msgbuf_pool);
+
+  size_t n_reclaimed = pkt_cache->n_pit_reclaimed + pkt_cache->n_cs_reclaimed;
+
+  pkt_cache_expiry_t expiry = {.msgbuf_pool = msgbuf_pool, .now = now};
+  timer_wheel_advance(pkt_cache->timer_wheel, now, budget, _pkt_cache_on_expiry,
+                      &expiry);
+
+  return pkt_cache->n_pit_reclaimed + pkt_cache->n_cs_reclaimed - n_reclaimed;
+}
+
 void pkt_cache_cs_clear(pkt_cache_t *pkt_cache) {
   assert(pkt_cache);
 
-  kh_pkt_cache_suffix_t *v_suffixes;
-  u32 k_suffix;
-  u32 v_pkt_cache_entry_id;
-  kh_foreach_value(pkt_cache->prefix_to_suffixes, v_suffixes, {
-    kh_foreach(v_suffixes, k_suffix, v_pkt_cache_entry_id, {
-      pkt_cache_entry_t *entry = pkt_cache_at(pkt_cache, v_pkt_cache_entry_id);
+  if (pkt_cache->index_type == PKT_CACHE_INDEX_TYPE_FLAT) {
+    pkt_cache_entry_t *entry;
+    pool_foreach(pkt_cache->entries, entry, {
       if (entry->entry_type == PKT_CACHE_CS_TYPE) {
-        // Remove from hash table
-        khiter_t k = kh_get_pkt_cache_suffix(v_suffixes, k_suffix);
-        assert(k != kh_end(v_suffixes));
-        kh_del_pkt_cache_suffix(v_suffixes, k);
+        // Remove from index
+        name_index_remove(pkt_cache->name_index, &entry->name);
 
-        // Remove from pool
+        // Remove from timer wheel and pool
+        timer_wheel_cancel(pkt_cache->timer_wheel,
+                           (unsigned)pkt_cache_get_entry_id(pkt_cache, entry));
         pool_put(pkt_cache->entries, entry);
       }
     });
-  });
+  } else {
+    kh_pkt_cache_suffix_t *v_suffixes;
+    u32 k_suffix;
+    u32 v_pkt_cache_entry_id;
+    kh_foreach_value(pkt_cache->prefix_to_suffixes, v_suffixes, {
+      kh_foreach(v_suffixes, k_suffix, v_pkt_cache_entry_id, {
+        pkt_cache_entry_t *entry =
+            pkt_cache_at(pkt_cache, v_pkt_cache_entry_id);
+        if (entry->entry_type == PKT_CACHE_CS_TYPE) {
+          // Remove from hash table
+          khiter_t k = kh_get_pkt_cache_suffix(v_suffixes, k_suffix);
+          assert(k != kh_end(v_suffixes));
+          kh_del_pkt_cache_suffix(v_suffixes, k);
+
+          // Remove from timer wheel and pool
+          timer_wheel_cancel(pkt_cache->timer_wheel, v_pkt_cache_entry_id);
+          pool_put(pkt_cache->entries, entry);
+        }
+      });
+    });
+  }
 
   // Reset cached prefix
   pkt_cache->cached_prefix = HICN_NAME_PREFIX_EMPTY;
@@ -782,6 +1348,9 @@ void pkt_cache_cs_clear(pkt_cache_t *pkt_cache) {
 
   // Re-create CS
   cs_clear(pkt_cache->cs);
+
+  if (pkt_cache->cs_disk && cs_disk_clear(pkt_cache->cs_disk) < 0)
+    ERROR("Could not clear the second tier of the CS");
 }
 
 size_t pkt_cache_get_num_cs_stale_entries(pkt_cache_t *pkt_cache) {
@@ -799,10 +1368,43 @@ size_t pkt_cache_get_num_cs_stale_entries(pkt_cache_t *pkt_cache) {
   return num_stale_entries;
 }
 
-int pkt_cache_set_cs_size(pkt_cache_t *pkt_cache, size_t size) {
-  if (pkt_cache->cs->num_entries > size) return -1;
+int pkt_cache_set_cs_type(pkt_cache_t *pkt_cache, cs_type_t type) {
+  assert(pkt_cache);
+
+  cs_t *cs = pkt_cache->cs;
+  if (cs->type == type) return 0;
+  if (cs->num_entries > 0) return -1;
+
+  cs_t *new_cs = _cs_create(type, cs->max_size);
+  if (!new_cs) return -1;
 
-  pkt_cache->cs->max_size = size;
+  cs_free(cs);
+  pkt_cache->cs = new_cs;
+  return 0;
+}
+
+int pkt_cache_set_cs_disk(pkt_cache_t *pkt_cache, const char *path,
+                          size_t size) {
+  assert(pkt_cache);
+
+  cs_disk_free(pkt_cache->cs_disk);
+  pkt_cache->cs_disk = NULL;
+  if (!path) return 0;
+
+  pkt_cache->cs_disk = cs_disk_create(path, size);
+  return pkt_cache->cs_disk ? 0 : -1;
+}
+
+int pkt_cache_set_cs_size(pkt_cache_t *pkt_cache, size_t size) {
+  cs_t *cs = pkt_cache->cs;
+  if (cs->num_entries > size) return -1;
+
+  size_t max_size = cs->max_size;
+  cs->max_size = size;
+  if (cs_vft[cs->type]->resize(cs) < 0) {
+    cs->max_size = max_size;
+    return -1;
+  }
   return 0;
 }
 
@@ -826,6 +1428,16 @@ void pkt_cache_log(pkt_cache_t *pkt_cache) {
         pkt_cache_get_cs_size(pkt_cache));
 
   cs_log(pkt_cache->cs);
+
+  cs_disk_t *cs_disk = pkt_cache->cs_disk;
+  if (cs_disk)
+    DEBUG(
+        "CS second tier: size = %zu, capacity = %zu, demotions = %lu, "
+        "promotions = %lu, overwrites = %lu, expired = %lu, oversized = %lu",
+        cs_disk_get_num_entries(cs_disk), cs_disk_get_num_slots(cs_disk),
+        cs_disk->stats.countDemotions, cs_disk->stats.countPromotions,
+        cs_disk->stats.countOverwrites, cs_disk->stats.countExpired,
+        cs_disk->stats.countOversized);
 }
 
 pkt_cache_stats_t pkt_cache_get_stats(pkt_cache_t *pkt_cache) {
@@ -834,7 +1446,21 @@ pkt_cache_stats_t pkt_cache_get_stats(pkt_cache_t *pkt_cache) {
       .n_pit_entries = (uint32_t)pkt_cache_get_pit_size(pkt_cache),
       .n_cs_entries = (uint32_t)pkt_cache_get_cs_size(pkt_cache),
       .n_lru_evictions = (uint32_t)lru_stats.countLruEvictions,
+      .n_cs_hits = (uint32_t)lru_stats.countHits,
+      .n_cs_misses = (uint32_t)lru_stats.countMisses,
+      .n_pit_reclaimed = (uint32_t)pkt_cache->n_pit_reclaimed,
+      .n_cs_reclaimed = (uint32_t)pkt_cache->n_cs_reclaimed,
+      .n_pit_full_drops = (uint32_t)pkt_cache->pit->stats.n_full_drops,
+      .n_pit_quota_drops = (uint32_t)pkt_cache->pit->stats.n_quota_drops,
+      .n_pit_replacements = (uint32_t)pkt_cache->pit->stats.n_replacements,
   };
 
+  cs_disk_t *cs_disk = pkt_cache->cs_disk;
+  if (cs_disk) {
+    stats.n_cs_disk_entries = (uint32_t)cs_disk_get_num_entries(cs_disk);
+    stats.n_cs_disk_demotions = (uint32_t)cs_disk->stats.countDemotions;
+    stats.n_cs_disk_promotions = (uint32_t)cs_disk->stats.countPromotions;
+  }
+
   return stats;
 }
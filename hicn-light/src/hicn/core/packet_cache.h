@@ -35,40 +35,54 @@
  * When an interest/data packet is received, the prefix and the associated
  * suffixes are saved; if the next packet cache operation involves the same
  * prefix, no additional lookups in the prefix hash hashtable are needed.
+ *
+ * Alternatively, entries can be indexed in a flat open-addressing table keyed
+ * on the full name (see name_index.h), which resolves a name with a single
+ * probe sequence over cache-line sized buckets. The index type is chosen when
+ * the packet cache is created; the default one can be changed at build time
+ * with WITH_FLAT_PKT_CACHE_INDEX.
+ *
+ * The content store can optionally be backed by a larger second tier (see
+ * content_store/disk.h): data packets evicted from the in-memory CS are
+ * demoted to it, and promoted back upon a CS miss for their name.
  */
 
 #ifndef HICNLIGHT_PACKET_CACHE_H
 #define HICNLIGHT_PACKET_CACHE_H
 
+#include <hicn/base.h>
+#include <hicn/interest_manifest.h>
 #include <hicn/util/khash.h>
 #include <hicn/util/slab.h>
 #include "content_store.h"
 #include "pit.h"
 #include "msgbuf_pool.h"
+#include "name_index.h"
+#include "timer_wheel.h"
+#include "../content_store/disk.h"
 #include "../content_store/lru.h"
 
 #define DEFAULT_PKT_CACHE_SIZE 2048
 
-typedef enum { PKT_CACHE_PIT_TYPE, PKT_CACHE_CS_TYPE } pkt_cache_entry_type_t;
+typedef enum {
+  PKT_CACHE_INDEX_TYPE_UNDEFINED,
+  PKT_CACHE_INDEX_TYPE_KHASH, /* Two-level prefix/suffix hash tables */
+  PKT_CACHE_INDEX_TYPE_FLAT,  /* Flat index on the full name */
+  PKT_CACHE_INDEX_TYPE_N,
+} pkt_cache_index_type_t;
+
+#define PKT_CACHE_INDEX_TYPE_VALID(type) \
+  (type != PKT_CACHE_INDEX_TYPE_UNDEFINED) && (type != PKT_CACHE_INDEX_TYPE_N)
+
+#ifdef WITH_FLAT_PKT_CACHE_INDEX
+#define DEFAULT_PKT_CACHE_INDEX_TYPE PKT_CACHE_INDEX_TYPE_FLAT
+#else
+#define DEFAULT_PKT_CACHE_INDEX_TYPE PKT_CACHE_INDEX_TYPE_KHASH
+#endif
 
-#define foreach_kh_verdict             \
-  _(FORWARD_INTEREST)                  \
-  _(AGGREGATE_INTEREST)                \
-  _(RETRANSMIT_INTEREST)               \
-  _(FORWARD_DATA)                      \
-  _(INTEREST_EXPIRED_FORWARD_INTEREST) \
-  _(DATA_EXPIRED_FORWARD_INTEREST)     \
-  _(STORE_DATA)                        \
-  _(CLEAR_DATA)                        \
-  _(UPDATE_DATA)                       \
-  _(IGNORE_DATA)                       \
-  _(ERROR)
+typedef enum { PKT_CACHE_PIT_TYPE, PKT_CACHE_CS_TYPE } pkt_cache_entry_type_t;
 
-typedef enum {
-#define _(x) PKT_CACHE_VERDICT_##x,
-  foreach_kh_verdict
-#undef _
-} pkt_cache_verdict_t;
+/* pkt_cache_verdict_t is defined in hicn/base.h */
 
 extern const char *_pkt_cache_verdict_str[];
 
@@ -102,6 +116,9 @@ typedef struct {
   // Now it is always set to true
   bool has_expire_ts;
 
+  // Linkage in the expiry timer wheel
+  timer_wheel_node_t timer;
+
   union {
     pit_entry_t pit_entry;
     cs_entry_t cs_entry;
@@ -112,21 +129,53 @@ typedef struct {
   pit_t *pit;
   cs_t *cs;
   pkt_cache_entry_t *entries;
+  pkt_cache_index_type_t index_type;
+
+  // PKT_CACHE_INDEX_TYPE_KHASH
   kh_pkt_cache_prefix_t *prefix_to_suffixes;
   slab_t *prefix_keys;
 
+  // PKT_CACHE_INDEX_TYPE_FLAT
+  name_index_t *name_index;
+
   // Cached prefix info to avoid double lookups,
   // used for both single interest speculation and interest manifest
   hicn_name_prefix_t cached_prefix;
   kh_pkt_cache_suffix_t *cached_suffixes;
+
+  // Incremented whenever an entry leaves the index, so that lookups done
+  // ahead of time can be checked for staleness
+  unsigned index_version;
+
+  // Expiry of PIT and CS entries, independently of lookups
+  timer_wheel_t *timer_wheel;
+  size_t n_pit_reclaimed;
+  size_t n_cs_reclaimed;
+
+  // Second tier of the CS, NULL if disabled
+  cs_disk_t *cs_disk;
 } pkt_cache_t;
 
+/**
+ * @brief Create a new packet cache (extended parameters).
+ *
+ * @param[in] index_type Data structure used to index entries by name
+ * @param[in] cs_size Maximum content store size
+ *
+ * @return pkt_cache_t* The newly created packet cache
+ */
+pkt_cache_t *_pkt_cache_create(pkt_cache_index_type_t index_type,
+                               size_t cs_size);
+
 /**
  * @brief Create a new packet cache.
  *
+ * @param[in] cs_size Maximum content store size
+ *
  * @return pkt_cache_t* The newly created packet cache
  */
-pkt_cache_t *pkt_cache_create(size_t cs_size);
+#define pkt_cache_create(cs_size) \
+  _pkt_cache_create(DEFAULT_PKT_CACHE_INDEX_TYPE, (cs_size))
 
 /**
  * @brief Add an entry with the specified name to the packet cache.
@@ -194,6 +243,16 @@ size_t pkt_cache_get_size(pkt_cache_t *pkt_cache);
  */
 size_t pkt_cache_get_num_cs_stale_entries(pkt_cache_t *pkt_cache);
 
+/**
+ * @brief Change the replacement policy of the content store
+ *
+ * @param[in] pkt_cache Pointer to the packet cache data structure to use
+ * @param[in] type Content store type
+ * @return int 0 if success, -1 if the content store is not empty or could not
+ * be created
+ */
+int pkt_cache_set_cs_type(pkt_cache_t *pkt_cache, cs_type_t type);
+
 /**
  * @brief Change the maximum capacity of the content store (LRU eviction will
  * be used after reaching the provided size)
@@ -205,6 +264,19 @@ size_t pkt_cache_get_num_cs_stale_entries(pkt_cache_t *pkt_cache);
  */
 int pkt_cache_set_cs_size(pkt_cache_t *pkt_cache, size_t size);
 
+/**
+ * @brief Enable the second tier of the content store, backed by the specified
+ * file, or disable it if path is NULL. Any previous second tier is discarded
+ * along with its content.
+ *
+ * @param[in] pkt_cache Pointer to the packet cache data structure to use
+ * @param[in] path Path of the backing file, or NULL
+ * @param[in] size Size of the backing file in bytes
+ * @return int 0 if success, -1 if the second tier could not be created
+ */
+int pkt_cache_set_cs_disk(pkt_cache_t *pkt_cache, const char *path,
+                          size_t size);
+
 /**
  * @brief Return the content store size.
  *
@@ -250,12 +322,60 @@ pkt_cache_entry_t *pkt_cache_lookup(pkt_cache_t *pkt_cache,
                                     bool is_serve_from_cs_enabled);
 
 /**
- * @brief Clear the content of the CS (PIT entries are left unmodified).
+ * @brief Prefetch the first level (prefix) bucket that a subsequent lookup
+ * for the specified name will access.
+ *
+ * This is meant to be called on a batch of packets ahead of the actual
+ * lookups, so that the memory accesses of the different packets overlap.
+ * With the flat index, this prefetches the only bucket that is needed.
+ *
+ * @param[in] pkt_cache Pointer to the packet cache data structure to use
+ * @param[in] name Packet name that will be looked up
+ */
+void pkt_cache_prefetch_prefix(const pkt_cache_t *pkt_cache,
+                               const hicn_name_t *name);
+
+/**
+ * @brief Prefetch the second level (suffix) bucket that a subsequent lookup
+ * for the specified name will access. The prefix bucket is expected to have
+ * been prefetched beforehand (see pkt_cache_prefetch_prefix), as it is read
+ * to locate the suffix table; no lookup is performed. This is a no-op with
+ * the flat index.
+ *
+ * @param[in] pkt_cache Pointer to the packet cache data structure to use
+ * @param[in] name Packet name that will be looked up
+ */
+void pkt_cache_prefetch_suffix(const pkt_cache_t *pkt_cache,
+                               const hicn_name_t *name);
+
+/**
+ * @brief Clear the content of the CS, including its second tier (PIT entries
+ * are left unmodified).
  *
  * @param pkt_cache Pointer to the packet cache data structure to use
  */
 void pkt_cache_cs_clear(pkt_cache_t *pkt_cache);
 
+/**
+ * @brief Reclaim the PIT and CS entries that have expired, without waiting for
+ * a subsequent lookup on their name.
+ *
+ * Entries are tracked in a hierarchical timing wheel, so that the cost of this
+ * function only depends on the number of expired entries and not on the size
+ * of the packet cache. Expired PIT entries are reported to the strategy of
+ * their FIB entry as timeouts, like in the case of a lazy expiry.
+ *
+ * @param[in] pkt_cache Pointer to the packet cache data structure to use
+ * @param[in] msgbuf_pool Pointer to the msgbuf pool holding CS packets
+ * @param[in] now Current time
+ * @param[in] budget Maximum number of expired timers to process (including
+ * those of entries whose lifetime has been extended), the remaining ones being
+ * processed on the next call
+ * @return size_t Number of entries reclaimed
+ */
+size_t pkt_cache_expire(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
+                        Ticks now, size_t budget);
+
 /**
  * @brief Log packet cache statistics.
  *
@@ -444,6 +564,10 @@ nexthops_t *pkt_cache_on_data(pkt_cache_t *pkt_cache,
  *      - INTEREST not expired: Aggregate or retransmit the interest received;
  *      - INTEREST expired: Update the PIT;
  *      - DATA expired: Convert CS entry to PIT entry;
+ *
+ * When a new PIT entry would be needed but the PIT is full (or the ingress
+ * connection has exhausted its quota) and the interest cannot be admitted, the
+ * verdict is PKT_CACHE_VERDICT_DROP_INTEREST and no entry is returned.
  */
 void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
                            off_t msgbuf_id, pkt_cache_verdict_t *verdict,
@@ -451,6 +575,32 @@ void pkt_cache_on_interest(pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool,
                            const hicn_name_t *name,
                            bool is_serve_from_cs_enabled);
 
+/**
+ * @brief Handle the reception of an interest manifest.
+ * @details Bulk version of pkt_cache_on_interest for all the suffixes set in
+ * the manifest bitmap. The suffixes are first resolved in the index in a
+ * single pass, prefetching all the buckets before the lookups, and the
+ * verdicts are then applied in the order of the manifest. Lookups invalidated
+ * by the processing of previous suffixes (removed entries, duplicate suffixes)
+ * are performed again.
+ *
+ * Results are stored at the position of the suffix in the manifest, and are
+ * left untouched for positions that are not set. Entries of dropped interests
+ * are NULL; the others remain valid until the packet cache is next modified.
+ *
+ * @param[in] manifest Deserialized interest manifest
+ * @param[in] name Name of the interest, whose suffix is replaced by the ones
+ * of the manifest
+ * @param[out] verdicts Verdict for each suffix
+ * @param[out] data_msgbuf_ids Data msgbuf for each PKT_CACHE_VERDICT_FORWARD_DATA
+ * @param[out] entries Packet cache entry for each suffix
+ */
+void pkt_cache_on_interest_manifest(
+    pkt_cache_t *pkt_cache, msgbuf_pool_t *msgbuf_pool, off_t msgbuf_id,
+    const interest_manifest_header_t *manifest, const hicn_name_t *name,
+    pkt_cache_verdict_t *verdicts, off_t *data_msgbuf_ids,
+    pkt_cache_entry_t **entries, bool is_serve_from_cs_enabled);
+
 /********* Low-level operations on the hash table *********/
 #ifdef WITH_TESTS
 unsigned __get_suffix(kh_pkt_cache_suffix_t *suffixes,
@@ -474,12 +624,23 @@ kh_pkt_cache_suffix_t *_get_suffixes(kh_pkt_cache_prefix_t *prefix_to_suffixes,
 
 /************** Content Store *****************************/
 
+/*
+ * Content store policies. The packet cache accounts entries in
+ * cs_t.num_entries before calling add_entry, and the policy selects an entry
+ * to evict (returning LRU_EVICTION and its identifier) whenever this number
+ * exceeds cs_t.max_size. The evicted entry, which is never the one being
+ * added, is already detached from the policy when add_entry returns.
+ * resize is called once cs_t.max_size has been changed; the previous size is
+ * restored if it fails.
+ */
 typedef struct {
   const char *name;
-  void (*initialize)(cs_t *cs);
+  int (*initialize)(cs_t *cs);
   void (*finalize)(cs_t *cs);
-  int (*add_entry)(pkt_cache_t *pkt_cache, off_t entry_id);
+  int (*resize)(cs_t *cs);
+  int (*add_entry)(pkt_cache_t *pkt_cache, off_t entry_id, off_t *evicted_id);
   void (*update_entry)(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry);
+  void (*hit_entry)(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry);
   int (*remove_entry)(pkt_cache_t *pkt_cache, pkt_cache_entry_t *entry);
 } cs_ops_t;
 extern const cs_ops_t *const cs_vft[];
@@ -494,8 +655,10 @@ extern const cs_ops_t *const cs_vft[];
       .name = #NAME,                            \
       .initialize = cs_##NAME##_initialize,     \
       .finalize = cs_##NAME##_finalize,         \
+      .resize = cs_##NAME##_resize,             \
       .add_entry = cs_##NAME##_add_entry,       \
       .update_entry = cs_##NAME##_update_entry, \
+      .hit_entry = cs_##NAME##_hit_entry,       \
       .remove_entry = cs_##NAME##_remove_entry, \
   }
 
@@ -29,8 +29,35 @@
  *
  */
 
+#include <string.h>
+#include <strings.h>
+
+#include <hicn/util/vector.h>
+
+#include "content_store.h"  // INVALID_ENTRY_ID
 #include "pit.h"
 
+static const char* _pit_full_policy_str[] = {
+#define _(x) [PIT_FULL_POLICY_##x] = #x,
+    foreach_pit_full_policy
+#undef _
+};
+
+pit_full_policy_t pit_full_policy_from_str(const char* str) {
+#define _(x)                    \
+  if (strcasecmp(str, #x) == 0) \
+    return PIT_FULL_POLICY_##x; \
+  else
+  foreach_pit_full_policy
+#undef _
+      return PIT_FULL_POLICY_UNDEFINED;
+}
+
+const char* pit_full_policy_str(pit_full_policy_t policy) {
+  if (!PIT_FULL_POLICY_VALID(policy)) return "UNDEFINED";
+  return _pit_full_policy_str[policy];
+}
+
 Ticks pit_calculate_lifetime(pit_t* pit, const msgbuf_t* msgbuf) {
   uint64_t lifetime = msgbuf_get_lifetime(msgbuf);
   if (lifetime == 0) lifetime = NSEC_TO_TICKS(DEFAULT_INTEREST_LIFETIME);
@@ -49,14 +76,75 @@ pit_t* _pit_create(size_t init_size, size_t max_size) {
   if (init_size == 0) init_size = DEFAULT_PIT_SIZE;
 
   pit->max_size = max_size;
+  pit->max_size_per_connection = 0;
+  pit->full_policy = DEFAULT_PIT_FULL_POLICY;
+
+  pit->num_entries = 0;
+  vector_init(pit->num_entries_per_connection, 0, 0);
+  if (!pit->num_entries_per_connection) goto ERR_VECTOR;
+
+  pit->head = INVALID_ENTRY_ID;
+  pit->tail = INVALID_ENTRY_ID;
+  pit->next_seq = 0;
+  pit->protected_seq = UINT64_MAX;
+  memset(&pit->stats, 0, sizeof(pit_stats_t));
+
   return pit;
+
+ERR_VECTOR:
+  free(pit);
+  return NULL;
 }
 
 void pit_free(pit_t* pit) {
   assert(pit);
+  vector_free(pit->num_entries_per_connection);
   free(pit);
 }
 
+void pit_set_max_size(pit_t* pit, size_t max_size,
+                      size_t max_size_per_connection) {
+  assert(pit);
+  pit->max_size = max_size;
+  pit->max_size_per_connection = max_size_per_connection;
+}
+
+void pit_set_full_policy(pit_t* pit, pit_full_policy_t policy) {
+  assert(pit);
+  assert(PIT_FULL_POLICY_VALID(policy));
+  pit->full_policy = policy;
+}
+
+unsigned pit_get_num_entries_for_connection(const pit_t* pit,
+                                            unsigned connection_id) {
+  if (connection_id >= vector_get_alloc_size(pit->num_entries_per_connection))
+    return 0;
+  return pit->num_entries_per_connection[connection_id];
+}
+
+void pit_on_entry_added(pit_t* pit, unsigned connection_id) {
+  pit->num_entries++;
+
+  int rc = vector_ensure_pos(pit->num_entries_per_connection, connection_id);
+  if (rc < 0) return;
+  pit->num_entries_per_connection[connection_id]++;
+}
+
+void pit_on_entry_removed(pit_t* pit, unsigned connection_id) {
+  assert(pit->num_entries > 0);
+  pit->num_entries--;
+
+  // Connection ids are never beyond the size of the vector once accounted
+  if (pit_get_num_entries_for_connection(pit, connection_id) > 0)
+    pit->num_entries_per_connection[connection_id]--;
+}
+
+bool pit_is_over_quota(const pit_t* pit, unsigned connection_id) {
+  return pit->max_size_per_connection != 0 &&
+         pit_get_num_entries_for_connection(pit, connection_id) >=
+             pit->max_size_per_connection;
+}
+
 // void pit_print(const pit_t *pit) {
 //   const Name *k;
 //   unsigned v;
@@ -27,6 +27,13 @@ typedef struct {
   nexthops_t ingressIdSet;
   nexthops_t egressIdSet;
   fib_entry_t* fib_entry;
+
+  // Connection the entry is accounted to (the one which created it)
+  unsigned owner;
+  // Admission order, used to select the entry to replace when the PIT is full
+  off_t prev;
+  off_t next;
+  uint64_t seq;
 } pit_entry_t;
 
 #define pit_entry_get_ingress(E) (&((E)->ingressIdSet))
@@ -42,9 +49,61 @@ typedef struct {
 
 #define pit_entry_egress_add(E, NH) nexthops_add(pit_entry_get_egress(E), (NH))
 
+/**
+ * Action taken when an interest would create a new PIT entry while the PIT is
+ * full:
+ *  - DROP: the interest is dropped;
+ *  - REPLACE: the oldest PIT entry is removed to make room for the new one.
+ *
+ * Interests exceeding the quota of their ingress connection are always
+ * dropped, so that a single face cannot take over the PIT.
+ */
+#define foreach_pit_full_policy \
+  _(DROP)                       \
+  _(REPLACE)
+
+typedef enum {
+  PIT_FULL_POLICY_UNDEFINED,
+#define _(x) PIT_FULL_POLICY_##x,
+  foreach_pit_full_policy
+#undef _
+      PIT_FULL_POLICY_N,
+} pit_full_policy_t;
+
+#define PIT_FULL_POLICY_VALID(policy) \
+  ((policy) != PIT_FULL_POLICY_UNDEFINED && (policy) != PIT_FULL_POLICY_N)
+
+#define DEFAULT_PIT_FULL_POLICY PIT_FULL_POLICY_DROP
+
+pit_full_policy_t pit_full_policy_from_str(const char* str);
+
+const char* pit_full_policy_str(pit_full_policy_t policy);
+
+typedef struct {
+  uint64_t n_full_drops;   // Interests dropped because the PIT was full
+  uint64_t n_quota_drops;  // Interests dropped because of connection quotas
+  uint64_t n_replacements; // Entries replaced to admit new interests
+} pit_stats_t;
+
 typedef struct {
-  // TODO(eloparco): How to handle PIT size?
-  size_t max_size;
+  size_t max_size;                 // 0 = unbounded
+  size_t max_size_per_connection;  // 0 = unbounded
+  pit_full_policy_t full_policy;
+
+  size_t num_entries;
+  // Number of entries accounted to each connection (indexed by connection id)
+  unsigned* num_entries_per_connection;
+
+  // Oldest and newest entries (ids in the packet cache)
+  off_t head;
+  off_t tail;
+
+  // Admission sequence number of the next entry, and of the first entry that
+  // may not be replaced (entries of the interest manifest being processed)
+  uint64_t next_seq;
+  uint64_t protected_seq;
+
+  pit_stats_t stats;
 } pit_t;
 
 #define DEFAULT_INTEREST_LIFETIME 4000000000ULL
@@ -70,4 +129,43 @@ pit_t* _pit_create(size_t init_size, size_t max_size);
 
 void pit_free(pit_t* pit);
 
+/**
+ * @brief Set the maximum number of PIT entries, overall and for each ingress
+ * connection (0 = unbounded).
+ */
+void pit_set_max_size(pit_t* pit, size_t max_size,
+                      size_t max_size_per_connection);
+
+void pit_set_full_policy(pit_t* pit, pit_full_policy_t policy);
+
+#define pit_get_num_entries(pit) ((pit)->num_entries)
+
+/**
+ * @brief Return the number of PIT entries accounted to a connection.
+ */
+unsigned pit_get_num_entries_for_connection(const pit_t* pit,
+                                            unsigned connection_id);
+
+/**
+ * @brief Account a new entry to a connection.
+ */
+void pit_on_entry_added(pit_t* pit, unsigned connection_id);
+
+/**
+ * @brief Release an entry accounted to a connection.
+ */
+void pit_on_entry_removed(pit_t* pit, unsigned connection_id);
+
+/**
+ * @brief Check whether the PIT is full, i.e. whether a new entry can only be
+ * admitted by replacing an existing one.
+ */
+#define pit_is_full(pit) \
+  ((pit)->max_size != 0 && (pit)->num_entries >= (pit)->max_size)
+
+/**
+ * @brief Check whether a connection has reached its quota of PIT entries.
+ */
+bool pit_is_over_quota(const pit_t* pit, unsigned connection_id);
+
 #endif /* HICNLIGHT_PIT_H */
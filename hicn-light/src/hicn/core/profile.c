@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "profile.h"
+
+void profile_initialize(profile_t *profile) {
+  memset(&profile->data, 0, sizeof(hicn_light_profile_t));
+#ifdef WITH_PROFILING
+  profile->data.enabled = 1;
+#endif
+  profile->start_cycles = profile_cycles_now();
+  profile->start_nsec = profile_nsec_now();
+}
+
+hicn_light_profile_t profile_get(const profile_t *profile) {
+  hicn_light_profile_t data = profile->data;
+
+  /*
+   * The counter frequency is estimated over the lifetime of the profile
+   * rather than calibrated at startup, which would delay it.
+   */
+  uint64_t elapsed_nsec = profile_nsec_now() - profile->start_nsec;
+  uint64_t elapsed_cycles = profile_cycles_now() - profile->start_cycles;
+  data.cycles_per_usec =
+      elapsed_nsec ? (uint32_t)(elapsed_cycles * 1000 / elapsed_nsec) : 0;
+
+  return data;
+}
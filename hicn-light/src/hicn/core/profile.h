@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file profile.h
+ * @brief Cycle-level profiling of the forwarder receive path.
+ *
+ * When built with WITH_PROFILING, the duration of each stage of the receive
+ * path (see foreach_profile_stage) is sampled with the CPU cycle counter and
+ * accounted in a per-stage histogram, and the packet cache verdicts are
+ * counted. Otherwise, the PROFILE_* macros expand to nothing and the hot path
+ * is left untouched.
+ */
+
+#ifndef HICNLIGHT_PROFILE_H
+#define HICNLIGHT_PROFILE_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include <hicn/base.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef struct {
+  hicn_light_profile_t data;
+
+  /* Reference points used to estimate the cycle counter frequency */
+  uint64_t start_cycles;
+  uint64_t start_nsec;
+} profile_t;
+
+static inline uint64_t profile_nsec_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the current value of the cycle counter (TSC on x86, virtual
+ * counter on ARMv8), or a nanosecond timestamp on other architectures.
+ */
+static inline uint64_t profile_cycles_now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t cycles;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(cycles));
+  return cycles;
+#else
+  return profile_nsec_now();
+#endif
+}
+
+/**
+ * @brief Initialize (or reset) profiling data.
+ */
+void profile_initialize(profile_t *profile);
+
+/**
+ * @brief Returns a snapshot of the profiling data.
+ */
+hicn_light_profile_t profile_get(const profile_t *profile);
+
+#ifdef WITH_PROFILING
+
+#define PROFILE_START(START) uint64_t START = profile_cycles_now()
+
+#define PROFILE_STOP(PROFILE, STAGE, START)                       \
+  histogram_add(&(PROFILE)->data.stages[PROFILE_STAGE_##STAGE], \
+                profile_cycles_now() - (START))
+
+#define PROFILE_VERDICT(PROFILE, VERDICT) (PROFILE)->data.verdicts[VERDICT]++
+
+#else
+
+#define PROFILE_START(START)
+#define PROFILE_STOP(PROFILE, STAGE, START)
+#define PROFILE_VERDICT(PROFILE, VERDICT)
+
+#endif /* WITH_PROFILING */
+
+#endif /* HICNLIGHT_PROFILE_H */
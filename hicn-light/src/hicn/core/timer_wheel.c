@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file timer_wheel.c
+ * \brief Implementation of the hierarchical timing wheel
+ *
+ * An element expiring at time T, scheduled when the wheel is at tick t, is
+ * placed at the lowest level l such that T - t < SLOTS^(l+1), in the slot
+ * given by bits [l * SLOT_BITS, (l + 1) * SLOT_BITS) of T. The slot of level l
+ * containing tick t is cascaded when t is a multiple of SLOTS^l, at which
+ * point its elements are rescheduled on lower levels. Elements beyond the
+ * range of the wheel are placed in the farthest slot of the last level and
+ * rescheduled each time it is cascaded.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "timer_wheel.h"
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+#define _slot_index(level, i) ((level)*TIMER_WHEEL_SLOTS + (i))
+
+#define _level_shift(level) ((level)*TIMER_WHEEL_SLOT_BITS)
+
+#define _get_node(wheel, id) (wheel)->get_node((wheel)->context, (id))
+
+/******************************************************************************
+ * Slot lists (helpers)
+ ******************************************************************************/
+
+static void _timer_wheel_link(timer_wheel_t *wheel, unsigned id,
+                              timer_wheel_node_t *node, uint16_t slot) {
+  unsigned head = wheel->heads[slot];
+
+  node->slot = slot;
+  node->prev = TIMER_WHEEL_INVALID_ID;
+  node->next = head;
+  if (head != TIMER_WHEEL_INVALID_ID) _get_node(wheel, head)->prev = id;
+  wheel->heads[slot] = id;
+  wheel->n_scheduled++;
+}
+
+static void _timer_wheel_unlink(timer_wheel_t *wheel, unsigned id,
+                                timer_wheel_node_t *node) {
+  if (node->prev != TIMER_WHEEL_INVALID_ID)
+    _get_node(wheel, node->prev)->next = node->next;
+  else
+    wheel->heads[node->slot] = node->next;
+
+  if (node->next != TIMER_WHEEL_INVALID_ID)
+    _get_node(wheel, node->next)->prev = node->prev;
+
+  timer_wheel_node_init(node);
+  wheel->n_scheduled--;
+}
+
+/* Place a node according to its expiry time and the current tick */
+static void _timer_wheel_insert(timer_wheel_t *wheel, unsigned id,
+                                timer_wheel_node_t *node) {
+  Ticks expire_ts = node->expire_ts;
+  if (expire_ts < wheel->tick) expire_ts = wheel->tick;
+
+  Ticks delta = expire_ts - wheel->tick;
+  unsigned level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 &&
+         delta >= ((Ticks)1 << _level_shift(level + 1)))
+    level++;
+
+  /* Beyond the range of the wheel: use its farthest slot */
+  Ticks range = (Ticks)1 << _level_shift(TIMER_WHEEL_LEVELS);
+  if (delta >= range) expire_ts = wheel->tick + range - 1;
+
+  unsigned i = (unsigned)(expire_ts >> _level_shift(level)) & SLOT_MASK;
+  _timer_wheel_link(wheel, id, node, (uint16_t)_slot_index(level, i));
+}
+
+/* Reschedule all elements of a slot on lower levels */
+static void _timer_wheel_cascade(timer_wheel_t *wheel, unsigned level) {
+  unsigned i = (unsigned)(wheel->tick >> _level_shift(level)) & SLOT_MASK;
+  uint16_t slot = (uint16_t)_slot_index(level, i);
+
+  unsigned id = wheel->heads[slot];
+  wheel->heads[slot] = TIMER_WHEEL_INVALID_ID;
+  while (id != TIMER_WHEEL_INVALID_ID) {
+    timer_wheel_node_t *node = _get_node(wheel, id);
+    unsigned next = node->next;
+
+    wheel->n_scheduled--;
+    _timer_wheel_insert(wheel, id, node);
+
+    id = next;
+  }
+}
+
+/******************************************************************************
+ * Public API
+ ******************************************************************************/
+
+timer_wheel_t *timer_wheel_create(timer_wheel_get_node_t get_node,
+                                  void *context, Ticks now) {
+  assert(get_node);
+
+  timer_wheel_t *wheel = malloc(sizeof(timer_wheel_t));
+  if (!wheel) return NULL;
+
+  for (unsigned i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++)
+    wheel->heads[i] = TIMER_WHEEL_INVALID_ID;
+  wheel->tick = now;
+  wheel->cascaded = false;
+  wheel->n_scheduled = 0;
+  wheel->get_node = get_node;
+  wheel->context = context;
+
+  return wheel;
+}
+
+void timer_wheel_free(timer_wheel_t *wheel) { free(wheel); }
+
+void timer_wheel_schedule(timer_wheel_t *wheel, unsigned id, Ticks expire_ts) {
+  assert(wheel);
+
+  timer_wheel_node_t *node = _get_node(wheel, id);
+  if (timer_wheel_node_is_scheduled(node)) _timer_wheel_unlink(wheel, id, node);
+
+  node->expire_ts = expire_ts;
+  _timer_wheel_insert(wheel, id, node);
+}
+
+void timer_wheel_cancel(timer_wheel_t *wheel, unsigned id) {
+  assert(wheel);
+
+  timer_wheel_node_t *node = _get_node(wheel, id);
+  if (timer_wheel_node_is_scheduled(node)) _timer_wheel_unlink(wheel, id, node);
+}
+
+size_t timer_wheel_advance(timer_wheel_t *wheel, Ticks now, size_t budget,
+                           timer_wheel_on_expiry_t on_expiry, void *data) {
+  assert(wheel);
+  assert(on_expiry);
+
+  size_t n_expired = 0;
+
+  while (wheel->tick <= now) {
+    /* Nothing to do while the wheel is empty */
+    if (wheel->n_scheduled == 0) {
+      wheel->tick = now + 1;
+      wheel->cascaded = false;
+      break;
+    }
+
+    /* Cascade upper levels first, as they can feed the lower ones */
+    if (!wheel->cascaded) {
+      for (unsigned level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        Ticks mask = ((Ticks)1 << _level_shift(level)) - 1;
+        if ((wheel->tick & mask) == 0) _timer_wheel_cascade(wheel, level);
+      }
+      wheel->cascaded = true;
+    }
+
+    /* Expire elements of the current slot */
+    uint16_t slot = (uint16_t)_slot_index(0, wheel->tick & SLOT_MASK);
+    while (wheel->heads[slot] != TIMER_WHEEL_INVALID_ID) {
+      if (n_expired == budget) return n_expired;
+
+      unsigned id = wheel->heads[slot];
+      _timer_wheel_unlink(wheel, id, _get_node(wheel, id));
+      on_expiry(wheel->context, id, data);
+      n_expired++;
+    }
+
+    wheel->tick++;
+    wheel->cascaded = false;
+  }
+
+  return n_expired;
+}
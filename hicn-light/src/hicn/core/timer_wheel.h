@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file timer_wheel.h
+ * @brief Hierarchical timing wheel
+ *
+ * The wheel schedules elements identified by an unsigned id (typically their
+ * position in a pool) at a given expiry time, expressed in Ticks. It is made
+ * of TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots each: level 0 has a
+ * resolution of one tick, and each slot of level l spans the whole level l-1.
+ * Elements are moved (cascaded) to the lower level when the wheel reaches
+ * their slot, so that scheduling, cancelling and expiring an element are all
+ * O(1) operations.
+ *
+ * Elements are chained in doubly-linked lists through a timer_wheel_node_t
+ * embedded in each of them, which the owner exposes through a callback. No
+ * memory is thus allocated by the wheel after its creation.
+ */
+
+#ifndef HICNLIGHT_TIMER_WHEEL_H
+#define HICNLIGHT_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ticks.h"
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+
+#define TIMER_WHEEL_INVALID_ID (~0u)
+
+typedef struct {
+  unsigned prev;
+  unsigned next;
+  uint16_t slot; /* Index across all levels, TIMER_WHEEL_NO_SLOT if none */
+  Ticks expire_ts;
+} timer_wheel_node_t;
+
+#define TIMER_WHEEL_NO_SLOT UINT16_MAX
+
+/**
+ * @brief Initialize the node of an element that is not (yet) scheduled.
+ */
+#define timer_wheel_node_init(node)      \
+  do {                                   \
+    (node)->prev = TIMER_WHEEL_INVALID_ID; \
+    (node)->next = TIMER_WHEEL_INVALID_ID; \
+    (node)->slot = TIMER_WHEEL_NO_SLOT;    \
+  } while (0)
+
+#define timer_wheel_node_is_scheduled(node) \
+  ((node)->slot != TIMER_WHEEL_NO_SLOT)
+
+/**
+ * @brief Returns the node embedded in the element with the specified id.
+ */
+typedef timer_wheel_node_t *(*timer_wheel_get_node_t)(void *context,
+                                                       unsigned id);
+
+/**
+ * @brief Called for each expired element, which has already been removed from
+ * the wheel (and can thus be rescheduled).
+ */
+typedef void (*timer_wheel_on_expiry_t)(void *context, unsigned id,
+                                        void *data);
+
+typedef struct {
+  unsigned heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+
+  /* Next tick to process; all previous ticks have been processed */
+  Ticks tick;
+  /* Whether the upper levels have been cascaded for the current tick */
+  bool cascaded;
+
+  size_t n_scheduled;
+
+  timer_wheel_get_node_t get_node;
+  void *context;
+} timer_wheel_t;
+
+/**
+ * @brief Create a timing wheel.
+ *
+ * @param[in] get_node Callback used to retrieve the node of an element
+ * @param[in] context Opaque context passed to the callbacks
+ * @param[in] now Current time
+ *
+ * @return timer_wheel_t* The newly created wheel, or NULL in case of error
+ */
+timer_wheel_t *timer_wheel_create(timer_wheel_get_node_t get_node,
+                                  void *context, Ticks now);
+
+void timer_wheel_free(timer_wheel_t *wheel);
+
+/**
+ * @brief Schedule an element to expire at the specified time. If the element
+ * was already scheduled, its expiry time is replaced.
+ */
+void timer_wheel_schedule(timer_wheel_t *wheel, unsigned id, Ticks expire_ts);
+
+/**
+ * @brief Remove an element from the wheel (no-op if it is not scheduled).
+ */
+void timer_wheel_cancel(timer_wheel_t *wheel, unsigned id);
+
+/**
+ * @brief Expire elements up to the specified time.
+ *
+ * @param[in] wheel The timing wheel
+ * @param[in] now Current time
+ * @param[in] budget Maximum number of elements to expire; the remaining ones
+ * are expired on the next call
+ * @param[in] on_expiry Callback invoked for each expired element
+ * @param[in] data User data passed to the callback
+ *
+ * @return The number of expired elements
+ */
+size_t timer_wheel_advance(timer_wheel_t *wheel, Ticks now, size_t budget,
+                           timer_wheel_on_expiry_t on_expiry, void *data);
+
+#define timer_wheel_len(wheel) ((wheel)->n_scheduled)
+
+#endif /* HICNLIGHT_TIMER_WHEEL_H */
@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file worker.c
+ * @brief Implementation of the multi-threaded data plane
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include <hicn/base/loop.h>
+#include <hicn/util/log.h>
+#include <hicn/util/vector.h>
+
+#include "worker.h"
+#include "../config/commands.h"
+#include "../config/configuration_file.h"
+#include "../io/base.h"  // MAX_MSG
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+/* Maximum number of messages waiting in the queue of a worker */
+#define WORKER_QUEUE_MAX_SIZE 4096
+
+typedef enum {
+  WORKER_MSG_PACKET,  /* Packet to process as if received by the worker */
+  WORKER_MSG_COMMAND, /* Command replicated from worker 0 (no reply) */
+} worker_msg_type_t;
+
+typedef struct {
+  worker_msg_type_t type;
+  bool has_ingress; /* Whether listener_key and pair are set */
+  listener_key_t listener_key;
+  address_pair_t pair;
+  size_t len;
+  uint8_t packet[MSGBUF_MAX_SIZE];
+} worker_msg_t;
+
+typedef struct {
+  unsigned id;
+  workers_t *workers;
+  forwarder_t *forwarder;
+  configuration_t *config;
+  pthread_t thread;
+
+  /* Messages sent by other workers, protected by the lock */
+  pthread_mutex_t lock;
+  worker_msg_t *queue;
+  bool stop;
+
+  /* Wakeup pipe, and the associated event in the worker loop */
+  int fd[2];
+  event_t *event;
+
+  /* Messages being processed (owner only) */
+  worker_msg_t *inbox;
+
+  /* Workers to notify upon flush (owner only) */
+  unsigned *pending;
+
+  /* Statistics (owner only) */
+  size_t n_handoffs;
+  size_t n_handoff_drops;
+} worker_t;
+
+struct workers_s {
+  unsigned n_workers;
+  worker_t *workers;
+};
+
+/*
+ * Enqueue a message into the queue of a worker, and mark the destination as
+ * pending for the source worker. Only the first len bytes of the packet are
+ * copied.
+ */
+static int _workers_enqueue(workers_t *workers, unsigned src, unsigned dst,
+                            worker_msg_type_t type, const listener_key_t *key,
+                            const address_pair_t *pair, const uint8_t *packet,
+                            size_t len) {
+  worker_t *worker = &workers->workers[dst];
+  int rc = -1;
+
+  if (len > MSGBUF_MAX_SIZE) return -1;
+
+  pthread_mutex_lock(&worker->lock);
+  size_t pos = vector_len(worker->queue);
+  if ((type == WORKER_MSG_PACKET) && (pos >= WORKER_QUEUE_MAX_SIZE))
+    goto END;
+  if (_vector_ensure_pos((void **)&worker->queue, sizeof(worker_msg_t), pos) <
+      0)
+    goto END;
+
+  worker_msg_t *msg = &worker->queue[pos];
+  msg->type = type;
+  msg->has_ingress = key && pair;
+  if (key) msg->listener_key = *key;
+  if (pair) msg->pair = *pair;
+  msg->len = len;
+  memcpy(msg->packet, packet, len);
+  vector_len(worker->queue)++;
+  rc = 0;
+
+END:
+  pthread_mutex_unlock(&worker->lock);
+
+  worker_t *self = &workers->workers[src];
+  if (rc < 0) {
+    self->n_handoff_drops++;
+    return -1;
+  }
+  self->n_handoffs++;
+  if (!vector_contains(self->pending, dst)) vector_push(self->pending, dst);
+  return 0;
+}
+
+static void _worker_notify(worker_t *worker) {
+  char c = 0;
+  if (write(worker->fd[1], &c, 1) < 0 && errno != EAGAIN)
+    ERROR("[worker] Could not notify worker %u: (%d) %s", worker->id, errno,
+          strerror(errno));
+}
+
+/*
+ * Resolve the connection on which a replicated command was received by worker
+ * 0 to the connection of this worker towards the same peer, which is created
+ * if needed and allowed.
+ */
+static unsigned _worker_get_ingress(worker_t *worker, const worker_msg_t *msg,
+                                    bool create) {
+  forwarder_t *forwarder = worker->forwarder;
+
+  if (!msg->has_ingress) return CONNECTION_ID_UNDEFINED;
+
+  connection_table_t *table = forwarder_get_connection_table(forwarder);
+  const connection_t *connection =
+      connection_table_get_by_pair(table, &msg->pair);
+  if (connection) return connection_table_get_connection_id(table, connection);
+  if (!create) return CONNECTION_ID_UNDEFINED;
+
+  listener_table_t *listener_table = forwarder_get_listener_table(forwarder);
+  listener_t *listener =
+      listener_table_get_by_key(listener_table, &msg->listener_key);
+  if (!listener) return CONNECTION_ID_UNDEFINED;
+
+  char name[SYMBOLIC_NAME_LEN];
+  if (connection_table_get_random_name(table, name) < 0)
+    return CONNECTION_ID_UNDEFINED;
+  return listener_create_connection(listener, name, &msg->pair);
+}
+
+static void _worker_process_command(worker_t *worker, worker_msg_t *msg) {
+  forwarder_t *forwarder = worker->forwarder;
+  const msg_header_t *header = (const msg_header_t *)msg->packet;
+  connection_t *self = NULL;
+  unsigned ingress_id;
+
+  switch (header->header.command_id) {
+    case COMMAND_TYPE_CONNECTION_REMOVE: {
+      /* Removing SELF is a no-op if this worker has no connection to it */
+      const msg_connection_remove_t *remove =
+          (const msg_connection_remove_t *)msg->packet;
+      ingress_id = _worker_get_ingress(worker, msg, false);
+      if (strcmp(remove->payload.symbolic_or_connid, "SELF") == 0) {
+        if (!connection_id_is_valid(ingress_id)) return;
+        connection_table_t *table = forwarder_get_connection_table(forwarder);
+        self = connection_table_at(table, ingress_id);
+      }
+      break;
+    }
+    case COMMAND_TYPE_ROUTE_ADD:
+    case COMMAND_TYPE_BATCH:
+      /* Routes through SELF use the connection of this worker to the peer */
+      ingress_id = _worker_get_ingress(worker, msg, true);
+      break;
+    default:
+      ingress_id = _worker_get_ingress(worker, msg, false);
+      break;
+  }
+
+  size_t reply_size = 0;
+  uint8_t *reply =
+      command_process(forwarder, msg->packet, ingress_id, &reply_size);
+
+  /* As on worker 0, a removed SELF connection is finalized once processed */
+  if (self && ((msg_header_t *)reply)->header.message_type == ACK_LIGHT)
+    connection_finalize(self);
+  if (reply != msg->packet) free(reply);
+}
+
+static void _worker_process_msg(worker_t *worker, worker_msg_t *msg) {
+  forwarder_t *forwarder = worker->forwarder;
+
+  switch (msg->type) {
+    case WORKER_MSG_PACKET: {
+      listener_table_t *table = forwarder_get_listener_table(forwarder);
+      listener_t *listener =
+          listener_table_get_by_key(table, &msg->listener_key);
+      if (!listener) {
+        WARN("[worker] Worker %u has no listener for handed off packet",
+             worker->id);
+        return;
+      }
+
+      msgbuf_pool_t *msgbuf_pool = forwarder_get_msgbuf_pool(forwarder);
+      msgbuf_t *msgbuf = NULL;
+      off_t msgbuf_id = _msgbuf_pool_get(
+          msgbuf_pool, msgbuf_class_fit(msg->len), &msgbuf);
+      if (!msgbuf_id_is_valid(msgbuf_id)) return;
+
+      memcpy(msgbuf_get_packet(msgbuf), msg->packet, msg->len);
+      msgbuf_set_len(msgbuf, msg->len);
+      msgbuf_pool_acquire(msgbuf);
+      forwarder_acquired_msgbuf_ids_push(forwarder, msgbuf_id);
+
+      /* Connection ids are local to a worker: lookup is done by address pair */
+      msgbuf_set_connection_id(msgbuf, CONNECTION_ID_UNDEFINED);
+
+      forwarder_receive(forwarder, listener, msgbuf_id, &msg->pair,
+                        ticks_now());
+      break;
+    }
+
+    case WORKER_MSG_COMMAND:
+      _worker_process_command(worker, msg);
+      break;
+  }
+}
+
+static int _worker_on_wakeup(void *owner, int fd, unsigned id, void *data) {
+  worker_t *worker = (worker_t *)owner;
+  forwarder_t *forwarder = worker->forwarder;
+  char buf[64];
+
+  /* Drain the wakeup pipe: pending messages are all in the queue */
+  while (read(fd, buf, sizeof(buf)) > 0)
+    ;
+
+  pthread_mutex_lock(&worker->lock);
+  bool stop = worker->stop;
+  worker_msg_t *queue = worker->queue;
+  worker->queue = worker->inbox;
+  worker->inbox = queue;
+  pthread_mutex_unlock(&worker->lock);
+
+  if (stop) {
+    loop_break(MAIN_LOOP);
+    return 0;
+  }
+
+  forwarder_acquired_msgbuf_ids_reset(forwarder);
+
+  worker_msg_t *msg;
+  vector_foreach(worker->inbox, msg, { _worker_process_msg(worker, msg); });
+  vector_reset(worker->inbox);
+
+  forwarder_flush_connections(forwarder);
+
+  msgbuf_pool_t *msgbuf_pool = forwarder_get_msgbuf_pool(forwarder);
+  const off_t *acquired_msgbuf_ids =
+      forwarder_get_acquired_msgbuf_ids(forwarder);
+  for (int i = 0; i < vector_len(acquired_msgbuf_ids); i++) {
+    msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, acquired_msgbuf_ids[i]);
+    msgbuf_pool_release(msgbuf_pool, &msgbuf);
+  }
+
+  return 0;
+}
+
+static int _worker_register(worker_t *worker) {
+  loop_fd_event_create(&worker->event, MAIN_LOOP, worker->fd[0], worker,
+                       _worker_on_wakeup, 0, NULL);
+  if (!worker->event) return -1;
+  return loop_fd_event_register(worker->event);
+}
+
+static void _worker_unregister(worker_t *worker) {
+  if (!worker->event) return;
+  loop_event_unregister(worker->event);
+  loop_event_free(worker->event);
+  worker->event = NULL;
+}
+
+static void *_worker_run(void *arg) {
+  worker_t *worker = (worker_t *)arg;
+  configuration_t *worker_config = worker->config;
+
+  MAIN_LOOP = loop_create();
+  if (!MAIN_LOOP) goto ERR_LOOP;
+
+  forwarder_t *forwarder = forwarder_create(worker_config);
+  if (!forwarder) goto ERR_FORWARDER;
+  forwarder_set_workers(forwarder, worker->workers, worker->id);
+  worker->forwarder = forwarder;
+
+  /*
+   * Listeners are created with SO_REUSEPORT, so that all workers share the
+   * same local addresses and the kernel distributes flows among them.
+   */
+  forwarder_setup_local_listeners(forwarder,
+                                  configuration_get_port(worker_config));
+  const char *fn_config = configuration_get_fn_config(worker_config);
+  if (fn_config) configuration_file_process(forwarder, fn_config);
+
+  if (_worker_register(worker) < 0) goto ERR_REGISTER;
+
+  INFO("[worker] Worker %u started", worker->id);
+  loop_dispatch(MAIN_LOOP);
+  INFO("[worker] Worker %u stopped (handoffs=%zu, drops=%zu)", worker->id,
+       worker->n_handoffs, worker->n_handoff_drops);
+
+  _worker_unregister(worker);
+ERR_REGISTER:
+  forwarder_free(forwarder); /* also frees worker_config */
+  worker->forwarder = NULL;
+  worker_config = NULL;
+ERR_FORWARDER:
+  loop_free(MAIN_LOOP);
+  MAIN_LOOP = NULL;
+ERR_LOOP:
+  if (worker_config) configuration_free(worker_config);
+  worker->config = NULL;
+  return NULL;
+}
+
+static int _worker_initialize(worker_t *worker, workers_t *workers,
+                              unsigned id, forwarder_t *forwarder) {
+  *worker = (worker_t){
+      .id = id,
+      .workers = workers,
+      /* Other workers create their own forwarder in their thread */
+      .forwarder = (id == 0) ? forwarder : NULL,
+  };
+
+  if (pipe(worker->fd) < 0) goto ERR_PIPE;
+  for (unsigned i = 0; i < 2; i++)
+    fcntl(worker->fd[i], F_SETFL, fcntl(worker->fd[i], F_GETFL) | O_NONBLOCK);
+
+  pthread_mutex_init(&worker->lock, NULL);
+  vector_init(worker->queue, MAX_MSG, 0);
+  vector_init(worker->inbox, MAX_MSG, 0);
+  vector_init(worker->pending, workers->n_workers, 0);
+  return 0;
+
+ERR_PIPE:
+  ERROR("[worker] Could not create wakeup pipe: (%d) %s", errno,
+        strerror(errno));
+  return -1;
+}
+
+static void _worker_finalize(worker_t *worker) {
+  close(worker->fd[0]);
+  close(worker->fd[1]);
+  pthread_mutex_destroy(&worker->lock);
+  vector_free(worker->queue);
+  vector_free(worker->inbox);
+  vector_free(worker->pending);
+}
+
+workers_t *workers_create(forwarder_t *forwarder, unsigned n_workers) {
+  assert(forwarder);
+  assert(n_workers > 0);
+
+  workers_t *workers = malloc(sizeof(workers_t));
+  if (!workers) goto ERR_MALLOC;
+
+  workers->n_workers = n_workers;
+  workers->workers = calloc(n_workers, sizeof(worker_t));
+  if (!workers->workers) goto ERR_WORKERS;
+
+  unsigned n_initialized;
+  for (n_initialized = 0; n_initialized < n_workers; n_initialized++)
+    if (_worker_initialize(&workers->workers[n_initialized], workers,
+                           n_initialized, forwarder) < 0)
+      goto ERR_INITIALIZE;
+
+  /*
+   * Each worker owns a shard of the content store: split the configured
+   * capacity so that the overall memory footprint is unchanged.
+   */
+  configuration_t *config = forwarder_get_configuration(forwarder);
+  size_t cs_size = configuration_get_cs_size(config) / n_workers;
+  configuration_set_cs_size(config, cs_size);
+  forwarder_cs_set_size(forwarder, cs_size);
+
+  /* PIT limits are split likewise, rounding up so that they remain non-zero */
+  size_t pit_size = configuration_get_pit_size(config);
+  size_t pit_size_per_connection =
+      configuration_get_pit_size_per_connection(config);
+  pit_size = (pit_size + n_workers - 1) / n_workers;
+  pit_size_per_connection =
+      (pit_size_per_connection + n_workers - 1) / n_workers;
+  configuration_set_pit_size(config, pit_size, pit_size_per_connection);
+  forwarder_pit_set_size(forwarder, pit_size, pit_size_per_connection);
+
+  /*
+   * So is the second tier of the content store, each worker having its own
+   * file: the main thread keeps the configured path, and other workers append
+   * their id to it.
+   */
+  const char *cs_disk_path = configuration_get_cs_disk_path(config);
+  size_t cs_disk_size = configuration_get_cs_disk_size(config) / n_workers;
+  if (cs_disk_path && n_workers > 1) {
+    configuration_set_cs_disk(config, cs_disk_path, cs_disk_size);
+    if (forwarder_cs_set_disk(forwarder, cs_disk_path, cs_disk_size) < 0)
+      goto ERR_CONFIG;
+  }
+
+  for (unsigned i = 1; i < n_workers; i++) {
+    configuration_t *worker_config = configuration_clone(config);
+    workers->workers[i].config = worker_config;
+    if (!worker_config) goto ERR_CONFIG;
+
+    if (cs_disk_path) {
+      char path[PATH_MAX];
+      int rc = snprintf(path, PATH_MAX, "%s.%u", cs_disk_path, i);
+      if (rc < 0 || rc >= PATH_MAX) goto ERR_CONFIG;
+      configuration_set_cs_disk(worker_config, path, cs_disk_size);
+    }
+  }
+
+  /* Worker 0 is the main thread */
+  forwarder_set_workers(forwarder, workers, 0);
+  if (_worker_register(&workers->workers[0]) < 0) goto ERR_REGISTER;
+
+  /* Signals are handled by the main thread only */
+  sigset_t mask, old_mask;
+  sigfillset(&mask);
+  pthread_sigmask(SIG_BLOCK, &mask, &old_mask);
+
+  unsigned n_started;
+  for (n_started = 1; n_started < n_workers; n_started++) {
+    worker_t *worker = &workers->workers[n_started];
+    if (pthread_create(&worker->thread, NULL, _worker_run, worker) != 0) {
+      ERROR("[worker] Could not start worker %u", n_started);
+      break;
+    }
+  }
+
+  pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+  if (n_started < n_workers) {
+    for (unsigned i = n_started; i < n_workers; i++)
+      configuration_free(workers->workers[i].config);
+    workers->n_workers = n_started;
+    workers_free(workers);
+    return NULL;
+  }
+
+  INFO("[worker] Started %u workers", n_workers);
+  return workers;
+
+ERR_REGISTER:
+  forwarder_set_workers(forwarder, NULL, 0);
+ERR_CONFIG:
+  for (unsigned i = 1; i < n_workers; i++)
+    if (workers->workers[i].config)
+      configuration_free(workers->workers[i].config);
+ERR_INITIALIZE:
+  for (unsigned i = 0; i < n_initialized; i++)
+    _worker_finalize(&workers->workers[i]);
+  free(workers->workers);
+ERR_WORKERS:
+  free(workers);
+ERR_MALLOC:
+  return NULL;
+}
+
+void workers_free(workers_t *workers) {
+  assert(workers);
+
+  for (unsigned i = 1; i < workers->n_workers; i++) {
+    worker_t *worker = &workers->workers[i];
+    pthread_mutex_lock(&worker->lock);
+    worker->stop = true;
+    pthread_mutex_unlock(&worker->lock);
+    _worker_notify(worker);
+    pthread_join(worker->thread, NULL);
+  }
+
+  worker_t *main_worker = &workers->workers[0];
+  _worker_unregister(main_worker);
+  forwarder_set_workers(main_worker->forwarder, NULL, 0);
+
+  for (unsigned i = 0; i < workers->n_workers; i++)
+    _worker_finalize(&workers->workers[i]);
+  free(workers->workers);
+  free(workers);
+}
+
+unsigned workers_get_num(const workers_t *workers) {
+  return workers->n_workers;
+}
+
+unsigned workers_get_shard(const workers_t *workers, const hicn_name_t *name) {
+  /*
+   * Sharding on the prefix keeps all suffixes of a prefix (and thus interest
+   * manifests) on the same worker, and matches the two-level indexing of the
+   * packet cache.
+   */
+  return hicn_name_get_prefix_hash(name) % workers->n_workers;
+}
+
+int workers_handoff(workers_t *workers, unsigned src, unsigned dst,
+                    const listener_t *listener, const address_pair_t *pair,
+                    const msgbuf_t *msgbuf) {
+  assert(dst < workers->n_workers);
+  assert(src != dst);
+
+  return _workers_enqueue(workers, src, dst, WORKER_MSG_PACKET, &listener->key,
+                          pair, msgbuf_get_packet(msgbuf),
+                          msgbuf_get_len(msgbuf));
+}
+
+void workers_replicate_command(workers_t *workers, command_type_t type,
+                               const listener_t *listener,
+                               const address_pair_t *pair,
+                               const uint8_t *packet, size_t size) {
+  switch (type) {
+    case COMMAND_TYPE_LISTENER_LIST:
+    case COMMAND_TYPE_CONNECTION_LIST:
+    case COMMAND_TYPE_ROUTE_LIST:
+    case COMMAND_TYPE_CACHE_LIST:
+    case COMMAND_TYPE_POLICY_LIST:
+    case COMMAND_TYPE_STATS_LIST:
+    case COMMAND_TYPE_FACE_STATS_LIST:
+    case COMMAND_TYPE_PROFILE_LIST:
+    case COMMAND_TYPE_SUBSCRIPTION_ADD:
+    case COMMAND_TYPE_SUBSCRIPTION_REMOVE:
+    case COMMAND_TYPE_ACTIVE_INTERFACE_UPDATE:
+    case COMMAND_TYPE_MAPME_SEND_UPDATE:
+      return;
+    default:
+      break;
+  }
+
+  const listener_key_t *key = listener ? &listener->key : NULL;
+  for (unsigned i = 1; i < workers->n_workers; i++)
+    if (_workers_enqueue(workers, 0, i, WORKER_MSG_COMMAND, key, pair, packet,
+                         size) < 0)
+      ERROR("[worker] Could not replicate command to worker %u", i);
+}
+
+void workers_flush(workers_t *workers, unsigned src) {
+  worker_t *self = &workers->workers[src];
+
+  unsigned *dst;
+  vector_foreach(self->pending, dst,
+                 { _worker_notify(&workers->workers[*dst]); });
+  vector_reset(self->pending);
+}
+
+#else
+
+workers_t *workers_create(forwarder_t *forwarder, unsigned n_workers) {
+  ERROR("[worker] Multiple workers are not supported on this platform");
+  return NULL;
+}
+
+void workers_free(workers_t *workers) {}
+
+unsigned workers_get_num(const workers_t *workers) { return 1; }
+
+unsigned workers_get_shard(const workers_t *workers, const hicn_name_t *name) {
+  return 0;
+}
+
+int workers_handoff(workers_t *workers, unsigned src, unsigned dst,
+                    const listener_t *listener, const address_pair_t *pair,
+                    const msgbuf_t *msgbuf) {
+  return -1;
+}
+
+void workers_replicate_command(workers_t *workers, command_type_t type,
+                               const listener_t *listener,
+                               const address_pair_t *pair,
+                               const uint8_t *packet, size_t size) {}
+
+void workers_flush(workers_t *workers, unsigned src) {}
+
+#endif /* _WIN32 */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file worker.h
+ * @brief Multi-threaded data plane
+ *
+ * The data plane can be split across N workers, each of them being a thread
+ * running its own event loop and forwarder instance (listeners, connections,
+ * msgbuf pool and packet cache). Worker 0 is the main thread.
+ *
+ * Listener sockets are bound by every worker with SO_REUSEPORT so that the
+ * kernel spreads incoming flows across workers (RSS-style). The PIT/CS is
+ * sharded by name prefix hash: a packet received by a worker that does not
+ * own its shard is copied to the owner through a per-worker queue, and the
+ * owner is woken up once per batch.
+ *
+ * The control plane is centralized on worker 0: commands received by other
+ * workers are handed over to worker 0, which replicates those that modify the
+ * forwarder state to all other workers.
+ */
+
+#ifndef HICNLIGHT_WORKER_H
+#define HICNLIGHT_WORKER_H
+
+#include "forwarder.h"
+
+typedef struct workers_s workers_t;
+
+/**
+ * @brief Start the data plane workers.
+ *
+ * @param[in] forwarder - Forwarder running on the main thread (worker 0)
+ * @param[in] n_workers - Total number of workers, including the main thread
+ *
+ * @return workers_t* The set of started workers, or NULL in case of error
+ */
+workers_t *workers_create(forwarder_t *forwarder, unsigned n_workers);
+
+/**
+ * @brief Stop all workers (apart from the main thread) and release resources.
+ */
+void workers_free(workers_t *workers);
+
+unsigned workers_get_num(const workers_t *workers);
+
+/**
+ * @brief Returns the worker owning the packet cache shard of a given name.
+ */
+unsigned workers_get_shard(const workers_t *workers, const hicn_name_t *name);
+
+/**
+ * @brief Queue a received packet for processing by another worker.
+ *
+ * The packet is copied, and the destination worker is notified upon the next
+ * call to workers_flush().
+ *
+ * @param[in] workers - The set of workers
+ * @param[in] src - Worker calling the function
+ * @param[in] dst - Worker that should process the packet
+ * @param[in] listener - Listener on which the packet was received
+ * @param[in] pair - Address pair on which the packet was received
+ * @param[in] msgbuf - Received packet
+ *
+ * @return 0 in case of success, -1 otherwise (the packet should be dropped)
+ */
+int workers_handoff(workers_t *workers, unsigned src, unsigned dst,
+                    const listener_t *listener, const address_pair_t *pair,
+                    const msgbuf_t *msgbuf);
+
+/**
+ * @brief Replicate a control command successfully processed by worker 0 on
+ * all other workers. Commands that do not modify the forwarder state
+ * (listings, subscriptions, ...) are ignored.
+ *
+ * Connection ids are local to each worker: the listener and address pair on
+ * which the command was received allow every worker to resolve SELF to its
+ * own connection towards the same peer.
+ *
+ * @param[in] workers - The set of workers
+ * @param[in] type - Type of the command
+ * @param[in] listener - Listener on which the command was received (or NULL)
+ * @param[in] pair - Address pair on which the command was received (or NULL)
+ * @param[in] packet - Command, as received before being processed
+ * @param[in] size - Size of the command
+ */
+void workers_replicate_command(workers_t *workers, command_type_t type,
+                               const listener_t *listener,
+                               const address_pair_t *pair,
+                               const uint8_t *packet, size_t size);
+
+/**
+ * @brief Notify the workers for which packets have been queued by worker src.
+ */
+void workers_flush(workers_t *workers, unsigned src);
+
+#endif /* HICNLIGHT_WORKER_H */
@@ -54,7 +54,8 @@ ssize_t io_read_single_socket(int fd, msgbuf_t *msgbuf, address_t *address) {
   socklen_t sa_len = sizeof(sa);
   uint8_t *packet = msgbuf_get_packet(msgbuf);
 
-  ssize_t n = recvfrom(fd, packet, MTU, 0, (struct sockaddr *)sa, &sa_len);
+  ssize_t n = recvfrom(fd, packet, msgbuf_get_buffer_size(msgbuf), 0,
+                       (struct sockaddr *)sa, &sa_len);
   msgbuf_set_len(msgbuf, (size_t)n);
 
 #ifdef __APPLE__
@@ -90,7 +91,7 @@ ssize_t io_read_batch_socket(int fd, msgbuf_t **msgbuf, address_t **address,
 
     iovecs[i] = (struct iovec){
         .iov_base = msgbuf_get_packet(msgbuf[i]),
-        .iov_len = MTU,
+        .iov_len = msgbuf_get_buffer_size(msgbuf[i]),
     };
   }
 
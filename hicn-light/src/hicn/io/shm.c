@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file shm.c
+ * @brief Implementation of shared memory faces with local applications
+ *
+ * Applications connect to a UNIX socket of the listener and pass it a memory
+ * region holding a pair of packet rings (see hicn/util/shm_ring.h). The
+ * accepted socket becomes the connection fd: it carries the notifications of
+ * both sides when their consumer has to be woken up, and its closure by the
+ * application removes the connection.
+ *
+ * Packets are copied between the rings and the message buffers, which saves
+ * the system calls and the kernel networking stack traversal of the UDP
+ * faces, but not the copies.
+ */
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <hicn/util/log.h>
+#include <hicn/util/shm_ring.h>
+
+#include "base.h"
+#include "../core/connection.h"
+#include "../core/connection_vft.h"
+#include "../core/connection_table.h"
+#include "../core/forwarder.h"
+#include "../core/listener.h"
+#include "../core/listener_vft.h"
+#include "../core/msgbuf.h"
+
+/* Maximum number of shared memory faces per worker */
+#define SHM_MAX_FACES 64
+
+#define SHM_LISTEN_BACKLOG 16
+
+/* Maximum number of applications connected but yet to send their region */
+#define SHM_MAX_HANDSHAKES SHM_LISTEN_BACKLOG
+
+/* Time allowed to the application to send its region once connected */
+#define SHM_HANDSHAKE_TIMEOUT_MS 100
+
+typedef struct {
+  int fd;
+  unsigned connection_id;
+  forwarder_t *forwarder;
+  hicn_shm_region_t *region;
+  size_t size;
+  /* Private head of the ring towards the application */
+  uint32_t tx_head;
+} shm_face_t;
+
+/*
+ * The read callbacks only receive the file descriptor, which is used to find
+ * the face. Faces are only accessed by the worker which accepted them.
+ */
+static LOOP_THREAD_LOCAL shm_face_t *shm_faces[SHM_MAX_FACES];
+
+static shm_face_t *shm_face_get(int fd) {
+  for (unsigned i = 0; i < SHM_MAX_FACES; i++)
+    if (shm_faces[i] && shm_faces[i]->fd == fd) return shm_faces[i];
+  return NULL;
+}
+
+static shm_face_t *shm_face_create(int fd, hicn_shm_region_t *region,
+                                   size_t size) {
+  for (unsigned i = 0; i < SHM_MAX_FACES; i++) {
+    if (shm_faces[i]) continue;
+
+    shm_face_t *face = malloc(sizeof(shm_face_t));
+    if (!face) return NULL;
+    *face = (shm_face_t){
+        .fd = fd,
+        .connection_id = CONNECTION_ID_UNDEFINED,
+        .region = region,
+        .size = size,
+        .tx_head = region->rings[HICN_SHM_RING_FROM_FWD].head,
+    };
+    shm_faces[i] = face;
+    return face;
+  }
+  return NULL;
+}
+
+static void shm_face_free(int fd) {
+  for (unsigned i = 0; i < SHM_MAX_FACES; i++) {
+    shm_face_t *face = shm_faces[i];
+    if (!face || face->fd != fd) continue;
+
+    munmap(face->region, face->size);
+    free(face);
+    shm_faces[i] = NULL;
+    return;
+  }
+}
+
+/* Wake up the application, unless the socket is already full of wake ups */
+static void shm_face_notify(const shm_face_t *face) {
+  if (send(face->fd, "", 1, MSG_DONTWAIT | MSG_NOSIGNAL) < 0 &&
+      errno != EAGAIN && errno != EWOULDBLOCK)
+    WARN("[shm] Could not notify face %u: (%d) %s", face->connection_id, errno,
+         strerror(errno));
+}
+
+/******************************************************************************
+ * Listener
+ ******************************************************************************/
+
+/*
+ * The region is received asynchronously so as not to block the loop: the
+ * accepted socket is watched until the application sends it, or the handshake
+ * times out.
+ */
+typedef struct {
+  int fd;
+  listener_t *listener;
+  event_t *event;
+  event_t *timer;
+} shm_handshake_t;
+
+typedef struct {
+  shm_handshake_t *handshakes[SHM_MAX_HANDSHAKES];
+} listener_shm_data_t;
+
+/* Stop watching the socket of the handshake, which is not closed */
+static void shm_handshake_free(shm_handshake_t *handshake) {
+  listener_shm_data_t *data = handshake->listener->data;
+  for (unsigned i = 0; i < SHM_MAX_HANDSHAKES; i++)
+    if (data->handshakes[i] == handshake) data->handshakes[i] = NULL;
+
+  if (handshake->event) loop_event_free(handshake->event);
+  if (handshake->timer) loop_event_free(handshake->timer);
+  free(handshake);
+}
+
+static int listener_shm_initialize(listener_t *listener) {
+  listener_shm_data_t *data = listener->data;
+  for (unsigned i = 0; i < SHM_MAX_HANDSHAKES; i++)
+    data->handshakes[i] = NULL;
+  return 0;
+}
+
+static void listener_shm_finalize(listener_t *listener) {
+  listener_shm_data_t *data = listener->data;
+  for (unsigned i = 0; i < SHM_MAX_HANDSHAKES; i++) {
+    shm_handshake_t *handshake = data->handshakes[i];
+    if (!handshake) continue;
+    close(handshake->fd);
+    shm_handshake_free(handshake);
+  }
+}
+
+static int listener_shm_punt(const listener_t *listener, const char *prefix_s) {
+  return -1;
+}
+
+static int listener_shm_get_socket(const listener_t *listener,
+                                   const address_t *local,
+                                   const address_t *remote,
+                                   const char *interface_name) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  in_port_t port = (local->as_ss.ss_family == AF_INET)
+                       ? local->as_sin.sin_port
+                       : local->as_sin6.sin6_port;
+
+  /* Abstract namespace: the name is not bound to the filesystem */
+  int len = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1,
+                     HICN_SHM_SOCKET_NAME, ntohs(port));
+  socklen_t addr_len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 +
+                                   (size_t)len);
+
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) goto ERR_SOCKET;
+
+  if (bind(fd, (struct sockaddr *)&addr, addr_len) < 0) goto ERR_BIND;
+  if (listen(fd, SHM_LISTEN_BACKLOG) < 0) goto ERR_BIND;
+
+  return fd;
+
+ERR_BIND:
+  close(fd);
+ERR_SOCKET:
+  return -1;
+}
+
+/*
+ * Receive the file descriptor of the memory region sent by the application.
+ * Returns -1 with errno set to EAGAIN if it has not been sent yet.
+ */
+static int listener_shm_recv_region_fd(int fd) {
+  char byte;
+  struct iovec iov = {.iov_base = &byte, .iov_len = sizeof(byte)};
+  union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+  } control;
+  struct msghdr msg = {
+      .msg_iov = &iov,
+      .msg_iovlen = 1,
+      .msg_control = control.buf,
+      .msg_controllen = sizeof(control.buf),
+  };
+
+  ssize_t n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+  if (n < 0) return -1;
+  /* Closed by the application */
+  if (n == 0) goto ERR_INVALID;
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(int)))
+    goto ERR_INVALID;
+
+  int region_fd;
+  memcpy(&region_fd, CMSG_DATA(cmsg), sizeof(int));
+  return region_fd;
+
+ERR_INVALID:
+  errno = EINVAL;
+  return -1;
+}
+
+static hicn_shm_region_t *listener_shm_map_region(int region_fd,
+                                                  size_t *size) {
+  struct stat st;
+  if (fstat(region_fd, &st) < 0 || st.st_size < (off_t)HICN_SHM_REGION_SIZE)
+    return NULL;
+
+  /* The region is only used up to the size we expect */
+  *size = HICN_SHM_REGION_SIZE;
+  void *region = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      region_fd, 0);
+  if (region == MAP_FAILED) return NULL;
+
+  if (!hicn_shm_region_is_valid(region, *size)) {
+    munmap(region, *size);
+    return NULL;
+  }
+  return region;
+}
+
+/* Create the face and its connection once the region has been received */
+static int listener_shm_add_face(listener_t *listener, int fd,
+                                 int region_fd) {
+  size_t size;
+  char name[SYMBOLIC_NAME_LEN];
+
+  hicn_shm_region_t *region = listener_shm_map_region(region_fd, &size);
+  close(region_fd);
+  if (!region) goto ERR_HANDSHAKE;
+
+  shm_face_t *face = shm_face_create(fd, region, size);
+  if (!face) goto ERR_FACE;
+
+  /*
+   * The connection table identifies connections by their address pair: the
+   * remote part is made unique by the socket, and the unspecified address
+   * avoids clashes with UDP faces on the loopback interface.
+   */
+  address_pair_t pair = {
+      .local = listener->address,
+      .remote = ADDRESS4_ANY(fd),
+  };
+
+  connection_table_t *table =
+      forwarder_get_connection_table(listener->forwarder);
+  if (connection_table_get_random_name(table, name) < 0) goto ERR_CONNECTION;
+
+  unsigned connection_id =
+      listener_add_connection(listener, FACE_TYPE_SHM, name, &pair, fd);
+  /* On failure, the socket has been closed with the connection */
+  if (!connection_id_is_valid(connection_id)) goto ERR_CONNECTION;
+
+  INFO("[shm] Application connected on face %u", connection_id);
+  return 0;
+
+ERR_CONNECTION:
+  if (shm_face_get(fd)) {
+    shm_face_free(fd);
+    close(fd);
+  }
+  return -1;
+ERR_FACE:
+  munmap(region, size);
+ERR_HANDSHAKE:
+  WARN("[shm] Rejecting application: invalid handshake");
+  close(fd);
+  return -1;
+}
+
+static int listener_shm_on_handshake(void *handshake_arg, int fd, unsigned id,
+                                     void *data) {
+  shm_handshake_t *handshake = handshake_arg;
+  listener_t *listener = handshake->listener;
+
+  int region_fd = listener_shm_recv_region_fd(fd);
+  if (region_fd < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+
+  shm_handshake_free(handshake);
+  if (region_fd < 0) {
+    WARN("[shm] Rejecting application: invalid handshake");
+    close(fd);
+    return -1;
+  }
+  return listener_shm_add_face(listener, fd, region_fd);
+}
+
+static int listener_shm_on_handshake_timeout(void *handshake_arg, int fd,
+                                             unsigned id, void *data) {
+  shm_handshake_t *handshake = handshake_arg;
+
+  WARN("[shm] Rejecting application: handshake timed out");
+  close(handshake->fd);
+  shm_handshake_free(handshake);
+  return 0;
+}
+
+static ssize_t listener_shm_accept(listener_t *listener) {
+  listener_shm_data_t *data = listener->data;
+
+  int fd = accept4(listener->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (fd < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+      ERROR("[shm] accept failed: (%d) %s", errno, strerror(errno));
+    return -1;
+  }
+
+  unsigned i;
+  for (i = 0; i < SHM_MAX_HANDSHAKES; i++)
+    if (!data->handshakes[i]) break;
+  if (i == SHM_MAX_HANDSHAKES) {
+    WARN("[shm] Rejecting application: too many pending handshakes");
+    goto ERR_HANDSHAKE;
+  }
+
+  shm_handshake_t *handshake = calloc(1, sizeof(shm_handshake_t));
+  if (!handshake) goto ERR_HANDSHAKE;
+  handshake->fd = fd;
+  handshake->listener = listener;
+  data->handshakes[i] = handshake;
+
+  loop_fd_event_create(&handshake->event, MAIN_LOOP, fd, handshake,
+                       listener_shm_on_handshake, 0, NULL);
+  loop_timer_create(&handshake->timer, MAIN_LOOP, handshake,
+                    listener_shm_on_handshake_timeout, NULL);
+  if (!handshake->event || !handshake->timer) goto ERR_EVENT;
+  if (loop_fd_event_register(handshake->event) < 0) goto ERR_EVENT;
+  loop_timer_register(handshake->timer, SHM_HANDSHAKE_TIMEOUT_MS);
+  return 0;
+
+ERR_EVENT:
+  shm_handshake_free(handshake);
+ERR_HANDSHAKE:
+  close(fd);
+  return -1;
+}
+
+/* Drain the wake ups, and detect the closure of the socket by the peer */
+static bool listener_shm_drain_socket(int fd) {
+  char buf[64];
+  for (;;) {
+    ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n > 0) continue;
+    if (n < 0 && errno == EINTR) continue;
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+  }
+}
+
+static ssize_t listener_shm_read_batch(int fd, msgbuf_t **msgbuf,
+                                       address_t **address, size_t len) {
+  const hicn_shm_ring_id_t ring_id = HICN_SHM_RING_TO_FWD;
+
+  shm_face_t *face = shm_face_get(fd);
+  if (!face) return -1;
+
+  if (!listener_shm_drain_socket(fd)) {
+    INFO("[shm] Application disconnected from face %u", face->connection_id);
+    forwarder_remove_connection(face->forwarder, face->connection_id, true);
+    return -1;
+  }
+
+  size_t n = 0;
+  uint32_t available;
+  while (n < len &&
+         (available = hicn_shm_ring_available(face->region, ring_id)) > 0) {
+    uint32_t i;
+    for (i = 0; i < available && n < len; i++) {
+      size_t size;
+      const uint8_t *packet =
+          hicn_shm_ring_peek(face->region, ring_id, i, &size);
+      if (!packet || size > msgbuf_get_buffer_size(msgbuf[n])) {
+        WARN("[shm] Dropping invalid packet on face %u", face->connection_id);
+        continue;
+      }
+      memcpy(msgbuf_get_packet(msgbuf[n]), packet, size);
+      msgbuf_set_len(msgbuf[n], size);
+      *address[n] = ADDRESS4_ANY(fd);
+      n++;
+    }
+    hicn_shm_ring_release(face->region, ring_id, i);
+  }
+
+  return (ssize_t)n;
+}
+
+const listener_ops_t listener_shm = {
+    .initialize = listener_shm_initialize,
+    .finalize = listener_shm_finalize,
+    .punt = listener_shm_punt,
+    .get_socket = listener_shm_get_socket,
+    .read_single = NULL,
+    .read_batch = listener_shm_read_batch,
+    .accept = listener_shm_accept,
+    .data_size = sizeof(listener_shm_data_t),
+};
+
+/******************************************************************************
+ * Connection
+ ******************************************************************************/
+
+typedef struct {
+  shm_face_t *face;
+} connection_shm_data_t;
+
+static int connection_shm_initialize(connection_t *connection) {
+  assert(connection);
+  assert(connection->type == FACE_TYPE_SHM);
+
+  connection_shm_data_t *data = connection->data;
+  assert(data);
+
+  /* The face has been set up by the listener upon accept */
+  data->face = shm_face_get(connection->fd);
+  if (!data->face) return -1;
+
+  data->face->connection_id = connection_get_id(connection);
+  data->face->forwarder = listener_get_forwarder(connection->listener);
+  return 0;
+}
+
+static void connection_shm_finalize(connection_t *connection) {
+  assert(connection);
+  assert(connection->type == FACE_TYPE_SHM);
+
+  /* connection->data might have been released on initialization failure */
+  shm_face_free(connection->fd);
+}
+
+static bool connection_shm_flush(connection_t *connection) {
+  assert(connection);
+  connection_shm_data_t *data = connection->data;
+  shm_face_t *face = data->face;
+
+  if (hicn_shm_ring_publish(face->region, HICN_SHM_RING_FROM_FWD,
+                            face->tx_head)) {
+    shm_face_notify(face);
+    connection->stats.tx_batches++;
+  }
+  return true;
+}
+
+static bool connection_shm_push(const connection_t *connection,
+                                const uint8_t *packet, size_t size) {
+  connection_shm_data_t *data = connection->data;
+  shm_face_t *face = data->face;
+
+  if (hicn_shm_ring_push(face->region, HICN_SHM_RING_FROM_FWD, &face->tx_head,
+                         packet, size) == 0)
+    return true;
+
+  /* Let the application catch up with what has been pushed so far */
+  if (hicn_shm_ring_publish(face->region, HICN_SHM_RING_FROM_FWD,
+                            face->tx_head))
+    shm_face_notify(face);
+  return false;
+}
+
+static bool connection_shm_send(connection_t *connection, msgbuf_t *msgbuf,
+                                bool queue) {
+  assert(connection);
+  assert(msgbuf);
+
+  if (msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_DATA)
+    msgbuf_update_pathlabel(msgbuf, connection_get_id(connection));
+
+  /* Packets are copied right away, only their publication is delayed */
+  if (!connection_shm_push(connection, msgbuf_get_packet(msgbuf),
+                           msgbuf_get_len(msgbuf)))
+    return false;
+
+  if (msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_DATA) {
+    connection->stats.data.tx_pkts++;
+    connection->stats.data.tx_bytes += msgbuf_get_len(msgbuf);
+  } else {
+    connection->stats.interests.tx_pkts++;
+    connection->stats.interests.tx_bytes += msgbuf_get_len(msgbuf);
+  }
+
+  if (!queue) connection_shm_flush(connection);
+  return true;
+}
+
+static bool connection_shm_send_packet(const connection_t *connection,
+                                       const uint8_t *packet, size_t size) {
+  assert(connection);
+  assert(packet);
+
+  if (!connection_shm_push(connection, packet, size)) return false;
+
+  connection_shm_data_t *data = connection->data;
+  shm_face_t *face = data->face;
+  if (hicn_shm_ring_publish(face->region, HICN_SHM_RING_FROM_FWD,
+                            face->tx_head))
+    shm_face_notify(face);
+  return true;
+}
+
+DECLARE_CONNECTION(shm)
+
+#endif /* __linux__ */
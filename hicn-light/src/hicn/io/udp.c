@@ -37,19 +37,21 @@
 #endif
 #include <sys/socket.h>
 
-#ifdef WITH_GSO
-#include <netinet/if_ether.h>  // ETH_DATA_LEN
-#include <linux/ipv6.h>        // struct ipv6hdr
-#include <netinet/udp.h>       // struct udphdr, SOL_UDP
+#ifdef __linux__
+#include <netinet/udp.h>  // SOL_UDP, UDP_SEGMENT
 //#include <linux/udp.h> // UDP_GRO
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
 #define UDP_GRO 104
-#endif /* WITH_GSO */
+#endif /* __linux__ */
 
 #include <hicn/util/log.h>
 #include <hicn/util/sstrncpy.h>
 #include <hicn/util/ring.h>
 
 #include "base.h"
+#include "udp.h"
 #include "../core/address_pair.h"
 #include "../core/connection.h"
 #include "../core/connection_vft.h"
@@ -122,14 +124,6 @@ int socket_set_options(int fd) {
     return -1;
   }
 
-#ifdef WITH_GSO
-  int gso_size = ETH_DATA_LEN - sizeof(struct ipv6hdr) - sizeof(struct udphdr);
-  if (setsockopt(fd, SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size)) < 0) {
-    perror("setsockopt");
-    return -1;
-  }
-#endif /* WITH_GSO */
-
 #ifdef WITH_GRO
   if (setsockopt(fd, IPPROTO_UDP, UDP_GRO, &(int){1}, sizeof(int)) < 0) {
     perror("setsockopt");
@@ -260,16 +254,6 @@ DECLARE_LISTENER(udp);
 
 #define RING_LEN 5 * MAX_MSG
 
-typedef struct {
-#ifdef __linux__
-  /* Ring buffer */
-  off_t *ring;
-
-  struct mmsghdr msghdr[MAX_MSG];
-  struct iovec iovecs[MAX_MSG];
-#endif /* __linux__ */
-} connection_udp_data_t;
-
 static int connection_udp_initialize(connection_t *connection) {
   assert(connection);
   assert(connection->type == FACE_TYPE_UDP);
@@ -280,6 +264,11 @@ static int connection_udp_initialize(connection_t *connection) {
   assert(data);
 
   ring_init(data->ring, RING_LEN);
+#ifdef WITH_GSO
+  data->gso = true;
+#else
+  data->gso = false;
+#endif /* WITH_GSO */
 
   void *name = NULL;
   int namelen = 0;
@@ -317,6 +306,26 @@ static int connection_udp_initialize(connection_t *connection) {
   return 0;
 }
 
+#ifdef __linux__
+/**
+ * @brief Release the n first packets of the ring buffer, acquired when they
+ * were queued, and remove them from it.
+ */
+static void connection_udp_dequeue(connection_t *connection, unsigned n) {
+  forwarder_t *forwarder = listener_get_forwarder(connection->listener);
+  msgbuf_pool_t *msgbuf_pool = forwarder_get_msgbuf_pool(forwarder);
+  connection_udp_data_t *data = connection->data;
+  off_t msgbuf_id;
+
+  for (unsigned i = 0; i < n; i++) {
+    ring_get(data->ring, i, &msgbuf_id);
+    msgbuf_t *msgbuf = msgbuf_pool_at(msgbuf_pool, msgbuf_id);
+    msgbuf_pool_release(msgbuf_pool, &msgbuf);
+  }
+  ring_advance(data->ring, n);
+}
+#endif /* __linux__ */
+
 static void connection_udp_finalize(connection_t *connection) {
   assert(connection);
   assert(connection->type == FACE_TYPE_UDP);
@@ -324,15 +333,58 @@ static void connection_udp_finalize(connection_t *connection) {
   connection_udp_data_t *data = connection->data;
   assert(data);
 
+  connection_udp_dequeue(connection, (unsigned)ring_get_size(data->ring));
   ring_free(data->ring);
 #endif /* __linux__ */
 }
 
+#ifdef __linux__
+unsigned connection_udp_prepare_msgs(connection_udp_data_t *data,
+                                     unsigned n_pkts) {
+  unsigned n_msgs = 0;
+  for (unsigned i = 0; i < n_pkts; n_msgs++) {
+    struct msghdr *hdr = &data->msghdr[n_msgs].msg_hdr;
+    unsigned n_segs = 1;
+
+    size_t seg_size = data->iovecs[i].iov_len;
+    if (data->gso) {
+      size_t len = seg_size;
+      while (i + n_segs < n_pkts && n_segs < UDP_GSO_MAX_SEGMENTS) {
+        size_t next_len = data->iovecs[i + n_segs].iov_len;
+        if (next_len > seg_size || len + next_len > UDP_GSO_MAX_PAYLOAD) break;
+        len += next_len;
+        n_segs++;
+        if (next_len < seg_size) break;
+      }
+    }
+
+    if (n_segs > 1) {
+      hdr->msg_control = data->control[n_msgs].buf;
+      hdr->msg_controllen = sizeof(data->control[n_msgs].buf);
+      struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      uint16_t gso_size = (uint16_t)seg_size;
+      memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+    } else {
+      hdr->msg_control = NULL;
+      hdr->msg_controllen = 0;
+    }
+
+    hdr->msg_iov = &data->iovecs[i];
+    hdr->msg_iovlen = n_segs;
+    i += n_segs;
+  }
+  return n_msgs;
+}
+#endif /* __linux__ */
+
 static bool connection_udp_flush(connection_t *connection) {
 #ifdef __linux__
   int retry = 0;
   off_t msgbuf_id = 0;
-  unsigned cpt;
+  unsigned cpt, n_msgs, n_sent;
   size_t i;
   int n;
 
@@ -342,6 +394,8 @@ static bool connection_udp_flush(connection_t *connection) {
   connection_udp_data_t *data = connection->data;
   assert(data);
 
+  if (ring_get_size(data->ring) == 0) return true;
+
   TRACE("[connection_udp_send] Flushing connection queue");
 
   /* Flush operation */
@@ -373,10 +427,22 @@ SEND:
     data->iovecs[i].iov_len = msgbuf_get_len(msgbuf);
     cpt++;
   });
+  n_msgs = connection_udp_prepare_msgs(data, cpt);
 
 SENDMMSG:
-  n = sendmmsg(connection->fd, data->msghdr, cpt, flags);
+  n = sendmmsg(connection->fd, data->msghdr, n_msgs, flags);
   if (n == -1) {
+#ifdef WITH_GSO
+    /* Fall back to one message per packet if segmentation is not supported */
+    if (data->gso && data->msghdr[0].msg_hdr.msg_controllen > 0 &&
+        (errno == EIO || errno == EINVAL)) {
+      WARN("Disabling UDP segmentation offload on connection %u: %s",
+           connection_get_id(connection), strerror(errno));
+      data->gso = false;
+      n_msgs = connection_udp_prepare_msgs(data, cpt);
+      goto SENDMMSG;
+    }
+#endif /* WITH_GSO */
     /* man(2)sendmmsg / BUGS
      *
      * If an error occurs after at least one message has been sent, the call
@@ -394,9 +460,16 @@ SENDMMSG:
     return false;
   }
 
-  ring_advance(data->ring, n);
+  connection->stats.tx_batches++;
+  n_sent = 0;
+  for (unsigned k = 0; k < n; k++) {
+    size_t n_segs = data->msghdr[k].msg_hdr.msg_iovlen;
+    if (n_segs > 1) connection->stats.tx_gso_batches++;
+    n_sent += (unsigned)n_segs;
+  }
+  connection_udp_dequeue(connection, n_sent);
 
-  if (n < cpt) {
+  if (n < n_msgs) {
     WARN("Unknown error after sending n=%d packets...", n);
     if (retry < 1) {
       retry++;
@@ -436,8 +509,13 @@ static bool connection_udp_send(connection_t *connection, msgbuf_t *msgbuf,
   /* Queue packet ? */
   if (queue) {
     off_t msgbuf_id;
-    if (ring_is_full(data->ring)) connection_udp_flush(connection);
+    if (ring_is_full(data->ring)) connection_flush(connection);
 
+    /*
+     * The connection might only be flushed after the batch the packet belongs
+     * to has been processed and its msgbufs released
+     */
+    msgbuf_pool_acquire(msgbuf);
     msgbuf_id = msgbuf_pool_get_id(msgbuf_pool, msgbuf);
     ring_add(data->ring, &msgbuf_id);
 
@@ -469,6 +547,7 @@ static bool connection_udp_send(connection_t *connection, msgbuf_t *msgbuf,
         return false;
       }
     }
+    connection->stats.tx_batches++;
 #ifdef __linux__
   }
 #endif /* __linux__ */
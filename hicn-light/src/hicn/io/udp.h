@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file udp.h
+ * #brief UDP connection data and transmission helpers.
+ */
+
+#ifndef HICNLIGHT_IO_UDP
+#define HICNLIGHT_IO_UDP
+
+#include <stdbool.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "base.h"
+
+/*
+ * Limits on the datagrams handed to the kernel for segmentation: number of
+ * segments, and total payload fitting in a single IP packet.
+ */
+#define UDP_GSO_MAX_SEGMENTS 64
+#define UDP_GSO_MAX_PAYLOAD 65507
+
+typedef struct {
+#ifdef __linux__
+  /* Ring buffer */
+  off_t *ring;
+
+  struct mmsghdr msghdr[MAX_MSG];
+  struct iovec iovecs[MAX_MSG];
+  /* Control buffers holding the segment size of each message */
+  union {
+    char buf[CMSG_SPACE(sizeof(uint16_t))];
+    size_t align; /* as struct cmsghdr, which C++ cannot embed */
+  } control[MAX_MSG];
+  /*
+   * Segmentation offload, only enabled under WITH_GSO, and cleared if the
+   * kernel or the device does not support it
+   */
+  bool gso;
+#endif /* __linux__ */
+} connection_udp_data_t;
+
+#ifdef __linux__
+/**
+ * @brief Build the messages transmitting the first n_pkts iovecs.
+ *
+ * Each packet is sent in its own message, unless segmentation offload is
+ * enabled: a run of packets of the same size, possibly terminated by a smaller
+ * one, is then sent as a single datagram that the kernel (or the device)
+ * splits back into the original packets.
+ *
+ * @return The number of messages
+ */
+unsigned connection_udp_prepare_msgs(connection_udp_data_t *data,
+                                     unsigned n_pkts);
+#endif /* __linux__ */
+
+#endif /* HICNLIGHT_IO_UDP */
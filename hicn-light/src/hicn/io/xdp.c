@@ -0,0 +1,1006 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xdp.c
+ * @brief Implementation of AF_XDP faces
+ *
+ * An XDP listener receives the UDP tunnel traffic of an interface directly
+ * from the driver, bypassing the kernel networking stack: a small XDP program
+ * attached to the interface redirects the UDP packets sent to the port of the
+ * listener to an AF_XDP socket, and lets everything else through.
+ *
+ * The socket exchanges frames with the kernel through a memory area (UMEM)
+ * and four rings, which are mapped in the forwarder. The UMEM is split in
+ * two halves, for reception and transmission. Packets are copied between
+ * frames and message buffers: the message buffer pool is reallocated when it
+ * grows, and can thus not be registered as UMEM.
+ *
+ * Connections share the socket of their listener, and build the Ethernet, IP
+ * and UDP headers themselves. The link-layer address of the peers is learnt
+ * from the packets they send, or taken from the ARP cache. Until it is known,
+ * packets are sent through a regular UDP socket, which also triggers the
+ * address resolution in the kernel.
+ *
+ * Limitations:
+ *  - only the first queue of the interface is bound, which should be the only
+ *    one (ethtool -L <interface> combined 1) or the target of the tunnel
+ *    traffic (ethtool -N);
+ *  - an interface hosts a single XDP program, hence a single XDP listener;
+ *  - IPv4 packets with options or fragmented are left to the kernel.
+ *
+ * The socket is bound in zero-copy mode when the driver supports it, and in
+ * copy mode otherwise (eg. on veth interfaces). Linux 5.9 or later is required
+ * to attach the program.
+ */
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef WITH_AF_XDP
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#endif /* WITH_AF_XDP */
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/udp.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#include <hicn/common.h>
+#include <hicn/util/log.h>
+
+#include "base.h"
+#include "xdp.h"
+#include "../core/connection.h"
+#include "../core/connection_vft.h"
+#include "../core/forwarder.h"
+#include "../core/listener.h"
+#include "../core/listener_vft.h"
+#include "../core/msgbuf.h"
+
+#define XDP_FRAME_SIZE 2048
+#define XDP_NUM_FRAMES 4096
+#define XDP_NUM_RX_FRAMES (XDP_NUM_FRAMES / 2)
+#define XDP_NUM_TX_FRAMES (XDP_NUM_FRAMES - XDP_NUM_RX_FRAMES)
+#define XDP_UMEM_SIZE ((size_t)XDP_NUM_FRAMES * XDP_FRAME_SIZE)
+
+/* All rings have the size of a UMEM half, so that they never overflow */
+#define XDP_RING_SIZE XDP_NUM_RX_FRAMES
+
+#define XDP_QUEUE_ID 0
+
+/* Maximum number of XDP listeners per worker */
+#define XDP_MAX_LISTENERS 8
+
+/* Number of link-layer addresses learnt per listener */
+#define XDP_MAX_NEIGHBORS 64
+
+#define XDP_TTL 64
+
+/******************************************************************************
+ * Frames
+ ******************************************************************************/
+
+const uint8_t *xdp_frame_parse(const uint8_t *frame, size_t len, size_t *size,
+                               address_t *address) {
+  const struct ether_header *eth = (const struct ether_header *)frame;
+  const struct udphdr *udp;
+  size_t header_len;
+
+  if (len < sizeof(struct ether_header)) return NULL;
+
+  /* The XDP program has checked the protocols and header lengths */
+  switch (ntohs(eth->ether_type)) {
+    case ETHERTYPE_IP: {
+      const struct iphdr *ip = (const struct iphdr *)(eth + 1);
+      header_len = XDP_HEADER_LEN_IPV4;
+      if (len < header_len) return NULL;
+      udp = (const struct udphdr *)(ip + 1);
+      *address = ADDRESS4(ntohl(ip->saddr), ntohs(udp->source));
+      break;
+    }
+    case ETHERTYPE_IPV6: {
+      const struct ip6_hdr *ip6 = (const struct ip6_hdr *)(eth + 1);
+      header_len = XDP_HEADER_LEN_IPV6;
+      if (len < header_len) return NULL;
+      udp = (const struct udphdr *)(ip6 + 1);
+      *address = ADDRESS6(ip6->ip6_src, ntohs(udp->source));
+      break;
+    }
+    default:
+      return NULL;
+  }
+
+  /* Ethernet padding follows short packets */
+  size_t udp_len = ntohs(udp->len);
+  if (udp_len < sizeof(struct udphdr) ||
+      udp_len > len - header_len + sizeof(struct udphdr))
+    return NULL;
+
+  *size = udp_len - sizeof(struct udphdr);
+  return frame + header_len;
+}
+
+size_t xdp_header_build(uint8_t *header, const uint8_t *mac,
+                        const address_t *local, const address_t *remote) {
+  memset(header, 0, XDP_HEADER_LEN_IPV6);
+  struct ether_header *eth = (struct ether_header *)header;
+  memcpy(eth->ether_shost, mac, ETH_ALEN);
+
+  struct udphdr *udp;
+  if (address_family(remote) == AF_INET) {
+    eth->ether_type = htons(ETHERTYPE_IP);
+    struct iphdr *ip = (struct iphdr *)(eth + 1);
+    ip->version = 4;
+    ip->ihl = sizeof(struct iphdr) / 4;
+    ip->frag_off = htons(IP_DF);
+    ip->ttl = XDP_TTL;
+    ip->protocol = IPPROTO_UDP;
+    ip->saddr = local->as_sin.sin_addr.s_addr;
+    ip->daddr = remote->as_sin.sin_addr.s_addr;
+    udp = (struct udphdr *)(ip + 1);
+    udp->source = local->as_sin.sin_port;
+    udp->dest = remote->as_sin.sin_port;
+    return XDP_HEADER_LEN_IPV4;
+  }
+
+  eth->ether_type = htons(ETHERTYPE_IPV6);
+  struct ip6_hdr *ip6 = (struct ip6_hdr *)(eth + 1);
+  ip6->ip6_flow = htonl(6 << 28);
+  ip6->ip6_nxt = IPPROTO_UDP;
+  ip6->ip6_hlim = XDP_TTL;
+  ip6->ip6_src = local->as_sin6.sin6_addr;
+  ip6->ip6_dst = remote->as_sin6.sin6_addr;
+  udp = (struct udphdr *)(ip6 + 1);
+  udp->source = local->as_sin6.sin6_port;
+  udp->dest = remote->as_sin6.sin6_port;
+  return XDP_HEADER_LEN_IPV6;
+}
+
+void xdp_header_complete(uint8_t *frame, size_t size) {
+  struct ether_header *eth = (struct ether_header *)frame;
+  size_t udp_len = sizeof(struct udphdr) + size;
+  struct udphdr *udp;
+
+  if (eth->ether_type == htons(ETHERTYPE_IP)) {
+    struct iphdr *ip = (struct iphdr *)(eth + 1);
+    ip->tot_len = htons((uint16_t)(sizeof(struct iphdr) + udp_len));
+    ip->check = 0;
+    ip->check = csum(ip, sizeof(struct iphdr), 0);
+    udp = (struct udphdr *)(ip + 1);
+    udp->len = htons((uint16_t)udp_len);
+    /* The UDP checksum is optional over IPv4 */
+    return;
+  }
+
+  struct ip6_hdr *ip6 = (struct ip6_hdr *)(eth + 1);
+  ip6->ip6_plen = htons((uint16_t)udp_len);
+  udp = (struct udphdr *)(ip6 + 1);
+  udp->len = htons((uint16_t)udp_len);
+
+  /*
+   * The pseudo-header is summed from the IPv6 header rather than copied to a
+   * structure, which csum() would read through incompatible pointers.
+   */
+  uint32_t sum =
+      (uint16_t)~csum(&ip6->ip6_src, 2 * sizeof(struct in6_addr), 0);
+  sum += htons((uint16_t)udp_len) + htons(IPPROTO_UDP);
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum += sum >> 16;
+  udp->check = 0;
+  udp->check = csum(udp, udp_len, (uint16_t)sum);
+  if (udp->check == 0) udp->check = 0xffff;
+}
+
+#ifdef WITH_AF_XDP
+
+typedef struct {
+  uint32_t *producer;
+  uint32_t *consumer;
+  uint32_t *flags;
+  void *desc;
+  /* Private index of the side we are on, published on submit/release */
+  uint32_t cached;
+  void *map;
+  size_t map_size;
+} xdp_ring_t;
+
+typedef struct {
+  int family;
+  union {
+    struct in_addr v4;
+    struct in6_addr v6;
+  } ip;
+  uint8_t mac[ETH_ALEN];
+} xdp_neighbor_t;
+
+typedef struct {
+  int fd; /* AF_XDP socket, also the listener fd */
+  int udp_fd;
+  int map_fd;
+  int prog_fd;
+  int link_fd;
+  bool zerocopy;
+  uint8_t mac[ETH_ALEN];
+
+  uint8_t *umem;
+  xdp_ring_t fill;
+  xdp_ring_t comp;
+  xdp_ring_t rx;
+  xdp_ring_t tx;
+
+  /* Transmission frames not in use by the kernel */
+  uint64_t tx_frames[XDP_NUM_TX_FRAMES];
+  unsigned n_tx_frames;
+
+  xdp_neighbor_t neighbors[XDP_MAX_NEIGHBORS];
+  unsigned n_neighbors;
+  unsigned last_neighbor;
+} listener_xdp_data_t;
+
+/*
+ * The read callbacks only receive the file descriptor, which is used to find
+ * the listener state.
+ */
+static LOOP_THREAD_LOCAL listener_xdp_data_t *xdp_listeners[XDP_MAX_LISTENERS];
+
+static listener_xdp_data_t *xdp_listener_get(int fd) {
+  for (unsigned i = 0; i < XDP_MAX_LISTENERS; i++)
+    if (xdp_listeners[i] && xdp_listeners[i]->fd == fd) return xdp_listeners[i];
+  return NULL;
+}
+
+/******************************************************************************
+ * Rings
+ ******************************************************************************/
+
+static int xdp_ring_map(xdp_ring_t *ring, int fd,
+                        const struct xdp_ring_offset *offset, size_t desc_size,
+                        off_t pgoff) {
+  ring->map_size = offset->desc + XDP_RING_SIZE * desc_size;
+  ring->map = mmap(NULL, ring->map_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, pgoff);
+  if (ring->map == MAP_FAILED) {
+    ring->map = NULL;
+    return -1;
+  }
+
+  ring->producer = (uint32_t *)((uint8_t *)ring->map + offset->producer);
+  ring->consumer = (uint32_t *)((uint8_t *)ring->map + offset->consumer);
+  ring->flags = (uint32_t *)((uint8_t *)ring->map + offset->flags);
+  ring->desc = (uint8_t *)ring->map + offset->desc;
+  ring->cached = 0;
+  return 0;
+}
+
+static void xdp_ring_unmap(xdp_ring_t *ring) {
+  if (ring->map) munmap(ring->map, ring->map_size);
+  ring->map = NULL;
+}
+
+/* Producer side (fill and tx rings) */
+
+static inline uint32_t xdp_ring_free(const xdp_ring_t *ring) {
+  return XDP_RING_SIZE -
+         (ring->cached - __atomic_load_n(ring->consumer, __ATOMIC_ACQUIRE));
+}
+
+static inline void xdp_ring_submit(xdp_ring_t *ring) {
+  __atomic_store_n(ring->producer, ring->cached, __ATOMIC_RELEASE);
+}
+
+/* Consumer side (rx and completion rings) */
+
+static inline uint32_t xdp_ring_available(const xdp_ring_t *ring) {
+  return __atomic_load_n(ring->producer, __ATOMIC_ACQUIRE) - ring->cached;
+}
+
+static inline void xdp_ring_release(xdp_ring_t *ring, uint32_t n) {
+  ring->cached += n;
+  __atomic_store_n(ring->consumer, ring->cached, __ATOMIC_RELEASE);
+}
+
+static inline uint64_t *xdp_ring_addr(const xdp_ring_t *ring, uint32_t i) {
+  return (uint64_t *)ring->desc + (i & (XDP_RING_SIZE - 1));
+}
+
+static inline struct xdp_desc *xdp_ring_xdp_desc(const xdp_ring_t *ring,
+                                                 uint32_t i) {
+  return (struct xdp_desc *)ring->desc + (i & (XDP_RING_SIZE - 1));
+}
+
+static inline bool xdp_ring_needs_wakeup(const xdp_ring_t *ring) {
+  return __atomic_load_n(ring->flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP;
+}
+
+/******************************************************************************
+ * XDP program
+ ******************************************************************************/
+
+static int xdp_bpf(enum bpf_cmd cmd, union bpf_attr *attr) {
+  return (int)syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+#define INSN(CODE, DST, SRC, OFF, IMM)                                   \
+  (struct bpf_insn) {                                                    \
+    .code = (CODE), .dst_reg = (DST), .src_reg = (SRC), .off = (OFF),    \
+    .imm = (IMM)                                                         \
+  }
+
+/*
+ * Append an instruction to the program, jumps being expressed with absolute
+ * targets.
+ */
+#define EMIT(CODE, DST, SRC, OFF, IMM)         \
+  do {                                         \
+    insns[n] = INSN(CODE, DST, SRC, OFF, IMM); \
+    n++;                                       \
+  } while (0)
+#define EMIT_JMP(OP, SRC_TYPE, DST, SRC, IMM, TARGET) \
+  EMIT(BPF_JMP | (OP) | (SRC_TYPE), DST, SRC, (TARGET) - n - 1, IMM)
+
+/*
+ * Redirect the UDP packets sent to the given port to the AF_XDP socket of the
+ * receive queue, if any, and pass all other packets to the kernel.
+ *
+ *   r6 = ctx, r2 = data, r3 = data_end, r4 = end of the headers, r5 = field
+ */
+static int xdp_prog_load(int map_fd, in_port_t port) {
+  enum { IPV6 = 9, IPV4 = 17, REDIRECT = 29, PASS = 35, LEN = 37 };
+  struct bpf_insn insns[LEN];
+  int n = 0;
+
+  EMIT(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0);
+  EMIT(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6,
+       offsetof(struct xdp_md, data), 0);
+  EMIT(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_6,
+       offsetof(struct xdp_md, data_end), 0);
+  EMIT(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0);
+  EMIT(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, ETH_HLEN);
+  EMIT_JMP(BPF_JGT, BPF_X, BPF_REG_4, BPF_REG_3, 0, PASS);
+  EMIT(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2,
+       offsetof(struct ether_header, ether_type), 0);
+  EMIT_JMP(BPF_JEQ, BPF_K, BPF_REG_5, 0, htons(ETHERTYPE_IP), IPV4);
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, htons(ETHERTYPE_IPV6), PASS);
+
+  assert(n == IPV6);
+  EMIT(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0);
+  EMIT(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, XDP_HEADER_LEN_IPV6);
+  EMIT_JMP(BPF_JGT, BPF_X, BPF_REG_4, BPF_REG_3, 0, PASS);
+  EMIT(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2,
+       ETH_HLEN + offsetof(struct ip6_hdr, ip6_nxt), 0);
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, IPPROTO_UDP, PASS);
+  EMIT(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2,
+       ETH_HLEN + sizeof(struct ip6_hdr) + offsetof(struct udphdr, dest), 0);
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, port, PASS);
+  EMIT_JMP(BPF_JA, BPF_K, 0, 0, 0, REDIRECT);
+
+  assert(n == IPV4);
+  EMIT(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0);
+  EMIT(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, XDP_HEADER_LEN_IPV4);
+  EMIT_JMP(BPF_JGT, BPF_X, BPF_REG_4, BPF_REG_3, 0, PASS);
+  /* Version 4, no options */
+  EMIT(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2, ETH_HLEN, 0);
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, 0x45, PASS);
+  /* Not fragmented */
+  EMIT(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2,
+       ETH_HLEN + offsetof(struct iphdr, frag_off), 0);
+  EMIT(BPF_ALU64 | BPF_AND | BPF_K, BPF_REG_5, 0, 0, htons(IP_MF | IP_OFFMASK));
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, 0, PASS);
+  EMIT(BPF_LDX | BPF_MEM | BPF_B, BPF_REG_5, BPF_REG_2,
+       ETH_HLEN + offsetof(struct iphdr, protocol), 0);
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, IPPROTO_UDP, PASS);
+  EMIT(BPF_LDX | BPF_MEM | BPF_H, BPF_REG_5, BPF_REG_2,
+       ETH_HLEN + sizeof(struct iphdr) + offsetof(struct udphdr, dest), 0);
+  EMIT_JMP(BPF_JNE, BPF_K, BPF_REG_5, 0, port, PASS);
+
+  /* Packets of queues without socket are passed to the kernel */
+  assert(n == REDIRECT);
+  EMIT(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6,
+       offsetof(struct xdp_md, rx_queue_index), 0);
+  EMIT(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map_fd);
+  EMIT(0, 0, 0, 0, 0);
+  EMIT(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS);
+  EMIT(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map);
+  EMIT(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+  assert(n == PASS);
+  EMIT(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS);
+  EMIT(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+  assert(n == LEN);
+
+  union bpf_attr attr = {
+      .prog_type = BPF_PROG_TYPE_XDP,
+      .insn_cnt = LEN,
+      .insns = (uintptr_t)insns,
+      .license = (uintptr_t) "Apache-2.0",
+  };
+  return xdp_bpf(BPF_PROG_LOAD, &attr);
+}
+
+#undef EMIT_JMP
+#undef EMIT
+#undef INSN
+
+static int xdp_map_create(void) {
+  union bpf_attr attr = {
+      .map_type = BPF_MAP_TYPE_XSKMAP,
+      .key_size = sizeof(uint32_t),
+      .value_size = sizeof(uint32_t),
+      .max_entries = XDP_QUEUE_ID + 1,
+  };
+  return xdp_bpf(BPF_MAP_CREATE, &attr);
+}
+
+static int xdp_map_update(int map_fd, uint32_t queue_id, int fd) {
+  uint32_t value = (uint32_t)fd;
+  union bpf_attr attr = {
+      .map_fd = (uint32_t)map_fd,
+      .key = (uintptr_t)&queue_id,
+      .value = (uintptr_t)&value,
+      .flags = BPF_ANY,
+  };
+  return xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr);
+}
+
+/* The program is detached when the link is closed */
+static int xdp_prog_attach(int prog_fd, unsigned ifindex) {
+  const uint32_t modes[] = {XDP_FLAGS_DRV_MODE, XDP_FLAGS_SKB_MODE};
+  int fd = -1;
+
+  for (unsigned i = 0; i < sizeof(modes) / sizeof(modes[0]) && fd < 0; i++) {
+    union bpf_attr attr = {
+        .link_create =
+            {
+                .prog_fd = (uint32_t)prog_fd,
+                .target_ifindex = ifindex,
+                .attach_type = BPF_XDP,
+                .flags = modes[i],
+            },
+    };
+    fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+  }
+  return fd;
+}
+
+/******************************************************************************
+ * Link-layer addresses
+ ******************************************************************************/
+
+static int xdp_get_hwaddr(const char *interface_name, uint8_t *mac) {
+  struct ifreq ifr = {0};
+  snprintf(ifr.ifr_name, IFNAMSIZ, "%s", interface_name);
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  int rc = ioctl(fd, SIOCGIFHWADDR, &ifr);
+  close(fd);
+  if (rc < 0 || ifr.ifr_hwaddr.sa_family != ARPHRD_ETHER) return -1;
+
+  memcpy(mac, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+  return 0;
+}
+
+/* Look up an IPv4 neighbor in the ARP cache of the kernel */
+static int xdp_get_arp_entry(const char *interface_name,
+                             const struct in_addr *ip, uint8_t *mac) {
+  struct arpreq req = {0};
+  struct sockaddr_in *sin = (struct sockaddr_in *)&req.arp_pa;
+  sin->sin_family = AF_INET;
+  sin->sin_addr = *ip;
+  snprintf(req.arp_dev, sizeof(req.arp_dev), "%s", interface_name);
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  int rc = ioctl(fd, SIOCGARP, &req);
+  close(fd);
+  if (rc < 0 || !(req.arp_flags & ATF_COM)) return -1;
+
+  memcpy(mac, req.arp_ha.sa_data, ETH_ALEN);
+  return 0;
+}
+
+static bool xdp_neighbor_match(const xdp_neighbor_t *neighbor, int family,
+                               const void *ip) {
+  if (neighbor->family != family) return false;
+  return family == AF_INET
+             ? memcmp(&neighbor->ip.v4, ip, sizeof(struct in_addr)) == 0
+             : memcmp(&neighbor->ip.v6, ip, sizeof(struct in6_addr)) == 0;
+}
+
+static xdp_neighbor_t *xdp_neighbor_get(listener_xdp_data_t *data, int family,
+                                        const void *ip) {
+  /* Packets usually come in bursts from the same peer */
+  if (xdp_neighbor_match(&data->neighbors[data->last_neighbor], family, ip))
+    return &data->neighbors[data->last_neighbor];
+
+  for (unsigned i = 0; i < data->n_neighbors && i < XDP_MAX_NEIGHBORS; i++) {
+    if (xdp_neighbor_match(&data->neighbors[i], family, ip)) {
+      data->last_neighbor = i;
+      return &data->neighbors[i];
+    }
+  }
+  return NULL;
+}
+
+static void xdp_neighbor_learn(listener_xdp_data_t *data, int family,
+                               const void *ip, const uint8_t *mac) {
+  xdp_neighbor_t *neighbor = xdp_neighbor_get(data, family, ip);
+  if (!neighbor) {
+    /* Replace the oldest entry once the table is full */
+    unsigned i = data->n_neighbors++ % XDP_MAX_NEIGHBORS;
+    neighbor = &data->neighbors[i];
+    neighbor->family = family;
+    if (family == AF_INET)
+      memcpy(&neighbor->ip.v4, ip, sizeof(struct in_addr));
+    else
+      memcpy(&neighbor->ip.v6, ip, sizeof(struct in6_addr));
+    data->last_neighbor = i;
+  }
+  memcpy(neighbor->mac, mac, ETH_ALEN);
+}
+
+/******************************************************************************
+ * Listener
+ ******************************************************************************/
+
+static int listener_xdp_initialize(listener_t *listener) {
+  listener_xdp_data_t *data = listener->data;
+  assert(data);
+
+  memset(data, 0, sizeof(listener_xdp_data_t));
+  data->fd = -1;
+  data->udp_fd = -1;
+  data->map_fd = -1;
+  data->prog_fd = -1;
+  data->link_fd = -1;
+  return 0;
+}
+
+/* Release everything but the AF_XDP socket, which is owned by the listener */
+static void listener_xdp_release(listener_xdp_data_t *data) {
+  for (unsigned i = 0; i < XDP_MAX_LISTENERS; i++)
+    if (xdp_listeners[i] == data) xdp_listeners[i] = NULL;
+
+  if (data->link_fd >= 0) close(data->link_fd);
+  if (data->prog_fd >= 0) close(data->prog_fd);
+  if (data->map_fd >= 0) close(data->map_fd);
+  if (data->udp_fd >= 0) close(data->udp_fd);
+  data->link_fd = data->prog_fd = data->map_fd = data->udp_fd = -1;
+
+  xdp_ring_unmap(&data->fill);
+  xdp_ring_unmap(&data->comp);
+  xdp_ring_unmap(&data->rx);
+  xdp_ring_unmap(&data->tx);
+
+  if (data->umem) munmap(data->umem, XDP_UMEM_SIZE);
+  data->umem = NULL;
+}
+
+static void listener_xdp_finalize(listener_t *listener) {
+  listener_xdp_data_t *data = listener->data;
+  if (data) listener_xdp_release(data);
+}
+
+static int listener_xdp_punt(const listener_t *listener, const char *prefix_s) {
+  return -1;
+}
+
+static int listener_xdp_setup_rings(listener_xdp_data_t *data) {
+  int fd = data->fd;
+  int size = XDP_RING_SIZE;
+
+  struct xdp_umem_reg umem_reg = {
+      .addr = (uintptr_t)data->umem,
+      .len = XDP_UMEM_SIZE,
+      .chunk_size = XDP_FRAME_SIZE,
+      .headroom = 0,
+  };
+  if (setsockopt(fd, SOL_XDP, XDP_UMEM_REG, &umem_reg, sizeof(umem_reg)) < 0)
+    return -1;
+
+  if (setsockopt(fd, SOL_XDP, XDP_UMEM_FILL_RING, &size, sizeof(size)) < 0 ||
+      setsockopt(fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size, sizeof(size)) <
+          0 ||
+      setsockopt(fd, SOL_XDP, XDP_RX_RING, &size, sizeof(size)) < 0 ||
+      setsockopt(fd, SOL_XDP, XDP_TX_RING, &size, sizeof(size)) < 0)
+    return -1;
+
+  struct xdp_mmap_offsets off;
+  socklen_t optlen = sizeof(off);
+  if (getsockopt(fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0) return -1;
+
+  if (xdp_ring_map(&data->fill, fd, &off.fr, sizeof(uint64_t),
+                   XDP_UMEM_PGOFF_FILL_RING) < 0 ||
+      xdp_ring_map(&data->comp, fd, &off.cr, sizeof(uint64_t),
+                   XDP_UMEM_PGOFF_COMPLETION_RING) < 0 ||
+      xdp_ring_map(&data->rx, fd, &off.rx, sizeof(struct xdp_desc),
+                   XDP_PGOFF_RX_RING) < 0 ||
+      xdp_ring_map(&data->tx, fd, &off.tx, sizeof(struct xdp_desc),
+                   XDP_PGOFF_TX_RING) < 0)
+    return -1;
+
+  return 0;
+}
+
+static int listener_xdp_bind(listener_xdp_data_t *data, unsigned ifindex) {
+  struct sockaddr_xdp sxdp = {
+      .sxdp_family = AF_XDP,
+      .sxdp_ifindex = ifindex,
+      .sxdp_queue_id = XDP_QUEUE_ID,
+      .sxdp_flags = XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP,
+  };
+
+  data->zerocopy = true;
+  if (bind(data->fd, (struct sockaddr *)&sxdp, sizeof(sxdp)) == 0) return 0;
+
+  /* Drivers without native AF_XDP support, eg. veth */
+  data->zerocopy = false;
+  sxdp.sxdp_flags = XDP_COPY | XDP_USE_NEED_WAKEUP;
+  return bind(data->fd, (struct sockaddr *)&sxdp, sizeof(sxdp));
+}
+
+/*
+ * Regular UDP socket bound to the same address, used for peers whose
+ * link-layer address is unknown. Its failure is not fatal.
+ */
+static int listener_xdp_get_udp_socket(const address_t *local) {
+  int fd = socket(address_family(local), SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+
+  if (bind(fd, address_sa(local), address_socklen(local)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int listener_xdp_get_socket(const listener_t *listener,
+                                   const address_t *local,
+                                   const address_t *remote,
+                                   const char *interface_name) {
+  /* Connections share the socket of the listener */
+  if (remote) return 0;
+
+  listener_xdp_data_t *data = listener->data;
+  in_port_t port = (local->as_ss.ss_family == AF_INET)
+                       ? local->as_sin.sin_port
+                       : local->as_sin6.sin6_port;
+
+  unsigned ifindex = interface_name ? if_nametoindex(interface_name) : 0;
+  if (ifindex == 0) {
+    ERROR("[xdp] An interface is required");
+    goto ERR_INTERFACE;
+  }
+  if (xdp_get_hwaddr(interface_name, data->mac) < 0) {
+    ERROR("[xdp] Interface %s is not an Ethernet interface", interface_name);
+    goto ERR_INTERFACE;
+  }
+
+  unsigned slot;
+  for (slot = 0; slot < XDP_MAX_LISTENERS; slot++)
+    if (!xdp_listeners[slot]) break;
+  if (slot == XDP_MAX_LISTENERS) goto ERR_INTERFACE;
+
+  data->umem = mmap(NULL, XDP_UMEM_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  if (data->umem == MAP_FAILED) {
+    data->umem = NULL;
+    goto ERR_INTERFACE;
+  }
+
+  data->fd = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+  if (data->fd < 0) goto ERR_SOCKET;
+
+  if (listener_xdp_setup_rings(data) < 0) goto ERR_SETUP;
+  if (listener_xdp_bind(data, ifindex) < 0) goto ERR_SETUP;
+
+  /* Give the reception half of the UMEM to the kernel */
+  for (unsigned i = 0; i < XDP_NUM_RX_FRAMES; i++)
+    *xdp_ring_addr(&data->fill, data->fill.cached++) =
+        (uint64_t)i * XDP_FRAME_SIZE;
+  xdp_ring_submit(&data->fill);
+
+  for (unsigned i = 0; i < XDP_NUM_TX_FRAMES; i++)
+    data->tx_frames[i] = (uint64_t)(XDP_NUM_RX_FRAMES + i) * XDP_FRAME_SIZE;
+  data->n_tx_frames = XDP_NUM_TX_FRAMES;
+
+  data->map_fd = xdp_map_create();
+  if (data->map_fd < 0) goto ERR_SETUP;
+  if (xdp_map_update(data->map_fd, XDP_QUEUE_ID, data->fd) < 0) goto ERR_SETUP;
+
+  data->prog_fd = xdp_prog_load(data->map_fd, port);
+  if (data->prog_fd < 0) goto ERR_SETUP;
+
+  data->link_fd = xdp_prog_attach(data->prog_fd, ifindex);
+  if (data->link_fd < 0) goto ERR_SETUP;
+
+  data->udp_fd = listener_xdp_get_udp_socket(local);
+  if (data->udp_fd < 0)
+    WARN("[xdp] No fallback socket, peers have to be resolved beforehand");
+
+  xdp_listeners[slot] = data;
+
+  INFO("[xdp] Listening on %s queue %u (%s mode)", interface_name,
+       XDP_QUEUE_ID, data->zerocopy ? "zero-copy" : "copy");
+  return data->fd;
+
+ERR_SETUP:
+  ERROR("[xdp] Could not set up AF_XDP on %s: (%d) %s", interface_name, errno,
+        strerror(errno));
+  close(data->fd);
+  data->fd = -1;
+ERR_SOCKET:
+  listener_xdp_release(data);
+ERR_INTERFACE:
+  return -1;
+}
+
+/* Extract the UDP payload and the source of a received frame */
+static bool listener_xdp_parse(listener_xdp_data_t *data, uint8_t *frame,
+                               size_t len, msgbuf_t *msgbuf,
+                               address_t *address) {
+  size_t size;
+  const uint8_t *payload = xdp_frame_parse(frame, len, &size, address);
+  if (!payload || size > msgbuf_get_buffer_size(msgbuf)) return false;
+
+  const struct ether_header *eth = (const struct ether_header *)frame;
+  if (address_family(address) == AF_INET)
+    xdp_neighbor_learn(data, AF_INET, &address->as_sin.sin_addr,
+                       eth->ether_shost);
+  else
+    xdp_neighbor_learn(data, AF_INET6, &address->as_sin6.sin6_addr,
+                       eth->ether_shost);
+
+  memcpy(msgbuf_get_packet(msgbuf), payload, size);
+  msgbuf_set_len(msgbuf, size);
+  return true;
+}
+
+static ssize_t listener_xdp_read_batch(int fd, msgbuf_t **msgbuf,
+                                       address_t **address, size_t len) {
+  listener_xdp_data_t *data = xdp_listener_get(fd);
+  if (!data) return -1;
+
+  uint32_t available = xdp_ring_available(&data->rx);
+  if (available > len) available = (uint32_t)len;
+
+  size_t n = 0;
+  for (uint32_t i = 0; i < available; i++) {
+    const struct xdp_desc *desc =
+        xdp_ring_xdp_desc(&data->rx, data->rx.cached + i);
+    uint64_t frame = desc->addr & ~(uint64_t)(XDP_FRAME_SIZE - 1);
+
+    if (desc->addr + desc->len <= XDP_UMEM_SIZE &&
+        listener_xdp_parse(data, data->umem + desc->addr, desc->len,
+                           msgbuf[n], address[n]))
+      n++;
+
+    /* Frames received are given back right away, as they have been copied */
+    *xdp_ring_addr(&data->fill, data->fill.cached++) = frame;
+  }
+
+  if (available > 0) {
+    xdp_ring_release(&data->rx, available);
+    xdp_ring_submit(&data->fill);
+    if (xdp_ring_needs_wakeup(&data->fill))
+      recvfrom(fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+  }
+
+  return (ssize_t)n;
+}
+
+const listener_ops_t listener_xdp = {
+    .initialize = listener_xdp_initialize,
+    .finalize = listener_xdp_finalize,
+    .punt = listener_xdp_punt,
+    .get_socket = listener_xdp_get_socket,
+    .read_single = NULL,
+    .read_batch = listener_xdp_read_batch,
+    .accept = NULL,
+    .data_size = sizeof(listener_xdp_data_t),
+};
+
+/******************************************************************************
+ * Connection
+ ******************************************************************************/
+
+typedef struct {
+  /* Template of the Ethernet, IP and UDP headers */
+  uint8_t header[XDP_HEADER_LEN_IPV6];
+  size_t header_len;
+  /* Whether the destination link-layer address is known */
+  bool resolved;
+} connection_xdp_data_t;
+
+static void connection_xdp_build_header(connection_t *connection) {
+  connection_xdp_data_t *data = connection->data;
+  listener_xdp_data_t *listener_data = connection->listener->data;
+
+  data->header_len = xdp_header_build(
+      data->header, listener_data->mac,
+      address_pair_get_local(&connection->pair),
+      address_pair_get_remote(&connection->pair));
+}
+
+/* Find the link-layer address of the remote end of the connection */
+static bool connection_xdp_resolve(const connection_t *connection) {
+  connection_xdp_data_t *data = connection->data;
+  listener_xdp_data_t *listener_data = connection->listener->data;
+  const address_t *remote = address_pair_get_remote(&connection->pair);
+  struct ether_header *eth = (struct ether_header *)data->header;
+
+  const void *ip = (address_family(remote) == AF_INET)
+                       ? (const void *)&remote->as_sin.sin_addr
+                       : (const void *)&remote->as_sin6.sin6_addr;
+  xdp_neighbor_t *neighbor =
+      xdp_neighbor_get(listener_data, address_family(remote), ip);
+  if (neighbor) {
+    memcpy(eth->ether_dhost, neighbor->mac, ETH_ALEN);
+    data->resolved = true;
+  } else if (address_family(remote) == AF_INET &&
+             xdp_get_arp_entry(connection->interface_name,
+                               &remote->as_sin.sin_addr,
+                               eth->ether_dhost) == 0) {
+    xdp_neighbor_learn(listener_data, AF_INET, ip, eth->ether_dhost);
+    data->resolved = true;
+  }
+  return data->resolved;
+}
+
+static int connection_xdp_initialize(connection_t *connection) {
+  assert(connection);
+  assert(connection->type == FACE_TYPE_XDP);
+
+  connection_xdp_data_t *data = connection->data;
+  assert(data);
+
+  const address_t *local = address_pair_get_local(&connection->pair);
+  const address_t *remote = address_pair_get_remote(&connection->pair);
+  if (address_family(local) != address_family(remote)) return -1;
+
+  data->resolved = false;
+  connection_xdp_build_header(connection);
+  connection_xdp_resolve(connection);
+  return 0;
+}
+
+static void connection_xdp_finalize(connection_t *connection) {
+  /* Nothing to do, the socket is owned by the listener */
+}
+
+/* Move the frames sent by the kernel back to the free list */
+static void xdp_reclaim_tx_frames(listener_xdp_data_t *data) {
+  uint32_t n = xdp_ring_available(&data->comp);
+  for (uint32_t i = 0; i < n; i++)
+    data->tx_frames[data->n_tx_frames++] =
+        *xdp_ring_addr(&data->comp, data->comp.cached + i);
+  if (n > 0) xdp_ring_release(&data->comp, n);
+}
+
+static void xdp_kick_tx(listener_xdp_data_t *data) {
+  /* In copy mode, packets are only sent from the system call */
+  if (data->zerocopy && !xdp_ring_needs_wakeup(&data->tx)) return;
+
+  if (sendto(data->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0 &&
+      errno != EAGAIN && errno != EBUSY && errno != ENOBUFS &&
+      errno != ENETDOWN)
+    WARN("[xdp] Could not wake up the transmission: (%d) %s", errno,
+         strerror(errno));
+}
+
+static bool connection_xdp_flush(connection_t *connection) {
+  assert(connection);
+  listener_xdp_data_t *listener_data = connection->listener->data;
+
+  xdp_kick_tx(listener_data);
+  connection->stats.tx_batches++;
+  return true;
+}
+
+static bool connection_xdp_push(const connection_t *connection,
+                                const uint8_t *packet, size_t size) {
+  connection_xdp_data_t *data = connection->data;
+  listener_xdp_data_t *listener_data = connection->listener->data;
+
+  if (!data->resolved && !connection_xdp_resolve(connection)) {
+    const address_t *remote = address_pair_get_remote(&connection->pair);
+    return listener_data->udp_fd >= 0 &&
+           sendto(listener_data->udp_fd, packet, size, MSG_DONTWAIT,
+                  address_sa(remote), address_socklen(remote)) >= 0;
+  }
+
+  if (size > XDP_FRAME_SIZE - data->header_len) return false;
+
+  if (listener_data->n_tx_frames == 0 ||
+      xdp_ring_free(&listener_data->tx) == 0) {
+    /* Let the kernel catch up with what has been queued so far */
+    xdp_kick_tx(listener_data);
+    xdp_reclaim_tx_frames(listener_data);
+    if (listener_data->n_tx_frames == 0 ||
+        xdp_ring_free(&listener_data->tx) == 0)
+      return false;
+  }
+
+  uint64_t addr = listener_data->tx_frames[--listener_data->n_tx_frames];
+  uint8_t *frame = listener_data->umem + addr;
+
+  memcpy(frame, data->header, data->header_len);
+  memcpy(frame + data->header_len, packet, size);
+  xdp_header_complete(frame, size);
+
+  struct xdp_desc *desc =
+      xdp_ring_xdp_desc(&listener_data->tx, listener_data->tx.cached++);
+  desc->addr = addr;
+  desc->len = (uint32_t)(data->header_len + size);
+  desc->options = 0;
+  xdp_ring_submit(&listener_data->tx);
+  return true;
+}
+
+static bool connection_xdp_send(connection_t *connection, msgbuf_t *msgbuf,
+                                bool queue) {
+  assert(connection);
+  assert(msgbuf);
+
+  if (msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_DATA)
+    msgbuf_update_pathlabel(msgbuf, connection_get_id(connection));
+
+  /* Packets are copied right away, only the transmission is delayed */
+  if (!connection_xdp_push(connection, msgbuf_get_packet(msgbuf),
+                           msgbuf_get_len(msgbuf)))
+    return false;
+
+  if (msgbuf_get_type(msgbuf) == HICN_PACKET_TYPE_DATA) {
+    connection->stats.data.tx_pkts++;
+    connection->stats.data.tx_bytes += msgbuf_get_len(msgbuf);
+  } else {
+    connection->stats.interests.tx_pkts++;
+    connection->stats.interests.tx_bytes += msgbuf_get_len(msgbuf);
+  }
+
+  if (!queue) connection_xdp_flush(connection);
+  return true;
+}
+
+static bool connection_xdp_send_packet(const connection_t *connection,
+                                       const uint8_t *packet, size_t size) {
+  assert(connection);
+  assert(packet);
+
+  if (!connection_xdp_push(connection, packet, size)) return false;
+
+  xdp_kick_tx(connection->listener->data);
+  return true;
+}
+
+DECLARE_CONNECTION(xdp)
+
+#endif /* WITH_AF_XDP */
+#endif /* __linux__ */
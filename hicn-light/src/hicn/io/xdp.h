@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xdp.h
+ * @brief Frames exchanged by AF_XDP faces.
+ *
+ * Frames carry the UDP tunnel traffic in Ethernet, IPv4 or IPv6 (without
+ * options or extension headers) and UDP headers.
+ */
+
+#ifndef HICNLIGHT_IO_XDP
+#define HICNLIGHT_IO_XDP
+
+#include <net/ethernet.h>
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/udp.h>
+
+#include "../core/address.h"
+
+#define XDP_HEADER_LEN_IPV4 \
+  (sizeof(struct ether_header) + sizeof(struct iphdr) + sizeof(struct udphdr))
+#define XDP_HEADER_LEN_IPV6 \
+  (sizeof(struct ether_header) + sizeof(struct ip6_hdr) + sizeof(struct udphdr))
+
+/**
+ * @brief Locate the UDP payload of a received frame.
+ *
+ * The length of the payload is taken from the UDP header, as short frames are
+ * followed by Ethernet padding.
+ *
+ * @param[in] frame Frame received
+ * @param[in] len Length of the frame
+ * @param[out] size Length of the payload
+ * @param[out] address Source address and port of the packet
+ * @return The payload, or NULL if the frame is truncated or is not IPv4/IPv6
+ */
+const uint8_t *xdp_frame_parse(const uint8_t *frame, size_t len, size_t *size,
+                               address_t *address);
+
+/**
+ * @brief Build the Ethernet, IP and UDP headers of the frames sent from local
+ * to remote, to be completed for each packet with xdp_header_complete(). The
+ * destination link-layer address is left to the caller.
+ *
+ * @param[out] header Buffer of XDP_HEADER_LEN_IPV6 bytes
+ * @param[in] mac Source link-layer address
+ * @return The length of the headers
+ */
+size_t xdp_header_build(uint8_t *header, const uint8_t *mac,
+                        const address_t *local, const address_t *remote);
+
+/**
+ * @brief Set the lengths and checksums of the headers of a frame built from
+ * a template and followed by size bytes of payload.
+ */
+void xdp_header_complete(uint8_t *frame, size_t size);
+
+#endif /* HICNLIGHT_IO_XDP */
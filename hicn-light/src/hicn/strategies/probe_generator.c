@@ -88,10 +88,12 @@ int generate_probe(probe_generator_t *pg, const msgbuf_t *msgbuf,
   uint32_t seq = get_seq_number(pg);
   if (seq == 0) return -1;
   msgbuf_modify_suffix(probe, seq);
+  // The connection holds its own reference to the probe until it is sent
+  msgbuf_pool_acquire(probe);
   connection_send(conn, probe_offset, true);
   connection_flush(conn);
   add_to_map(pg, seq, ticks_now());
-  msgbuf_pool_put(msgbuf_pool, probe);
+  msgbuf_pool_release(msgbuf_pool, &probe);
 
   return 0;
 }
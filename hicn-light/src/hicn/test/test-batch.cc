@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+extern "C" {
+#define WITH_TESTS
+#include <hicn/base/loop.h>
+#include <hicn/config/configuration.h>
+#include <hicn/core/address.h>
+#include <hicn/core/address_pair.h>
+#include <hicn/core/fib.h>
+#include <hicn/core/forwarder.h>
+#include <hicn/core/listener.h>
+#include <hicn/config/batch.h>
+#include <hicn/config/commands.h>
+}
+
+class BatchTest : public ::testing::Test {
+ protected:
+  BatchTest() {
+    conf_ = configuration_create();
+    MAIN_LOOP = loop_create();
+    fwd_ = forwarder_create(conf_);
+
+    address_t listener_addr = ADDRESS4_LOCALHOST(9596);
+    listener_ = listener_create(FACE_TYPE_UDP_LISTENER, &listener_addr, "lo",
+                                "lo_udp4", fwd_);
+
+    address_pair_t pair_a = {.local = listener_addr,
+                             .remote = ADDRESS4_LOCALHOST(12345)};
+    address_pair_t pair_b = {.local = listener_addr,
+                             .remote = ADDRESS4_LOCALHOST(12346)};
+    conn_a_ = listener_create_connection(listener_, "conn_a", &pair_a);
+    conn_b_ = listener_create_connection(listener_, "conn_b", &pair_b);
+  }
+
+  virtual ~BatchTest() {
+    forwarder_free(fwd_);
+    loop_free(MAIN_LOOP);
+    MAIN_LOOP = NULL;
+  }
+
+  /* Send a batch holding a route to 'prefix' (if any) and return the reply */
+  uint8_t sendBatch(unsigned ingress_id, uint8_t flags,
+                    const char *nexthop = NULL, const char *prefix = NULL) {
+    memset(&msg_, 0, sizeof(msg_));
+    msg_.header.message_type = REQUEST_LIGHT;
+    msg_.header.command_id = COMMAND_TYPE_BATCH;
+    msg_.header.length = 1;
+    msg_.payload.flags = flags;
+
+    if (prefix) {
+      cmd_batch_item_t *item = &msg_.payload.items[msg_.payload.n_items++];
+      item->command_id = COMMAND_TYPE_ROUTE_ADD;
+      strcpy(item->route_add.symbolic_or_connid, nexthop);
+      hicn_ip_prefix_t ip_prefix;
+      EXPECT_EQ(hicn_ip_prefix_pton(prefix, &ip_prefix), 0);
+      item->route_add.address = ip_prefix.address;
+      item->route_add.family = ip_prefix.family;
+      item->route_add.len = ip_prefix.len;
+    }
+
+    size_t reply_size;
+    command_process(fwd_, (uint8_t *)&msg_, ingress_id, &reply_size);
+    return msg_.header.message_type;
+  }
+
+  bool hasRoute(const char *prefix, unsigned conn_id) {
+    hicn_ip_prefix_t ip_prefix;
+    hicn_prefix_t hicn_prefix;
+    hicn_ip_prefix_pton(prefix, &ip_prefix);
+    hicn_prefix_create_from_ip_prefix(&ip_prefix, &hicn_prefix);
+
+    fib_entry_t *entry = fib_contains(forwarder_get_fib(fwd_), &hicn_prefix);
+    return entry && nexthops_contains(fib_entry_get_nexthops(entry), conn_id);
+  }
+
+  configuration_t *conf_;
+  forwarder_t *fwd_;
+  listener_t *listener_;
+  unsigned conn_a_;
+  unsigned conn_b_;
+  msg_batch_t msg_;
+};
+
+TEST_F(BatchTest, Commit) {
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_BEGIN, "SELF", "b001::/64"),
+            ACK_LIGHT);
+  EXPECT_FALSE(hasRoute("b001::/64", conn_a_));
+
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_COMMIT, "conn_b", "b002::/64"),
+            ACK_LIGHT);
+  EXPECT_TRUE(hasRoute("b001::/64", conn_a_));
+  EXPECT_TRUE(hasRoute("b002::/64", conn_b_));
+}
+
+TEST_F(BatchTest, SelfResolvedWhenStaged) {
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_BEGIN, "SELF", "b001::/64"),
+            ACK_LIGHT);
+
+  // The staged item no longer refers to the connection sending the batch
+  batch_t *batch = forwarder_get_batch(fwd_);
+  ASSERT_EQ(batch_get_len(batch), 1u);
+  EXPECT_STRNE(batch_get_items(batch)[0].route_add.symbolic_or_connid, "SELF");
+
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_COMMIT), ACK_LIGHT);
+  EXPECT_TRUE(hasRoute("b001::/64", conn_a_));
+  EXPECT_FALSE(hasRoute("b001::/64", conn_b_));
+}
+
+TEST_F(BatchTest, BeginWhileBusy) {
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_BEGIN, "SELF", "b001::/64"),
+            ACK_LIGHT);
+
+  // Another connection can neither take over nor append to the batch
+  EXPECT_EQ(sendBatch(conn_b_, BATCH_FLAG_BEGIN, "SELF", "b002::/64"),
+            NACK_LIGHT);
+  EXPECT_EQ(sendBatch(conn_b_, BATCH_FLAG_COMMIT, "SELF", "b002::/64"),
+            NACK_LIGHT);
+
+  // The batch of the first connection is left untouched
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_COMMIT), ACK_LIGHT);
+  EXPECT_TRUE(hasRoute("b001::/64", conn_a_));
+  EXPECT_FALSE(hasRoute("b002::/64", conn_b_));
+
+  // Once committed, the other connection can start its own
+  EXPECT_EQ(sendBatch(conn_b_, BATCH_FLAG_BEGIN | BATCH_FLAG_COMMIT, "SELF",
+                      "b002::/64"),
+            ACK_LIGHT);
+  EXPECT_TRUE(hasRoute("b002::/64", conn_b_));
+}
+
+TEST_F(BatchTest, OwnerRemoved) {
+  EXPECT_EQ(sendBatch(conn_a_, BATCH_FLAG_BEGIN, "SELF", "b001::/64"),
+            ACK_LIGHT);
+
+  forwarder_remove_connection(fwd_, conn_a_, true);
+  EXPECT_EQ(batch_get_len(forwarder_get_batch(fwd_)), 0u);
+
+  EXPECT_EQ(sendBatch(conn_b_, BATCH_FLAG_BEGIN | BATCH_FLAG_COMMIT, "SELF",
+                      "b002::/64"),
+            ACK_LIGHT);
+  EXPECT_TRUE(hasRoute("b002::/64", conn_b_));
+}
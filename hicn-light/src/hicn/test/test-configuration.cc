@@ -15,6 +15,9 @@ static inline char LOG_FILE[] = "/dev/null";
 static inline uint16_t PORT = 1234;
 static inline uint16_t CONF_PORT = 5678;
 static inline bool IS_DAEMON_MODE = true;
+static inline unsigned N_WORKERS = 4;
+static inline unsigned FLUSH_BATCH_SIZE = 32;
+static inline unsigned FLUSH_LATENCY = 2;
 static inline char PREFIX[] = "b001::/16";
 static inline char PREFIX_2[] = "c001::/16";
 static inline strategy_type_t STRATEGY_TYPE = STRATEGY_TYPE_BESTPATH;
@@ -58,6 +61,53 @@ TEST_F(ConfigurationTest, SetGeneralParameters) {
   EXPECT_EQ(is_daemon_mode, IS_DAEMON_MODE);
 }
 
+TEST_F(ConfigurationTest, SetWorkersParameter) {
+  // Single-threaded forwarder by default
+  EXPECT_EQ(configuration_get_n_workers(config), 1u);
+
+  configuration_set_n_workers(config, N_WORKERS);
+  EXPECT_EQ(configuration_get_n_workers(config), N_WORKERS);
+}
+
+TEST_F(ConfigurationTest, SetFlushPolicy) {
+  // Connections are flushed after each batch of received packets by default
+  EXPECT_EQ(configuration_get_flush_batch_size(config), 0u);
+  EXPECT_EQ(configuration_get_flush_latency(config), 0u);
+
+  configuration_set_flush_policy(config, FLUSH_BATCH_SIZE, FLUSH_LATENCY);
+  EXPECT_EQ(configuration_get_flush_batch_size(config), FLUSH_BATCH_SIZE);
+  EXPECT_EQ(configuration_get_flush_latency(config), FLUSH_LATENCY);
+
+  // The policy applies to the forwarders of all workers
+  configuration_t *clone = configuration_clone(config);
+  ASSERT_NE(clone, nullptr);
+  EXPECT_EQ(configuration_get_flush_batch_size(clone), FLUSH_BATCH_SIZE);
+  EXPECT_EQ(configuration_get_flush_latency(clone), FLUSH_LATENCY);
+  configuration_free(clone);
+}
+
+TEST_F(ConfigurationTest, CloneConfiguration) {
+  configuration_set_cs_size(config, CS_SIZE);
+  configuration_set_port(config, PORT);
+  configuration_set_n_workers(config, N_WORKERS);
+  configuration_set_strategy(config, PREFIX, STRATEGY_TYPE);
+
+  configuration_t *clone = configuration_clone(config);
+  ASSERT_NE(clone, nullptr);
+  EXPECT_EQ(configuration_get_cs_size(clone), CS_SIZE);
+  EXPECT_EQ(configuration_get_port(clone), PORT);
+  EXPECT_EQ(configuration_get_n_workers(clone), N_WORKERS);
+
+  // Per-prefix strategies are not shared with the clone
+  EXPECT_EQ(configuration_get_strategy(clone, PREFIX),
+            STRATEGY_TYPE_UNDEFINED);
+  configuration_set_strategy(clone, PREFIX_2, STRATEGY_TYPE);
+  EXPECT_EQ(configuration_get_strategy(config, PREFIX_2),
+            STRATEGY_TYPE_UNDEFINED);
+
+  configuration_free(clone);
+}
+
 TEST_F(ConfigurationTest, SetLogParameters) {
   configuration_set_loglevel(config, LOG_LEVEL);
   int log_level = configuration_get_loglevel(config);
@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <hicn/test/test-utils.h>
+
+extern "C" {
+#define WITH_TESTS
+#include <hicn/core/packet_cache.h>
+#include <hicn/content_store/cm_sketch.h>
+}
+
+static constexpr unsigned CS_SIZE = 100;
+static constexpr unsigned CONN_ID = 0;
+static constexpr unsigned FIVE_SECONDS = 5000;
+
+static constexpr unsigned N_HOT = 20;
+static constexpr unsigned N_HITS = 4;
+static constexpr unsigned N_SCAN = 1000;
+static constexpr int N_OPS = 20000;
+
+class ContentStoreTest : public ::testing::TestWithParam<cs_type_t> {
+ protected:
+  ContentStoreTest() {
+    pkt_cache = _pkt_cache_create(PKT_CACHE_INDEX_TYPE_KHASH, CS_SIZE);
+    int rc = pkt_cache_set_cs_type(pkt_cache, GetParam());
+    EXPECT_EQ(rc, 0);
+    msgbuf_pool = msgbuf_pool_create();
+
+    hicn_ip_address_t prefix;
+    inet_pton(AF_INET6, "b001::", (struct in6_addr *)&prefix);
+    rc = hicn_name_create_from_ip_address(prefix, 0, &name);
+    EXPECT_EQ(rc, 0);
+  }
+
+  virtual ~ContentStoreTest() {
+    msgbuf_pool_free(msgbuf_pool);
+    pkt_cache_free(pkt_cache);
+  }
+
+  msgbuf_t *msgbuf_create(uint32_t seq, hicn_packet_type_t type) {
+    msgbuf_t *msgbuf;
+    msgbuf_pool_get(msgbuf_pool, &msgbuf);
+
+    hicn_name_set_suffix(&name, seq);
+    msgbuf->connection_id = CONN_ID;
+    msgbuf_set_name(msgbuf, &name);
+
+    hicn_packet_buffer_t *pkbuf = msgbuf_get_pkbuf(msgbuf);
+    hicn_packet_set_format(pkbuf, HICN_PACKET_FORMAT_IPV6_TCP);
+    hicn_packet_set_type(pkbuf, type);
+    hicn_packet_set_buffer(pkbuf, msgbuf->packet, MTU, 0);
+    int rc = hicn_packet_init_header(pkbuf, 0);
+    EXPECT_EQ(rc, 0);
+
+    // Same field as the data expiry time
+    msgbuf_set_interest_lifetime(msgbuf, FIVE_SECONDS);
+    return msgbuf;
+  }
+
+  void insert(uint32_t seq) {
+    msgbuf_t *msgbuf = msgbuf_create(seq, HICN_PACKET_TYPE_DATA);
+    pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf,
+                        msgbuf_pool_get_id(msgbuf_pool, msgbuf));
+  }
+
+  pkt_cache_verdict_t request(uint32_t seq) {
+    msgbuf_t *msgbuf = msgbuf_create(seq, HICN_PACKET_TYPE_INTEREST);
+    pkt_cache_verdict_t verdict;
+    off_t data_msgbuf_id;
+    pkt_cache_entry_t *entry;
+    pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                          msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                          &data_msgbuf_id, &entry, &name, true);
+    // The interest is not stored in the packet cache when served from the CS
+    if (verdict == PKT_CACHE_VERDICT_FORWARD_DATA)
+      msgbuf_pool_put(msgbuf_pool, msgbuf);
+    return verdict;
+  }
+
+  bool is_cached(uint32_t seq) {
+    pkt_cache_lookup_t lookup_result;
+    off_t entry_id;
+    hicn_name_set_suffix(&name, seq);
+    pkt_cache_lookup(pkt_cache, &name, msgbuf_pool, &lookup_result, &entry_id,
+                     true);
+    return lookup_result == PKT_CACHE_LU_DATA_NOT_EXPIRED;
+  }
+
+  // Number of entries tracked by the policy, across all its segments
+  size_t policy_len() {
+    cs_t *cs = pkt_cache_get_cs(pkt_cache);
+    switch (cs->type) {
+      case CS_TYPE_SLRU:
+        return cs->slru.len[CS_SLRU_PROBATION] +
+               cs->slru.len[CS_SLRU_PROTECTED];
+      case CS_TYPE_ARC:
+        return cs->arc.len[CS_ARC_T1] + cs->arc.len[CS_ARC_T2];
+      case CS_TYPE_TINYLFU:
+        return cs->tinylfu.window_len +
+               cs->tinylfu.main.len[CS_SLRU_PROBATION] +
+               cs->tinylfu.main.len[CS_SLRU_PROTECTED];
+      default:
+        return cs->num_entries;
+    }
+  }
+
+  pkt_cache_t *pkt_cache;
+  msgbuf_pool_t *msgbuf_pool;
+  hicn_name_t name;
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    CsTypes, ContentStoreTest,
+    ::testing::Values(CS_TYPE_LRU, CS_TYPE_SLRU, CS_TYPE_ARC, CS_TYPE_TINYLFU),
+    [](const ::testing::TestParamInfo<cs_type_t> &info) {
+      return std::string(cs_type_str(info.param));
+    });
+
+TEST_P(ContentStoreTest, Capacity) {
+  for (uint32_t seq = 0; seq < 3 * CS_SIZE; seq++) {
+    insert(seq);
+    EXPECT_LE(pkt_cache_get_cs_size(pkt_cache), (size_t)CS_SIZE);
+    EXPECT_EQ(policy_len(), pkt_cache_get_cs_size(pkt_cache));
+  }
+  EXPECT_EQ(pkt_cache_get_cs_size(pkt_cache), (size_t)CS_SIZE);
+
+  // The packet cache does not hold more entries than the CS reports
+  EXPECT_EQ(pkt_cache_get_size(pkt_cache), (size_t)CS_SIZE);
+  size_t n_cached = 0;
+  for (uint32_t seq = 0; seq < 3 * CS_SIZE; seq++) n_cached += is_cached(seq);
+  EXPECT_EQ(n_cached, (size_t)CS_SIZE);
+}
+
+TEST_P(ContentStoreTest, RandomWorkload) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> dist(0, 5 * CS_SIZE);
+
+  for (int i = 0; i < N_OPS; i++) {
+    uint32_t seq = dist(gen);
+    if (is_cached(seq)) {
+      EXPECT_EQ(request(seq), PKT_CACHE_VERDICT_FORWARD_DATA);
+    } else if (i % 7 == 0 && pkt_cache_get_cs_size(pkt_cache) > 0) {
+      // Remove a random entry, as done on expiry
+      do {
+        seq = dist(gen);
+      } while (!is_cached(seq));
+      off_t entry_id;
+      pkt_cache_lookup_t lookup_result;
+      hicn_name_set_suffix(&name, seq);
+      pkt_cache_entry_t *entry = pkt_cache_lookup(
+          pkt_cache, &name, msgbuf_pool, &lookup_result, &entry_id, true);
+      pkt_cache_cs_remove_entry(pkt_cache, entry, msgbuf_pool, false);
+    } else {
+      insert(seq);
+    }
+    ASSERT_LE(pkt_cache_get_cs_size(pkt_cache), (size_t)CS_SIZE);
+    ASSERT_EQ(policy_len(), pkt_cache_get_cs_size(pkt_cache));
+    ASSERT_EQ(pkt_cache_get_size(pkt_cache), pkt_cache_get_cs_size(pkt_cache));
+  }
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_GT(stats.n_cs_hits, 0u);
+  EXPECT_EQ(stats.n_cs_misses, 0u);
+}
+
+TEST_P(ContentStoreTest, ScanResistance) {
+  // A small set of popular contents...
+  for (uint32_t seq = 0; seq < N_HOT; seq++) insert(seq);
+  for (unsigned i = 0; i < N_HITS; i++)
+    for (uint32_t seq = 0; seq < N_HOT; seq++)
+      EXPECT_EQ(request(seq), PKT_CACHE_VERDICT_FORWARD_DATA);
+
+  // ... followed by a scan of contents requested only once
+  for (uint32_t seq = N_HOT; seq < N_HOT + N_SCAN; seq++) insert(seq);
+
+  size_t n_hot_cached = 0;
+  for (uint32_t seq = 0; seq < N_HOT; seq++) n_hot_cached += is_cached(seq);
+
+  if (GetParam() == CS_TYPE_LRU)
+    EXPECT_EQ(n_hot_cached, 0u);
+  else
+    EXPECT_EQ(n_hot_cached, (size_t)N_HOT);
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_cs_hits, N_HOT * N_HITS);
+
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  if (GetParam() == CS_TYPE_TINYLFU) {
+    EXPECT_GT(cs->stats.tinylfu.countRejections, 0u);
+    EXPECT_GT(cs->stats.tinylfu.main.countPromotions, 0u);
+  } else if (GetParam() == CS_TYPE_SLRU) {
+    EXPECT_EQ(cs->stats.slru.countPromotions, (uint64_t)N_HOT);
+  }
+}
+
+TEST_P(ContentStoreTest, Shrink) {
+  // Entries that have all been hit at least once...
+  for (uint32_t seq = 0; seq < CS_SIZE / 2; seq++) insert(seq);
+  for (uint32_t seq = 0; seq < CS_SIZE / 2; seq++)
+    EXPECT_EQ(request(seq), PKT_CACHE_VERDICT_FORWARD_DATA);
+
+  // ... fill the CS once shrunk to their number
+  EXPECT_EQ(pkt_cache_set_cs_size(pkt_cache, CS_SIZE / 2), 0);
+
+  for (uint32_t seq = CS_SIZE; seq < 2 * CS_SIZE; seq++) {
+    insert(seq);
+    EXPECT_TRUE(is_cached(seq));
+    ASSERT_EQ(pkt_cache_get_cs_size(pkt_cache), (size_t)CS_SIZE / 2);
+    ASSERT_EQ(policy_len(), pkt_cache_get_cs_size(pkt_cache));
+  }
+
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  if (GetParam() == CS_TYPE_SLRU) {
+    EXPECT_LE(cs->slru.len[CS_SLRU_PROTECTED],
+              (size_t)CS_SIZE / 2 * CS_SLRU_PROTECTED_RATIO / 100);
+    EXPECT_GT(cs->stats.slru.countDemotions, 0u);
+  } else if (GetParam() == CS_TYPE_TINYLFU) {
+    EXPECT_LT(cs->tinylfu.sketch.width, (size_t)CS_SIZE);
+  }
+}
+
+TEST_P(ContentStoreTest, Grow) {
+  static constexpr unsigned LARGE_CS_SIZE = 10 * CS_SIZE;
+  for (uint32_t seq = 0; seq < CS_SIZE; seq++) insert(seq);
+  EXPECT_EQ(pkt_cache_set_cs_size(pkt_cache, LARGE_CS_SIZE), 0);
+
+  for (uint32_t seq = CS_SIZE; seq < 2 * LARGE_CS_SIZE; seq++) {
+    insert(seq);
+    if (seq % 3 == 0) {
+      EXPECT_EQ(request(seq - 1), PKT_CACHE_VERDICT_FORWARD_DATA);
+    }
+  }
+  EXPECT_EQ(pkt_cache_get_cs_size(pkt_cache), (size_t)LARGE_CS_SIZE);
+  EXPECT_EQ(policy_len(), pkt_cache_get_cs_size(pkt_cache));
+
+  // The frequency sketch tracks as many elements as the CS holds
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+  if (GetParam() == CS_TYPE_TINYLFU) {
+    EXPECT_GE(cs->tinylfu.sketch.width, (size_t)LARGE_CS_SIZE);
+    EXPECT_GT(cs->stats.tinylfu.countAdmissions, 0u);
+  }
+}
+
+TEST_P(ContentStoreTest, SetTypeOnNonEmptyCS) {
+  insert(0);
+  EXPECT_EQ(pkt_cache_set_cs_type(pkt_cache, GetParam()), 0);
+
+  cs_type_t other = GetParam() == CS_TYPE_LRU ? CS_TYPE_ARC : CS_TYPE_LRU;
+  EXPECT_EQ(pkt_cache_set_cs_type(pkt_cache, other), -1);
+
+  pkt_cache_cs_clear(pkt_cache);
+  EXPECT_EQ(pkt_cache_set_cs_type(pkt_cache, other), 0);
+  EXPECT_EQ(pkt_cache_get_cs(pkt_cache)->type, other);
+}
+
+class ContentStoreArcTest : public ContentStoreTest {};
+
+TEST_P(ContentStoreArcTest, GhostHits) {
+  cs_t *cs = pkt_cache_get_cs(pkt_cache);
+
+  // Fill the cache, half of the entries being accessed again (T2)
+  for (uint32_t seq = 0; seq < CS_SIZE; seq++) insert(seq);
+  for (uint32_t seq = CS_SIZE / 2; seq < CS_SIZE; seq++)
+    EXPECT_EQ(request(seq), PKT_CACHE_VERDICT_FORWARD_DATA);
+  EXPECT_EQ(cs->arc.len[CS_ARC_T1], (size_t)CS_SIZE / 2);
+  EXPECT_EQ(cs->arc.len[CS_ARC_T2], (size_t)CS_SIZE / 2);
+
+  // New entries evict the other half to the recency ghost list (B1)
+  for (uint32_t seq = CS_SIZE; seq < CS_SIZE + CS_SIZE / 2; seq++) insert(seq);
+  EXPECT_FALSE(is_cached(0));
+  EXPECT_EQ(cs->arc.p, 0u);
+  EXPECT_EQ(cs->arc.len[CS_ARC_T2], (size_t)CS_SIZE / 2);
+
+  // Re-inserting one of them grows the target size of T1 and places the entry
+  // in T2
+  insert(0);
+  EXPECT_EQ(cs->stats.arc.countGhostHitsRecency, 1u);
+  EXPECT_EQ(cs->stats.arc.countGhostHitsFrequency, 0u);
+  EXPECT_GT(cs->arc.p, 0u);
+  EXPECT_EQ(cs->arc.len[CS_ARC_T2], (size_t)CS_SIZE / 2 + 1);
+  EXPECT_TRUE(is_cached(0));
+}
+
+INSTANTIATE_TEST_SUITE_P(Arc, ContentStoreArcTest,
+                         ::testing::Values(CS_TYPE_ARC));
+
+TEST(ContentStoreTypeTest, FromString) {
+  EXPECT_EQ(cs_type_from_str("lru"), CS_TYPE_LRU);
+  EXPECT_EQ(cs_type_from_str("SLRU"), CS_TYPE_SLRU);
+  EXPECT_EQ(cs_type_from_str("arc"), CS_TYPE_ARC);
+  EXPECT_EQ(cs_type_from_str("tinylfu"), CS_TYPE_TINYLFU);
+  EXPECT_FALSE(CS_TYPE_VALID(cs_type_from_str("fifo")));
+}
+
+TEST(CountMinSketchTest, EstimateAndAging) {
+  cm_sketch_t sketch;
+  ASSERT_EQ(cm_sketch_init(&sketch, CS_SIZE), 0);
+
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 1), 0u);
+  for (int i = 0; i < 10; i++) cm_sketch_increment(&sketch, 1);
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 1), 10u);
+
+  // Counters saturate
+  for (int i = 0; i < 20; i++) cm_sketch_increment(&sketch, 2);
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 2), (unsigned)CM_SKETCH_MAX_COUNT);
+
+  // All counters are halved once the sample size is reached
+  while (sketch.n_samples < sketch.sample_size - 1)
+    cm_sketch_increment(&sketch, 2);
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 1), 10u);
+  cm_sketch_increment(&sketch, 2);
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 1), 5u);
+  EXPECT_EQ(sketch.n_samples, sketch.sample_size / 2);
+
+  cm_sketch_finalize(&sketch);
+}
+
+TEST(CountMinSketchTest, Resize) {
+  cm_sketch_t sketch;
+  ASSERT_EQ(cm_sketch_init(&sketch, CS_SIZE), 0);
+  size_t width = sketch.width;
+  for (int i = 0; i < 10; i++) cm_sketch_increment(&sketch, 1);
+
+  // Counters are kept as long as the width does not change...
+  ASSERT_EQ(cm_sketch_resize(&sketch, width), 0);
+  EXPECT_EQ(sketch.width, width);
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 1), 10u);
+
+  // ... and reset otherwise
+  ASSERT_EQ(cm_sketch_resize(&sketch, 10 * CS_SIZE), 0);
+  EXPECT_GE(sketch.width, (size_t)10 * CS_SIZE);
+  EXPECT_EQ(sketch.sample_size, CM_SKETCH_SAMPLE_FACTOR * sketch.width);
+  EXPECT_EQ(sketch.n_samples, 0u);
+  EXPECT_EQ(cm_sketch_estimate(&sketch, 1), 0u);
+
+  cm_sketch_finalize(&sketch);
+}
+
+class ContentStoreDiskTest : public ContentStoreTest {
+ protected:
+  ContentStoreDiskTest() {
+    char path[] = "/tmp/hicn-light-cs-disk-XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT_GE(fd, 0);
+    close(fd);
+    disk_path = path;
+  }
+
+  virtual ~ContentStoreDiskTest() { unlink(disk_path.c_str()); }
+
+  std::string disk_path;
+};
+
+TEST_P(ContentStoreDiskTest, LogOverwrite) {
+  static constexpr size_t N_SLOTS = 4;
+  cs_disk_t *disk =
+      cs_disk_create(disk_path.c_str(), N_SLOTS * CS_DISK_SLOT_SIZE);
+  ASSERT_NE(disk, nullptr);
+  EXPECT_EQ(cs_disk_get_num_slots(disk), N_SLOTS);
+
+  uint8_t packet[MTU];
+  for (uint32_t seq = 0; seq < N_SLOTS + 1; seq++) {
+    hicn_name_set_suffix(&name, seq);
+    memset(packet, seq, sizeof(packet));
+    EXPECT_EQ(cs_disk_put(disk, &name, packet, 100 + seq, FIVE_SECONDS), 0);
+  }
+  EXPECT_EQ(cs_disk_get_num_entries(disk), N_SLOTS);
+  EXPECT_EQ(disk->stats.countOverwrites, 1u);
+
+  // The oldest packet has been overwritten
+  hicn_name_set_suffix(&name, 0);
+  EXPECT_EQ(cs_disk_get(disk, &name, 0), nullptr);
+
+  hicn_name_set_suffix(&name, 2);
+  const cs_disk_slot_t *slot = cs_disk_get(disk, &name, 0);
+  ASSERT_NE(slot, nullptr);
+  EXPECT_EQ(slot->len, 102u);
+  EXPECT_EQ(slot->packet[0], 2u);
+  EXPECT_EQ(slot->packet[101], 2u);
+
+  // Removed and expired packets are not returned
+  cs_disk_remove(disk, &name);
+  EXPECT_EQ(cs_disk_get(disk, &name, 0), nullptr);
+  hicn_name_set_suffix(&name, 3);
+  EXPECT_EQ(cs_disk_get(disk, &name, FIVE_SECONDS), nullptr);
+  EXPECT_EQ(disk->stats.countExpired, 1u);
+  EXPECT_EQ(cs_disk_get_num_entries(disk), N_SLOTS - 2);
+
+  // Free slots are not accounted as overwrites
+  for (uint32_t seq = N_SLOTS + 1; seq < 2 * N_SLOTS; seq++) {
+    hicn_name_set_suffix(&name, seq);
+    EXPECT_EQ(cs_disk_put(disk, &name, packet, 100, FIVE_SECONDS), 0);
+  }
+  EXPECT_EQ(disk->stats.countOverwrites, 2u);
+
+  EXPECT_EQ(cs_disk_clear(disk), 0);
+  EXPECT_EQ(cs_disk_get_num_entries(disk), 0u);
+
+  cs_disk_free(disk);
+}
+
+TEST_P(ContentStoreDiskTest, DemoteAndPromote) {
+  static constexpr unsigned N_DEMOTED = 10;
+  ASSERT_EQ(pkt_cache_set_cs_disk(pkt_cache, disk_path.c_str(),
+                                  4 * CS_SIZE * CS_DISK_SLOT_SIZE),
+            0);
+
+  for (uint32_t seq = 0; seq < CS_SIZE + N_DEMOTED; seq++) insert(seq);
+  EXPECT_EQ(pkt_cache_get_cs_size(pkt_cache), (size_t)CS_SIZE);
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_cs_disk_entries, N_DEMOTED);
+  EXPECT_EQ(stats.n_cs_disk_demotions, N_DEMOTED);
+
+  // A miss in memory is served from the second tier...
+  uint32_t demoted_seq = 0;
+  for (uint32_t seq = 0; seq < CS_SIZE + N_DEMOTED; seq++) {
+    if (!is_cached(seq)) {
+      demoted_seq = seq;
+      break;
+    }
+  }
+  EXPECT_EQ(request(demoted_seq), PKT_CACHE_VERDICT_FORWARD_DATA);
+  EXPECT_TRUE(is_cached(demoted_seq));
+  EXPECT_EQ(pkt_cache_get_cs_size(pkt_cache), (size_t)CS_SIZE);
+
+  // ... which is exclusive, the victim of the promotion being demoted
+  stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_cs_disk_promotions, 1u);
+  EXPECT_EQ(stats.n_cs_disk_entries, N_DEMOTED);
+  EXPECT_EQ(stats.n_cs_hits, 1u);
+  EXPECT_EQ(stats.n_cs_misses, 0u);
+
+  // Names absent from both tiers still create a PIT entry
+  EXPECT_EQ(request(2 * CS_SIZE), PKT_CACHE_VERDICT_FORWARD_INTEREST);
+
+  pkt_cache_cs_clear(pkt_cache);
+  stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_cs_disk_entries, 0u);
+}
+
+TEST_P(ContentStoreDiskTest, JumboNotDemoted) {
+  static constexpr unsigned N_JUMBO = 5;
+  ASSERT_EQ(pkt_cache_set_cs_disk(pkt_cache, disk_path.c_str(),
+                                  4 * CS_SIZE * CS_DISK_SLOT_SIZE),
+            0);
+
+  // Packets larger than the MTU are evicted without going to the second tier
+  for (uint32_t seq = 0; seq < N_JUMBO; seq++) {
+    msgbuf_t *msgbuf = msgbuf_create(seq, HICN_PACKET_TYPE_DATA);
+    msgbuf_set_len(msgbuf, MTU + 100);
+    pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf,
+                        msgbuf_pool_get_id(msgbuf_pool, msgbuf));
+  }
+  for (uint32_t seq = N_JUMBO; seq < CS_SIZE + N_JUMBO + 1; seq++)
+    insert(seq);
+
+  cs_disk_t *disk = pkt_cache->cs_disk;
+  EXPECT_EQ(disk->stats.countOversized, N_JUMBO);
+  EXPECT_EQ(disk->stats.countDemotions, 1u);
+  EXPECT_EQ(cs_disk_get_num_entries(disk), 1u);
+}
+
+INSTANTIATE_TEST_SUITE_P(Disk, ContentStoreDiskTest,
+                         ::testing::Values(CS_TYPE_LRU));
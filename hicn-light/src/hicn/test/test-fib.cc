@@ -15,6 +15,10 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+#include <vector>
+#include <hicn/test/test-utils.h>
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -184,3 +188,152 @@ TEST_F(FibTest, FibAddNested) {
   EXPECT_TRUE(fib_is_valid(fib));
   EXPECT_TRUE(fib_check_preorder(fib, prefix_array_2, used_array_2));
 }
+
+TEST_F(FibTest, MatchCache) {
+  HICN_PREFIX(b001_64, "b001::/64");
+  HICN_PREFIX(b001_96, "b001::/96");
+  hicn_name_t name;
+  ASSERT_EQ(hicn_name_create("b001::1", 1, &name), 0);
+
+  EXPECT_EQ(fib_match_name(fib, &name), nullptr);
+  EXPECT_EQ(fib_match_name(fib, &name), nullptr);
+  EXPECT_EQ(fib_get_cache_stats(fib).n_hits, 1u);
+
+  /* Adding a longer prefix invalidates the cached result */
+  fib_entry_t *entry_64 = _fib_add_prefix(fib, &b001_64);
+  EXPECT_EQ(fib_match_name(fib, &name), entry_64);
+  fib_entry_t *entry_96 = _fib_add_prefix(fib, &b001_96);
+  EXPECT_EQ(fib_match_name(fib, &name), entry_96);
+  EXPECT_EQ(fib_match_name(fib, &name), entry_96);
+  EXPECT_EQ(fib_get_cache_stats(fib).n_hits, 2u);
+
+  /* Suffixes share the cached result of their prefix */
+  hicn_name_set_suffix(&name, 2);
+  EXPECT_EQ(fib_match_name(fib, &name), entry_96);
+  EXPECT_EQ(fib_get_cache_stats(fib).n_hits, 3u);
+
+  fib_remove_entry(fib, entry_96);
+  EXPECT_EQ(fib_match_name(fib, &name), entry_64);
+  EXPECT_EQ(fib_get_cache_stats(fib).n_misses, 4u);
+}
+
+class FibTypeTest : public ::testing::TestWithParam<fib_type_t> {
+ protected:
+  FibTypeTest() : gen(0) { fib = _fib_create(GetParam(), NULL); }
+  virtual ~FibTypeTest() { fib_free(fib); }
+
+  hicn_prefix_t random_prefix(uint8_t len) {
+    hicn_prefix_t prefix = {0};
+    for (unsigned i = 0; i < 16; i++) prefix.name.v6.as_u8[i] = gen();
+    /* Clustered prefixes, so that they share long paths */
+    prefix.name.v6.as_u8[0] = 0xb0 + gen() % 3;
+    prefix.name.v6.as_u8[1] = gen() % 4;
+    hicn_prefix_truncate(&prefix, len);
+    return prefix;
+  }
+
+  /* Longest prefix of the key among the reference ones */
+  fib_entry_t *reference_match(const hicn_prefix_t *key) {
+    fib_entry_t *match = NULL;
+    uint32_t match_len = 0;
+    for (auto &[prefix, entry] : reference) {
+      if (prefix.len > key->len) continue;
+      if (hicn_prefix_lpm(&prefix, key) != prefix.len) continue;
+      if (!match || prefix.len >= match_len) {
+        match = entry;
+        match_len = prefix.len;
+      }
+    }
+    return match;
+  }
+
+  fib_t *fib;
+  std::mt19937 gen;
+  std::vector<std::pair<hicn_prefix_t, fib_entry_t *>> reference;
+};
+
+INSTANTIATE_TEST_SUITE_P(FibTypes, FibTypeTest,
+                         ::testing::Values(FIB_TYPE_TRIE, FIB_TYPE_MTRIE),
+                         [](const ::testing::TestParamInfo<fib_type_t> &info) {
+                           return std::string(info.param == FIB_TYPE_TRIE
+                                                  ? "Trie"
+                                                  : "Mtrie");
+                         });
+
+TEST_P(FibTypeTest, MatchBelowInnerNode) {
+  HICN_PREFIX(b001, "b001::/64");
+  HICN_PREFIX(c001, "c001::/64");
+  HICN_PREFIX(b001_1, "b001::1/128");
+  HICN_PREFIX(b002_1, "b002::1/128");
+
+  fib_entry_t *entry = _fib_add_prefix(fib, &b001);
+  _fib_add_prefix(fib, &c001);
+
+  EXPECT_EQ(fib_match_prefix(fib, &b001_1), entry);
+  /* Diverges below the 8000::/1 inner node, which must not be returned */
+  EXPECT_EQ(fib_match_prefix(fib, &b002_1), nullptr);
+}
+
+TEST_P(FibTypeTest, RandomMatch) {
+  const unsigned N_PREFIXES = 2000;
+  const unsigned N_LOOKUPS = 5000;
+
+  for (unsigned i = 0; i < N_PREFIXES; i++) {
+    hicn_prefix_t prefix = random_prefix(gen() % 129);
+    if (fib_contains(fib, &prefix)) continue;
+    reference.push_back({prefix, _fib_add_prefix(fib, &prefix)});
+  }
+
+  auto check = [&]() {
+    EXPECT_TRUE(fib_is_valid(fib));
+    EXPECT_EQ(fib_get_size(fib), reference.size());
+    for (unsigned i = 0; i < N_LOOKUPS; i++) {
+      /* Keys below existing prefixes, and random ones */
+      hicn_prefix_t key = random_prefix(128);
+      if (i % 2 == 0) {
+        const hicn_prefix_t &prefix = reference[gen() % reference.size()].first;
+        for (unsigned bit = 0; bit < prefix.len; bit++) {
+          uint8_t mask = 0x80 >> (bit % 8);
+          key.name.v6.as_u8[bit / 8] &= ~mask;
+          key.name.v6.as_u8[bit / 8] |= prefix.name.v6.as_u8[bit / 8] & mask;
+        }
+      }
+      if (i % 3 == 0) hicn_prefix_truncate(&key, gen() % 129);
+      ASSERT_EQ(fib_match_prefix(fib, &key), reference_match(&key));
+    }
+  };
+
+  check();
+
+  /* Remove half of the prefixes */
+  std::shuffle(reference.begin(), reference.end(), gen);
+  for (unsigned i = 0; i < N_PREFIXES / 2 && !reference.empty(); i++) {
+    fib_remove_entry(fib, reference.back().second);
+    reference.pop_back();
+  }
+
+  check();
+}
+
+TEST_P(FibTypeTest, PerformanceMatch) {
+  /* Route table of 1M random /48 to /64 prefixes */
+  const unsigned N_PREFIXES = 1000000;
+  const unsigned N_LOOKUPS = 10000;
+
+  std::vector<hicn_prefix_t> keys;
+  for (unsigned i = 0; i < N_PREFIXES; i++) {
+    hicn_prefix_t prefix = random_prefix(48 + gen() % 17);
+    _fib_add_prefix(fib, &prefix);
+    if (i % (N_PREFIXES / N_LOOKUPS) == 0) {
+      prefix.name.v6.as_u64[1] = gen();
+      prefix.len = 128;
+      keys.push_back(prefix);
+    }
+  }
+
+  auto elapsed_time = get_execution_time([&]() {
+    for (auto &key : keys) fib_match_prefix(fib, &key);
+  });
+  std::cout << "FIB lookups (" << keys.size() << "): " << elapsed_time
+            << " ms\n";
+}
@@ -42,7 +42,8 @@ TEST_F(MsgbufPoolTest, Create) {
   EXPECT_NE(msgbuf_pool, nullptr);
 
   /* Check msgbuf_pool size */
-  size_t msgbuf_pool_size = pool_hdr(msgbuf_pool->buffers)->alloc_size;
+  size_t msgbuf_pool_size =
+      pool_hdr(msgbuf_pool->buffers[MSGBUF_CLASS_DEFAULT])->alloc_size;
   EXPECT_EQ(msgbuf_pool_size, (size_t)PACKET_POOL_DEFAULT_INIT_SIZE);
 }
 
@@ -189,3 +190,83 @@ TEST_F(MsgbufPoolTest, CloneMsgbuf) {
   EXPECT_NE(new_msgbuf, msgbuf);
   EXPECT_TRUE(memcmp(msgbuf, new_msgbuf, sizeof(msgbuf_t)) == 0);
 }
+
+TEST_F(MsgbufPoolTest, ClassFit) {
+  EXPECT_EQ(msgbuf_class_fit(0), MSGBUF_CLASS_SMALL);
+  EXPECT_EQ(msgbuf_class_fit(256), MSGBUF_CLASS_SMALL);
+  EXPECT_EQ(msgbuf_class_fit(257), MSGBUF_CLASS_DEFAULT);
+  EXPECT_EQ(msgbuf_class_fit(MTU), MSGBUF_CLASS_DEFAULT);
+  EXPECT_EQ(msgbuf_class_fit(9000), MSGBUF_CLASS_JUMBO);
+  EXPECT_EQ(msgbuf_class_fit(MSGBUF_MAX_SIZE + 1), MSGBUF_CLASS_N);
+}
+
+TEST_F(MsgbufPoolTest, GetMsgbufPerClass) {
+  msgbuf_t *msgbufs[MSGBUF_CLASS_N];
+  off_t ids[MSGBUF_CLASS_N];
+
+  for (unsigned i = 0; i < MSGBUF_CLASS_N; i++) {
+    msgbuf_class_t size_class = (msgbuf_class_t)i;
+    ids[i] = _msgbuf_pool_get(msgbuf_pool, size_class, &msgbufs[i]);
+    EXPECT_NE(msgbuf_id_is_valid((unsigned long)ids[i]), 0);
+    EXPECT_EQ(msgbuf_get_buffer_size(msgbufs[i]),
+              msgbuf_class_get_size(size_class));
+  }
+
+  /* Ids are unique across classes, and map back to their msgbuf */
+  for (unsigned i = 0; i < MSGBUF_CLASS_N; i++) {
+    EXPECT_EQ(msgbuf_pool_get_id(msgbuf_pool, msgbufs[i]), ids[i]);
+    EXPECT_EQ(msgbuf_pool_at(msgbuf_pool, ids[i]), msgbufs[i]);
+    for (unsigned j = 0; j < i; j++) EXPECT_NE(ids[i], ids[j]);
+  }
+
+  /* The whole buffer of a jumbo msgbuf is usable */
+  msgbuf_t *jumbo = msgbufs[MSGBUF_CLASS_JUMBO];
+  memset(msgbuf_get_packet(jumbo), 0xff, msgbuf_get_buffer_size(jumbo));
+  EXPECT_EQ(msgbuf_pool_at(msgbuf_pool, ids[MSGBUF_CLASS_JUMBO]), jumbo);
+}
+
+TEST_F(MsgbufPoolTest, FitMsgbufs) {
+  const int NUM_MSG = 3;
+  const size_t lens[NUM_MSG] = {100, 1400, 200};
+  msgbuf_t *msgbufs[NUM_MSG];
+  off_t ids[NUM_MSG];
+
+  msgbuf_pool_set_rx_class(msgbuf_pool, MSGBUF_CLASS_JUMBO);
+  ASSERT_EQ(msgbuf_pool_getn(msgbuf_pool, msgbufs, NUM_MSG), 0);
+  for (unsigned i = 0; i < NUM_MSG; i++) {
+    EXPECT_EQ(msgbufs[i]->size_class, MSGBUF_CLASS_JUMBO);
+    ids[i] = msgbuf_pool_get_id(msgbuf_pool, msgbufs[i]);
+    memset(msgbuf_get_packet(msgbufs[i]), i, lens[i]);
+    msgbuf_set_len(msgbufs[i], lens[i]);
+  }
+
+  ASSERT_EQ(msgbuf_pool_fitn(msgbuf_pool, msgbufs, ids, NUM_MSG), 0);
+
+  const msgbuf_class_t expected[NUM_MSG] = {
+      MSGBUF_CLASS_SMALL, MSGBUF_CLASS_DEFAULT, MSGBUF_CLASS_SMALL};
+  for (unsigned i = 0; i < NUM_MSG; i++) {
+    EXPECT_EQ(msgbufs[i]->size_class, expected[i]) << "Invalid index: " << i;
+    EXPECT_EQ(msgbuf_pool_at(msgbuf_pool, ids[i]), msgbufs[i]);
+    EXPECT_EQ(msgbuf_get_len(msgbufs[i]), lens[i]);
+    EXPECT_EQ(msgbuf_get_packet(msgbufs[i])[lens[i] - 1], i);
+  }
+
+  /* The receive buffers have been put back into the pool */
+  EXPECT_EQ(pool_get_free_indices_size(
+                msgbuf_pool->buffers[MSGBUF_CLASS_JUMBO]),
+            pool_hdr(msgbuf_pool->buffers[MSGBUF_CLASS_JUMBO])->alloc_size);
+}
+
+TEST_F(MsgbufPoolTest, CloneMsgbufKeepsClass) {
+  msgbuf_t *msgbuf = NULL;
+  off_t msgbuf_id = _msgbuf_pool_get(msgbuf_pool, MSGBUF_CLASS_SMALL, &msgbuf);
+  memset(msgbuf_get_packet(msgbuf), 0xaa, 64);
+  msgbuf_set_len(msgbuf, 64);
+
+  msgbuf_t *new_msgbuf;
+  off_t new_msg_id = msgbuf_pool_clone(msgbuf_pool, &new_msgbuf, msgbuf_id);
+  EXPECT_EQ(new_msgbuf->size_class, MSGBUF_CLASS_SMALL);
+  EXPECT_EQ(new_msgbuf, msgbuf_pool_at(msgbuf_pool, new_msg_id));
+  EXPECT_TRUE(memcmp(msgbuf_get_packet(msgbuf), msgbuf_get_packet(new_msgbuf),
+                     64) == 0);
+}
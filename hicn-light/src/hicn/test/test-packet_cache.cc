@@ -17,6 +17,7 @@
 
 #include <optional>
 #include <random>
+#include <vector>
 #include <hicn/test/test-utils.h>
 
 extern "C" {
@@ -36,8 +37,9 @@ static constexpr int N_OPS = 50000;
 
 class PacketCacheTest : public ::testing::Test {
  protected:
-  PacketCacheTest() {
-    pkt_cache = pkt_cache_create(CS_SIZE);
+  PacketCacheTest(
+      pkt_cache_index_type_t index_type = PKT_CACHE_INDEX_TYPE_KHASH) {
+    pkt_cache = _pkt_cache_create(index_type, CS_SIZE);
     int rc = hicn_name_create_from_ip_address(IPV4_ANY, 0, &name);
     EXPECT_EQ(rc, 0);
     msgbuf_pool = msgbuf_pool_create();
@@ -93,6 +95,24 @@ class PacketCacheTest : public ::testing::Test {
   msgbuf_t *msgbuf;
 };
 
+/*
+ * Tests that only rely on the packet cache API are run against all index
+ * types; tests of the two-level khash internals use PacketCacheTest directly.
+ */
+class PacketCacheIndexTest
+    : public PacketCacheTest,
+      public ::testing::WithParamInterface<pkt_cache_index_type_t> {
+ protected:
+  PacketCacheIndexTest() : PacketCacheTest(GetParam()) {}
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    IndexTypes, PacketCacheIndexTest,
+    ::testing::Values(PKT_CACHE_INDEX_TYPE_KHASH, PKT_CACHE_INDEX_TYPE_FLAT),
+    [](const ::testing::TestParamInfo<pkt_cache_index_type_t> &info) {
+      return info.param == PKT_CACHE_INDEX_TYPE_FLAT ? "Flat" : "Khash";
+    });
+
 TEST_F(PacketCacheTest, LowLevelOperations) {
   kh_pkt_cache_prefix_t *prefix_to_suffixes = kh_init_pkt_cache_prefix();
   const hicn_name_prefix_t *prefix = hicn_name_get_prefix(&name);
@@ -121,7 +141,7 @@ TEST_F(PacketCacheTest, LowLevelOperations) {
   _prefix_map_free(prefix_to_suffixes);
 }
 
-TEST_F(PacketCacheTest, CreatePacketCache) {
+TEST_P(PacketCacheIndexTest, CreatePacketCache) {
   // Check packet cache allocation
   EXPECT_NE(pkt_cache, nullptr);
   pit_t *pit = pkt_cache_get_pit(pkt_cache);
@@ -135,7 +155,7 @@ TEST_F(PacketCacheTest, CreatePacketCache) {
   ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), 0u);
 }
 
-TEST_F(PacketCacheTest, AddPacketCacheEntry) {
+TEST_P(PacketCacheIndexTest, AddPacketCacheEntry) {
   // Add entry to the packet cache
   entry = pkt_cache_allocate(pkt_cache);
   EXPECT_NE(entry, nullptr);
@@ -151,7 +171,7 @@ TEST_F(PacketCacheTest, AddPacketCacheEntry) {
   EXPECT_NE(lookup_result, PKT_CACHE_LU_NONE);
 }
 
-TEST_F(PacketCacheTest, GetCS) {
+TEST_P(PacketCacheIndexTest, GetCS) {
   cs_t *cs = pkt_cache_get_cs(pkt_cache);
   ASSERT_NE(cs, nullptr);
   ASSERT_EQ(pkt_cache_get_cs_size(pkt_cache), 0u);
@@ -162,13 +182,13 @@ TEST_F(PacketCacheTest, GetCS) {
   EXPECT_EQ(cs->lru.tail, (off_t)INVALID_ENTRY_ID);
 }
 
-TEST_F(PacketCacheTest, GetPIT) {
+TEST_P(PacketCacheIndexTest, GetPIT) {
   pit_t *pit = pkt_cache_get_pit(pkt_cache);
   ASSERT_NE(pit, nullptr);
   ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), 0u);
 }
 
-TEST_F(PacketCacheTest, LookupEmpty) {
+TEST_P(PacketCacheIndexTest, LookupEmpty) {
   pkt_cache_lookup_t lookup_result;
   off_t entry_id;
   pkt_cache_entry_t *entry = pkt_cache_lookup(pkt_cache, &name, msgbuf_pool,
@@ -178,7 +198,48 @@ TEST_F(PacketCacheTest, LookupEmpty) {
   EXPECT_EQ(entry, nullptr);
 }
 
-TEST_F(PacketCacheTest, AddEntryAndLookup) {
+TEST_P(PacketCacheIndexTest, PrefetchEmpty) {
+  // Prefetching must not have side effects on an empty packet cache
+  pkt_cache_prefetch_prefix(pkt_cache, &name);
+  pkt_cache_prefetch_suffix(pkt_cache, &name);
+
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  pkt_cache_entry_t *entry = pkt_cache_lookup(pkt_cache, &name, msgbuf_pool,
+                                              &lookup_result, &entry_id, true);
+  EXPECT_EQ(lookup_result, PKT_CACHE_LU_NONE);
+  EXPECT_EQ(entry, nullptr);
+  EXPECT_EQ(pkt_cache_get_size(pkt_cache), 0u);
+}
+
+TEST_P(PacketCacheIndexTest, PrefetchAndLookup) {
+  entry = pkt_cache_allocate(pkt_cache);
+  ASSERT_NE(entry, nullptr);
+  entry->name = name;
+  entry->entry_type = PKT_CACHE_PIT_TYPE;
+  pkt_cache_add_to_index(pkt_cache, entry);
+
+  hicn_name_t other_name = get_name_from_prefix("c001::0");
+  pkt_cache_prefetch_prefix(pkt_cache, &name);
+  pkt_cache_prefetch_prefix(pkt_cache, &other_name);
+  pkt_cache_prefetch_suffix(pkt_cache, &name);
+  pkt_cache_prefetch_suffix(pkt_cache, &other_name);
+
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  pkt_cache_entry_t *lu_entry = pkt_cache_lookup(
+      pkt_cache, &name, msgbuf_pool, &lookup_result, &entry_id, true);
+  EXPECT_EQ(lookup_result, PKT_CACHE_LU_INTEREST_NOT_EXPIRED);
+  EXPECT_EQ(lu_entry, entry);
+
+  lu_entry = pkt_cache_lookup(pkt_cache, &other_name, msgbuf_pool,
+                              &lookup_result, &entry_id, true);
+  EXPECT_EQ(lookup_result, PKT_CACHE_LU_NONE);
+  EXPECT_EQ(lu_entry, nullptr);
+  EXPECT_EQ(pkt_cache_get_size(pkt_cache), 1u);
+}
+
+TEST_P(PacketCacheIndexTest, AddEntryAndLookup) {
   // Add entry to the packet cache
   entry = pkt_cache_allocate(pkt_cache);
   entry->name = name;
@@ -198,7 +259,7 @@ TEST_F(PacketCacheTest, AddEntryAndLookup) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, AddToPIT) {
+TEST_P(PacketCacheIndexTest, AddToPIT) {
   // Check if entry properly created
   pkt_cache_entry_t *entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, &name);
   ASSERT_NE(entry, nullptr);
@@ -216,7 +277,7 @@ TEST_F(PacketCacheTest, AddToPIT) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, AddToCS) {
+TEST_P(PacketCacheIndexTest, AddToCS) {
   // Check if entry properly created
   pkt_cache_entry_t *entry =
       pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf, MSGBUF_ID);
@@ -242,7 +303,7 @@ TEST_F(PacketCacheTest, AddToCS) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, PitToCS) {
+TEST_P(PacketCacheIndexTest, PitToCS) {
   // Prepare PIT entry
   pkt_cache_entry_t *entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, &name);
   off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
@@ -274,7 +335,7 @@ TEST_F(PacketCacheTest, PitToCS) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, CsToPIT) {
+TEST_P(PacketCacheIndexTest, CsToPIT) {
   // Prepare CS entry
   pkt_cache_entry_t *entry =
       pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf, MSGBUF_ID);
@@ -299,7 +360,7 @@ TEST_F(PacketCacheTest, CsToPIT) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, UpdateInPIT) {
+TEST_P(PacketCacheIndexTest, UpdateInPIT) {
   // Prepare PIT entry
   pkt_cache_entry_t *entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, &name);
   off_t entry_id = pkt_cache_get_entry_id(pkt_cache, entry);
@@ -325,7 +386,7 @@ TEST_F(PacketCacheTest, UpdateInPIT) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, UpdateInCS) {
+TEST_P(PacketCacheIndexTest, UpdateInCS) {
   // Prepare CS entry
   pkt_cache_entry_t *entry =
       pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf, MSGBUF_ID);
@@ -353,7 +414,7 @@ TEST_F(PacketCacheTest, UpdateInCS) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, RemoveFromPIT) {
+TEST_P(PacketCacheIndexTest, RemoveFromPIT) {
   // Prepare PIT entry
   pkt_cache_entry_t *entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, &name);
   ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), 1u);
@@ -372,7 +433,7 @@ TEST_F(PacketCacheTest, RemoveFromPIT) {
   EXPECT_EQ(lu_entry, nullptr);
 }
 
-TEST_F(PacketCacheTest, RemoveFromCS) {
+TEST_P(PacketCacheIndexTest, RemoveFromCS) {
   // Prepare CS entry
   pkt_cache_entry_t *entry =
       pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf, MSGBUF_ID);
@@ -398,7 +459,7 @@ TEST_F(PacketCacheTest, RemoveFromCS) {
   EXPECT_EQ(lu_entry, nullptr);
 }
 
-TEST_F(PacketCacheTest, AddTwoEntriesToCS) {
+TEST_P(PacketCacheIndexTest, AddTwoEntriesToCS) {
   // Prepare another msgbuf
   hicn_name_t new_name;
   int rc = hicn_name_create_from_ip_address(IPV4_LOOPBACK, 0, &new_name);
@@ -421,7 +482,7 @@ TEST_F(PacketCacheTest, AddTwoEntriesToCS) {
   ASSERT_EQ(pkt_cache_get_cs_size(pkt_cache), 2u);
 }
 
-TEST_F(PacketCacheTest, AggregateInPIT) {
+TEST_P(PacketCacheIndexTest, AggregateInPIT) {
   // Prepare another msgbuf
   hicn_name_t new_name;
   int rc = hicn_name_create_from_ip_address(IPV4_LOOPBACK, 0, &new_name);
@@ -450,7 +511,7 @@ TEST_F(PacketCacheTest, AggregateInPIT) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, RetransmissionInPIT) {
+TEST_P(PacketCacheIndexTest, RetransmissionInPIT) {
   // Prepare another msgbuf (using same connection ID)
   hicn_name_t new_name;
   int rc = hicn_name_create_from_ip_address(IPV4_LOOPBACK, 0, &new_name);
@@ -479,7 +540,7 @@ TEST_F(PacketCacheTest, RetransmissionInPIT) {
   EXPECT_EQ(lu_entry, entry);
 }
 
-TEST_F(PacketCacheTest, LookupExpiredInterest) {
+TEST_P(PacketCacheIndexTest, LookupExpiredInterest) {
   // Prepare msgbuf with 0 as interest lifetime
   msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &name, 0);
 
@@ -497,7 +558,7 @@ TEST_F(PacketCacheTest, LookupExpiredInterest) {
   EXPECT_EQ(lookup_result, PKT_CACHE_LU_INTEREST_EXPIRED);
 }
 
-TEST_F(PacketCacheTest, LookupExpiredData) {
+TEST_P(PacketCacheIndexTest, LookupExpiredData) {
   // Prepare msgbuf with 0 as data expiry time
   msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &name, 0);
 
@@ -516,7 +577,7 @@ TEST_F(PacketCacheTest, LookupExpiredData) {
   EXPECT_EQ(lookup_result, PKT_CACHE_LU_DATA_EXPIRED);
 }
 
-TEST_F(PacketCacheTest, GetStaleEntries) {
+TEST_P(PacketCacheIndexTest, GetStaleEntries) {
   // Add to CS a msgbuf with immediate expiration (i.e. stale)
   msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &name, 0);
   pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf, MSGBUF_ID);
@@ -540,7 +601,7 @@ TEST_F(PacketCacheTest, GetStaleEntries) {
   EXPECT_EQ(num_stale_entries, 2u);
 }
 
-TEST_F(PacketCacheTest, GetMultipleStaleEntries) {
+TEST_P(PacketCacheIndexTest, GetMultipleStaleEntries) {
   hicn_ip_address_t addr;
   char name[30];
   const int NUM_STALES = 10;
@@ -663,7 +724,94 @@ TEST_F(PacketCacheTest, PerformanceCachedLookupRandom) {
   std::cout << "Cached lookup (rand): " << elapsed_time_single_rand << " ms\n";
 }
 
-TEST_F(PacketCacheTest, Clear) {
+TEST_P(PacketCacheIndexTest, AddLookupRemoveMany) {
+  static constexpr int N_PREFIXES = 8;
+  static constexpr int N_SUFFIXES = 2000;
+  char prefix_str[30];
+
+  std::vector<hicn_name_t> names;
+  for (int i = 0; i < N_PREFIXES; i++) {
+    snprintf(prefix_str, 30, "b00%d::0", i);
+    hicn_name_t tmp = get_name_from_prefix(prefix_str);
+    for (int seq = 0; seq < N_SUFFIXES; seq++) {
+      hicn_name_set_suffix(&tmp, seq);
+      names.push_back(tmp);
+    }
+  }
+
+  // Add to PIT (growing the index). Entry ids are kept instead of pointers as
+  // the pool of entries gets resized.
+  std::vector<off_t> entry_ids;
+  for (auto &n : names) {
+    pkt_cache_entry_t *entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, &n);
+    entry_ids.push_back(pkt_cache_get_entry_id(pkt_cache, entry));
+  }
+  ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), names.size());
+
+  // Remove every other entry
+  for (size_t i = 0; i < names.size(); i += 2)
+    pkt_cache_pit_remove_entry(pkt_cache,
+                               pkt_cache_entry_at(pkt_cache, entry_ids[i]));
+  ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), names.size() / 2);
+
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  for (size_t i = 0; i < names.size(); i++) {
+    pkt_cache_entry_t *lu_entry = pkt_cache_lookup(
+        pkt_cache, &names[i], msgbuf_pool, &lookup_result, &entry_id, true);
+    if (i % 2 == 0) {
+      EXPECT_EQ(lookup_result, PKT_CACHE_LU_NONE);
+      EXPECT_EQ(lu_entry, nullptr);
+    } else {
+      EXPECT_EQ(lookup_result, PKT_CACHE_LU_INTEREST_NOT_EXPIRED);
+      ASSERT_NE(lu_entry, nullptr);
+      EXPECT_TRUE(hicn_name_equals(&lu_entry->name, &names[i]));
+    }
+  }
+
+  // Add removed entries back (reusing deleted slots)
+  for (size_t i = 0; i < names.size(); i += 2)
+    pkt_cache_add_to_pit(pkt_cache, msgbuf, &names[i]);
+  ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), names.size());
+
+  for (auto &n : names) {
+    pkt_cache_entry_t *lu_entry = pkt_cache_lookup(
+        pkt_cache, &n, msgbuf_pool, &lookup_result, &entry_id, true);
+    EXPECT_EQ(lookup_result, PKT_CACHE_LU_INTEREST_NOT_EXPIRED);
+    ASSERT_NE(lu_entry, nullptr);
+    EXPECT_TRUE(hicn_name_equals(&lu_entry->name, &n));
+  }
+}
+
+static const hicn_name_t *get_name_at(const void *context, unsigned id) {
+  return &static_cast<const hicn_name_t *>(context)[id];
+}
+
+TEST_F(PacketCacheTest, PerformanceFlatLookup) {
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+
+  std::vector<hicn_name_t> names(N_OPS);
+  for (int seq = 0; seq < N_OPS; seq++) {
+    hicn_name_set_suffix(&tmp, seq);
+    names[seq] = tmp;
+  }
+
+  auto elapsed_time_flat = get_execution_time([&]() {
+    name_index_t *index = name_index_create(get_name_at, names.data());
+
+    // Add to index
+    for (int seq = 0; seq < N_OPS; seq++)
+      name_index_put(index, &names[seq], seq);
+
+    // Read from index
+    for (int seq = 0; seq < N_OPS; seq++) name_index_get(index, &names[seq]);
+
+    name_index_free(index);
+  });
+  std::cout << "Flat lookup: " << elapsed_time_flat << " ms\n";
+}
+
+TEST_P(PacketCacheIndexTest, Clear) {
   hicn_name_t tmp_name1, tmp_name2;
   cs_t *cs = pkt_cache_get_cs(pkt_cache);
 
@@ -701,3 +849,376 @@ TEST_F(PacketCacheTest, Clear) {
   ASSERT_EQ(cs->num_entries, 0);
   ASSERT_EQ(cs->stats.lru.countAdds, 0u);
 }
+
+TEST_P(PacketCacheIndexTest, ExpireReclaimsEntries) {
+  hicn_name_t name_2, name_3;
+  int rc = hicn_name_create_from_ip_address(IPV4_LOOPBACK, 0, &name_2);
+  EXPECT_EQ(rc, 0);
+  rc = hicn_name_create_from_ip_address(IPV6_LOOPBACK, 0, &name_3);
+  EXPECT_EQ(rc, 0);
+
+  // Interest and data with immediate expiration, interest with 5 seconds
+  // lifetime
+  msgbuf_t *msgbuf_1 = msgbuf_create(msgbuf_pool, CONN_ID, &name, 0);
+  msgbuf_t *msgbuf_2 = msgbuf_create(msgbuf_pool, CONN_ID, &name_2, 0);
+  msgbuf_t *msgbuf_3 = msgbuf_create(msgbuf_pool, CONN_ID, &name_3);
+  pkt_cache_add_to_pit(pkt_cache, msgbuf_1, &name);
+  pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, msgbuf_2,
+                      msgbuf_pool_get_id(msgbuf_pool, msgbuf_2));
+  pkt_cache_add_to_pit(pkt_cache, msgbuf_3, &name_3);
+  ASSERT_EQ(pkt_cache_get_pit_size(pkt_cache), 2u);
+  ASSERT_EQ(pkt_cache_get_cs_size(pkt_cache), 1u);
+
+  // Expired entries are reclaimed without any lookup
+  Ticks now = ticks_now();
+  EXPECT_EQ(pkt_cache_expire(pkt_cache, msgbuf_pool, now, N_OPS), 2u);
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), 1u);
+  EXPECT_EQ(pkt_cache_get_cs_size(pkt_cache), 0u);
+
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  pkt_cache_lookup(pkt_cache, &name, msgbuf_pool, &lookup_result, &entry_id,
+                   true);
+  EXPECT_EQ(lookup_result, PKT_CACHE_LU_NONE);
+  pkt_cache_lookup(pkt_cache, &name_2, msgbuf_pool, &lookup_result, &entry_id,
+                   true);
+  EXPECT_EQ(lookup_result, PKT_CACHE_LU_NONE);
+
+  // The remaining interest expires after its lifetime
+  EXPECT_EQ(pkt_cache_expire(pkt_cache, msgbuf_pool, now + 100, N_OPS), 0u);
+  EXPECT_EQ(
+      pkt_cache_expire(pkt_cache, msgbuf_pool, now + 2 * FIVE_SECONDS, N_OPS),
+      1u);
+  EXPECT_EQ(pkt_cache_get_size(pkt_cache), 0u);
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_pit_reclaimed, 2u);
+  EXPECT_EQ(stats.n_cs_reclaimed, 1u);
+}
+
+TEST_P(PacketCacheIndexTest, ExpireBudget) {
+  static constexpr size_t N_ENTRIES = 100;
+  static constexpr size_t BUDGET = 30;
+
+  msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &name, 0);
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+  for (size_t seq = 0; seq < N_ENTRIES; seq++) {
+    hicn_name_set_suffix(&tmp, seq);
+    pkt_cache_add_to_pit(pkt_cache, msgbuf, &tmp);
+  }
+
+  // Work is bounded by the budget, the remaining entries are reclaimed by
+  // subsequent calls
+  Ticks now = ticks_now();
+  size_t n_reclaimed = 0;
+  while (pkt_cache_get_pit_size(pkt_cache) > 0) {
+    size_t n = pkt_cache_expire(pkt_cache, msgbuf_pool, now, BUDGET);
+    EXPECT_LE(n, BUDGET);
+    ASSERT_GT(n, 0u);
+    n_reclaimed += n;
+  }
+  EXPECT_EQ(n_reclaimed, N_ENTRIES);
+}
+
+TEST_P(PacketCacheIndexTest, ExpireAfterAggregation) {
+  static constexpr Ticks SHORT_LIFETIME = 100;
+
+  msgbuf_t *short_msgbuf =
+      msgbuf_create(msgbuf_pool, CONN_ID, &name, SHORT_LIFETIME);
+  pkt_cache_entry_t *entry =
+      pkt_cache_add_to_pit(pkt_cache, short_msgbuf, &name);
+  Ticks now = ticks_now();
+
+  // Extend the lifetime of the entry through aggregation
+  msgbuf_t *long_msgbuf = msgbuf_create(msgbuf_pool, CONN_ID_2, &name);
+  pkt_cache_try_aggregate_in_pit(pkt_cache, entry, long_msgbuf, &name);
+
+  // The entry is not reclaimed at its initial expiry time...
+  EXPECT_EQ(
+      pkt_cache_expire(pkt_cache, msgbuf_pool, now + SHORT_LIFETIME, N_OPS),
+      0u);
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), 1u);
+
+  // ... but only after the extended one
+  EXPECT_EQ(
+      pkt_cache_expire(pkt_cache, msgbuf_pool, now + 2 * FIVE_SECONDS, N_OPS),
+      1u);
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), 0u);
+}
+
+TEST_P(PacketCacheIndexTest, PitAdmissionFull) {
+  static constexpr size_t PIT_SIZE = 10;
+
+  pit_t *pit = pkt_cache_get_pit(pkt_cache);
+  pit_set_max_size(pit, PIT_SIZE, 0);
+
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+  pkt_cache_verdict_t verdict;
+  off_t data_msgbuf_id;
+  pkt_cache_entry_t *entry;
+  for (size_t seq = 0; seq < PIT_SIZE + 5; seq++) {
+    hicn_name_set_suffix(&tmp, seq);
+    msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &tmp);
+    pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                          msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                          &data_msgbuf_id, &entry, &tmp, true);
+    if (seq < PIT_SIZE) {
+      EXPECT_EQ(verdict, PKT_CACHE_VERDICT_FORWARD_INTEREST);
+    } else {
+      EXPECT_EQ(verdict, PKT_CACHE_VERDICT_DROP_INTEREST);
+      EXPECT_EQ(entry, nullptr);
+    }
+  }
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), PIT_SIZE);
+  EXPECT_EQ(pit_get_num_entries(pit), PIT_SIZE);
+
+  // Interests matching a pending one are still aggregated
+  hicn_name_set_suffix(&tmp, 0);
+  msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID_2, &tmp);
+  pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                        msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                        &data_msgbuf_id, &entry, &tmp, true);
+  EXPECT_EQ(verdict, PKT_CACHE_VERDICT_AGGREGATE_INTEREST);
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_pit_full_drops, 5u);
+  EXPECT_EQ(stats.n_pit_quota_drops, 0u);
+  EXPECT_EQ(stats.n_pit_replacements, 0u);
+}
+
+TEST_P(PacketCacheIndexTest, PitAdmissionQuota) {
+  static constexpr size_t QUOTA = 4;
+
+  pit_t *pit = pkt_cache_get_pit(pkt_cache);
+  pit_set_max_size(pit, 0, QUOTA);
+
+  // A connection exhausting its quota does not prevent other connections from
+  // creating entries
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+  pkt_cache_verdict_t verdict;
+  off_t data_msgbuf_id;
+  pkt_cache_entry_t *entry;
+  for (size_t seq = 0; seq < 2 * QUOTA; seq++) {
+    hicn_name_set_suffix(&tmp, seq);
+    msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &tmp);
+    pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                          msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                          &data_msgbuf_id, &entry, &tmp, true);
+    EXPECT_EQ(verdict, seq < QUOTA ? PKT_CACHE_VERDICT_FORWARD_INTEREST
+                                   : PKT_CACHE_VERDICT_DROP_INTEREST);
+  }
+  EXPECT_EQ(pit_get_num_entries_for_connection(pit, CONN_ID), QUOTA);
+
+  hicn_name_set_suffix(&tmp, 2 * QUOTA);
+  msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID_2, &tmp);
+  pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                        msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                        &data_msgbuf_id, &entry, &tmp, true);
+  EXPECT_EQ(verdict, PKT_CACHE_VERDICT_FORWARD_INTEREST);
+  EXPECT_EQ(pit_get_num_entries_for_connection(pit, CONN_ID_2), 1u);
+
+  // Removing an entry releases the quota of its connection
+  hicn_name_set_suffix(&tmp, 0);
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  entry = pkt_cache_lookup(pkt_cache, &tmp, msgbuf_pool, &lookup_result,
+                           &entry_id, true);
+  ASSERT_EQ(lookup_result, PKT_CACHE_LU_INTEREST_NOT_EXPIRED);
+  pkt_cache_pit_remove_entry(pkt_cache, entry);
+  EXPECT_EQ(pit_get_num_entries_for_connection(pit, CONN_ID), QUOTA - 1);
+  EXPECT_FALSE(pit_is_over_quota(pit, CONN_ID));
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_pit_quota_drops, QUOTA);
+  EXPECT_EQ(stats.n_pit_full_drops, 0u);
+}
+
+TEST_P(PacketCacheIndexTest, PitAdmissionReplace) {
+  static constexpr size_t PIT_SIZE = 10;
+
+  pit_t *pit = pkt_cache_get_pit(pkt_cache);
+  pit_set_max_size(pit, PIT_SIZE, 0);
+  pit_set_full_policy(pit, PIT_FULL_POLICY_REPLACE);
+
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+  pkt_cache_verdict_t verdict;
+  off_t data_msgbuf_id;
+  pkt_cache_entry_t *entry;
+  for (size_t seq = 0; seq < PIT_SIZE + 3; seq++) {
+    hicn_name_set_suffix(&tmp, seq);
+    msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &tmp);
+    pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                          msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                          &data_msgbuf_id, &entry, &tmp, true);
+    EXPECT_EQ(verdict, PKT_CACHE_VERDICT_FORWARD_INTEREST);
+  }
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), PIT_SIZE);
+
+  // The oldest entries have been replaced
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  for (size_t seq = 0; seq < PIT_SIZE + 3; seq++) {
+    hicn_name_set_suffix(&tmp, seq);
+    pkt_cache_lookup(pkt_cache, &tmp, msgbuf_pool, &lookup_result, &entry_id,
+                     true);
+    EXPECT_EQ(lookup_result, seq < 3 ? PKT_CACHE_LU_NONE
+                                     : PKT_CACHE_LU_INTEREST_NOT_EXPIRED);
+  }
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_pit_replacements, 3u);
+  EXPECT_EQ(stats.n_pit_full_drops, 0u);
+}
+
+TEST_P(PacketCacheIndexTest, PitAdmissionReplaceManifest) {
+  static constexpr size_t PIT_SIZE = 3;
+
+  pit_t *pit = pkt_cache_get_pit(pkt_cache);
+  pit_set_max_size(pit, PIT_SIZE, 0);
+  pit_set_full_policy(pit, PIT_FULL_POLICY_REPLACE);
+
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+  hicn_name_set_suffix(&tmp, 0);
+  msgbuf_t *pending = msgbuf_create(msgbuf_pool, CONN_ID_2, &tmp);
+  pkt_cache_add_to_pit(pkt_cache, pending, &tmp);
+
+  uint8_t buffer[sizeof(interest_manifest_header_t) +
+                 MAX_SUFFIXES_IN_MANIFEST * sizeof(hicn_name_suffix_t)];
+  interest_manifest_header_t *manifest = (interest_manifest_header_t *)buffer;
+  interest_manifest_init(manifest, 1);
+  for (hicn_name_suffix_t suffix : {2, 3, 4, 5})
+    interest_manifest_add_suffix(manifest, suffix);
+
+  hicn_name_set_suffix(&tmp, 1);
+  msgbuf_t *interest = msgbuf_create(msgbuf_pool, CONN_ID, &tmp);
+  pkt_cache_verdict_t verdicts[MAX_SUFFIXES_IN_MANIFEST];
+  off_t data_msgbuf_ids[MAX_SUFFIXES_IN_MANIFEST];
+  pkt_cache_entry_t *entries[MAX_SUFFIXES_IN_MANIFEST];
+  pkt_cache_on_interest_manifest(pkt_cache, msgbuf_pool,
+                                 msgbuf_pool_get_id(msgbuf_pool, interest),
+                                 manifest, &tmp, verdicts, data_msgbuf_ids,
+                                 entries, true);
+
+  // Only the entry older than the manifest is replaced, the ones admitted for
+  // its first suffixes are kept
+  for (unsigned i = 0; i < 5; i++)
+    EXPECT_EQ(verdicts[i], i < PIT_SIZE ? PKT_CACHE_VERDICT_FORWARD_INTEREST
+                                        : PKT_CACHE_VERDICT_DROP_INTEREST)
+        << "Invalid index: " << i;
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), PIT_SIZE);
+
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  hicn_name_set_suffix(&tmp, 0);
+  pkt_cache_lookup(pkt_cache, &tmp, msgbuf_pool, &lookup_result, &entry_id,
+                   true);
+  EXPECT_EQ(lookup_result, PKT_CACHE_LU_NONE);
+  for (unsigned i = 0; i < PIT_SIZE; i++) {
+    hicn_name_set_suffix(&tmp, i + 1);
+    EXPECT_EQ(pkt_cache_lookup(pkt_cache, &tmp, msgbuf_pool, &lookup_result,
+                               &entry_id, true),
+              entries[i])
+        << "Invalid index: " << i;
+  }
+
+  pkt_cache_stats_t stats = pkt_cache_get_stats(pkt_cache);
+  EXPECT_EQ(stats.n_pit_replacements, 1u);
+  EXPECT_EQ(stats.n_pit_full_drops, 2u);
+
+  // Entries of past manifests can be replaced again
+  hicn_name_set_suffix(&tmp, 6);
+  msgbuf_t *msgbuf = msgbuf_create(msgbuf_pool, CONN_ID, &tmp);
+  pkt_cache_verdict_t verdict;
+  off_t data_msgbuf_id;
+  pkt_cache_entry_t *entry;
+  pkt_cache_on_interest(pkt_cache, msgbuf_pool,
+                        msgbuf_pool_get_id(msgbuf_pool, msgbuf), &verdict,
+                        &data_msgbuf_id, &entry, &tmp, true);
+  EXPECT_EQ(verdict, PKT_CACHE_VERDICT_FORWARD_INTEREST);
+}
+
+TEST_P(PacketCacheIndexTest, PitAccountingOnDataAndExpiry) {
+  pit_t *pit = pkt_cache_get_pit(pkt_cache);
+
+  // Satisfied interests no longer count towards the PIT limits
+  pkt_cache_entry_t *entry = pkt_cache_add_to_pit(pkt_cache, msgbuf, &name);
+  EXPECT_EQ(pit_get_num_entries(pit), 1u);
+  pkt_cache_pit_to_cs(pkt_cache, entry, msgbuf_pool, msgbuf, MSGBUF_ID,
+                      pkt_cache_get_entry_id(pkt_cache, entry));
+  EXPECT_EQ(pit_get_num_entries(pit), 0u);
+  EXPECT_EQ(pit_get_num_entries_for_connection(pit, CONN_ID), 0u);
+
+  // Neither do expired ones
+  hicn_name_t name_2 = get_name_from_prefix("b002::0");
+  msgbuf_t *msgbuf_2 = msgbuf_create(msgbuf_pool, CONN_ID_2, &name_2, 0);
+  pkt_cache_add_to_pit(pkt_cache, msgbuf_2, &name_2);
+  EXPECT_EQ(pit_get_num_entries_for_connection(pit, CONN_ID_2), 1u);
+  pkt_cache_expire(pkt_cache, msgbuf_pool, ticks_now(), N_OPS);
+  EXPECT_EQ(pit_get_num_entries(pit), 0u);
+  EXPECT_EQ(pit_get_num_entries_for_connection(pit, CONN_ID_2), 0u);
+}
+
+TEST_P(PacketCacheIndexTest, OnInterestManifest) {
+  hicn_name_t tmp = get_name_from_prefix("b001::0");
+
+  // Suffix 1 is pending from another connection, suffix 2 is in the CS
+  hicn_name_set_suffix(&tmp, 1);
+  msgbuf_t *pending = msgbuf_create(msgbuf_pool, CONN_ID_2, &tmp);
+  pkt_cache_entry_t *pit_entry = pkt_cache_add_to_pit(pkt_cache, pending, &tmp);
+  off_t pit_entry_id = pkt_cache_get_entry_id(pkt_cache, pit_entry);
+
+  hicn_name_set_suffix(&tmp, 2);
+  msgbuf_t *data = msgbuf_create(msgbuf_pool, CONN_ID_2, &tmp);
+  off_t data_id = msgbuf_pool_get_id(msgbuf_pool, data);
+  pkt_cache_add_to_cs(pkt_cache, msgbuf_pool, data, data_id);
+
+  // Manifest for suffixes 0 to 4, with suffix 3 repeated and one position unset
+  uint8_t buffer[sizeof(interest_manifest_header_t) +
+                 MAX_SUFFIXES_IN_MANIFEST * sizeof(hicn_name_suffix_t)];
+  interest_manifest_header_t *manifest = (interest_manifest_header_t *)buffer;
+  interest_manifest_init(manifest, 0);
+  for (hicn_name_suffix_t suffix : {1, 2, 3, 4, 3, 5})
+    interest_manifest_add_suffix(manifest, suffix);
+  interest_manifest_del_suffix(manifest, 6);
+
+  hicn_name_set_suffix(&tmp, 0);
+  msgbuf_t *interest = msgbuf_create(msgbuf_pool, CONN_ID, &tmp);
+  pkt_cache_save_suffixes_for_prefix(pkt_cache, hicn_name_get_prefix(&tmp));
+
+  pkt_cache_verdict_t verdicts[MAX_SUFFIXES_IN_MANIFEST];
+  off_t data_msgbuf_ids[MAX_SUFFIXES_IN_MANIFEST];
+  pkt_cache_entry_t *entries[MAX_SUFFIXES_IN_MANIFEST];
+  verdicts[6] = PKT_CACHE_VERDICT_ERROR;
+  pkt_cache_on_interest_manifest(pkt_cache, msgbuf_pool,
+                                 msgbuf_pool_get_id(msgbuf_pool, interest),
+                                 manifest, &tmp, verdicts, data_msgbuf_ids,
+                                 entries, true);
+
+  const pkt_cache_verdict_t expected[] = {
+      PKT_CACHE_VERDICT_FORWARD_INTEREST,
+      PKT_CACHE_VERDICT_AGGREGATE_INTEREST,
+      PKT_CACHE_VERDICT_FORWARD_DATA,
+      PKT_CACHE_VERDICT_FORWARD_INTEREST,
+      PKT_CACHE_VERDICT_FORWARD_INTEREST,
+      PKT_CACHE_VERDICT_RETRANSMIT_INTEREST,
+      PKT_CACHE_VERDICT_ERROR,  // Not set in the bitmap
+  };
+  for (unsigned i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+    EXPECT_EQ(verdicts[i], expected[i]) << "Invalid index: " << i;
+  EXPECT_EQ(data_msgbuf_ids[2], data_id);
+  EXPECT_EQ(entries[1], pkt_cache_entry_at(pkt_cache, pit_entry_id));
+  EXPECT_EQ(entries[3], entries[5]);
+  EXPECT_EQ(pkt_cache_get_pit_size(pkt_cache), 4u);
+
+  // Returned entries are the ones now in the packet cache
+  pkt_cache_lookup_t lookup_result;
+  off_t entry_id;
+  const hicn_name_suffix_t *suffixes =
+      (const hicn_name_suffix_t *)(manifest + 1);
+  for (unsigned i = 0; i < 6; i++) {
+    hicn_name_set_suffix(&tmp, suffixes[i]);
+    pkt_cache_entry_t *entry = pkt_cache_lookup(
+        pkt_cache, &tmp, msgbuf_pool, &lookup_result, &entry_id, true);
+    EXPECT_EQ(entry, entries[i]) << "Invalid index: " << i;
+  }
+}
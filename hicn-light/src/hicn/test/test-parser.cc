@@ -39,6 +39,15 @@ TEST_F(ParserTest, AddValidListener) {
   EXPECT_EQ(std::string(command_.object.listener.interface_name), "eth0");
 }
 
+TEST_F(ParserTest, AddValidXdpListener) {
+  std::string cmd = "add listener xdp xdp0 10.0.0.1 9695 eth0";
+
+  ASSERT_EQ(parse(cmd.c_str(), &command_), 0);
+  EXPECT_EQ(command_.object.listener.type, FACE_TYPE_XDP_LISTENER);
+  EXPECT_EQ(std::string(command_.object.listener.name), "xdp0");
+  EXPECT_EQ(std::string(command_.object.listener.interface_name), "eth0");
+}
+
 TEST_F(ParserTest, AddListenerSymbolicOverflow) {
   std::string cmd =
       "add listener udp super-long-symbolic-name 10.0.0.1 9696 eth0";
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+#define WITH_TESTS
+#include <hicn/core/timer_wheel.h>
+}
+
+#define N_ELEMENTS 1000
+#define START_TICK 1000
+
+static timer_wheel_node_t *get_node(void *context, unsigned id) {
+  return &((timer_wheel_node_t *)context)[id];
+}
+
+static void on_expiry(void *context, unsigned id, void *data) {
+  std::vector<unsigned> *expired = (std::vector<unsigned> *)data;
+  expired->push_back(id);
+}
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  TimerWheelTest() {
+    for (unsigned i = 0; i < N_ELEMENTS; i++) timer_wheel_node_init(&nodes[i]);
+    wheel = timer_wheel_create(get_node, nodes, START_TICK);
+  }
+  virtual ~TimerWheelTest() { timer_wheel_free(wheel); }
+
+  size_t advance(Ticks now, size_t budget = N_ELEMENTS) {
+    return timer_wheel_advance(wheel, now, budget, on_expiry, &expired);
+  }
+
+  timer_wheel_node_t nodes[N_ELEMENTS];
+  timer_wheel_t *wheel;
+  std::vector<unsigned> expired;
+};
+
+TEST_F(TimerWheelTest, CreateTimerWheel) {
+  ASSERT_NE(wheel, nullptr);
+  EXPECT_EQ(timer_wheel_len(wheel), 0u);
+  EXPECT_EQ(advance(START_TICK + 100), 0u);
+}
+
+TEST_F(TimerWheelTest, ExpireAtDeadline) {
+  timer_wheel_schedule(wheel, 0, START_TICK + 10);
+  EXPECT_EQ(timer_wheel_len(wheel), 1u);
+  EXPECT_TRUE(timer_wheel_node_is_scheduled(&nodes[0]));
+
+  EXPECT_EQ(advance(START_TICK + 9), 0u);
+  EXPECT_EQ(advance(START_TICK + 10), 1u);
+  ASSERT_EQ(expired.size(), 1u);
+  EXPECT_EQ(expired[0], 0u);
+  EXPECT_EQ(timer_wheel_len(wheel), 0u);
+  EXPECT_FALSE(timer_wheel_node_is_scheduled(&nodes[0]));
+}
+
+TEST_F(TimerWheelTest, ExpireInPast) {
+  // Elements scheduled in the past expire on the next advance
+  timer_wheel_schedule(wheel, 0, START_TICK - 100);
+  EXPECT_EQ(advance(START_TICK), 1u);
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  timer_wheel_schedule(wheel, 0, START_TICK + 10);
+  timer_wheel_schedule(wheel, 1, START_TICK + 10);
+  timer_wheel_schedule(wheel, 2, START_TICK + 10);
+
+  timer_wheel_cancel(wheel, 1);
+  timer_wheel_cancel(wheel, 1);  // No-op
+  EXPECT_EQ(timer_wheel_len(wheel), 2u);
+
+  EXPECT_EQ(advance(START_TICK + 10), 2u);
+  EXPECT_EQ(std::count(expired.begin(), expired.end(), 1u), 0);
+}
+
+TEST_F(TimerWheelTest, Reschedule) {
+  timer_wheel_schedule(wheel, 0, START_TICK + 10);
+  timer_wheel_schedule(wheel, 0, START_TICK + 5000);
+  EXPECT_EQ(timer_wheel_len(wheel), 1u);
+
+  EXPECT_EQ(advance(START_TICK + 4999), 0u);
+  EXPECT_EQ(advance(START_TICK + 5000), 1u);
+}
+
+TEST_F(TimerWheelTest, Budget) {
+  for (unsigned i = 0; i < 10; i++) timer_wheel_schedule(wheel, i, START_TICK);
+
+  EXPECT_EQ(advance(START_TICK, 4), 4u);
+  EXPECT_EQ(advance(START_TICK, 4), 4u);
+  EXPECT_EQ(advance(START_TICK, 4), 2u);
+  EXPECT_EQ(timer_wheel_len(wheel), 0u);
+}
+
+TEST_F(TimerWheelTest, CascadeAllLevels) {
+  // Expiry times spanning all levels, and beyond the range of the wheel
+  Ticks range = (Ticks)1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS);
+  Ticks expire_ts[N_ELEMENTS];
+  for (unsigned i = 0; i < N_ELEMENTS; i++) {
+    expire_ts[i] = START_TICK + ((Ticks)i * i * i * 37) % (2 * range);
+    timer_wheel_schedule(wheel, i, expire_ts[i]);
+  }
+
+  // Advance with irregular steps, checking that elements never expire early
+  // nor late with respect to the step
+  Ticks now = START_TICK - 1;
+  while (timer_wheel_len(wheel) > 0) {
+    Ticks prev = now;
+    now += 1 + (now * 7919) % 50000;
+    expired.clear();
+    advance(now);
+    for (unsigned id : expired) {
+      EXPECT_LE(expire_ts[id], now);
+      EXPECT_GT(expire_ts[id], prev);
+    }
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+#define WITH_TESTS
+#include <hicn/io/udp.h>
+}
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+class UdpTest : public ::testing::Test {
+ protected:
+  UdpTest() {
+    memset(&data_, 0, sizeof(data_));
+    data_.gso = true;
+  }
+
+  /* Queue packets of the specified sizes and build the messages */
+  unsigned prepare(const std::vector<size_t> &sizes) {
+    EXPECT_LE(sizes.size(), (size_t)MAX_MSG);
+    for (size_t i = 0; i < sizes.size(); i++) {
+      data_.iovecs[i].iov_base = packet_;
+      data_.iovecs[i].iov_len = sizes[i];
+    }
+    return connection_udp_prepare_msgs(&data_, (unsigned)sizes.size());
+  }
+
+  size_t getSegments(unsigned msg) {
+    return data_.msghdr[msg].msg_hdr.msg_iovlen;
+  }
+
+  /* Segment size carried by the message, or 0 if it is not segmented */
+  uint16_t getSegmentSize(unsigned msg) {
+    struct msghdr *hdr = &data_.msghdr[msg].msg_hdr;
+    if (hdr->msg_controllen == 0) return 0;
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr);
+    EXPECT_EQ(cmsg->cmsg_level, SOL_UDP);
+    EXPECT_EQ(cmsg->cmsg_type, UDP_SEGMENT);
+    uint16_t gso_size;
+    memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+    return gso_size;
+  }
+
+  connection_udp_data_t data_;
+  uint8_t packet_[1500];
+};
+
+TEST_F(UdpTest, SameSize) {
+  EXPECT_EQ(prepare(std::vector<size_t>(10, 1000)), 1u);
+  EXPECT_EQ(getSegments(0), 10u);
+  EXPECT_EQ(getSegmentSize(0), 1000u);
+  EXPECT_EQ(data_.msghdr[0].msg_hdr.msg_iov, &data_.iovecs[0]);
+}
+
+TEST_F(UdpTest, SmallerLast) {
+  // The smaller packet terminates the run
+  std::vector<size_t> sizes(10, 1000);
+  sizes.push_back(500);
+  sizes.push_back(1000);
+  sizes.push_back(1000);
+  EXPECT_EQ(prepare(sizes), 2u);
+  EXPECT_EQ(getSegments(0), 11u);
+  EXPECT_EQ(getSegmentSize(0), 1000u);
+  EXPECT_EQ(getSegments(1), 2u);
+  EXPECT_EQ(getSegmentSize(1), 1000u);
+  EXPECT_EQ(data_.msghdr[1].msg_hdr.msg_iov, &data_.iovecs[11]);
+}
+
+TEST_F(UdpTest, LargerPacket) {
+  // A larger packet cannot be a segment of the run, and is sent alone
+  EXPECT_EQ(prepare({1000, 1000, 1200, 800}), 2u);
+  EXPECT_EQ(getSegments(0), 2u);
+  EXPECT_EQ(getSegmentSize(0), 1000u);
+  EXPECT_EQ(getSegments(1), 2u);
+  EXPECT_EQ(getSegmentSize(1), 1200u);
+
+  EXPECT_EQ(prepare({500, 1000}), 2u);
+  EXPECT_EQ(getSegments(0), 1u);
+  EXPECT_EQ(getSegmentSize(0), 0u);
+  EXPECT_EQ(getSegments(1), 1u);
+  EXPECT_EQ(getSegmentSize(1), 0u);
+}
+
+TEST_F(UdpTest, SegmentCap) {
+  EXPECT_EQ(prepare(std::vector<size_t>(100, 100)), 2u);
+  EXPECT_EQ(getSegments(0), (size_t)UDP_GSO_MAX_SEGMENTS);
+  EXPECT_EQ(getSegments(1), 100u - UDP_GSO_MAX_SEGMENTS);
+}
+
+TEST_F(UdpTest, PayloadCap) {
+  // 46 packets of 1400 bytes fit in a datagram, a 47th would not
+  EXPECT_EQ(prepare(std::vector<size_t>(100, 1400)), 3u);
+  EXPECT_EQ(getSegments(0), 46u);
+  EXPECT_EQ(getSegments(1), 46u);
+  EXPECT_EQ(getSegments(2), 8u);
+  EXPECT_LE(getSegments(0) * 1400, (size_t)UDP_GSO_MAX_PAYLOAD);
+
+  // The smaller last packet is only added if it fits as well
+  std::vector<size_t> sizes(46, 1400);
+  sizes.push_back(100);
+  EXPECT_EQ(prepare(sizes), 1u);
+  sizes.back() = 1200;
+  EXPECT_EQ(prepare(sizes), 2u);
+  EXPECT_EQ(getSegments(1), 1u);
+  EXPECT_EQ(getSegmentSize(1), 0u);
+}
+
+TEST_F(UdpTest, Fallback) {
+  std::vector<size_t> sizes(10, 1000);
+  sizes.push_back(500);
+  EXPECT_EQ(prepare(sizes), 1u);
+
+  // Upon EIO/EINVAL, the flush disables segmentation and prepares the same
+  // packets again: one message each, without control message
+  data_.gso = false;
+  EXPECT_EQ(connection_udp_prepare_msgs(&data_, (unsigned)sizes.size()),
+            (unsigned)sizes.size());
+  for (unsigned i = 0; i < sizes.size(); i++) {
+    EXPECT_EQ(getSegments(i), 1u) << "Invalid index: " << i;
+    EXPECT_EQ(data_.msghdr[i].msg_hdr.msg_control, nullptr)
+        << "Invalid index: " << i;
+    EXPECT_EQ(data_.msghdr[i].msg_hdr.msg_controllen, 0u)
+        << "Invalid index: " << i;
+    EXPECT_EQ(data_.msghdr[i].msg_hdr.msg_iov, &data_.iovecs[i])
+        << "Invalid index: " << i;
+  }
+}
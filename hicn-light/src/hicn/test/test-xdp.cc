@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <string.h>
+
+extern "C" {
+#define WITH_TESTS
+#include <hicn/common.h>
+#include <hicn/core/address.h>
+#include <hicn/io/xdp.h>
+}
+
+/* Smallest Ethernet frame, without the frame check sequence */
+#define ETHER_MIN_FRAME_LEN 60
+
+class XdpTest : public ::testing::Test {
+ protected:
+  XdpTest() {
+    memset(frame_, 0, sizeof(frame_));
+    for (size_t i = 0; i < sizeof(payload_); i++) payload_[i] = (uint8_t)i;
+  }
+
+  /* Build the frame carrying size bytes of payload from local to remote */
+  size_t buildFrame(const address_t *local, const address_t *remote,
+                    size_t size) {
+    uint8_t header[XDP_HEADER_LEN_IPV6];
+    size_t header_len = xdp_header_build(header, mac_, local, remote);
+    memcpy(frame_, header, header_len);
+    memcpy(frame_ + header_len, payload_, size);
+    xdp_header_complete(frame_, size);
+    return header_len + size;
+  }
+
+  struct ether_header *eth() { return (struct ether_header *)frame_; }
+
+  void expectPayload(size_t len, const address_t *source, size_t size) {
+    size_t parsed_size;
+    address_t address;
+    const uint8_t *payload =
+        xdp_frame_parse(frame_, len, &parsed_size, &address);
+    ASSERT_NE(payload, nullptr);
+    EXPECT_EQ(parsed_size, size);
+    EXPECT_EQ(memcmp(payload, payload_, size), 0);
+    EXPECT_TRUE(address_equals(&address, source));
+  }
+
+  bool parse(size_t len) {
+    size_t size;
+    address_t address;
+    return xdp_frame_parse(frame_, len, &size, &address) != NULL;
+  }
+
+  const uint8_t mac_[ETH_ALEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+  uint8_t payload_[1400];
+  uint8_t frame_[2048];
+};
+
+TEST_F(XdpTest, BuildHeaderIPv4) {
+  address_t local = ADDRESS4(0x0a000001, 9695);
+  address_t remote = ADDRESS4(0x0a000002, 9696);
+  EXPECT_EQ(buildFrame(&local, &remote, 100), XDP_HEADER_LEN_IPV4 + 100);
+
+  EXPECT_EQ(ntohs(eth()->ether_type), ETHERTYPE_IP);
+  EXPECT_EQ(memcmp(eth()->ether_shost, mac_, ETH_ALEN), 0);
+
+  struct iphdr *ip = (struct iphdr *)(eth() + 1);
+  EXPECT_EQ(ip->version, 4u);
+  EXPECT_EQ(ip->ihl, 5u);
+  EXPECT_EQ(ip->protocol, IPPROTO_UDP);
+  EXPECT_EQ(ip->saddr, local.as_sin.sin_addr.s_addr);
+  EXPECT_EQ(ip->daddr, remote.as_sin.sin_addr.s_addr);
+  EXPECT_EQ(ntohs(ip->tot_len), sizeof(struct iphdr) + 8 + 100);
+  EXPECT_EQ(csum(ip, sizeof(struct iphdr), 0), 0u);
+
+  struct udphdr *udp = (struct udphdr *)(ip + 1);
+  EXPECT_EQ(ntohs(udp->source), 9695u);
+  EXPECT_EQ(ntohs(udp->dest), 9696u);
+  EXPECT_EQ(ntohs(udp->len), 8u + 100);
+
+  // Headers are completed again for each packet sent from the template
+  EXPECT_EQ(buildFrame(&local, &remote, 1400), XDP_HEADER_LEN_IPV4 + 1400);
+  EXPECT_EQ(ntohs(ip->tot_len), sizeof(struct iphdr) + 8 + 1400);
+  EXPECT_EQ(csum(ip, sizeof(struct iphdr), 0), 0u);
+  EXPECT_EQ(ntohs(udp->len), 8u + 1400);
+}
+
+TEST_F(XdpTest, BuildHeaderIPv6) {
+  struct in6_addr local_addr, remote_addr;
+  inet_pton(AF_INET6, "2001:db8::1", &local_addr);
+  inet_pton(AF_INET6, "2001:db8::2", &remote_addr);
+  address_t local = ADDRESS6(local_addr, 9695);
+  address_t remote = ADDRESS6(remote_addr, 9696);
+  EXPECT_EQ(buildFrame(&local, &remote, 101), XDP_HEADER_LEN_IPV6 + 101);
+
+  EXPECT_EQ(ntohs(eth()->ether_type), ETHERTYPE_IPV6);
+
+  struct ip6_hdr *ip6 = (struct ip6_hdr *)(eth() + 1);
+  EXPECT_EQ(ntohl(ip6->ip6_flow) >> 28, 6u);
+  EXPECT_EQ(ip6->ip6_nxt, IPPROTO_UDP);
+  EXPECT_EQ(memcmp(&ip6->ip6_src, &local_addr, sizeof(local_addr)), 0);
+  EXPECT_EQ(memcmp(&ip6->ip6_dst, &remote_addr, sizeof(remote_addr)), 0);
+  EXPECT_EQ(ntohs(ip6->ip6_plen), 8u + 101);
+
+  struct udphdr *udp = (struct udphdr *)(ip6 + 1);
+  EXPECT_EQ(ntohs(udp->source), 9695u);
+  EXPECT_EQ(ntohs(udp->dest), 9696u);
+  EXPECT_EQ(ntohs(udp->len), 8u + 101);
+
+  // The UDP checksum, mandatory over IPv6, covers the pseudo-header
+  uint8_t pseudo_header[40] = {0};
+  uint32_t len = htonl(8 + 101);
+  memcpy(pseudo_header, &local_addr, sizeof(local_addr));
+  memcpy(pseudo_header + 16, &remote_addr, sizeof(remote_addr));
+  memcpy(pseudo_header + 32, &len, sizeof(len));
+  pseudo_header[39] = IPPROTO_UDP;
+  EXPECT_NE(udp->check, 0u);
+  uint16_t sum = (uint16_t)~csum(pseudo_header, sizeof(pseudo_header), 0);
+  EXPECT_EQ(csum(udp, 8 + 101, sum), 0u);
+}
+
+TEST_F(XdpTest, ParseIPv4) {
+  address_t local = ADDRESS4(0x0a000001, 9695);
+  address_t remote = ADDRESS4(0x0a000002, 9696);
+  size_t len = buildFrame(&local, &remote, 1000);
+  expectPayload(len, &local, 1000);
+}
+
+TEST_F(XdpTest, ParseIPv6) {
+  struct in6_addr local_addr, remote_addr;
+  inet_pton(AF_INET6, "2001:db8::1", &local_addr);
+  inet_pton(AF_INET6, "2001:db8::2", &remote_addr);
+  address_t local = ADDRESS6(local_addr, 9695);
+  address_t remote = ADDRESS6(remote_addr, 9696);
+  size_t len = buildFrame(&local, &remote, 1000);
+  expectPayload(len, &local, 1000);
+}
+
+TEST_F(XdpTest, EthernetPadding) {
+  // Frames shorter than the Ethernet minimum are padded, the payload length
+  // comes from the UDP header
+  address_t local = ADDRESS4(0x0a000001, 9695);
+  address_t remote = ADDRESS4(0x0a000002, 9696);
+  size_t len = buildFrame(&local, &remote, 4);
+  ASSERT_LT(len, (size_t)ETHER_MIN_FRAME_LEN);
+  memset(frame_ + len, 0xff, ETHER_MIN_FRAME_LEN - len);
+  expectPayload(ETHER_MIN_FRAME_LEN, &local, 4);
+
+  // Empty payload
+  len = buildFrame(&local, &remote, 0);
+  expectPayload(ETHER_MIN_FRAME_LEN, &local, 0);
+}
+
+TEST_F(XdpTest, BadUdpLength) {
+  address_t local = ADDRESS4(0x0a000001, 9695);
+  address_t remote = ADDRESS4(0x0a000002, 9696);
+  size_t len = buildFrame(&local, &remote, 100);
+  struct udphdr *udp =
+      (struct udphdr *)((struct iphdr *)(eth() + 1) + 1);
+
+  // Longer than the frame
+  udp->len = htons(8 + 101);
+  EXPECT_FALSE(parse(len));
+
+  // Shorter than the UDP header
+  udp->len = htons(7);
+  EXPECT_FALSE(parse(len));
+
+  // Shorter than the frame is fine (padding)
+  udp->len = htons(8 + 50);
+  EXPECT_TRUE(parse(len));
+}
+
+TEST_F(XdpTest, Truncated) {
+  address_t local = ADDRESS4(0x0a000001, 9695);
+  address_t remote = ADDRESS4(0x0a000002, 9696);
+  buildFrame(&local, &remote, 0);
+
+  EXPECT_TRUE(parse(XDP_HEADER_LEN_IPV4));
+  EXPECT_FALSE(parse(XDP_HEADER_LEN_IPV4 - 1));
+  EXPECT_FALSE(parse(sizeof(struct ether_header) - 1));
+
+  // Neither IPv4 nor IPv6
+  eth()->ether_type = htons(ETHERTYPE_ARP);
+  EXPECT_FALSE(parse(XDP_HEADER_LEN_IPV4));
+}
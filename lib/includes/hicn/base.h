@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "common.h"
+#include <hicn/util/histogram.h>
 #ifdef _WIN32
 #include <Winsock2.h>
 #else
@@ -315,6 +316,10 @@ typedef struct
   uint32_t countDroppedNoReversePath;
   uint32_t countDataExpired;
 
+  // FIB lookups served by the FIB cache
+  uint32_t countFibCacheHits;
+  uint32_t countFibCacheMisses;
+
   // TODO(eloparco): Currently not used
   // uint32_t countDroppedNoHopLimit;
   // uint32_t countDroppedZeroHopLimitFromRemote;
@@ -326,6 +331,22 @@ typedef struct
   uint32_t n_pit_entries;
   uint32_t n_cs_entries;
   uint32_t n_lru_evictions;
+  // CS lookups, whatever the replacement policy
+  uint32_t n_cs_hits;
+  uint32_t n_cs_misses;
+  // Second tier of the CS (if enabled)
+  uint32_t n_cs_disk_entries;
+  uint32_t n_cs_disk_demotions;
+  uint32_t n_cs_disk_promotions;
+  // Entries reclaimed by the expiry timer, as opposed to the lazy expiries
+  // counted by countInterestsExpired and countDataExpired
+  uint32_t n_pit_reclaimed;
+  uint32_t n_cs_reclaimed;
+  // Interests refused by PIT admission control, and PIT entries replaced to
+  // admit new ones
+  uint32_t n_pit_full_drops;
+  uint32_t n_pit_quota_drops;
+  uint32_t n_pit_replacements;
 } pkt_cache_stats_t;
 
 typedef struct
@@ -334,6 +355,64 @@ typedef struct
   pkt_cache_stats_t pkt_cache;
 } hicn_light_stats_t;
 
+/*
+ * Verdicts of the hicn-light packet cache lookups. They are defined here so
+ * that control tools can name the per-verdict profiling counters.
+ */
+#define foreach_kh_verdict                                                    \
+  _ (FORWARD_INTEREST)                                                        \
+  _ (AGGREGATE_INTEREST)                                                      \
+  _ (RETRANSMIT_INTEREST)                                                     \
+  _ (FORWARD_DATA)                                                            \
+  _ (INTEREST_EXPIRED_FORWARD_INTEREST)                                       \
+  _ (DATA_EXPIRED_FORWARD_INTEREST)                                           \
+  _ (STORE_DATA)                                                              \
+  _ (CLEAR_DATA)                                                              \
+  _ (UPDATE_DATA)                                                             \
+  _ (IGNORE_DATA)                                                             \
+  _ (DROP_INTEREST)                                                           \
+  _ (ERROR)
+
+typedef enum
+{
+#define _(x) PKT_CACHE_VERDICT_##x,
+  foreach_kh_verdict
+#undef _
+    PKT_CACHE_N_VERDICTS
+} pkt_cache_verdict_t;
+
+/*
+ * Stages of the hicn-light receive path whose duration is profiled when the
+ * forwarder is built with WITH_PROFILING.
+ */
+#define foreach_profile_stage                                                 \
+  _ (PARSE, parse)                                                            \
+  _ (FIB, fib)                                                                \
+  _ (PKT_CACHE, pkt_cache)                                                    \
+  _ (STRATEGY, strategy)                                                      \
+  _ (SEND, send)                                                              \
+  _ (FLUSH, flush)
+
+typedef enum
+{
+#define _(x, y) PROFILE_STAGE_##x,
+  foreach_profile_stage
+#undef _
+    PROFILE_STAGE_N
+} profile_stage_t;
+
+typedef struct
+{
+  /* False if the forwarder was built without profiling support */
+  uint32_t enabled;
+  /* Frequency of the counter used to measure the stages */
+  uint32_t cycles_per_usec;
+  /* Duration of each stage, in cycles */
+  histogram_t stages[PROFILE_STAGE_N];
+  /* Outcome of the packet cache lookups */
+  uint32_t verdicts[PKT_CACHE_N_VERDICTS];
+} hicn_light_profile_t;
+
 typedef struct
 {
   uint32_t conn_id;
@@ -351,6 +430,8 @@ typedef struct
     uint32_t tx_pkts;
     uint32_t tx_bytes;
   } data;
+  uint32_t tx_batches;     /* Transmission system calls */
+  uint32_t tx_gso_batches; /* Datagrams handed to segmentation offload */
 } connection_stats_t;
 
 #endif /* HICN_BASE_H */
@@ -37,6 +37,7 @@
 #include <assert.h>
 
 #include <hicn/util/types.h>
+#include <hicn/util/checksum.h>
 
 #define HICN_EXPECT_FALSE(x) __builtin_expect ((x), 1)
 #define HICN_EXPECT_TRUE(x)  __builtin_expect ((x), 0)
@@ -188,26 +189,13 @@ void hicn_packet_dump (const uint8_t *buffer, size_t len);
  * @param [in] size - Size of buffer
  * @param [in] init - Checksum initial value
  * @return Checksum of specified buffer
+ *
+ * See hicn/util/checksum.h to checksum a buffer made of several chunks.
  */
 static inline u16
 csum (const void *addr, size_t size, u16 init)
 {
-  u32 sum = init;
-  const u16 *bytes = (u16 *) addr;
-
-  while (size > 1)
-    {
-      sum += *bytes++;
-      size -= sizeof (u16);
-    }
-  if (size)
-    {
-      sum += *(const u8 *) bytes;
-    }
-  sum = (sum >> 16) + (sum & 0xffff);
-  sum += (sum >> 16);
-
-  return (u16) ~sum;
+  return (u16) ~hicn_csum_fold (hicn_csum_partial (addr, size, init));
 }
 
 /*
@@ -141,6 +141,10 @@ extern const char *_face_state_str[];
   _ (TCP_LISTENER)                                                            \
   _ (UDP)                                                                     \
   _ (UDP_LISTENER)                                                            \
+  _ (SHM)                                                                     \
+  _ (SHM_LISTENER)                                                            \
+  _ (XDP)                                                                     \
+  _ (XDP_LISTENER)                                                            \
   _ (N)
 
 #define MAXSZ_FACE_TYPE_ 13
@@ -158,6 +162,8 @@ typedef enum
   FACE_PROTOCOL_HICN,
   FACE_PROTOCOL_UDP,
   FACE_PROTOCOL_TCP,
+  FACE_PROTOCOL_SHM,
+  FACE_PROTOCOL_XDP,
   FACE_PROTOCOL_UNKNOWN,
 } face_protocol_t;
 
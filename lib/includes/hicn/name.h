@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h> // memcpy
 #ifndef _WIN32
 #include <netinet/in.h> // struct sockadd
 #endif
@@ -93,7 +94,7 @@ typedef uint32_t hicn_name_suffix_t;
 #define hicn_name_prefix_cmp	      hicn_ip_address_cmp
 #define hicn_name_prefix_equals	      hicn_ip_address_equals
 #define hicn_name_prefix_get_len_bits hicn_ip_address_get_len_bits
-#define hicn_name_prefix_get_hash     hicn_ip_address_get_hash
+#define hicn_name_prefix_get_hash     hicn_name_prefix_hash
 #define hicn_name_prefix_snprintf     hicn_ip_address_snprintf
 #define HICN_NAME_PREFIX_EMPTY	      IP_ADDRESS_EMPTY
 
@@ -106,6 +107,7 @@ typedef struct
 static_assert (offsetof (hicn_name_t, prefix) == 0, "");
 static_assert (offsetof (hicn_name_t, suffix) == 16, "");
 static_assert (sizeof (hicn_name_t) == 20, "");
+static_assert (sizeof (hicn_name_prefix_t) == 16, "");
 
 #define HICN_NAME_EMPTY                                                       \
   (hicn_name_t) { .prefix = HICN_NAME_PREFIX_EMPTY, .suffix = 0, }
@@ -170,17 +172,83 @@ int hicn_name_create_from_ip_prefix (const hicn_ip_prefix_t *prefix, u32 id,
 int hicn_name_compare (const hicn_name_t *name_1, const hicn_name_t *name_2,
 		       bool consider_segment);
 
+/*
+ * Name hashing
+ *
+ * Names have a fixed layout (16 byte prefix, 4 byte suffix), which is hashed
+ * as three words rather than byte by byte. The two halves of the prefix are
+ * multiplied by distinct odd constants (a bijection on each half), combined,
+ * and go through the 64 bit finalizer of MurmurHash3, in which every input
+ * bit affects every output bit. The suffix is mixed with the prefix hash by
+ * a second finalizer, so that the prefix hash can be computed once for all
+ * the suffixes of a manifest.
+ *
+ * Hashes only have a meaning within a process, they depend on endianness.
+ */
+
+static inline u64
+_hicn_name_hash_fmix64 (u64 h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * @brief Provides a 32-bit hash of an hICN name prefix
+ * @param [in] prefix - Prefix to hash
+ * @return Hash of the prefix
+ */
+static inline u32
+hicn_name_prefix_hash (const hicn_name_prefix_t *prefix)
+{
+  u64 w[2];
+  u64 h;
+
+  memcpy (w, prefix, sizeof (w));
+
+  h = w[1] * 0xc2b2ae3d27d4eb4fULL;
+  h = w[0] * 0x9e3779b97f4a7c15ULL + ((h >> 32) | (h << 32));
+  return (u32) _hicn_name_hash_fmix64 (h);
+}
+
+/**
+ * @brief Mixes a suffix into a prefix hash
+ * @param [in] prefix_hash - Hash of the name prefix
+ * @param [in] suffix - Name suffix
+ * @return Hash of the name, as returned by hicn_name_hash()
+ */
+static inline u32
+hicn_name_suffix_mix (u32 prefix_hash, hicn_name_suffix_t suffix)
+{
+  return (u32) _hicn_name_hash_fmix64 (((u64) prefix_hash << 32) | suffix);
+}
+
+/**
+ * @brief Provides a 32-bit hash of an hICN name
+ * @param [in] name - Name to hash
+ * @return Hash of the name
+ */
+static inline u32
+hicn_name_hash (const hicn_name_t *name)
+{
+  return hicn_name_suffix_mix (hicn_name_prefix_hash (&name->prefix),
+			       name->suffix);
+}
+
 /**
  * @brief Provides a 32-bit hash of an hICN name
  * @param [in] name - Name to hash
- * @param [out] hash - Resulting hash
  * @param [in] consider_suffix - Consider the suffix in the hash computation
- * @return hICN error code
+ * @return Hash of the name, or of its prefix only
  */
 uint32_t _hicn_name_get_hash (const hicn_name_t *name, bool consider_suffix);
 
-#define hicn_name_get_hash(NAME)	_hicn_name_get_hash (NAME, true)
-#define hicn_name_get_prefix_hash(NAME) _hicn_name_get_hash (NAME, false)
+#define hicn_name_get_hash(NAME)	hicn_name_hash (NAME)
+#define hicn_name_get_prefix_hash(NAME) hicn_name_prefix_hash (&(NAME)->prefix)
 
 /**
  * @brief Test whether an hICN name is empty
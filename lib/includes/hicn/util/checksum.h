@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file checksum.h
+ * \brief Internet checksum (RFC 1071) over buffers and buffer chains.
+ *
+ * The one's complement sum of 16 bit words is congruent, modulo 0xffff, to
+ * the sum of the same bytes taken as 32 or 64 bit words. Buffers are thus
+ * summed 32 bits at a time into 64 bit accumulators, by SSE2, AVX2 or NEON
+ * kernels when available, and the result is only folded to 16 bits once.
+ *
+ * Partial sums are kept unfolded across the chunks of a scatter-gather
+ * buffer. A chunk starting at an odd offset has its bytes swapped with
+ * respect to the 16 bit words of the whole buffer: rotating its 64 bit sum by
+ * 8 bits, ie. multiplying it by 256 modulo 2^64 - 1 (a multiple of 0xffff),
+ * accounts for it without folding.
+ */
+
+#ifndef UTIL_CHECKSUM_H
+#define UTIL_CHECKSUM_H
+
+#include <stddef.h>
+
+#include <hicn/util/types.h>
+
+typedef enum
+{
+  HICN_CSUM_SCALAR,
+  HICN_CSUM_SSE2,
+  HICN_CSUM_AVX2,
+  HICN_CSUM_NEON,
+  HICN_CSUM_N,
+} hicn_csum_impl_t;
+
+/**
+ * @brief Adds the 16 bit words of a buffer to an unfolded partial sum
+ * @param [in] addr - Pointer to buffer start
+ * @param [in] size - Size of buffer, an odd last byte is padded with zero
+ * @param [in] sum - Partial sum to start from
+ * @return Unfolded partial sum
+ */
+u64 hicn_csum_partial (const void *addr, size_t size, u64 sum);
+
+/**
+ * @brief Tells whether an implementation is built in and supported by the CPU
+ */
+int hicn_csum_impl_supported (hicn_csum_impl_t impl);
+
+/**
+ * @brief Selects the implementation used by hicn_csum_partial().
+ *
+ * The fastest supported one is selected by default, the others are available
+ * for tests and benchmarks.
+ *
+ * @return 0 in case of success, -1 if the implementation is not supported
+ */
+int hicn_csum_set_impl (hicn_csum_impl_t impl);
+
+hicn_csum_impl_t hicn_csum_get_impl (void);
+
+const char *hicn_csum_impl_name (hicn_csum_impl_t impl);
+
+static inline u64
+hicn_csum_add (u64 a, u64 b)
+{
+  u64 t = a + b;
+  return t + (t < b);
+}
+
+/**
+ * @brief Reduces an unfolded partial sum to 16 bits
+ */
+static inline u16
+hicn_csum_fold (u64 sum)
+{
+  u32 s = (u32) (sum & 0xffffffff);
+  u32 h = (u32) (sum >> 32);
+
+  s += h;
+  s += (s < h);
+  s = (s & 0xffff) + (s >> 16);
+  s = (s & 0xffff) + (s >> 16);
+
+  return (u16) s;
+}
+
+/*
+ * Streaming API, for buffers made of several chunks of arbitrary lengths.
+ */
+
+typedef struct
+{
+  u64 sum;
+  size_t len; /* Bytes summed so far */
+} hicn_csum_state_t;
+
+static inline void
+hicn_csum_init (hicn_csum_state_t *state, u16 init)
+{
+  state->sum = init;
+  state->len = 0;
+}
+
+static inline void
+hicn_csum_update (hicn_csum_state_t *state, const void *addr, size_t size)
+{
+  if (!(state->len & 1))
+    {
+      state->sum = hicn_csum_partial (addr, size, state->sum);
+    }
+  else
+    {
+      u64 sum = hicn_csum_partial (addr, size, 0);
+      state->sum = hicn_csum_add (state->sum, (sum << 8) | (sum >> 56));
+    }
+  state->len += size;
+}
+
+/**
+ * @brief Returns the checksum of the chunks, as computed by csum()
+ */
+static inline u16
+hicn_csum_final (const hicn_csum_state_t *state)
+{
+  return (u16) ~hicn_csum_fold (state->sum);
+}
+
+#endif /* UTIL_CHECKSUM_H */
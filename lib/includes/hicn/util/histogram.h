@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file histogram.h
+ * \brief Fixed-size log-linear histogram
+ *
+ * Values are counted in buckets whose width doubles at each power of two, each
+ * power of two being split in HISTOGRAM_SUB_BUCKETS linear sub-buckets (in the
+ * spirit of HDR histograms). The relative error on any reported value is thus
+ * bounded by 1 / HISTOGRAM_SUB_BUCKETS, whatever its magnitude, for a constant
+ * memory footprint and a constant cost per sample.
+ *
+ * The structure has a fixed size and no pointers so that it can be exchanged
+ * as is between processes.
+ */
+
+#ifndef UTIL_HISTOGRAM_H
+#define UTIL_HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define HISTOGRAM_SUB_BITS    2
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+/* Covers values up to 2^25 (eg. ~10ms worth of cycles at 3GHz) */
+#define HISTOGRAM_N_BUCKETS 96
+
+typedef struct
+{
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+  uint32_t buckets[HISTOGRAM_N_BUCKETS];
+} histogram_t;
+
+/**
+ * @brief Returns the index of the bucket holding a given value.
+ *
+ * Values beyond the range of the histogram are accounted in the last bucket.
+ */
+static inline unsigned
+histogram_bucket (uint64_t value)
+{
+  if (value < HISTOGRAM_SUB_BUCKETS)
+    return (unsigned) value;
+
+  unsigned msb = 63 - __builtin_clzll (value);
+  unsigned shift = msb - HISTOGRAM_SUB_BITS;
+  unsigned bucket = (shift + 1) * HISTOGRAM_SUB_BUCKETS +
+		    ((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+  return bucket < HISTOGRAM_N_BUCKETS ? bucket : HISTOGRAM_N_BUCKETS - 1;
+}
+
+/**
+ * @brief Returns the lowest value accounted in a given bucket.
+ */
+static inline uint64_t
+histogram_bucket_lower (unsigned bucket)
+{
+  if (bucket < HISTOGRAM_SUB_BUCKETS)
+    return bucket;
+
+  unsigned shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+  uint64_t sub = bucket & (HISTOGRAM_SUB_BUCKETS - 1);
+  return (HISTOGRAM_SUB_BUCKETS + sub) << shift;
+}
+
+static inline void
+histogram_reset (histogram_t *histogram)
+{
+  memset (histogram, 0, sizeof (histogram_t));
+}
+
+static inline void
+histogram_add (histogram_t *histogram, uint64_t value)
+{
+  if (histogram->count == 0 || value < histogram->min)
+    histogram->min = value;
+  if (value > histogram->max)
+    histogram->max = value;
+  histogram->count++;
+  histogram->sum += value;
+  histogram->buckets[histogram_bucket (value)]++;
+}
+
+static inline uint64_t
+histogram_mean (const histogram_t *histogram)
+{
+  return histogram->count ? histogram->sum / histogram->count : 0;
+}
+
+/**
+ * @brief Returns an estimate of the given percentile of the recorded values.
+ *
+ * @param[in] histogram Histogram to query
+ * @param[in] percentile Percentile in [0, 100]
+ *
+ * @return The lower bound of the bucket holding the percentile, clamped to
+ * the recorded minimum and maximum values, or 0 if the histogram is empty.
+ */
+static inline uint64_t
+histogram_percentile (const histogram_t *histogram, double percentile)
+{
+  if (histogram->count == 0)
+    return 0;
+  if (percentile >= 100)
+    return histogram->max;
+
+  uint64_t rank = (uint64_t) (percentile / 100.0 * histogram->count);
+  if (rank >= histogram->count)
+    rank = histogram->count - 1;
+
+  uint64_t seen = 0;
+  for (unsigned i = 0; i < HISTOGRAM_N_BUCKETS; i++)
+    {
+      seen += histogram->buckets[i];
+      if (seen > rank)
+	{
+	  uint64_t value = histogram_bucket_lower (i);
+	  if (value < histogram->min)
+	    return histogram->min;
+	  if (value > histogram->max)
+	    return histogram->max;
+	  return value;
+	}
+    }
+  return histogram->max;
+}
+
+#endif /* UTIL_HISTOGRAM_H */
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * \file shm_ring.h
+ * \brief Packet rings shared between an application and hicn-light.
+ *
+ * A shared memory face is a memory region (typically a memfd created by the
+ * application, and passed to the forwarder over a UNIX socket) made of a
+ * header, two descriptor rings, one per direction, and the packet buffers.
+ *
+ * Each ring has a single producer and a single consumer: the producer copies
+ * a packet in a buffer, fills the descriptor at its head and advances the
+ * head, while the consumer reads the descriptors up to the head and advances
+ * its tail once done with the buffers. Each index is written by one side
+ * only, so that no lock nor atomic read-modify-write operation is needed.
+ *
+ * The consumer sleeps on a file descriptor when its ring is empty. To avoid a
+ * system call per packet, the producer only notifies it when publishing new
+ * descriptors on a ring it might have seen empty, ie. when the tail equals
+ * the previously published head. Full barriers on both sides make sure that
+ * either the producer sees the consumer caught up, or the consumer sees the
+ * new head before sleeping.
+ *
+ * Indices and descriptors written by the peer are not trusted: they are
+ * checked against the ring and region sizes before use.
+ */
+
+#ifndef UTIL_SHM_RING_H
+#define UTIL_SHM_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HICN_SHM_MAGIC	 0x6869636e /* "hicn" */
+#define HICN_SHM_VERSION 1
+
+/* Number of descriptors in each ring (must be a power of two) */
+#define HICN_SHM_RING_SIZE 1024
+#define HICN_SHM_RING_MASK (HICN_SHM_RING_SIZE - 1)
+
+/* Size of a packet buffer */
+#define HICN_SHM_BUFFER_SIZE 2048
+
+/* Name of the UNIX socket of the forwarder, in the abstract namespace */
+#define HICN_SHM_SOCKET_NAME "hicn-light-shm-%u"
+
+#define HICN_SHM_CACHELINE 64
+
+typedef enum
+{
+  HICN_SHM_RING_TO_FWD,	  /* Packets sent by the application */
+  HICN_SHM_RING_FROM_FWD, /* Packets sent by the forwarder */
+  HICN_SHM_RING_N,
+} hicn_shm_ring_id_t;
+
+typedef struct
+{
+  uint32_t offset; /* Offset of the packet from the start of the region */
+  uint32_t length;
+} hicn_shm_desc_t;
+
+typedef struct
+{
+  /* Head and tail are written by different processes, keep them apart */
+  uint32_t head __attribute__ ((aligned (HICN_SHM_CACHELINE)));
+  uint32_t tail __attribute__ ((aligned (HICN_SHM_CACHELINE)));
+  hicn_shm_desc_t desc[HICN_SHM_RING_SIZE]
+    __attribute__ ((aligned (HICN_SHM_CACHELINE)));
+} hicn_shm_ring_t;
+
+typedef struct
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t ring_size;
+  uint32_t buffer_size;
+  hicn_shm_ring_t rings[HICN_SHM_RING_N];
+} hicn_shm_region_t;
+
+/* Buffers follow the header, each ring using its own set */
+#define HICN_SHM_BUFFERS_OFFSET                                               \
+  ((sizeof (hicn_shm_region_t) + HICN_SHM_CACHELINE - 1) &                    \
+   ~(size_t) (HICN_SHM_CACHELINE - 1))
+
+#define HICN_SHM_REGION_SIZE                                                  \
+  (HICN_SHM_BUFFERS_OFFSET +                                                  \
+   (size_t) HICN_SHM_RING_N * HICN_SHM_RING_SIZE * HICN_SHM_BUFFER_SIZE)
+
+/**
+ * @brief Initialize a region, which must be HICN_SHM_REGION_SIZE bytes long.
+ *
+ * This is done by the application before passing the region to the forwarder.
+ */
+static inline void
+hicn_shm_region_init (hicn_shm_region_t *region)
+{
+  memset (region, 0, sizeof (hicn_shm_region_t));
+  region->magic = HICN_SHM_MAGIC;
+  region->version = HICN_SHM_VERSION;
+  region->ring_size = HICN_SHM_RING_SIZE;
+  region->buffer_size = HICN_SHM_BUFFER_SIZE;
+}
+
+/**
+ * @brief Check that a region received from the peer matches our layout.
+ */
+static inline bool
+hicn_shm_region_is_valid (const hicn_shm_region_t *region, size_t size)
+{
+  return size >= HICN_SHM_REGION_SIZE && region->magic == HICN_SHM_MAGIC &&
+	 region->version == HICN_SHM_VERSION &&
+	 region->ring_size == HICN_SHM_RING_SIZE &&
+	 region->buffer_size == HICN_SHM_BUFFER_SIZE;
+}
+
+static inline uint32_t
+_hicn_shm_buffer_offset (hicn_shm_ring_id_t ring_id, uint32_t slot)
+{
+  return (uint32_t) (HICN_SHM_BUFFERS_OFFSET +
+		     ((size_t) ring_id * HICN_SHM_RING_SIZE + slot) *
+		       HICN_SHM_BUFFER_SIZE);
+}
+
+/* Producer */
+
+/**
+ * @brief Copy a packet in the next free slot of a ring, without making it
+ * visible to the consumer yet.
+ *
+ * @param[in,out] head Private head of the producer, advanced on success. It
+ * must be initialized to the published head of the ring.
+ *
+ * @return 0 in case of success, -1 if the ring is full or the packet too large
+ */
+static inline int
+hicn_shm_ring_push (hicn_shm_region_t *region, hicn_shm_ring_id_t ring_id,
+		    uint32_t *head, const uint8_t *packet, size_t len)
+{
+  hicn_shm_ring_t *ring = &region->rings[ring_id];
+
+  if (len > HICN_SHM_BUFFER_SIZE)
+    return -1;
+
+  /* A corrupted tail makes the ring look full */
+  uint32_t tail = __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE);
+  if ((uint32_t) (*head - tail) >= HICN_SHM_RING_SIZE)
+    return -1;
+
+  uint32_t slot = *head & HICN_SHM_RING_MASK;
+  uint32_t offset = _hicn_shm_buffer_offset (ring_id, slot);
+  memcpy ((uint8_t *) region + offset, packet, len);
+  ring->desc[slot] = (hicn_shm_desc_t){ .offset = offset,
+					.length = (uint32_t) len };
+  (*head)++;
+  return 0;
+}
+
+/**
+ * @brief Make the packets pushed so far visible to the consumer.
+ *
+ * @return Whether the consumer has to be notified.
+ */
+static inline bool
+hicn_shm_ring_publish (hicn_shm_region_t *region, hicn_shm_ring_id_t ring_id,
+		       uint32_t head)
+{
+  hicn_shm_ring_t *ring = &region->rings[ring_id];
+
+  uint32_t prev_head = ring->head; /* Only written by us */
+  if (head == prev_head)
+    return false;
+
+  __atomic_store_n (&ring->head, head, __ATOMIC_RELEASE);
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+  return __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE) == prev_head;
+}
+
+/* Consumer */
+
+/**
+ * @brief Return the number of packets available to the consumer.
+ */
+static inline uint32_t
+hicn_shm_ring_available (const hicn_shm_region_t *region,
+			 hicn_shm_ring_id_t ring_id)
+{
+  const hicn_shm_ring_t *ring = &region->rings[ring_id];
+
+  uint32_t head = __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE);
+  uint32_t n = head - ring->tail; /* Tail is only written by us */
+
+  /* A corrupted head makes the ring look empty */
+  return n <= HICN_SHM_RING_SIZE ? n : 0;
+}
+
+/**
+ * @brief Return the i-th available packet of a ring, which remains valid
+ * until released.
+ *
+ * @return The packet, or NULL if its descriptor is invalid.
+ */
+static inline const uint8_t *
+hicn_shm_ring_peek (const hicn_shm_region_t *region,
+		    hicn_shm_ring_id_t ring_id, uint32_t i, size_t *len)
+{
+  const hicn_shm_ring_t *ring = &region->rings[ring_id];
+
+  hicn_shm_desc_t desc = ring->desc[(ring->tail + i) & HICN_SHM_RING_MASK];
+  if (desc.offset < HICN_SHM_BUFFERS_OFFSET ||
+      desc.length > HICN_SHM_BUFFER_SIZE ||
+      desc.offset > HICN_SHM_REGION_SIZE - desc.length)
+    return NULL;
+
+  *len = desc.length;
+  return (const uint8_t *) region + desc.offset;
+}
+
+/**
+ * @brief Release the first n available packets of a ring to the producer.
+ *
+ * The ring should be checked for available packets again before sleeping.
+ */
+static inline void
+hicn_shm_ring_release (hicn_shm_region_t *region, hicn_shm_ring_id_t ring_id,
+		       uint32_t n)
+{
+  hicn_shm_ring_t *ring = &region->rings[ring_id];
+
+  __atomic_store_n (&ring->tail, ring->tail + n, __ATOMIC_RELEASE);
+  __atomic_thread_fence (__ATOMIC_SEQ_CST);
+}
+
+#endif /* UTIL_SHM_RING_H */
@@ -93,12 +93,9 @@ hicn_name_compare (const hicn_name_t *name_1, const hicn_name_t *name_2,
 uint32_t
 _hicn_name_get_hash (const hicn_name_t *name, bool consider_suffix)
 {
-  uint32_t hash = hash32 (&name->prefix, sizeof (name->prefix));
-
   if (consider_suffix)
-    hash = cumulative_hash32 (&name->suffix, sizeof (name->suffix), hash);
-
-  return hash;
+    return hicn_name_hash (name);
+  return hicn_name_prefix_hash (&name->prefix);
 }
 
 int
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+extern "C"
+{
+#include <hicn/common.h>
+#include <hicn/util/checksum.h>
+}
+
+/* Reference implementation, summing 16 bit words in network order */
+static u16
+csum_reference (const u8 *p, size_t size, u16 init)
+{
+  u32 sum = ntohs (init);
+
+  for (; size > 1; p += 2, size -= 2)
+    {
+      sum += (p[0] << 8) | p[1];
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  if (size)
+    {
+      sum += p[0] << 8;
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+  return htons ((u16) ~sum);
+}
+
+class ChecksumTest : public ::testing::Test
+{
+protected:
+  ChecksumTest () : generator_ (42) {}
+
+  virtual ~ChecksumTest () { hicn_csum_set_impl (default_impl_); }
+
+  std::vector<u8>
+  randomBuffer (size_t size)
+  {
+    std::uniform_int_distribution<int> dist (0, 255);
+    std::vector<u8> buffer (size);
+    for (auto &b : buffer)
+      b = (u8) dist (generator_);
+    return buffer;
+  }
+
+  std::mt19937 generator_;
+  hicn_csum_impl_t default_impl_ = hicn_csum_get_impl ();
+};
+
+TEST_F (ChecksumTest, DefaultIsSupported)
+{
+  EXPECT_TRUE (hicn_csum_impl_supported (hicn_csum_get_impl ()));
+  EXPECT_TRUE (hicn_csum_impl_supported (HICN_CSUM_SCALAR));
+  EXPECT_EQ (hicn_csum_set_impl (HICN_CSUM_N), -1);
+}
+
+/*
+ * Every implementation against the reference, over sizes around the vector
+ * widths, at all alignments modulo 16.
+ */
+TEST_F (ChecksumTest, Implementations)
+{
+  std::vector<u8> buffer = randomBuffer (2048 + 16);
+
+  for (int type = 0; type < HICN_CSUM_N; type++)
+    {
+      if (hicn_csum_set_impl (hicn_csum_impl_t (type)) < 0)
+	continue;
+
+      for (size_t offset = 0; offset < 16; offset++)
+	for (size_t size = 0; size <= 2048; size += (size < 160 ? 1 : 97))
+	  {
+	    const u8 *p = buffer.data () + offset;
+	    u16 init = (u16) (size * 31 + offset);
+	    EXPECT_EQ (csum (p, size, init), csum_reference (p, size, init))
+	      << hicn_csum_impl_name (hicn_csum_impl_t (type)) << " size "
+	      << size << " offset " << offset;
+	  }
+    }
+}
+
+/* Carries must not be lost on buffers made of 0xff bytes */
+TEST_F (ChecksumTest, AllOnes)
+{
+  std::vector<u8> buffer (65536 + 1, 0xff);
+
+  for (int type = 0; type < HICN_CSUM_N; type++)
+    {
+      if (hicn_csum_set_impl (hicn_csum_impl_t (type)) < 0)
+	continue;
+
+      for (size_t size : { 1, 2, 3, 63, 64, 1400, 65535, 65536, 65537 })
+	EXPECT_EQ (csum (buffer.data (), size, 0xffff),
+		   csum_reference (buffer.data (), size, 0xffff))
+	  << hicn_csum_impl_name (hicn_csum_impl_t (type)) << " size "
+	  << size;
+    }
+}
+
+/* A buffer split in chunks of any length has the checksum of the whole */
+TEST_F (ChecksumTest, Streaming)
+{
+  std::vector<u8> buffer = randomBuffer (4096);
+  std::uniform_int_distribution<size_t> dist (0, 100);
+
+  for (int type = 0; type < HICN_CSUM_N; type++)
+    {
+      if (hicn_csum_set_impl (hicn_csum_impl_t (type)) < 0)
+	continue;
+
+      for (int round = 0; round < 100; round++)
+	{
+	  hicn_csum_state_t state;
+	  hicn_csum_init (&state, 0x1234);
+
+	  size_t pos = 0;
+	  while (pos < buffer.size ())
+	    {
+	      size_t len = std::min (dist (generator_), buffer.size () - pos);
+	      hicn_csum_update (&state, buffer.data () + pos, len);
+	      pos += len;
+	    }
+
+	  EXPECT_EQ (hicn_csum_final (&state),
+		     csum_reference (buffer.data (), buffer.size (), 0x1234))
+	    << hicn_csum_impl_name (hicn_csum_impl_t (type));
+	}
+    }
+}
+
+/*
+ * Throughput of each implementation available, on payloads of the size of a
+ * data packet.
+ */
+TEST_F (ChecksumTest, Benchmark)
+{
+  const size_t size = 1400;
+  const int rounds = 200000;
+  std::vector<u8> buffer = randomBuffer (size);
+
+  for (int type = 0; type < HICN_CSUM_N; type++)
+    {
+      if (hicn_csum_set_impl (hicn_csum_impl_t (type)) < 0)
+	continue;
+
+      volatile u16 result = 0;
+      auto start = std::chrono::steady_clock::now ();
+      for (int i = 0; i < rounds; i++)
+	result = csum (buffer.data (), size, result);
+      std::chrono::duration<double> elapsed =
+	std::chrono::steady_clock::now () - start;
+
+      printf ("[ checksum ] %s: %.2f GB/s, %.1f ns per %zu byte packet\n",
+	      hicn_csum_impl_name (hicn_csum_impl_t (type)),
+	      double (rounds) * size / elapsed.count () / 1e9,
+	      elapsed.count () * 1e9 / rounds, size);
+    }
+}
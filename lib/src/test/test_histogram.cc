@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include <hicn/util/histogram.h>
+}
+
+class HistogramTest : public ::testing::Test
+{
+protected:
+  HistogramTest () { histogram_reset (&histogram); }
+  virtual ~HistogramTest () {}
+
+  histogram_t histogram;
+};
+
+TEST_F (HistogramTest, BucketBoundaries)
+{
+  // Small values have their own bucket
+  for (uint64_t v = 0; v < HISTOGRAM_SUB_BUCKETS; v++)
+    EXPECT_EQ (histogram_bucket (v), v);
+
+  // Buckets are contiguous, and their lower bound maps back to them
+  for (unsigned i = 1; i < HISTOGRAM_N_BUCKETS; i++)
+    {
+      uint64_t lower = histogram_bucket_lower (i);
+      EXPECT_GT (lower, histogram_bucket_lower (i - 1));
+      EXPECT_EQ (histogram_bucket (lower), i);
+      EXPECT_EQ (histogram_bucket (lower - 1), i - 1);
+    }
+
+  // Out of range values end up in the last bucket
+  EXPECT_EQ (histogram_bucket (UINT64_MAX), HISTOGRAM_N_BUCKETS - 1u);
+}
+
+TEST_F (HistogramTest, RelativeError)
+{
+  // The lower bound of a bucket is within 1/HISTOGRAM_SUB_BUCKETS of the value
+  for (uint64_t v = 1; v < (1ULL << 24); v = v * 3 / 2 + 1)
+    {
+      uint64_t lower = histogram_bucket_lower (histogram_bucket (v));
+      EXPECT_LE (lower, v);
+      EXPECT_LE (v - lower, v / HISTOGRAM_SUB_BUCKETS);
+    }
+}
+
+TEST_F (HistogramTest, Percentiles)
+{
+  EXPECT_EQ (histogram_percentile (&histogram, 50), 0UL);
+
+  for (uint64_t v = 1; v <= 1000; v++)
+    histogram_add (&histogram, v);
+
+  EXPECT_EQ (histogram.count, 1000UL);
+  EXPECT_EQ (histogram.min, 1UL);
+  EXPECT_EQ (histogram.max, 1000UL);
+  EXPECT_EQ (histogram_mean (&histogram), 500UL);
+
+  uint64_t p50 = histogram_percentile (&histogram, 50);
+  EXPECT_LE (p50, 501UL);
+  EXPECT_GE (p50, 501UL - 501UL / HISTOGRAM_SUB_BUCKETS);
+
+  uint64_t p99 = histogram_percentile (&histogram, 99);
+  EXPECT_LE (p99, 991UL);
+  EXPECT_GE (p99, 991UL - 991UL / HISTOGRAM_SUB_BUCKETS);
+
+  EXPECT_EQ (histogram_percentile (&histogram, 0), 1UL);
+  EXPECT_EQ (histogram_percentile (&histogram, 100), 1000UL);
+}
@@ -23,8 +23,14 @@
 #include <unistd.h>
 #include <netinet/in.h>
 
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
 extern "C"
 {
+#include <hicn/name.h>
 #include <hicn/util/khash.h>
 }
 
@@ -177,3 +183,223 @@ TEST_F (KHashTest, Collisions)
 
   kh_destroy_test_map (map);
 }
+
+/*
+ * Name hashing: hash tables index buckets with the low bits of the hash, and
+ * the flat name index of hicn-light also keeps the 7 most significant bits as
+ * a tag. Both should be uniformly distributed for the typical name sets of
+ * hICN, ie. consecutive suffixes under a prefix, and consecutive prefixes.
+ */
+
+#define name_hash_eq(a, b) (hicn_name_compare ((a), (b), true) == 0)
+KHASH_INIT (name_map, const hicn_name_t *, unsigned, 1, hicn_name_hash,
+	    name_hash_eq);
+
+class NameHashTest : public ::testing::Test
+{
+protected:
+  static const unsigned N_KEYS = 1 << 16;
+
+  /* Names with consecutive suffixes under a single prefix */
+  static std::vector<hicn_name_t>
+  consecutiveSuffixes (const char *prefix)
+  {
+    std::vector<hicn_name_t> names (N_KEYS);
+    for (unsigned i = 0; i < N_KEYS; i++)
+      EXPECT_EQ (hicn_name_create (prefix, i, &names[i]), 0);
+    return names;
+  }
+
+  /* Names with consecutive prefixes, IPv6 or IPv4 */
+  static std::vector<hicn_name_t>
+  consecutivePrefixes (bool v4)
+  {
+    std::vector<hicn_name_t> names (N_KEYS);
+    char address[INET6_ADDRSTRLEN];
+    for (unsigned i = 0; i < N_KEYS; i++)
+      {
+	if (v4)
+	  snprintf (address, sizeof (address), "10.0.%u.%u", i >> 8, i & 0xff);
+	else
+	  snprintf (address, sizeof (address), "b001::%x:0", i);
+	EXPECT_EQ (hicn_name_create (address, 0, &names[i]), 0);
+      }
+    return names;
+  }
+
+  /*
+   * Chi-squared statistic of the distribution of hashes among n_bins bins
+   * (a power of 2), using the bits starting at the specified shift.
+   */
+  static double
+  chiSquared (const std::vector<u32> &hashes, unsigned n_bins, unsigned shift)
+  {
+    std::vector<unsigned> bins (n_bins, 0);
+    for (u32 h : hashes)
+      bins[(h >> shift) & (n_bins - 1)]++;
+
+    double expected = double (hashes.size ()) / n_bins;
+    double chi2 = 0;
+    for (unsigned count : bins)
+      chi2 += (count - expected) * (count - expected) / expected;
+    return chi2;
+  }
+
+  /*
+   * The statistic follows a chi-squared law with n_bins - 1 degrees of
+   * freedom, whose mean is n_bins - 1 and variance 2 * (n_bins - 1).
+   */
+  static void
+  expectUniform (const std::vector<u32> &hashes, const char *what)
+  {
+    for (unsigned n_bins : { 128u, 1024u, 16384u })
+      {
+	double dof = n_bins - 1;
+	double limit = dof + 6 * std::sqrt (2 * dof);
+	EXPECT_LT (chiSquared (hashes, n_bins, 0), limit)
+	  << what << ": low bits, " << n_bins << " bins";
+      }
+    EXPECT_LT (chiSquared (hashes, 128, 25), 127 + 6 * std::sqrt (2 * 127.0))
+      << what << ": tag bits";
+  }
+};
+
+TEST_F (NameHashTest, SuffixMixMatchesNameHash)
+{
+  std::vector<hicn_name_t> names = consecutiveSuffixes ("b001::1234");
+  u32 prefix_hash = hicn_name_prefix_hash (&names[0].prefix);
+
+  for (const hicn_name_t &name : names)
+    {
+      EXPECT_EQ (hicn_name_prefix_hash (&name.prefix), prefix_hash);
+      EXPECT_EQ (hicn_name_suffix_mix (prefix_hash, name.suffix),
+		 hicn_name_hash (&name));
+      EXPECT_EQ (hicn_name_get_hash (&name), hicn_name_hash (&name));
+      EXPECT_EQ (hicn_name_get_prefix_hash (&name), prefix_hash);
+    }
+}
+
+TEST_F (NameHashTest, Distribution)
+{
+  std::vector<u32> hashes (N_KEYS);
+
+  std::vector<hicn_name_t> names = consecutiveSuffixes ("b001::1234");
+  for (unsigned i = 0; i < N_KEYS; i++)
+    hashes[i] = hicn_name_hash (&names[i]);
+  expectUniform (hashes, "IPv6 suffixes");
+
+  names = consecutiveSuffixes ("10.0.0.1");
+  for (unsigned i = 0; i < N_KEYS; i++)
+    hashes[i] = hicn_name_hash (&names[i]);
+  expectUniform (hashes, "IPv4 suffixes");
+
+  names = consecutivePrefixes (false);
+  for (unsigned i = 0; i < N_KEYS; i++)
+    hashes[i] = hicn_name_prefix_hash (&names[i].prefix);
+  expectUniform (hashes, "IPv6 prefixes");
+
+  names = consecutivePrefixes (true);
+  for (unsigned i = 0; i < N_KEYS; i++)
+    hashes[i] = hicn_name_prefix_hash (&names[i].prefix);
+  expectUniform (hashes, "IPv4 prefixes");
+}
+
+/* Flipping any bit of the name flips each bit of the hash with p = 0.5 */
+TEST_F (NameHashTest, Avalanche)
+{
+  const unsigned n_samples = 2000;
+  const unsigned n_bits = 8 * (sizeof (hicn_name_prefix_t) + sizeof (u32));
+  std::mt19937 generator (42);
+  std::vector<unsigned> flips (n_bits * 32, 0);
+
+  for (unsigned n = 0; n < n_samples; n++)
+    {
+      u8 bytes[20];
+      for (auto &b : bytes)
+	b = (u8) generator ();
+
+      hicn_name_t name;
+      memcpy (&name.prefix, bytes, sizeof (name.prefix));
+      memcpy (&name.suffix, bytes + 16, sizeof (name.suffix));
+      u32 hash = hicn_name_hash (&name);
+
+      for (unsigned bit = 0; bit < n_bits; bit++)
+	{
+	  hicn_name_t flipped = name;
+	  u8 *p = bit < 128 ? (u8 *) &flipped.prefix + bit / 8 :
+			      (u8 *) &flipped.suffix + (bit - 128) / 8;
+	  *p ^= 1 << (bit % 8);
+
+	  u32 diff = hash ^ hicn_name_hash (&flipped);
+	  for (unsigned out = 0; out < 32; out++)
+	    flips[bit * 32 + out] += (diff >> out) & 1;
+	}
+    }
+
+  for (unsigned bit = 0; bit < n_bits; bit++)
+    for (unsigned out = 0; out < 32; out++)
+      {
+	double p = double (flips[bit * 32 + out]) / n_samples;
+	EXPECT_GT (p, 0.4) << "input bit " << bit << ", output bit " << out;
+	EXPECT_LT (p, 0.6) << "input bit " << bit << ", output bit " << out;
+      }
+}
+
+/* Probe lengths of a khash table keyed on names stay short */
+TEST_F (NameHashTest, KhashNameMap)
+{
+  std::vector<hicn_name_t> names = consecutiveSuffixes ("b001::1234");
+  kh_name_map_t *map = kh_init (name_map);
+  int ret;
+
+  for (unsigned i = 0; i < N_KEYS; i++)
+    {
+      khiter_t k = kh_put_name_map (map, &names[i], &ret);
+      ASSERT_EQ (ret, 1);
+      kh_val (map, k) = i;
+    }
+
+  /* Same probe sequence as kh_get: count the buckets visited per key */
+  khint_t mask = kh_n_buckets (map) - 1;
+  size_t total = 0;
+  for (unsigned i = 0; i < N_KEYS; i++)
+    {
+      khint_t k = hicn_name_hash (&names[i]) & mask, step = 0;
+      while (kh_key (map, k) != &names[i])
+	k = (k + (++step)) & mask;
+      total += step + 1;
+
+      khiter_t it = kh_get_name_map (map, &names[i]);
+      ASSERT_NE (it, kh_end (map));
+      EXPECT_EQ (kh_val (map, it), i);
+    }
+  EXPECT_LT (double (total) / N_KEYS, 2.0);
+
+  kh_destroy_name_map (map);
+}
+
+TEST_F (NameHashTest, Benchmark)
+{
+  std::vector<hicn_name_t> names = consecutiveSuffixes ("b001::1234");
+  const int rounds = 100;
+  volatile u32 sink = 0;
+
+  auto start = std::chrono::steady_clock::now ();
+  for (int r = 0; r < rounds; r++)
+    for (const hicn_name_t &name : names)
+      sink = sink + cumulative_hash32 (
+		      &name.suffix, sizeof (name.suffix),
+		      hash32 (&name.prefix, sizeof (name.prefix)));
+  std::chrono::duration<double> fnv = std::chrono::steady_clock::now () - start;
+
+  start = std::chrono::steady_clock::now ();
+  for (int r = 0; r < rounds; r++)
+    for (const hicn_name_t &name : names)
+      sink = sink + hicn_name_hash (&name);
+  std::chrono::duration<double> fixed =
+    std::chrono::steady_clock::now () - start;
+
+  printf ("[ name hash ] fnv-1a: %.2f ns, fixed-width: %.2f ns per name\n",
+	  fnv.count () * 1e9 / rounds / N_KEYS,
+	  fixed.count () * 1e9 / rounds / N_KEYS);
+}
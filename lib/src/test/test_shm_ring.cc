@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <thread>
+
+extern "C"
+{
+#include <hicn/util/shm_ring.h>
+}
+
+class ShmRingTest : public ::testing::Test
+{
+protected:
+  ShmRingTest ()
+  {
+    region = (hicn_shm_region_t *) aligned_alloc (HICN_SHM_CACHELINE,
+						  HICN_SHM_REGION_SIZE);
+    hicn_shm_region_init (region);
+  }
+  virtual ~ShmRingTest () { free (region); }
+
+  hicn_shm_region_t *region;
+  uint32_t head = 0;
+};
+
+TEST_F (ShmRingTest, RegionValidation)
+{
+  EXPECT_TRUE (hicn_shm_region_is_valid (region, HICN_SHM_REGION_SIZE));
+  EXPECT_FALSE (hicn_shm_region_is_valid (region, HICN_SHM_REGION_SIZE - 1));
+  region->version++;
+  EXPECT_FALSE (hicn_shm_region_is_valid (region, HICN_SHM_REGION_SIZE));
+}
+
+TEST_F (ShmRingTest, PushPublishConsume)
+{
+  const hicn_shm_ring_id_t r = HICN_SHM_RING_TO_FWD;
+  uint8_t packet[100];
+  size_t len = 0;
+
+  for (unsigned i = 0; i < 3; i++)
+    {
+      memset (packet, i, sizeof (packet));
+      EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, 10 + i), 0);
+    }
+
+  /* Nothing is visible before publication */
+  EXPECT_EQ (hicn_shm_ring_available (region, r), 0u);
+
+  /* The consumer is idle and must be notified, only once */
+  EXPECT_TRUE (hicn_shm_ring_publish (region, r, head));
+  EXPECT_FALSE (hicn_shm_ring_publish (region, r, head));
+  EXPECT_EQ (hicn_shm_ring_available (region, r), 3u);
+
+  for (unsigned i = 0; i < 3; i++)
+    {
+      const uint8_t *p = hicn_shm_ring_peek (region, r, i, &len);
+      ASSERT_NE (p, nullptr);
+      EXPECT_EQ (len, 10u + i);
+      EXPECT_EQ (p[0], i);
+    }
+  hicn_shm_ring_release (region, r, 3);
+  EXPECT_EQ (hicn_shm_ring_available (region, r), 0u);
+
+  /* The other direction is unaffected */
+  EXPECT_EQ (hicn_shm_ring_available (region, HICN_SHM_RING_FROM_FWD), 0u);
+}
+
+TEST_F (ShmRingTest, NotifyOnlyIdleConsumer)
+{
+  const hicn_shm_ring_id_t r = HICN_SHM_RING_FROM_FWD;
+  uint8_t packet[64] = { 0 };
+
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, sizeof (packet)),
+	     0);
+  EXPECT_TRUE (hicn_shm_ring_publish (region, r, head));
+
+  /* The consumer has not caught up yet: no notification needed */
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, sizeof (packet)),
+	     0);
+  EXPECT_FALSE (hicn_shm_ring_publish (region, r, head));
+
+  /* Once it has, it might be sleeping */
+  hicn_shm_ring_release (region, r, hicn_shm_ring_available (region, r));
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, sizeof (packet)),
+	     0);
+  EXPECT_TRUE (hicn_shm_ring_publish (region, r, head));
+}
+
+TEST_F (ShmRingTest, RingFull)
+{
+  const hicn_shm_ring_id_t r = HICN_SHM_RING_TO_FWD;
+  uint8_t packet[HICN_SHM_BUFFER_SIZE + 1] = { 0 };
+
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, sizeof (packet)),
+	     -1);
+
+  for (unsigned i = 0; i < HICN_SHM_RING_SIZE; i++)
+    EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, 1), 0);
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, 1), -1);
+  hicn_shm_ring_publish (region, r, head);
+
+  hicn_shm_ring_release (region, r, 1);
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, 1), 0);
+}
+
+TEST_F (ShmRingTest, CorruptedIndices)
+{
+  const hicn_shm_ring_id_t r = HICN_SHM_RING_TO_FWD;
+  uint8_t packet[64] = { 0 };
+  size_t len = 0;
+
+  /* A head beyond the ring size is ignored */
+  region->rings[r].head = HICN_SHM_RING_SIZE + 1;
+  EXPECT_EQ (hicn_shm_ring_available (region, r), 0u);
+  region->rings[r].head = 0;
+
+  /* Descriptors pointing outside of the buffers are rejected */
+  EXPECT_EQ (hicn_shm_ring_push (region, r, &head, packet, sizeof (packet)),
+	     0);
+  hicn_shm_ring_publish (region, r, head);
+  region->rings[r].desc[0].offset = 0;
+  EXPECT_EQ (hicn_shm_ring_peek (region, r, 0, &len), nullptr);
+  region->rings[r].desc[0].offset = HICN_SHM_REGION_SIZE - 10;
+  EXPECT_EQ (hicn_shm_ring_peek (region, r, 0, &len), nullptr);
+  region->rings[r].desc[0].offset = HICN_SHM_BUFFERS_OFFSET;
+  region->rings[r].desc[0].length = HICN_SHM_BUFFER_SIZE + 1;
+  EXPECT_EQ (hicn_shm_ring_peek (region, r, 0, &len), nullptr);
+}
+
+/* Packets are received in order and intact across threads */
+TEST_F (ShmRingTest, ProducerConsumer)
+{
+  static constexpr uint32_t N_PACKETS = 100000;
+  const hicn_shm_ring_id_t r = HICN_SHM_RING_TO_FWD;
+
+  std::thread producer ([this, r] () {
+    uint32_t seq = 0;
+    while (seq < N_PACKETS)
+      {
+	while (seq < N_PACKETS &&
+	       hicn_shm_ring_push (region, r, &head, (uint8_t *) &seq,
+				   sizeof (seq)) == 0)
+	  seq++;
+	hicn_shm_ring_publish (region, r, head);
+	std::this_thread::yield ();
+      }
+  });
+
+  uint32_t expected = 0;
+  bool in_order = true;
+  while (expected < N_PACKETS)
+    {
+      uint32_t n = hicn_shm_ring_available (region, r);
+      if (n == 0)
+	std::this_thread::yield ();
+      for (uint32_t i = 0; i < n; i++)
+	{
+	  size_t len = 0;
+	  uint32_t seq;
+	  const uint8_t *p = hicn_shm_ring_peek (region, r, i, &len);
+	  if (!p || len != sizeof (seq))
+	    {
+	      in_order = false;
+	      continue;
+	    }
+	  memcpy (&seq, p, sizeof (seq));
+	  in_order &= seq == expected;
+	  expected++;
+	}
+      hicn_shm_ring_release (region, r, n);
+      if (!in_order)
+	break;
+    }
+  producer.join ();
+
+  EXPECT_TRUE (in_order);
+  EXPECT_EQ (expected, N_PACKETS);
+}
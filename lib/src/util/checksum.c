@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file checksum.c
+ * @brief Implementation of the Internet checksum kernels.
+ */
+
+#include <string.h>
+
+#include <hicn/util/checksum.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CSUM_X86
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CSUM_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+ * Sums the remaining bytes, 8 then 2 at a time, padding an odd last byte with
+ * zero as if the buffer was followed by a null byte.
+ */
+static u64
+csum_tail (const u8 *p, size_t size, u64 sum)
+{
+  u64 w64;
+  u16 w16;
+
+  for (; size >= 8; p += 8, size -= 8)
+    {
+      memcpy (&w64, p, sizeof (w64));
+      sum = hicn_csum_add (sum, w64);
+    }
+  for (; size >= 2; p += 2, size -= 2)
+    {
+      memcpy (&w16, p, sizeof (w16));
+      sum = hicn_csum_add (sum, w16);
+    }
+  if (size)
+    {
+      w16 = 0;
+      memcpy (&w16, p, 1);
+      sum = hicn_csum_add (sum, w16);
+    }
+
+  return sum;
+}
+
+static u64
+csum_scalar (const void *addr, size_t size, u64 sum)
+{
+  const u8 *p = (const u8 *) addr;
+  u64 w[4];
+
+  for (; size >= 32; p += 32, size -= 32)
+    {
+      memcpy (w, p, sizeof (w));
+      sum = hicn_csum_add (sum, w[0]);
+      sum = hicn_csum_add (sum, w[1]);
+      sum = hicn_csum_add (sum, w[2]);
+      sum = hicn_csum_add (sum, w[3]);
+    }
+
+  return csum_tail (p, size, sum);
+}
+
+/*
+ * Vector kernels zero-extend 32 bit words into 64 bit lanes, which cannot
+ * overflow before 16GB of data, and add the lanes together at the end.
+ */
+#ifdef CSUM_X86
+
+__attribute__ ((target ("sse2"))) static u64
+csum_sse2 (const void *addr, size_t size, u64 sum)
+{
+  const u8 *p = (const u8 *) addr;
+  __m128i zero = _mm_setzero_si128 ();
+  __m128i acc0 = zero, acc1 = zero;
+  u64 lanes[2];
+
+  for (; size >= 32; p += 32, size -= 32)
+    {
+      __m128i a = _mm_loadu_si128 ((const __m128i *) p);
+      __m128i b = _mm_loadu_si128 ((const __m128i *) (p + 16));
+      acc0 = _mm_add_epi64 (acc0, _mm_unpacklo_epi32 (a, zero));
+      acc1 = _mm_add_epi64 (acc1, _mm_unpackhi_epi32 (a, zero));
+      acc0 = _mm_add_epi64 (acc0, _mm_unpacklo_epi32 (b, zero));
+      acc1 = _mm_add_epi64 (acc1, _mm_unpackhi_epi32 (b, zero));
+    }
+
+  _mm_storeu_si128 ((__m128i *) lanes, _mm_add_epi64 (acc0, acc1));
+  sum = hicn_csum_add (sum, lanes[0]);
+  sum = hicn_csum_add (sum, lanes[1]);
+
+  return csum_tail (p, size, sum);
+}
+
+__attribute__ ((target ("avx2"))) static u64
+csum_avx2 (const void *addr, size_t size, u64 sum)
+{
+  const u8 *p = (const u8 *) addr;
+  __m256i zero = _mm256_setzero_si256 ();
+  __m256i acc0 = zero, acc1 = zero;
+  u64 lanes[4];
+
+  for (; size >= 64; p += 64, size -= 64)
+    {
+      __m256i a = _mm256_loadu_si256 ((const __m256i *) p);
+      __m256i b = _mm256_loadu_si256 ((const __m256i *) (p + 32));
+      acc0 = _mm256_add_epi64 (acc0, _mm256_unpacklo_epi32 (a, zero));
+      acc1 = _mm256_add_epi64 (acc1, _mm256_unpackhi_epi32 (a, zero));
+      acc0 = _mm256_add_epi64 (acc0, _mm256_unpacklo_epi32 (b, zero));
+      acc1 = _mm256_add_epi64 (acc1, _mm256_unpackhi_epi32 (b, zero));
+    }
+  if (size >= 32)
+    {
+      __m256i a = _mm256_loadu_si256 ((const __m256i *) p);
+      acc0 = _mm256_add_epi64 (acc0, _mm256_unpacklo_epi32 (a, zero));
+      acc1 = _mm256_add_epi64 (acc1, _mm256_unpackhi_epi32 (a, zero));
+      p += 32;
+      size -= 32;
+    }
+
+  _mm256_storeu_si256 ((__m256i *) lanes, _mm256_add_epi64 (acc0, acc1));
+  sum = hicn_csum_add (sum, lanes[0]);
+  sum = hicn_csum_add (sum, lanes[1]);
+  sum = hicn_csum_add (sum, lanes[2]);
+  sum = hicn_csum_add (sum, lanes[3]);
+
+  return csum_tail (p, size, sum);
+}
+
+#endif /* CSUM_X86 */
+
+#ifdef CSUM_NEON
+
+static u64
+csum_neon (const void *addr, size_t size, u64 sum)
+{
+  const u8 *p = (const u8 *) addr;
+  uint64x2_t acc0 = vdupq_n_u64 (0), acc1 = vdupq_n_u64 (0);
+
+  /* Pairwise add and accumulate long: two 32 bit words in each 64 bit lane */
+  for (; size >= 32; p += 32, size -= 32)
+    {
+      acc0 = vpadalq_u32 (acc0, vreinterpretq_u32_u8 (vld1q_u8 (p)));
+      acc1 = vpadalq_u32 (acc1, vreinterpretq_u32_u8 (vld1q_u8 (p + 16)));
+    }
+
+  acc0 = vaddq_u64 (acc0, acc1);
+  sum = hicn_csum_add (sum, vgetq_lane_u64 (acc0, 0));
+  sum = hicn_csum_add (sum, vgetq_lane_u64 (acc0, 1));
+
+  return csum_tail (p, size, sum);
+}
+
+#endif /* CSUM_NEON */
+
+typedef u64 (*csum_fn) (const void *addr, size_t size, u64 sum);
+
+/* Indexed by hicn_csum_impl_t, NULL if not built for this architecture */
+static const struct
+{
+  const char *name;
+  csum_fn fn;
+} csum_impls[HICN_CSUM_N] = {
+  { "scalar", csum_scalar },
+#ifdef CSUM_X86
+  { "sse2", csum_sse2 },
+  { "avx2", csum_avx2 },
+#else
+  { "sse2", NULL },
+  { "avx2", NULL },
+#endif
+#ifdef CSUM_NEON
+  { "neon", csum_neon },
+#else
+  { "neon", NULL },
+#endif
+};
+
+/* Implementations picked by default, by order of preference */
+static const hicn_csum_impl_t csum_preferred[] = {
+  HICN_CSUM_NEON,
+  HICN_CSUM_AVX2,
+  HICN_CSUM_SSE2,
+};
+
+static u64 csum_resolve (const void *addr, size_t size, u64 sum);
+
+static hicn_csum_impl_t csum_type = HICN_CSUM_SCALAR;
+
+/*
+ * Resolved on first use. Concurrent first calls all store the same values,
+ * so no synchronization is needed.
+ */
+static csum_fn csum_impl = csum_resolve;
+
+int
+hicn_csum_impl_supported (hicn_csum_impl_t impl)
+{
+  if (impl < 0 || impl >= HICN_CSUM_N || csum_impls[impl].fn == NULL)
+    return 0;
+
+#ifdef CSUM_X86
+  switch (impl)
+    {
+    case HICN_CSUM_SSE2:
+      return __builtin_cpu_supports ("sse2");
+    case HICN_CSUM_AVX2:
+      return __builtin_cpu_supports ("avx2");
+    default:
+      break;
+    }
+#endif
+  return 1;
+}
+
+static void
+csum_select (void)
+{
+  hicn_csum_impl_t type = HICN_CSUM_SCALAR;
+  unsigned i;
+
+  for (i = 0; i < sizeof (csum_preferred) / sizeof (csum_preferred[0]); i++)
+    if (hicn_csum_impl_supported (csum_preferred[i]))
+      {
+	type = csum_preferred[i];
+	break;
+      }
+
+  csum_type = type;
+  csum_impl = csum_impls[type].fn;
+}
+
+static u64
+csum_resolve (const void *addr, size_t size, u64 sum)
+{
+  csum_select ();
+  return csum_impl (addr, size, sum);
+}
+
+u64
+hicn_csum_partial (const void *addr, size_t size, u64 sum)
+{
+  return csum_impl (addr, size, sum);
+}
+
+int
+hicn_csum_set_impl (hicn_csum_impl_t impl)
+{
+  if (!hicn_csum_impl_supported (impl))
+    return -1;
+
+  csum_type = impl;
+  csum_impl = csum_impls[impl].fn;
+  return 0;
+}
+
+hicn_csum_impl_t
+hicn_csum_get_impl (void)
+{
+  if (csum_impl == csum_resolve)
+    csum_select ();
+  return csum_type;
+}
+
+const char *
+hicn_csum_impl_name (hicn_csum_impl_t impl)
+{
+  if (impl < 0 || impl >= HICN_CSUM_N)
+    return "unknown";
+  return csum_impls[impl].name;
+}
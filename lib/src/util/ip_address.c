@@ -432,7 +432,7 @@ hicn_ip_address_match_family (const hicn_ip_address_t *address, int family)
 uint32_t
 hicn_ip_address_get_hash (const hicn_ip_address_t *address)
 {
-  return hash32 (address, sizeof (address));
+  return hash32 (address, sizeof (*address));
 }
 
 /* URL */
@@ -40,7 +40,8 @@ class Signer {
 
   virtual ~Signer();
 
-  // Sign a packet.
+  // Sign a packet. The signature is computed in a buffer local to the call,
+  // so several packets can be signed concurrently by the same signer.
   virtual void signPacket(PacketPtr packet);
   virtual void signBuffer(const std::vector<uint8_t> &buffer);
   virtual void signBuffer(const utils::MemBuf *buffer);
@@ -69,6 +70,11 @@ class Signer {
   void display();
 
  protected:
+  // Compute the signature of a buffer chain into signature and return the
+  // signature length. Does not modify the signer.
+  std::size_t computeSignature(const utils::MemBuf *buffer,
+                               utils::MemBuf &signature) const;
+
   CryptoSuite suite_;
   utils::MemBuf::Ptr signature_;
   std::size_t signature_len_;
@@ -54,6 +54,7 @@ static constexpr uint32_t max_out_of_order_segments = 3;  // content object
 static constexpr uint32_t manifest_max_capacity = 30;
 static constexpr uint32_t manifest_factor_relevant = 100;
 static constexpr uint32_t manifest_factor_alert = 20;
+static constexpr uint32_t producer_threads = 0;
 
 // RAAQM
 static const int sample_number = 30;
@@ -35,6 +35,7 @@ typedef enum {
   RAAQM = 10,
   CBR = 11,
   RTC = 12,
+  BBR = 13,
 } TransportProtocolAlgorithms;
 
 typedef enum {
@@ -78,6 +79,7 @@ typedef enum {
   SUFFIX_STRATEGY = 124,
   PACKET_FORMAT = 125,
   FEC_TYPE = 126,
+  PRODUCER_THREADS = 127,
 } GeneralTransportOptions;
 
 typedef enum {
@@ -62,7 +62,10 @@ class TransportStatistics {
         in_congestion_(false),
         residual_loss_rate_(0.0),
         quality_score_(5),
-        alerts_(0) {}
+        alerts_(0),
+        bottleneck_bandwidth_(0.0),
+        min_rtt_(0.0),
+        pacing_rate_(0.0) {}
 
   TRANSPORT_ALWAYS_INLINE void updateRetxCount(uint64_t retx) {
     retx_count_ += retx;
@@ -142,6 +145,19 @@ class TransportStatistics {
     in_congestion_ = state;
   }
 
+  TRANSPORT_ALWAYS_INLINE void updateBottleneckBandwidth(double bps) {
+    bottleneck_bandwidth_ = bps;
+  }
+
+  TRANSPORT_ALWAYS_INLINE void updateMinRtt(
+      const utils::SteadyTime::Microseconds &rtt) {
+    min_rtt_ = double(rtt.count()) / 1000.0;
+  }
+
+  TRANSPORT_ALWAYS_INLINE void updatePacingRate(double bps) {
+    pacing_rate_ = bps;
+  }
+
   TRANSPORT_ALWAYS_INLINE void setAlert(statsAlerts x) {
     alerts_ |= 1UL << (uint32_t)x;
   }
@@ -216,6 +232,14 @@ class TransportStatistics {
 
   TRANSPORT_ALWAYS_INLINE uint32_t getAlerts() const { return alerts_; }
 
+  TRANSPORT_ALWAYS_INLINE double getBottleneckBandwidth() const {
+    return bottleneck_bandwidth_;
+  }
+
+  TRANSPORT_ALWAYS_INLINE double getMinRtt() const { return min_rtt_; }
+
+  TRANSPORT_ALWAYS_INLINE double getPacingRate() const { return pacing_rate_; }
+
   TRANSPORT_ALWAYS_INLINE void setAlpha(double val) { alpha_ = val; }
 
   TRANSPORT_ALWAYS_INLINE void reset() {
@@ -237,6 +261,9 @@ class TransportStatistics {
     received_fec_ = 0;
     in_congestion_ = false;
     quality_score_ = 5;
+    bottleneck_bandwidth_ = 0;
+    min_rtt_ = 0;
+    pacing_rate_ = 0;
   }
 
  private:
@@ -265,6 +292,12 @@ class TransportStatistics {
   // something bad is appening in the network, the encode is done accoding to
   // the enum alerts;
   uint32_t alerts_;
+
+  // Path model of the model-based protocols: bottleneck bandwidth and pacing
+  // rate in bits per second, minimum RTT in milliseconds
+  double bottleneck_bandwidth_;
+  double min_rtt_;
+  double pacing_rate_;
 };
 
 }  // namespace interface
@@ -71,10 +71,13 @@ void Signer::signPacket(PacketPtr packet) {
   // Reset fields to compute the packet hash
   packet->resetForHash();
 
-  // Compute the signature and put it in the packet
-  signBuffer(packet);
-  packet->setSignature(signature_);
-  packet->setSignatureSize(signature_len_);
+  // Compute the signature and put it in the packet. The buffer is local to the
+  // call: the packet pool is per thread and signPacket may run on the workers
+  // of the producer.
+  utils::MemBuf::Ptr signature = utils::MemBuf::create(signature_field_len);
+  std::size_t signature_len = computeSignature(packet, *signature);
+  packet->setSignature(signature);
+  packet->setSignatureSize(signature_len);
 
   // Restore header
   packet->loadHeader(header_copy, header_len);
@@ -126,6 +129,11 @@ void Signer::signBuffer(const std::vector<uint8_t> &buffer) {
 }
 
 void Signer::signBuffer(const utils::MemBuf *buffer) {
+  signature_len_ = computeSignature(buffer, *signature_);
+}
+
+std::size_t Signer::computeSignature(const utils::MemBuf *buffer,
+                                     utils::MemBuf &signature) const {
   DCHECK(key_ != nullptr);
   CryptoHashEVP hash_evp = CryptoHash::getEVP(getHashType());
 
@@ -134,6 +142,7 @@ void Signer::signBuffer(const utils::MemBuf *buffer) {
   }
 
   const utils::MemBuf *p = buffer;
+  std::size_t signature_len = 0;
   std::shared_ptr<EVP_MD_CTX> mdctx(EVP_MD_CTX_create(), EVP_MD_CTX_free);
 
   if (mdctx == nullptr) {
@@ -153,20 +162,22 @@ void Signer::signBuffer(const utils::MemBuf *buffer) {
     p = p->next();
   } while (p != buffer);
 
-  if (EVP_DigestSignFinal(mdctx.get(), nullptr, &signature_len_) != 1) {
+  if (EVP_DigestSignFinal(mdctx.get(), nullptr, &signature_len) != 1) {
     throw errors::RuntimeException("Digest computation failed");
   }
 
-  DCHECK(signature_len_ <= signature_->tailroom());
-  signature_->setLength(signature_len_);
+  DCHECK(signature_len <= signature.tailroom());
+  signature.setLength(signature_len);
 
-  if (EVP_DigestSignFinal(mdctx.get(), signature_->writableData(),
-                          &signature_len_) != 1) {
+  if (EVP_DigestSignFinal(mdctx.get(), signature.writableData(),
+                          &signature_len) != 1) {
     throw errors::RuntimeException("Digest computation failed");
   }
 
-  DCHECK(signature_len_ <= signature_->tailroom());
-  signature_->setLength(signature_len_);
+  DCHECK(signature_len <= signature.tailroom());
+  signature.setLength(signature_len);
+
+  return signature_len;
 }
 
 const utils::MemBuf::Ptr &Signer::getSignature() const { return signature_; }
@@ -339,7 +339,8 @@ bool SymmetricVerifier::verifyBuffer(const std::vector<uint8_t> &buffer,
   const utils::MemBuf::Ptr &signature_bis =
       core::PacketManager<>::getInstance().getMemBuf();
   signature_bis->append(signature->length());
-  size_t signature_bis_len;
+  size_t signature_bis_len =
+      signature_bis->length() + signature_bis->tailroom();
   std::shared_ptr<EVP_MD_CTX> mdctx(EVP_MD_CTX_create(), EVP_MD_CTX_free);
 
   if (mdctx == nullptr) {
@@ -377,7 +378,8 @@ bool SymmetricVerifier::verifyBuffer(const utils::MemBuf *buffer,
   const utils::MemBuf::Ptr &signature_bis =
       core::PacketManager<>::getInstance().getMemBuf();
   signature_bis->append(signature->length());
-  size_t signature_bis_len;
+  size_t signature_bis_len =
+      signature_bis->length() + signature_bis->tailroom();
   std::shared_ptr<EVP_MD_CTX> mdctx(EVP_MD_CTX_create(), EVP_MD_CTX_free);
 
   if (mdctx == nullptr) {
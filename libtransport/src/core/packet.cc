@@ -26,6 +26,7 @@ TRANSPORT_CLANG_DISABLE_WARNING("-Wextern-c-compat")
 #endif
 #include <hicn/base.h>
 #include <hicn/error.h>
+#include <hicn/util/checksum.h>
 }
 
 namespace transport {
@@ -285,13 +286,17 @@ void Packet::setChecksum() {
     throw errors::RuntimeException(
         "Error setting getting packet header length.");
 
-  uint16_t partial_csum = csum(data() + header_len, length() - header_len, 0);
+  hicn_csum_state_t state;
+  hicn_csum_init(&state, 0);
+  hicn_csum_update(&state, data() + header_len, length() - header_len);
 
   for (utils::MemBuf *current = next(); current != this;
        current = current->next()) {
-    partial_csum = csum(current->data(), current->length(), ~partial_csum);
+    hicn_csum_update(&state, current->data(), current->length());
   }
 
+  uint16_t partial_csum = hicn_csum_final(&state);
+
   if (hicn_packet_compute_header_checksum(&pkbuf_, partial_csum) < 0) {
     throw errors::MalformedPacketException();
   }
@@ -303,13 +308,17 @@ bool Packet::checkIntegrity() const {
     throw errors::RuntimeException(
         "Error setting getting packet header length.");
 
-  uint16_t partial_csum = csum(data() + header_len, length() - header_len, 0);
+  hicn_csum_state_t state;
+  hicn_csum_init(&state, 0);
+  hicn_csum_update(&state, data() + header_len, length() - header_len);
 
   for (const utils::MemBuf *current = next(); current != this;
        current = current->next()) {
-    partial_csum = csum(current->data(), current->length(), ~partial_csum);
+    hicn_csum_update(&state, current->data(), current->length());
   }
 
+  uint16_t partial_csum = hicn_csum_final(&state);
+
   if (hicn_packet_check_integrity_no_payload(&pkbuf_, partial_csum) < 0) {
     return false;
   }
@@ -23,6 +23,7 @@
 #include <hicn/transport/interfaces/portal.h>
 #include <hicn/transport/portability/portability.h>
 #include <utils/deadline_timer.h>
+#include <utils/timing_wheel.h>
 
 namespace transport {
 
@@ -43,26 +44,35 @@ class PendingInterest {
  public:
   using Ptr = utils::ObjectPool<PendingInterest>::Ptr;
 
-  PendingInterest(asio::io_service &io_service, const Interest::Ptr &interest)
-      : interest_(interest), timer_(io_service) {}
+  PendingInterest() : timer_(utils::TimingWheel::INVALID_HANDLE) {}
 
-  PendingInterest(asio::io_service &io_service, const Interest::Ptr &interest,
+  explicit PendingInterest(const Interest::Ptr &interest)
+      : interest_(interest), timer_(utils::TimingWheel::INVALID_HANDLE) {}
+
+  PendingInterest(const Interest::Ptr &interest,
                   OnContentObjectCallback &&on_content_object,
                   OnInterestTimeoutCallback &&on_interest_timeout)
       : interest_(interest),
-        timer_(io_service),
+        timer_(utils::TimingWheel::INVALID_HANDLE),
         on_content_object_callback_(std::move(on_content_object)),
         on_interest_timeout_callback_(std::move(on_interest_timeout)) {}
 
   ~PendingInterest() = default;
 
-  template <typename Handler>
-  void startCountdown(uint32_t lifetime, Handler &&cb) {
-    timer_.expires_from_now(std::chrono::milliseconds(lifetime));
-    timer_.async_wait(std::forward<Handler>(cb));
+  /**
+   * Start the countdown of the interest lifetime on the portal timing wheel,
+   * cancelling the previous one if any.
+   */
+  void startCountdown(utils::TimingWheel &timers, uint32_t lifetime,
+                      uint64_t data) {
+    timers.cancel(timer_);
+    timer_ = timers.schedule(std::chrono::milliseconds(lifetime), data);
   }
 
-  void cancelTimer() { timer_.cancel(); }
+  void cancelTimer(utils::TimingWheel &timers) {
+    timers.cancel(timer_);
+    timer_ = utils::TimingWheel::INVALID_HANDLE;
+  }
 
   Interest::Ptr &&getInterest() { return std::move(interest_); }
 
@@ -89,7 +99,7 @@ class PendingInterest {
 
  private:
   Interest::Ptr interest_;
-  asio::steady_timer timer_;
+  utils::TimingWheel::Handle timer_;
   OnContentObjectCallback on_content_object_callback_;
   OnInterestTimeoutCallback on_interest_timeout_callback_;
 };
@@ -30,12 +30,11 @@
 #include <hicn/transport/interfaces/portal.h>
 #include <hicn/transport/portability/portability.h>
 #include <hicn/transport/utils/event_thread.h>
-#include <hicn/transport/utils/fixed_block_allocator.h>
+#include <utils/flat_hash_table.h>
 
 #include <future>
 #include <memory>
 #include <queue>
-#include <unordered_map>
 
 namespace libconfig {
 class Setting;
@@ -48,110 +47,11 @@ namespace portal_details {
 
 static constexpr uint32_t pit_size = 1024;
 
-class HandlerMemory {
-#ifdef __vpp__
- public:
-  HandlerMemory() {}
-
-  HandlerMemory(const HandlerMemory &) = delete;
-  HandlerMemory &operator=(const HandlerMemory &) = delete;
-
-  void *allocate(std::size_t /* size */) {
-    return utils::FixedBlockAllocator<128, 8192>::getInstance().allocateBlock();
-  }
-
-  void deallocate(void *pointer) {
-    utils::FixedBlockAllocator<128, 8192>::getInstance().deallocateBlock(
-        pointer);
-  }
-#else
- public:
-  HandlerMemory() {}
-
-  HandlerMemory(const HandlerMemory &) = delete;
-  HandlerMemory &operator=(const HandlerMemory &) = delete;
-
-  void *allocate(std::size_t size) { return ::operator new(size); }
-
-  void deallocate(void *pointer) { ::operator delete(pointer); }
-#endif
-};
-
-// The allocator to be associated with the handler objects. This allocator only
-// needs to satisfy the C++11 minimal allocator requirements.
-template <typename T>
-class HandlerAllocator {
- public:
-  using value_type = T;
-
-  explicit HandlerAllocator(HandlerMemory &mem) : memory_(mem) {}
-
-  template <typename U>
-  HandlerAllocator(const HandlerAllocator<U> &other) noexcept
-      : memory_(other.memory_) {}
-
-  bool operator==(const HandlerAllocator &other) const noexcept {
-    return &memory_ == &other.memory_;
-  }
-
-  bool operator!=(const HandlerAllocator &other) const noexcept {
-    return &memory_ != &other.memory_;
-  }
-
-  T *allocate(std::size_t n) const {
-    return static_cast<T *>(memory_.allocate(sizeof(T) * n));
-  }
-
-  void deallocate(T *p, std::size_t /*n*/) const {
-    return memory_.deallocate(p);
-  }
-
- private:
-  template <typename>
-  friend class HandlerAllocator;
-
-  // The underlying memory.
-  HandlerMemory &memory_;
-};
-
-// Wrapper class template for handler objects to allow handler memory
-// allocation to be customised. The allocator_type type and get_allocator()
-// member function are used by the asynchronous operations to obtain the
-// allocator. Calls to operator() are forwarded to the encapsulated handler.
-template <typename Handler>
-class CustomAllocatorHandler {
- public:
-  using allocator_type = HandlerAllocator<Handler>;
-
-  CustomAllocatorHandler(HandlerMemory &m, Handler h)
-      : memory_(m), handler_(h) {}
-
-  allocator_type get_allocator() const noexcept {
-    return allocator_type(memory_);
-  }
-
-  template <typename... Args>
-  void operator()(Args &&...args) {
-    handler_(std::forward<Args>(args)...);
-  }
-
- private:
-  HandlerMemory &memory_;
-  Handler handler_;
-};
-
-// Helper function to wrap a handler object to add custom allocation.
-template <typename Handler>
-inline CustomAllocatorHandler<Handler> makeCustomAllocatorHandler(
-    HandlerMemory &m, Handler h) {
-  return CustomAllocatorHandler<Handler>(m, h);
-}
-
 }  // namespace portal_details
 
 class PortalConfiguration;
 
-using PendingInterestHashTable = std::unordered_map<uint32_t, PendingInterest>;
+using PendingInterestHashTable = ::utils::FlatHashTable<PendingInterest>;
 
 /**
  * Portal is a opaque class which is used for sending/receiving interest/data
@@ -280,6 +180,16 @@ class Portal : public ::utils::NonCopyable,
             },
             worker_.getIoService(), app_name_);
 
+        if (is_consumer) {
+          // Interest lifetimes are all managed by a single timing wheel
+          interest_timers_ = ::utils::TimingWheel::createShared(
+              worker_.getIoService(), [self](uint64_t data) {
+                if (auto ptr = self.lock()) {
+                  ptr->timerHandler(uint32_t(data >> 32), uint32_t(data));
+                }
+              });
+        }
+
         io_module_->connect(is_consumer);
         is_consumer_ = is_consumer;
       }
@@ -327,12 +237,10 @@ class Portal : public ::utils::NonCopyable,
     uint32_t counter = 0;
     // Set timers
     do {
-      auto pend_int = pending_interest_hash_table_.try_emplace(
-          hash, worker_.getIoService(), interest);
+      auto pend_int = pending_interest_hash_table_.try_emplace(hash, interest);
       PendingInterest &pending_interest = pend_int.first->second;
       if (!pend_int.second) {
         // element was already in map
-        pend_int.first->second.cancelTimer();
         pending_interest.setInterest(interest);
       }
 
@@ -342,19 +250,9 @@ class Portal : public ::utils::NonCopyable,
           std::move(on_interest_timeout_callback));
 
       if (is_consumer_) {
-        auto self = weak_from_this();
-        pending_interest.startCountdown(
-            lifetime, portal_details::makeCustomAllocatorHandler(
-                          async_callback_memory_,
-                          [self, hash, seq](const std::error_code &ec) {
-                            if (TRANSPORT_EXPECT_FALSE(ec.operator bool())) {
-                              return;
-                            }
-
-                            if (auto ptr = self.lock()) {
-                              ptr->timerHandler(hash, seq);
-                            }
-                          }));
+        // The countdown of an interest already in the map is restarted
+        pending_interest.startCountdown(*interest_timers_, lifetime,
+                                        (uint64_t(hash) << 32) | seq);
       }
 
       if (suffix) {
@@ -372,7 +270,9 @@ class Portal : public ::utils::NonCopyable,
       DLOG_IF(INFO, VLOG_IS_ON(3)) << "Found pending interest.";
 
       PendingInterest &pend_interest = it->second;
-      pend_interest.cancelTimer();
+      if (is_consumer_) {
+        pend_interest.cancelTimer(*interest_timers_);
+      }
       auto _int = pend_interest.getInterest();
       auto callback = pend_interest.getOnDataCallback();
       pending_interest_hash_table_.erase(it);
@@ -538,8 +438,8 @@ class Portal : public ::utils::NonCopyable,
    * Clear the pending interest hash table.
    */
   void doClear() {
-    for (auto &pend_interest : pending_interest_hash_table_) {
-      pend_interest.second.cancelTimer();
+    if (interest_timers_) {
+      interest_timers_->clear();
     }
 
     pending_interest_hash_table_.clear();
@@ -671,7 +571,6 @@ class Portal : public ::utils::NonCopyable,
   }
 
  private:
-  portal_details::HandlerMemory async_callback_memory_;
   std::unique_ptr<IoModule> io_module_;
 
   ::utils::EventThread &worker_;
@@ -679,6 +578,7 @@ class Portal : public ::utils::NonCopyable,
   std::string app_name_;
 
   PendingInterestHashTable pending_interest_hash_table_;
+  std::shared_ptr<::utils::TimingWheel> interest_timers_;
   std::set<Prefix> served_namespaces_;
 
   TransportCallback *transport_callback_;
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/shm_connector.h>
+#include <glog/logging.h>
+#include <hicn/transport/utils/branch_prediction.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace transport {
+
+namespace core {
+
+ShmConnector::~ShmConnector() { doClose(); }
+
+void ShmConnector::connect(std::uint16_t port) {
+  if (state_ != State::CLOSED) {
+    return;
+  }
+
+  state_ = State::CONNECTING;
+  port_ = port;
+
+  if (!createRegion()) {
+    LOG(ERROR) << "Error in SHM connector: cannot create the memory region: "
+               << strerror(errno);
+    state_ = State::CLOSED;
+    return;
+  }
+
+  if (!doConnect()) {
+    retryConnection();
+  }
+}
+
+bool ShmConnector::createRegion() {
+  region_fd_ = memfd_create("hicn-shm", MFD_CLOEXEC);
+  if (region_fd_ < 0) {
+    return false;
+  }
+
+  if (ftruncate(region_fd_, HICN_SHM_REGION_SIZE) < 0) {
+    return false;
+  }
+
+  void *region = mmap(nullptr, HICN_SHM_REGION_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, region_fd_, 0);
+  if (region == MAP_FAILED) {
+    return false;
+  }
+
+  region_ = static_cast<hicn_shm_region_t *>(region);
+  hicn_shm_region_init(region_);
+  tx_head_ = 0;
+  return true;
+}
+
+bool ShmConnector::doConnect() {
+  struct sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+
+  // Abstract namespace, see hicn-light io/shm.c
+  int len = snprintf(addr.sun_path + 1, sizeof(addr.sun_path) - 1,
+                     HICN_SHM_SOCKET_NAME, port_);
+  socklen_t addr_len = offsetof(struct sockaddr_un, sun_path) + 1 + len;
+
+  int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+
+  if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), addr_len) <
+      0) {
+    ::close(fd);
+    return false;
+  }
+
+  // Pass the region to the forwarder
+  char byte = 0;
+  struct iovec iov = {&byte, sizeof(byte)};
+  union {
+    char buf[CMSG_SPACE(sizeof(int))];
+    struct cmsghdr align;
+  } control = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &region_fd_, sizeof(int));
+
+  if (::sendmsg(fd, &msg, 0) < 0) {
+    ::close(fd);
+    return false;
+  }
+
+  std::error_code ec;
+  socket_.assign(fd, ec);
+  if (ec) {
+    ::close(fd);
+    return false;
+  }
+  socket_.non_blocking(true, ec);
+
+  state_ = State::CONNECTED;
+  doRecvPacket();
+
+  if (data_available_) {
+    data_available_ = false;
+    writeHandler();
+  }
+
+  on_reconnect_callback_(this, make_error_code(core_error::success));
+  return true;
+}
+
+void ShmConnector::retryConnection() {
+  if (connection_reattempts_++ >= max_reconnection_reattempts) {
+    LOG(ERROR) << "Error in SHM connector: cannot connect to the forwarder.";
+    state_ = State::CLOSED;
+    return;
+  }
+
+  LOG(ERROR) << "Error in SHM connector: connection refused. Retrying...";
+  timer_.expires_from_now(std::chrono::milliseconds(500));
+  std::weak_ptr<ShmConnector> self = shared_from_this();
+  timer_.async_wait([self](const std::error_code &ec) {
+    if (ec) {
+      return;
+    }
+    if (auto ptr = self.lock()) {
+      if (!ptr->doConnect()) {
+        ptr->retryConnection();
+      }
+    }
+  });
+}
+
+void ShmConnector::send(Packet &packet) { send(packet.shared_from_this()); }
+
+void ShmConnector::send(const utils::MemBuf::Ptr &buffer) {
+  auto self = shared_from_this();
+  io_service_.post([self, buffer]() {
+    bool write_in_progress = !self->output_buffer_.empty();
+    self->output_buffer_.push_back(std::move(buffer));
+    if (TRANSPORT_EXPECT_TRUE(self->state_ == State::CONNECTED)) {
+      // Let the packets posted meanwhile be published together
+      if (!write_in_progress) {
+        self->io_service_.post([self]() { self->writeHandler(); });
+      }
+    } else {
+      self->data_available_ = true;
+    }
+  });
+}
+
+void ShmConnector::notify() {
+  char byte = 0;
+  // A full socket already holds a pending notification
+  ::send(socket_.native_handle(), &byte, sizeof(byte),
+         MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+void ShmConnector::writeHandler() {
+  if (TRANSPORT_EXPECT_FALSE(state_ != State::CONNECTED)) {
+    return;
+  }
+
+  uint8_t linear[HICN_SHM_BUFFER_SIZE];
+
+  while (!output_buffer_.empty()) {
+    auto &packet = output_buffer_.front();
+    const uint8_t *data = packet->data();
+    std::size_t length = packet->length();
+
+    if (packet->isChained()) {
+      length = packet->computeChainDataLength();
+      if (length > sizeof(linear)) {
+        sendFailed();
+        output_buffer_.pop_front();
+        continue;
+      }
+
+      std::size_t offset = 0;
+      const utils::MemBuf *current = packet.get();
+      do {
+        std::memcpy(linear + offset, current->data(), current->length());
+        offset += current->length();
+        current = current->next();
+      } while (current != packet.get());
+      data = linear;
+    }
+
+    if (hicn_shm_ring_push(region_, HICN_SHM_RING_TO_FWD, &tx_head_, data,
+                           length) < 0) {
+      if (length > HICN_SHM_BUFFER_SIZE) {
+        sendFailed();
+        output_buffer_.pop_front();
+        continue;
+      }
+      // Ring full
+      break;
+    }
+
+    sendSuccess(*packet);
+    output_buffer_.pop_front();
+  }
+
+  if (hicn_shm_ring_publish(region_, HICN_SHM_RING_TO_FWD, tx_head_)) {
+    notify();
+  }
+
+  if (!output_buffer_.empty()) {
+    send_timer_.expires_from_now(std::chrono::microseconds(50));
+    std::weak_ptr<ShmConnector> self = shared_from_this();
+    send_timer_.async_wait([self](const std::error_code &ec) {
+      if (ec) {
+        return;
+      }
+      if (auto ptr = self.lock()) {
+        ptr->writeHandler();
+      }
+    });
+  } else {
+    sent_callback_(this, make_error_code(core_error::success));
+  }
+}
+
+void ShmConnector::doRecvPacket() {
+  std::weak_ptr<ShmConnector> self = shared_from_this();
+  socket_.async_wait(asio::posix::stream_descriptor::wait_read,
+                     [self](const std::error_code &ec) {
+                       if (ec) {
+                         if (ec.value() !=
+                             static_cast<int>(std::errc::operation_canceled)) {
+                           LOG(ERROR) << "Error in SHM connector: "
+                                      << ec.value() << " " << ec.message();
+                         }
+                         return;
+                       }
+                       if (auto ptr = self.lock()) {
+                         ptr->readHandler();
+                       }
+                     });
+}
+
+void ShmConnector::readHandler() {
+  DLOG_IF(INFO, VLOG_IS_ON(3)) << "ShmConnector receive packets";
+
+  if (TRANSPORT_EXPECT_FALSE(state_ != State::CONNECTED)) {
+    return;
+  }
+
+  // Drain the notifications, and detect the closure of the forwarder
+  char buf[64];
+  ssize_t n;
+  while ((n = ::recv(socket_.native_handle(), buf, sizeof(buf),
+                     MSG_DONTWAIT)) > 0) {
+  }
+
+  if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+    LOG(ERROR) << "Error in SHM connector: the forwarder closed the face.";
+    std::vector<utils::MemBuf::Ptr> v;
+    receive_callback_(this, v, make_error_code(core_error::receive_failed));
+    return;
+  }
+
+  // Check the ring again after releasing, before going back to sleep
+  std::uint32_t available;
+  while ((available = hicn_shm_ring_available(
+              region_, HICN_SHM_RING_FROM_FWD)) > 0) {
+    std::vector<utils::MemBuf::Ptr> v;
+    v.reserve(std::min(available, std::uint32_t(max_burst)));
+
+    std::uint32_t i;
+    for (i = 0; i < available && i < max_burst; i++) {
+      std::size_t length;
+      const uint8_t *packet =
+          hicn_shm_ring_peek(region_, HICN_SHM_RING_FROM_FWD, i, &length);
+      if (TRANSPORT_EXPECT_FALSE(!packet)) {
+        continue;
+      }
+
+      auto read_buffer = getRawBuffer();
+      if (TRANSPORT_EXPECT_FALSE(length > read_buffer.second)) {
+        continue;
+      }
+      std::memcpy(read_buffer.first, packet, length);
+
+      auto buffer = getPacketFromBuffer(read_buffer.first, length);
+      receiveSuccess(*buffer);
+      v.push_back(std::move(buffer));
+    }
+    hicn_shm_ring_release(region_, HICN_SHM_RING_FROM_FWD, i);
+
+    receive_callback_(this, v, make_error_code(core_error::success));
+    if (state_ != State::CONNECTED) {
+      return;
+    }
+  }
+
+  doRecvPacket();
+}
+
+void ShmConnector::close() {
+  DLOG_IF(INFO, VLOG_IS_ON(2)) << "ShmConnector::close";
+  state_ = State::CLOSED;
+
+  // The rings might still be in use by the caller, unmap them later
+  auto self = shared_from_this();
+  io_service_.post([self]() { self->doClose(); });
+}
+
+void ShmConnector::doClose() {
+  state_ = State::CLOSED;
+
+  std::error_code ec;
+  timer_.cancel(ec);
+  send_timer_.cancel(ec);
+
+  // Closing the socket removes the face in the forwarder
+  if (socket_.is_open()) {
+    socket_.close(ec);
+  }
+
+  if (region_) {
+    munmap(region_, HICN_SHM_REGION_SIZE);
+    region_ = nullptr;
+  }
+
+  if (region_fd_ >= 0) {
+    ::close(region_fd_);
+    region_fd_ = -1;
+  }
+}
+
+}  // namespace core
+
+}  // namespace transport
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <core/errors.h>
+#include <hicn/transport/core/asio_wrapper.h>
+#include <hicn/transport/core/connector.h>
+#include <hicn/transport/portability/platform.h>
+
+extern "C" {
+#include <hicn/util/shm_ring.h>
+}
+
+namespace transport {
+
+namespace core {
+
+/**
+ * Connector to a local hicn-light forwarder through a shared memory face.
+ *
+ * The connector creates the memory region holding the packet rings and
+ * passes it to the forwarder over a UNIX socket, which is then used for
+ * notifications only: packets are exchanged through the rings, without
+ * crossing the kernel.
+ */
+class ShmConnector : public Connector {
+ public:
+  template <typename ReceiveCallback, typename SentCallback, typename OnClose,
+            typename OnReconnect>
+  ShmConnector(asio::io_service &io_service, ReceiveCallback &&receive_callback,
+               SentCallback &&packet_sent, OnClose &&on_close_callback,
+               OnReconnect &&on_reconnect)
+      : Connector(receive_callback, packet_sent, on_close_callback,
+                  on_reconnect),
+        io_service_(io_service),
+        socket_(io_service_),
+        timer_(io_service_),
+        send_timer_(io_service_),
+        region_fd_(-1),
+        region_(nullptr),
+        tx_head_(0),
+        port_(0),
+        data_available_(false) {}
+
+  ~ShmConnector() override;
+
+  void send(Packet &packet) override;
+
+  void send(const utils::MemBuf::Ptr &buffer) override;
+
+  void close() override;
+
+  /**
+   * Connect to the forwarder listening on the specified port.
+   */
+  void connect(std::uint16_t port);
+
+  auto shared_from_this() { return utils::shared_from(this); }
+
+ private:
+  bool createRegion();
+  bool doConnect();
+  void retryConnection();
+  void doRecvPacket();
+  void readHandler();
+  void writeHandler();
+  void notify();
+  void doClose();
+
+ private:
+  asio::io_service &io_service_;
+  asio::posix::stream_descriptor socket_;
+  asio::steady_timer timer_;
+  asio::steady_timer send_timer_;
+
+  int region_fd_;
+  hicn_shm_region_t *region_;
+  /* Private head of the ring towards the forwarder */
+  std::uint32_t tx_head_;
+
+  std::uint16_t port_;
+  bool data_available_;
+};
+
+}  // namespace core
+
+}  // namespace transport
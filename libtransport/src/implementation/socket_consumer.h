@@ -21,6 +21,7 @@
 #include <hicn/transport/interfaces/statistics.h>
 #include <hicn/transport/utils/event_thread.h>
 #include <implementation/socket.h>
+#include <protocols/bbr.h>
 #include <protocols/cbr.h>
 #include <protocols/raaqm.h>
 #include <protocols/rtc/rtc.h>
@@ -85,6 +86,10 @@ class ConsumerSocket : public Socket {
         transport_protocol_ =
             std::make_shared<protocol::rtc::RTCTransportProtocol>(this);
         break;
+      case TransportProtocolAlgorithms::BBR:
+        transport_protocol_ =
+            std::make_shared<protocol::BbrTransportProtocol>(this);
+        break;
       case TransportProtocolAlgorithms::RAAQM:
       default:
         transport_protocol_ =
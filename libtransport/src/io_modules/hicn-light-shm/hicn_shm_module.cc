@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/shm_connector.h>
+#include <io_modules/hicn-light-shm/hicn_shm_module.h>
+
+namespace transport {
+
+namespace core {
+
+HicnShmModule::HicnShmModule() : HicnForwarderModule() {}
+
+HicnShmModule::~HicnShmModule() {}
+
+void HicnShmModule::connect(bool is_consumer) {
+  std::static_pointer_cast<ShmConnector>(connector_)->connect(forwarder_port);
+  connector_->setRole(is_consumer ? Connector::Role::CONSUMER
+                                  : Connector::Role::PRODUCER);
+}
+
+void HicnShmModule::init(Connector::PacketReceivedCallback &&receive_callback,
+                         Connector::PacketSentCallback &&sent_callback,
+                         Connector::OnCloseCallback &&close_callback,
+                         Connector::OnReconnectCallback &&reconnect_callback,
+                         asio::io_service &io_service,
+                         const std::string &app_name) {
+  if (!connector_) {
+    connector_.reset(new ShmConnector(
+        io_service, std::move(receive_callback), std::move(sent_callback),
+        std::move(close_callback), std::move(reconnect_callback)));
+  }
+}
+
+extern "C" IoModule *create_module(void) { return new HicnShmModule(); }
+
+}  // namespace core
+
+}  // namespace transport
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021-2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <io_modules/hicn-light/hicn_forwarder_module.h>
+
+namespace transport {
+
+namespace core {
+
+/**
+ * Module connecting to a local hicn-light forwarder through a shared memory
+ * face instead of a UDP one. Control messages are the same.
+ */
+class HicnShmModule : public HicnForwarderModule {
+ public:
+  HicnShmModule();
+
+  ~HicnShmModule();
+
+  void connect(bool is_consumer) override;
+
+  void init(Connector::PacketReceivedCallback &&receive_callback,
+            Connector::PacketSentCallback &&sent_callback,
+            Connector::OnCloseCallback &&close_callback,
+            Connector::OnReconnectCallback &&reconnect_callback,
+            asio::io_service &io_service,
+            const std::string &app_name = "Libtransport") override;
+};
+
+extern "C" IoModule *create_module(void);
+
+}  // namespace core
+
+}  // namespace transport
@@ -30,7 +30,8 @@ HicnForwarderModule::HicnForwarderModule()
 HicnForwarderModule::~HicnForwarderModule() {}
 
 void HicnForwarderModule::connect(bool is_consumer) {
-  connector_->connect("localhost", 9695);
+  std::static_pointer_cast<UdpTunnelConnector>(connector_)->connect(
+      "localhost", forwarder_port);
   connector_->setRole(is_consumer ? Connector::Role::CONSUMER
                                   : Connector::Role::PRODUCER);
 }
@@ -256,7 +257,9 @@ utils::MemBuf::Ptr HicnForwarderModule::createCommandSetForwardingStrategy(
   return ret;
 }
 
+#ifndef HICN_FORWARDER_MODULE_NO_FACTORY
 extern "C" IoModule *create_module(void) { return new HicnForwarderModule(); }
+#endif
 
 }  // namespace core
 
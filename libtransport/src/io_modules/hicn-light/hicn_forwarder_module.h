@@ -86,6 +86,10 @@ class HicnForwarderModule : public IoModule {
 
   void closeConnection() override;
 
+ protected:
+  /* Port of the local forwarder */
+  static constexpr std::uint16_t forwarder_port = 9695;
+
  private:
   utils::MemBuf::Ptr createCommandRoute(std::unique_ptr<sockaddr> &&addr,
                                         uint8_t prefix_length);
@@ -95,14 +99,17 @@ class HicnForwarderModule : public IoModule {
       std::unique_ptr<sockaddr> &&addr, uint32_t prefix_len,
       std::string strategy);
 
- private:
-  std::shared_ptr<UdpTunnelConnector> connector_;
+ protected:
+  std::shared_ptr<Connector> connector_;
 
+ private:
   /* Sequence number used for sending control messages */
   uint32_t seq_;
 };
 
+#ifndef HICN_FORWARDER_MODULE_NO_FACTORY
 extern "C" IoModule *create_module(void);
+#endif
 
 }  // namespace core
 
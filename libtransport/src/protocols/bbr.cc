@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <implementation/socket_consumer.h>
+#include <protocols/bbr.h>
+
+#include <algorithm>
+
+namespace transport {
+
+namespace protocol {
+
+using namespace interface;
+
+BbrTransportProtocol::BbrTransportProtocol(
+    implementation::ConsumerSocket *icnet_socket)
+    : RaaqmTransportProtocol(icnet_socket),
+      state_(State::STARTUP),
+      pacing_gain_(kHighGain),
+      cwnd_gain_(kHighGain),
+      delivered_(0),
+      packet_size_(0),
+      round_count_(0),
+      next_round_delivered_(0),
+      round_start_(false),
+      loss_in_round_(false),
+      btl_bw_(0),
+      min_rtt_(utils::SteadyTime::Microseconds::max()),
+      filled_pipe_(false),
+      full_bw_(0),
+      full_bw_count_(0),
+      cycle_index_(0),
+      prior_cwnd_(kInitialCwnd),
+      probe_rtt_round_done_(false),
+      pacing_rate_(0) {}
+
+BbrTransportProtocol::~BbrTransportProtocol() {}
+
+void BbrTransportProtocol::reset() {
+  RaaqmTransportProtocol::reset();
+
+  auto now = utils::SteadyTime::Clock::now();
+
+  // The model is rebuilt for every download
+  enterStartup();
+  current_window_size_ = kInitialCwnd;
+  socket_->setSocketOption(GeneralTransportOptions::CURRENT_WINDOW_SIZE,
+                           current_window_size_);
+
+  delivered_ = 0;
+  delivered_time_ = now;
+  first_sent_time_ = now;
+  packet_size_ = 0;
+
+  round_count_ = 0;
+  next_round_delivered_ = 0;
+  round_start_ = false;
+  loss_in_round_ = false;
+
+  bw_samples_.fill(0);
+  btl_bw_ = 0;
+
+  min_rtt_ = utils::SteadyTime::Microseconds::max();
+  min_rtt_stamp_ = now;
+
+  filled_pipe_ = false;
+  full_bw_ = 0;
+  full_bw_count_ = 0;
+
+  prior_cwnd_ = kInitialCwnd;
+  probe_rtt_done_stamp_ = utils::SteadyTime::TimePoint();
+  probe_rtt_round_done_ = false;
+
+  pacing_rate_ = 0;
+}
+
+void BbrTransportProtocol::afterDataUnsatisfied(uint64_t segment) {
+  // The window follows the model and is not cut on losses, which are only
+  // used to end the bandwidth probing phase
+  loss_in_round_ = true;
+}
+
+void BbrTransportProtocol::afterContentReception(
+    const Interest &interest, const ContentObject &content_object) {
+  updatePathTable(content_object);
+
+  auto segment = content_object.getName().getSuffix();
+  auto now = utils::SteadyTime::Clock::now();
+  auto rtt = utils::SteadyTime::getDurationUs(
+      interest_timepoints_[segment & mask], now);
+
+  cur_path_->insertNewRtt(rtt, now);
+
+  onDelivery(segment,
+             content_object.payloadSize() + content_object.headerSize(), rtt,
+             now);
+
+  // Expose the model
+  stats_->updateBottleneckBandwidth(btl_bw_ * 8);
+  stats_->updateMinRtt(min_rtt_);
+  stats_->updatePacingRate(pacing_rate_ * 8);
+  stats_->updateCCState(static_cast<int>(state_));
+  updateStats(segment, rtt, now);
+}
+
+void BbrTransportProtocol::sendInterest(
+    const Name &interest_name,
+    std::array<uint32_t, MAX_AGGREGATED_INTEREST> *additional_suffixes,
+    uint32_t len) {
+  saveSendState(interest_name.getSuffix(), utils::SteadyTime::Clock::now());
+  RaaqmTransportProtocol::sendInterest(interest_name, additional_suffixes,
+                                       len);
+}
+
+void BbrTransportProtocol::saveSendState(
+    uint32_t segment, const utils::SteadyTime::TimePoint &now) {
+  if (interests_in_flight_ == 0) {
+    // Restart from idle: do not let the idle time count in the next sample
+    delivered_time_ = first_sent_time_ = now;
+  }
+
+  send_state_[segment & mask] = {delivered_, delivered_time_, first_sent_time_};
+}
+
+double BbrTransportProtocol::pacingRate() {
+  return packet_size_ > 0 ? pacing_rate_ / packet_size_ : 0;
+}
+
+void BbrTransportProtocol::onDelivery(
+    uint32_t segment, std::size_t bytes,
+    const utils::SteadyTime::Microseconds &rtt,
+    const utils::SteadyTime::TimePoint &now) {
+  updateModel(segment, bytes, rtt, now);
+  updateState(now);
+  updateControl();
+}
+
+void BbrTransportProtocol::updateModel(
+    uint32_t segment, std::size_t bytes,
+    const utils::SteadyTime::Microseconds &rtt,
+    const utils::SteadyTime::TimePoint &now) {
+  const SendState &sent = send_state_[segment & mask];
+  auto send_time = interest_timepoints_[segment & mask];
+
+  packet_size_ = packet_size_ == 0 ? double(bytes)
+                                   : (1. - kPacketSizeAlpha) * packet_size_ +
+                                         kPacketSizeAlpha * double(bytes);
+  delivered_ += bytes;
+  delivered_time_ = now;
+  first_sent_time_ = send_time;
+
+  // A round ends when an interest sent after its start is satisfied
+  round_start_ = false;
+  if (sent.delivered >= next_round_delivered_) {
+    next_round_delivered_ = delivered_;
+    round_count_++;
+    round_start_ = true;
+    loss_in_round_ = false;
+    bw_samples_[round_count_ % kBwFilterRounds] = 0;
+  }
+
+  // Min RTT
+  bool min_rtt_expired = now > min_rtt_stamp_ + kMinRttWindow;
+  if (rtt <= min_rtt_ || min_rtt_expired) {
+    min_rtt_ = rtt;
+    min_rtt_stamp_ = now;
+  }
+
+  if (min_rtt_expired && state_ != State::PROBE_RTT) {
+    enterProbeRtt();
+  }
+
+  // Delivery rate over the longest of the send and receive intervals, which
+  // is never shorter than the min RTT when the sample is meaningful
+  double send_elapsed =
+      std::chrono::duration<double>(send_time - sent.first_sent_time).count();
+  double ack_elapsed =
+      std::chrono::duration<double>(now - sent.delivered_time).count();
+  double interval = std::max(send_elapsed, ack_elapsed);
+  double min_rtt = std::chrono::duration<double>(min_rtt_).count();
+
+  if (interval <= 0 || interval < min_rtt) {
+    return;
+  }
+
+  double rate = double(delivered_ - sent.delivered) / interval;
+  double &sample = bw_samples_[round_count_ % kBwFilterRounds];
+  sample = std::max(sample, rate);
+  btl_bw_ = *std::max_element(bw_samples_.begin(), bw_samples_.end());
+}
+
+void BbrTransportProtocol::updateState(
+    const utils::SteadyTime::TimePoint &now) {
+  switch (state_) {
+    case State::STARTUP:
+      checkFullPipe();
+      if (filled_pipe_) {
+        // Drain the queue built during startup
+        state_ = State::DRAIN;
+        pacing_gain_ = 1. / kHighGain;
+        cwnd_gain_ = kHighGain;
+      }
+      break;
+    case State::DRAIN:
+      if (interests_in_flight_ <= targetInFlight(1.)) {
+        enterProbeBw(now);
+      }
+      break;
+    case State::PROBE_BW:
+      if (isNextCyclePhase(now)) {
+        cycle_index_ = (cycle_index_ + 1) % kCycleLength;
+        cycle_stamp_ = now;
+        pacing_gain_ = kPacingGainCycle[cycle_index_];
+      }
+      break;
+    case State::PROBE_RTT:
+      handleProbeRtt(now);
+      break;
+  }
+}
+
+void BbrTransportProtocol::updateControl() {
+  double min_window_size = 0.;
+  double max_window_size = 0.;
+  socket_->getSocketOption(GeneralTransportOptions::MIN_WINDOW_SIZE,
+                           min_window_size);
+  socket_->getSocketOption(GeneralTransportOptions::MAX_WINDOW_SIZE,
+                           max_window_size);
+
+  double cwnd = current_window_size_;
+  if (btl_bw_ > 0) {
+    double target = targetInFlight(cwnd_gain_);
+    if (filled_pipe_) {
+      cwnd = std::min(cwnd + 1, target);
+    } else if (cwnd < target || delivered_ < kInitialCwnd * packet_size_) {
+      cwnd += 1;
+    }
+  }
+
+  cwnd = std::max(cwnd, kMinCwnd);
+  if (state_ == State::PROBE_RTT) {
+    cwnd = std::min(cwnd, kMinCwnd);
+  }
+
+  current_window_size_ =
+      std::max(min_window_size, std::min(max_window_size, cwnd));
+  socket_->setSocketOption(GeneralTransportOptions::CURRENT_WINDOW_SIZE,
+                           current_window_size_);
+
+  // The first rate paces the initial window over the first RTT. Until the
+  // pipe is full the rate is only increased, so that the low estimates of the
+  // first rounds do not slow down the startup.
+  double rate = pacing_gain_ * btl_bw_;
+  if (pacing_rate_ == 0) {
+    rate = std::max(rate, kHighGain * current_window_size_ * packet_size_ /
+                              std::chrono::duration<double>(min_rtt_).count());
+  }
+
+  if (filled_pipe_ || rate > pacing_rate_) {
+    pacing_rate_ = rate;
+  }
+}
+
+void BbrTransportProtocol::enterStartup() {
+  state_ = State::STARTUP;
+  pacing_gain_ = kHighGain;
+  cwnd_gain_ = kHighGain;
+}
+
+void BbrTransportProtocol::enterProbeBw(
+    const utils::SteadyTime::TimePoint &now) {
+  state_ = State::PROBE_BW;
+  cwnd_gain_ = kProbeBwCwndGain;
+
+  // Start from a random phase, except the one draining the queue
+  std::uniform_int_distribution<unsigned> dist(0, kCycleLength - 2);
+  cycle_index_ = dist(gen_);
+  if (cycle_index_ >= 1) {
+    cycle_index_++;
+  }
+
+  cycle_stamp_ = now;
+  pacing_gain_ = kPacingGainCycle[cycle_index_];
+}
+
+void BbrTransportProtocol::enterProbeRtt() {
+  state_ = State::PROBE_RTT;
+  pacing_gain_ = 1.;
+  cwnd_gain_ = 1.;
+  prior_cwnd_ = current_window_size_;
+  probe_rtt_done_stamp_ = utils::SteadyTime::TimePoint();
+}
+
+void BbrTransportProtocol::checkFullPipe() {
+  if (filled_pipe_ || !round_start_) {
+    return;
+  }
+
+  if (btl_bw_ >= full_bw_ * kFullBwThreshold) {
+    full_bw_ = btl_bw_;
+    full_bw_count_ = 0;
+    return;
+  }
+
+  if (++full_bw_count_ >= kFullBwRounds) {
+    filled_pipe_ = true;
+  }
+}
+
+bool BbrTransportProtocol::isNextCyclePhase(
+    const utils::SteadyTime::TimePoint &now) {
+  bool full_length = now - cycle_stamp_ > min_rtt_;
+
+  if (pacing_gain_ > 1.) {
+    return full_length &&
+           (loss_in_round_ ||
+            interests_in_flight_ >= targetInFlight(pacing_gain_));
+  }
+
+  if (pacing_gain_ < 1.) {
+    return full_length || interests_in_flight_ <= targetInFlight(1.);
+  }
+
+  return full_length;
+}
+
+void BbrTransportProtocol::handleProbeRtt(
+    const utils::SteadyTime::TimePoint &now) {
+  if (probe_rtt_done_stamp_ == utils::SteadyTime::TimePoint()) {
+    if (interests_in_flight_ <= kMinCwnd) {
+      // Hold the minimum window for a round and at least kProbeRttDuration
+      probe_rtt_done_stamp_ = now + kProbeRttDuration;
+      probe_rtt_round_done_ = false;
+      next_round_delivered_ = delivered_;
+    }
+    return;
+  }
+
+  if (round_start_) {
+    probe_rtt_round_done_ = true;
+  }
+
+  if (probe_rtt_round_done_ && now > probe_rtt_done_stamp_) {
+    min_rtt_stamp_ = now;
+    current_window_size_ = std::max(current_window_size_, prior_cwnd_);
+    if (filled_pipe_) {
+      enterProbeBw(now);
+    } else {
+      enterStartup();
+    }
+  }
+}
+
+utils::SteadyTime::Microseconds BbrTransportProtocol::pathRtt() {
+  auto rtt = min_rtt_;
+
+  // Propagation delay of the slowest path, in milliseconds
+  for (auto &path : path_table_) {
+    unsigned int pd = path.second->getPropagationDelay();
+    if (pd != UINT_MAX && !path.second->isStale()) {
+      rtt = std::max(rtt, utils::SteadyTime::Microseconds(pd * 1000ULL));
+    }
+  }
+
+  return rtt;
+}
+
+double BbrTransportProtocol::targetInFlight(double gain) {
+  if (btl_bw_ == 0 || min_rtt_ == utils::SteadyTime::Microseconds::max()) {
+    return kInitialCwnd;
+  }
+
+  double bdp = btl_bw_ * std::chrono::duration<double>(pathRtt()).count();
+  return gain * bdp / packet_size_;
+}
+
+}  // end namespace protocol
+
+}  // end namespace transport
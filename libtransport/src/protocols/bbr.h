@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <protocols/raaqm.h>
+
+namespace transport {
+
+namespace protocol {
+
+/**
+ * Model-based congestion control in the style of BBR. Instead of reacting to
+ * delay variations, the consumer builds a model of the path made of its
+ * bottleneck bandwidth (windowed max of the delivery rate) and of its
+ * propagation delay (windowed min of the RTT), and sends interests at the
+ * bottleneck rate with about one BDP of them in flight.
+ *
+ * Per-path RTTs are still tracked in the RAAQM path table, so that on
+ * multipath the window covers the slowest path in use.
+ */
+class BbrTransportProtocol : public RaaqmTransportProtocol {
+ public:
+  enum class State : uint8_t { STARTUP, DRAIN, PROBE_BW, PROBE_RTT };
+
+  BbrTransportProtocol(implementation::ConsumerSocket *icnet_socket);
+
+  ~BbrTransportProtocol();
+
+  using RaaqmTransportProtocol::start;
+  using RaaqmTransportProtocol::stop;
+
+  void reset() override;
+
+ protected:
+  /**
+   * Delivery state at the time an interest is sent, used to compute the
+   * delivery rate when its data comes back.
+   */
+  struct SendState {
+    uint64_t delivered;
+    utils::SteadyTime::TimePoint delivered_time;
+    utils::SteadyTime::TimePoint first_sent_time;
+  };
+
+  static constexpr double kHighGain = 2.885;  // 2 / ln(2)
+  static constexpr double kProbeBwCwndGain = 2.;
+  static constexpr unsigned kCycleLength = 8;
+  static constexpr double kPacingGainCycle[kCycleLength] = {
+      1.25, 0.75, 1., 1., 1., 1., 1., 1.};
+  static constexpr unsigned kBwFilterRounds = 10;
+  static constexpr unsigned kFullBwRounds = 3;
+  static constexpr double kFullBwThreshold = 1.25;
+  static constexpr double kMinCwnd = 4.;
+  static constexpr double kInitialCwnd = 10.;
+  static constexpr double kPacketSizeAlpha = 0.125;
+  static constexpr std::chrono::seconds kMinRttWindow{10};
+  static constexpr std::chrono::milliseconds kProbeRttDuration{200};
+
+  void afterContentReception(const Interest &interest,
+                             const ContentObject &content_object) override;
+  void afterDataUnsatisfied(uint64_t segment) override;
+  void sendInterest(const Name &interest_name,
+                    std::array<uint32_t, MAX_AGGREGATED_INTEREST>
+                        *additional_suffixes = nullptr,
+                    uint32_t len = 0) override;
+  double pacingRate() override;
+
+  /**
+   * @brief Save the delivery state at the time the interest for segment is
+   * sent.
+   */
+  void saveSendState(uint32_t segment, const utils::SteadyTime::TimePoint &now);
+
+  /**
+   * @brief Update the model and the controls with the delivery of segment.
+   */
+  void onDelivery(uint32_t segment, std::size_t bytes,
+                  const utils::SteadyTime::Microseconds &rtt,
+                  const utils::SteadyTime::TimePoint &now);
+
+  void updateModel(uint32_t segment, std::size_t bytes,
+                   const utils::SteadyTime::Microseconds &rtt,
+                   const utils::SteadyTime::TimePoint &now);
+  void updateState(const utils::SteadyTime::TimePoint &now);
+  void updateControl();
+
+  void enterStartup();
+  void enterProbeBw(const utils::SteadyTime::TimePoint &now);
+  void enterProbeRtt();
+  void checkFullPipe();
+  bool isNextCyclePhase(const utils::SteadyTime::TimePoint &now);
+  void handleProbeRtt(const utils::SteadyTime::TimePoint &now);
+
+  /**
+   * RTT used for the BDP: the min RTT of the model, or the largest one of the
+   * paths currently delivering data.
+   */
+  utils::SteadyTime::Microseconds pathRtt();
+
+  /**
+   * @brief Data in flight, in interests, needed to fill the pipe scaled by
+   * gain.
+   */
+  double targetInFlight(double gain);
+
+  State state_;
+  double pacing_gain_;
+  double cwnd_gain_;
+
+  // Delivery rate estimation
+  std::array<SendState, buffer_size> send_state_;
+  uint64_t delivered_;
+  utils::SteadyTime::TimePoint delivered_time_;
+  utils::SteadyTime::TimePoint first_sent_time_;
+  double packet_size_;
+
+  // Round trips, counted in deliveries of interests sent in the previous round
+  uint64_t round_count_;
+  uint64_t next_round_delivered_;
+  bool round_start_;
+  bool loss_in_round_;
+
+  // Bottleneck bandwidth in bytes per second, max over kBwFilterRounds rounds
+  std::array<double, kBwFilterRounds> bw_samples_;
+  double btl_bw_;
+
+  // Min RTT, expiring after kMinRttWindow
+  utils::SteadyTime::Microseconds min_rtt_;
+  utils::SteadyTime::TimePoint min_rtt_stamp_;
+
+  // Startup
+  bool filled_pipe_;
+  double full_bw_;
+  unsigned full_bw_count_;
+
+  // Probe bandwidth
+  unsigned cycle_index_;
+  utils::SteadyTime::TimePoint cycle_stamp_;
+
+  // Probe RTT
+  double prior_cwnd_;
+  utils::SteadyTime::TimePoint probe_rtt_done_stamp_;
+  bool probe_rtt_round_done_;
+
+  // Pacing rate in bytes per second, zero until the first RTT sample
+  double pacing_rate_;
+};
+
+}  // end namespace protocol
+
+}  // end namespace transport
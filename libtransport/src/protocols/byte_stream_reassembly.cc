@@ -22,25 +22,39 @@
 #include <protocols/indexer.h>
 #include <protocols/transport_protocol.h>
 
+#include <algorithm>
+
 namespace transport {
 
 namespace protocol {
 
 using namespace core;
-using ReadCallback = interface::ConsumerSocket::ReadCallback;
 
 ByteStreamReassembly::ByteStreamReassembly(
     implementation::ConsumerSocket *icn_socket,
     TransportProtocol *transport_protocol)
     : Reassembly(icn_socket, transport_protocol),
+      received_packets_(kReceivedPacketsSize),
       index_(Indexer::invalid_index),
-      download_complete_(false) {}
+      download_complete_(false),
+      read_callback_(nullptr),
+      direct_placement_(false),
+      application_buffer_(nullptr),
+      application_buffer_size_(0),
+      application_buffer_used_(0),
+      pending_length_(0),
+      max_buffer_size_(0) {}
 
 void ByteStreamReassembly::reassemble(ContentObject &content_object) {
+  // The last segment is left in the table once copied: retransmissions
+  // received after it would copy it again
+  if (TRANSPORT_EXPECT_FALSE(download_complete_)) {
+    return;
+  }
+
   if (TRANSPORT_EXPECT_TRUE(read_buffer_->capacity())) {
-    received_packets_.emplace(
-        std::make_pair(content_object.getName().getSuffix(),
-                       content_object.shared_from_this()));
+    received_packets_.try_emplace(content_object.getName().getSuffix(),
+                                  content_object.shared_from_this());
     assembleContent();
   }
 }
@@ -83,25 +97,32 @@ bool ByteStreamReassembly::copyContent(ContentObject &content_object) {
 
   utils::MemBuf *current = &content_object;
 
-  do {
-    auto payload_length = current->length();
-    auto write_size = std::min(payload_length, read_buffer_->tailroom());
-    auto additional_bytes = payload_length > read_buffer_->tailroom()
-                                ? payload_length - read_buffer_->tailroom()
-                                : 0;
-
-    std::memcpy(read_buffer_->writableTail(), current->data(), write_size);
-    read_buffer_->append(write_size);
-
-    if (!read_buffer_->tailroom()) {
-      notifyApplication();
-      std::memcpy(read_buffer_->writableTail(), current->data() + write_size,
-                  additional_bytes);
-      read_buffer_->append(additional_bytes);
-    }
+  if (direct_placement_) {
+    do {
+      copyToApplication(current->data(), current->length());
+      current = current->next();
+    } while (current != &content_object);
+  } else {
+    do {
+      auto payload_length = current->length();
+      auto write_size = std::min(payload_length, read_buffer_->tailroom());
+      auto additional_bytes = payload_length > read_buffer_->tailroom()
+                                  ? payload_length - read_buffer_->tailroom()
+                                  : 0;
+
+      std::memcpy(read_buffer_->writableTail(), current->data(), write_size);
+      read_buffer_->append(write_size);
+
+      if (!read_buffer_->tailroom()) {
+        notifyApplication();
+        std::memcpy(read_buffer_->writableTail(), current->data() + write_size,
+                    additional_bytes);
+        read_buffer_->append(additional_bytes);
+      }
 
-    current = current->next();
-  } while (current != &content_object);
+      current = current->next();
+    } while (current != &content_object);
+  }
 
   download_complete_ = indexer_verifier_->getFinalSuffix() ==
                        content_object.getName().getSuffix();
@@ -116,19 +137,72 @@ bool ByteStreamReassembly::copyContent(ContentObject &content_object) {
   return ret;
 }
 
+void ByteStreamReassembly::copyToApplication(const uint8_t *data,
+                                             std::size_t length) {
+  while (length) {
+    if (application_buffer_used_ == application_buffer_size_) {
+      application_buffer_ = nullptr;
+      application_buffer_size_ = 0;
+      application_buffer_used_ = 0;
+      read_callback_->getReadBuffer(&application_buffer_,
+                                    &application_buffer_size_);
+
+      if (!application_buffer_ || !application_buffer_size_) {
+        throw errors::RuntimeException(
+            "Invalid buffer provided by the application.");
+      }
+    }
+
+    auto to_copy =
+        std::min({length, application_buffer_size_ - application_buffer_used_,
+                  max_buffer_size_ - pending_length_});
+    std::memcpy(application_buffer_ + application_buffer_used_, data,
+                to_copy);
+    application_buffer_used_ += to_copy;
+    pending_length_ += to_copy;
+    data += to_copy;
+    length -= to_copy;
+
+    if (pending_length_ == max_buffer_size_) {
+      notifyApplication();
+    }
+  }
+}
+
+void ByteStreamReassembly::notifyApplication() {
+  if (!direct_placement_) {
+    Reassembly::notifyApplication();
+    return;
+  }
+
+  // The next bytes go to a new buffer, as with the read buffer
+  auto length = pending_length_;
+  pending_length_ = 0;
+  application_buffer_ = nullptr;
+  application_buffer_size_ = 0;
+  application_buffer_used_ = 0;
+
+  read_callback_->readDataAvailable(length);
+}
+
 void ByteStreamReassembly::reInitialize() {
   index_ = Indexer::invalid_index;
   download_complete_ = false;
 
   received_packets_.clear();
 
-  // reset read buffer
-  ReadCallback *read_callback;
+  application_buffer_ = nullptr;
+  application_buffer_size_ = 0;
+  application_buffer_used_ = 0;
+  pending_length_ = 0;
 
+  // reset read buffer
   if (reassembly_consumer_socket_) {
     reassembly_consumer_socket_->getSocketOption(
-        interface::ConsumerCallbacksOptions::READ_CALLBACK, &read_callback);
-    read_buffer_ = utils::MemBuf::create(read_callback->maxBufferSize());
+        interface::ConsumerCallbacksOptions::READ_CALLBACK, &read_callback_);
+    max_buffer_size_ = read_callback_->maxBufferSize();
+    direct_placement_ = !read_callback_->isBufferMovable();
+    read_buffer_ = utils::MemBuf::create(max_buffer_size_);
   }
 }
 
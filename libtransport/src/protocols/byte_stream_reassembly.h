@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <hicn/transport/interfaces/socket_consumer.h>
 #include <protocols/reassembly.h>
+#include <utils/flat_hash_table.h>
 
 namespace transport {
 
@@ -35,13 +37,36 @@ class ByteStreamReassembly : public Reassembly {
 
   virtual void reInitialize() override;
 
+  /**
+   * With an application providing its own buffers, payloads are copied there
+   * directly; the application is notified once maxBufferSize() bytes were
+   * written, as when they go through the read buffer.
+   */
+  void notifyApplication() override;
+
  private:
   void assembleContent();
 
+  void copyToApplication(const uint8_t *data, std::size_t length);
+
  protected:
-  std::unordered_map<std::uint32_t, core::ContentObject::Ptr> received_packets_;
+  // Out of order segments, indexed by suffix. Consecutive suffixes land in
+  // consecutive buckets, and no memory is allocated once the table is large
+  // enough for the segments in flight.
+  ::utils::FlatHashTable<core::ContentObject::Ptr> received_packets_;
   uint32_t index_;
   bool download_complete_;
+
+  // Direct placement into the buffers of the application
+  interface::ConsumerSocket::ReadCallback *read_callback_;
+  bool direct_placement_;
+  uint8_t *application_buffer_;
+  std::size_t application_buffer_size_;
+  std::size_t application_buffer_used_;
+  std::size_t pending_length_;
+  std::size_t max_buffer_size_;
+
+  static constexpr std::size_t kReceivedPacketsSize = 1024;
 };
 
 }  // namespace protocol
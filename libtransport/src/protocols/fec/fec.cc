@@ -50,6 +50,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /**
  * XXX This disable a warning raising only in some platforms.
  * TODO Check if this warning is a mistake or it is a real bug:
@@ -151,6 +157,14 @@ static gf gf_mul_table[GF_SIZE + 1][GF_SIZE + 1];
 
 #define gf_mul(x, y) gf_mul_table[x][y]
 
+#if (GF_BITS == 8)
+/*
+ * Products of each element by the 16 values of a nibble, low ([0]) and high
+ * ([1]), used by the vectorized versions of addmul1().
+ */
+alignas(16) static gf gf_mul_split[GF_SIZE + 1][2][16];
+#endif
+
 #define USE_GF_MULC gf *__gf_mulc_
 #define GF_MULC0(c) __gf_mulc_ = gf_mul_table[c]
 #define GF_ADDMULC(dst, x) dst ^= __gf_mulc_[x]
@@ -162,6 +176,14 @@ static void init_mul_table() {
       gf_mul_table[i][j] = gf_exp[modnn(gf_log[i] + gf_log[j])];
 
   for (j = 0; j < GF_SIZE + 1; j++) gf_mul_table[0][j] = gf_mul_table[j][0] = 0;
+
+#if (GF_BITS == 8)
+  for (i = 0; i < GF_SIZE + 1; i++)
+    for (j = 0; j < 16; j++) {
+      gf_mul_split[i][0][j] = gf_mul_table[i][j];
+      gf_mul_split[i][1][j] = gf_mul_table[i][j << 4];
+    }
+#endif
 }
 #else /* GF_BITS > 8 */
 static inline gf gf_mul(x, y) {
@@ -281,7 +303,7 @@ static void generate_gf(void) {
  * Note that gcc on
  */
 #define addmul(dst, src, c, sz) \
-  if (c != 0) addmul1(dst, src, c, sz)
+  if (c != 0) addmul_impl(dst, src, c, sz)
 
 #define UNROLL 16 /* 1, 4, 8, 16 */
 static void addmul1(gf *dst1, gf *src1, gf c, int sz) {
@@ -320,6 +342,147 @@ static void addmul1(gf *dst1, gf *src1, gf c, int sz) {
     GF_ADDMULC(*dst, *src);
 }
 
+/*
+ * Vectorized versions of addmul1() for GF(2^8), using split tables: as
+ * multiplication distributes over addition, c * x = c * (x & 0x0f) ^
+ * c * (x & 0xf0), and both terms are looked up in 16 entry tables with a
+ * byte shuffle instruction, 16 to 64 bytes at a time. The results are the
+ * same as with the scalar version, which handles the remaining bytes.
+ */
+#if (GF_BITS == 8)
+#if defined(__x86_64__) || defined(__i386__)
+#define FEC_ADDMUL_X86
+
+__attribute__((target("ssse3"))) static void addmul_ssse3(gf *dst, gf *src,
+                                                          gf c, int sz) {
+  int i = 0;
+
+  __m128i tlo = _mm_load_si128((const __m128i *)gf_mul_split[c][0]);
+  __m128i thi = _mm_load_si128((const __m128i *)gf_mul_split[c][1]);
+  __m128i mask = _mm_set1_epi8(0x0f);
+
+  for (; i + 16 <= sz; i += 16) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i l = _mm_shuffle_epi8(tlo, _mm_and_si128(x, mask));
+    __m128i h =
+        _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_xor_si128(d, _mm_xor_si128(l, h)));
+  }
+
+  if (i < sz) addmul1(dst + i, src + i, c, sz - i);
+}
+
+__attribute__((target("avx2"))) static void addmul_avx2(gf *dst, gf *src, gf c,
+                                                        int sz) {
+  int i = 0;
+
+  __m256i tlo = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)gf_mul_split[c][0]));
+  __m256i thi = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)gf_mul_split[c][1]));
+  __m256i mask = _mm256_set1_epi8(0x0f);
+
+  for (; i + 32 <= sz; i += 32) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i l = _mm256_shuffle_epi8(tlo, _mm256_and_si256(x, mask));
+    __m256i h = _mm256_shuffle_epi8(
+        thi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    _mm256_storeu_si256((__m256i *)(dst + i),
+                        _mm256_xor_si256(d, _mm256_xor_si256(l, h)));
+  }
+
+  if (i < sz) addmul1(dst + i, src + i, c, sz - i);
+}
+
+/*
+ * The AVX-512 intrinsics of some GCC versions trigger spurious warnings:
+ * https://gcc.gnu.org/bugzilla/show_bug.cgi?id=105593
+ */
+#ifndef __clang__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+__attribute__((target("avx512f,avx512bw"))) static void addmul_avx512(
+    gf *dst, gf *src, gf c, int sz) {
+  int i = 0;
+
+  __m512i tlo = _mm512_broadcast_i32x4(
+      _mm_load_si128((const __m128i *)gf_mul_split[c][0]));
+  __m512i thi = _mm512_broadcast_i32x4(
+      _mm_load_si128((const __m128i *)gf_mul_split[c][1]));
+  __m512i mask = _mm512_set1_epi8(0x0f);
+
+  for (; i + 64 <= sz; i += 64) {
+    __m512i x = _mm512_loadu_si512((const void *)(src + i));
+    __m512i l = _mm512_shuffle_epi8(tlo, _mm512_and_si512(x, mask));
+    __m512i h = _mm512_shuffle_epi8(
+        thi, _mm512_and_si512(_mm512_srli_epi64(x, 4), mask));
+    __m512i d = _mm512_loadu_si512((const void *)(dst + i));
+    /* 0x96 is the truth table of a three-way xor */
+    _mm512_storeu_si512((void *)(dst + i),
+                        _mm512_ternarylogic_epi64(d, l, h, 0x96));
+  }
+
+  if (i < sz) addmul1(dst + i, src + i, c, sz - i);
+}
+#ifndef __clang__
+#pragma GCC diagnostic pop
+#endif
+#endif /* __x86_64__ || __i386__ */
+
+#if defined(__aarch64__)
+#define FEC_ADDMUL_NEON
+
+static void addmul_neon(gf *dst, gf *src, gf c, int sz) {
+  int i = 0;
+
+  uint8x16_t tlo = vld1q_u8(gf_mul_split[c][0]);
+  uint8x16_t thi = vld1q_u8(gf_mul_split[c][1]);
+  uint8x16_t mask = vdupq_n_u8(0x0f);
+
+  for (; i + 16 <= sz; i += 16) {
+    uint8x16_t x = vld1q_u8(src + i);
+    uint8x16_t l = vqtbl1q_u8(tlo, vandq_u8(x, mask));
+    uint8x16_t h = vqtbl1q_u8(thi, vshrq_n_u8(x, 4));
+    vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), veorq_u8(l, h)));
+  }
+
+  if (i < sz) addmul1(dst + i, src + i, c, sz - i);
+}
+#endif /* __aarch64__ */
+#endif /* GF_BITS == 8 */
+
+typedef void (*addmul_fn)(gf *dst, gf *src, gf c, int sz);
+
+/* Indexed by fec_addmul_t, NULL if not built for this architecture */
+static const struct {
+  const char *name;
+  addmul_fn fn;
+} addmul_impls[FEC_ADDMUL_N] = {
+    {"scalar", addmul1},
+#ifdef FEC_ADDMUL_X86
+    {"ssse3", addmul_ssse3},
+    {"avx2", addmul_avx2},
+    {"avx512", addmul_avx512},
+#else
+    {"ssse3", NULL},
+    {"avx2", NULL},
+    {"avx512", NULL},
+#endif
+#ifdef FEC_ADDMUL_NEON
+    {"neon", addmul_neon},
+#else
+    {"neon", NULL},
+#endif
+};
+
+static fec_addmul_t addmul_type = FEC_ADDMUL_SCALAR;
+static addmul_fn addmul_impl = addmul1;
+
 /*
  * computes C = AB where A is n*k, B is k*m, C is n*m
  */
@@ -532,13 +695,74 @@ int invert_vdm(gf *src, int k) {
   return 0;
 }
 
+int fec_addmul_supported(fec_addmul_t type) {
+  if (type < 0 || type >= FEC_ADDMUL_N || addmul_impls[type].fn == NULL)
+    return 0;
+
+#ifdef FEC_ADDMUL_X86
+  switch (type) {
+    case FEC_ADDMUL_SSSE3:
+      return __builtin_cpu_supports("ssse3");
+    case FEC_ADDMUL_AVX2:
+      return __builtin_cpu_supports("avx2");
+    case FEC_ADDMUL_AVX512:
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("avx512bw");
+    default:
+      break;
+  }
+#endif
+  return 1;
+}
+
+/*
+ * Implementations picked by default, by order of preference. AVX-512 is left
+ * out as it is no faster than AVX2 on packet-sized buffers, and may lower
+ * the clock frequency of the core.
+ */
+static const fec_addmul_t addmul_preferred[] = {
+    FEC_ADDMUL_NEON,
+    FEC_ADDMUL_AVX2,
+    FEC_ADDMUL_SSSE3,
+};
+
 static int fec_initialized = 0;
 static void init_fec() {
+  unsigned i;
+
   generate_gf();
   init_mul_table();
+
+  addmul_type = FEC_ADDMUL_SCALAR;
+  for (i = 0; i < sizeof(addmul_preferred) / sizeof(addmul_preferred[0]); i++)
+    if (fec_addmul_supported(addmul_preferred[i])) {
+      addmul_type = addmul_preferred[i];
+      break;
+    }
+  addmul_impl = addmul_impls[addmul_type].fn;
+
   fec_initialized = 1;
 }
 
+int fec_set_addmul(fec_addmul_t type) {
+  if (fec_initialized == 0) init_fec();
+  if (!fec_addmul_supported(type)) return -1;
+
+  addmul_type = type;
+  addmul_impl = addmul_impls[type].fn;
+  return 0;
+}
+
+fec_addmul_t fec_get_addmul() {
+  if (fec_initialized == 0) init_fec();
+  return addmul_type;
+}
+
+const char *fec_addmul_name(fec_addmul_t type) {
+  if (type < 0 || type >= FEC_ADDMUL_N) return "unknown";
+  return addmul_impls[type].name;
+}
+
 /*
  * This section contains the proper FEC encoding/decoding routines.
  * The encoding matrix is computed starting with a Vandermonde matrix,
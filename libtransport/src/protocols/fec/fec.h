@@ -62,4 +62,24 @@ struct fec_parms *fec_new(int k, int n);
 void fec_encode(struct fec_parms *code, gf *src[], gf *fec, int index, int sz);
 int fec_decode(struct fec_parms *code, gf *pkt[], int index[], int sz);
 
+/*
+ * Implementations of the multiply-accumulate over packets on which encoding
+ * and decoding rely, all giving the same results. The fastest one supported
+ * by the CPU is selected on initialization; the others are available for
+ * tests and benchmarks.
+ */
+typedef enum {
+  FEC_ADDMUL_SCALAR,
+  FEC_ADDMUL_SSSE3,
+  FEC_ADDMUL_AVX2,
+  FEC_ADDMUL_AVX512,
+  FEC_ADDMUL_NEON,
+  FEC_ADDMUL_N,
+} fec_addmul_t;
+
+int fec_addmul_supported(fec_addmul_t type);
+int fec_set_addmul(fec_addmul_t type); /* -1 if not supported */
+fec_addmul_t fec_get_addmul();
+const char *fec_addmul_name(fec_addmul_t type);
+
 /* end of file */
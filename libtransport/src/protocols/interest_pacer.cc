@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <protocols/interest_pacer.h>
+
+#include <algorithm>
+
+namespace transport {
+
+namespace protocol {
+
+InterestPacer::InterestPacer(asio::io_service &io_service)
+    : timer_(io_service),
+      rate_(0),
+      tokens_(0),
+      bucket_size_(0),
+      tick_(kMinTick),
+      last_refill_(Clock::now()) {}
+
+InterestPacer::~InterestPacer() { timer_.cancel(); }
+
+void InterestPacer::setRate(double rate) {
+  auto now = Clock::now();
+  refill(now);
+
+  if (rate <= 0) {
+    rate_ = 0;
+    return;
+  }
+
+  bool paced = rate_ > 0;
+  rate_ = rate;
+  tick_ = std::max<Clock::duration>(
+      kMinTick, std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(1. / rate_)));
+  double batch = rate_ * std::chrono::duration<double>(tick_).count();
+  bucket_size_ = 2. * std::max(1., batch);
+
+  // Pacing starts with a full bucket
+  tokens_ = paced ? std::min(tokens_, bucket_size_) : bucket_size_;
+}
+
+bool InterestPacer::ready() {
+  // Only read the clock once the tokens of the current batch are spent
+  if (rate_ == 0 || tokens_ >= 1.) {
+    return true;
+  }
+
+  refill(Clock::now());
+  return tokens_ >= 1.;
+}
+
+void InterestPacer::reset() {
+  rate_ = 0;
+  tokens_ = 0;
+  bucket_size_ = 0;
+  tick_ = kMinTick;
+  last_refill_ = Clock::now();
+  timer_.expires_at(Clock::time_point());
+}
+
+void InterestPacer::refill(const Clock::time_point &now) {
+  if (rate_ > 0) {
+    tokens_ = std::min(
+        bucket_size_,
+        tokens_ +
+            rate_ * std::chrono::duration<double>(now - last_refill_).count());
+  }
+
+  last_refill_ = now;
+}
+
+}  // end namespace protocol
+
+}  // end namespace transport
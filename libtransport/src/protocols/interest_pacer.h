@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <hicn/transport/core/asio_wrapper.h>
+#include <hicn/transport/utils/chrono_typedefs.h>
+#include <hicn/transport/utils/noncopyable.h>
+
+#include <chrono>
+
+namespace transport {
+
+namespace protocol {
+
+/**
+ * Token bucket spreading the interests of a window over time, so that the
+ * data they retrieve does not come back in bursts.
+ *
+ * Tokens are interests and are refilled at the pacing rate set by the
+ * protocol. When the bucket is empty the protocol waits for the next tick,
+ * which is at least kMinTick long: at high rates each tick releases a batch of
+ * rate * tick interests instead of waking up the thread for each of them. The
+ * bucket holds two batches, enough to absorb the lateness of the timer without
+ * allowing large bursts after idle periods.
+ *
+ * All methods must be called from the thread running the io_service.
+ */
+class InterestPacer : utils::NonCopyable {
+ public:
+  using Clock = utils::SteadyTime::Clock;
+
+  static constexpr std::chrono::microseconds kMinTick{100};
+
+  InterestPacer(asio::io_service &io_service);
+
+  ~InterestPacer();
+
+  /**
+   * @brief Sets the pacing rate, in interests per second. A rate of zero
+   * disables pacing.
+   */
+  void setRate(double rate);
+
+  double getRate() const { return rate_; }
+
+  /**
+   * @brief Tells whether the bucket holds a token for sending one interest.
+   * If not, no interest should be sent before the next tick, see asyncWait().
+   */
+  bool ready();
+
+  /**
+   * @brief Takes the token of an interest sent. Interests sent without
+   * checking ready() first, such as urgent retransmissions, leave the bucket
+   * in debt.
+   */
+  void consume() {
+    if (rate_ > 0) {
+      tokens_ -= 1.;
+    }
+  }
+
+  /**
+   * @brief Calls handler with an std::error_code at the next tick, unless a
+   * tick is already pending. The handler is called with
+   * asio::error::operation_aborted if the pacer is reset or destroyed.
+   */
+  template <typename Handler>
+  void asyncWait(Handler &&handler) {
+    auto now = Clock::now();
+    if (timer_.expiry() > now) {
+      return;
+    }
+
+    timer_.expires_at(now + tick_);
+    timer_.async_wait(std::forward<Handler>(handler));
+  }
+
+  /**
+   * @brief Disables pacing and cancels the pending tick.
+   */
+  void reset();
+
+ private:
+  void refill(const Clock::time_point &now);
+
+  asio::steady_timer timer_;
+  double rate_;
+  double tokens_;
+  double bucket_size_;
+  Clock::duration tick_;
+  Clock::time_point last_refill_;
+};
+
+}  // end namespace protocol
+
+}  // end namespace transport
@@ -27,7 +27,7 @@ using namespace implementation;
 
 ByteStreamProductionProtocol::ByteStreamProductionProtocol(
     implementation::ProducerSocket *icn_socket)
-    : ProductionProtocol(icn_socket) {}
+    : ProductionProtocol(icn_socket), next_worker_(0) {}
 
 ByteStreamProductionProtocol::~ByteStreamProductionProtocol() { stop(); }
 
@@ -93,6 +93,11 @@ uint32_t ByteStreamProductionProtocol::produceStream(
   socket_->getSocketOption(GeneralTransportOptions::PACKET_FORMAT,
                            default_format);
 
+  // Number of threads computing digests and signatures
+  uint32_t producer_threads;
+  socket_->getSocketOption(GeneralTransportOptions::PRODUCER_THREADS,
+                           producer_threads);
+
   Name name(content_name);
   size_t buffer_size = buffer->length();
   size_t signature_length = signer_->getSignatureFieldSize();
@@ -110,7 +115,6 @@ uint32_t ByteStreamProductionProtocol::produceStream(
   uint32_t manifest_header_size;
   uint64_t manifest_free_space;
   uint32_t nb_manifests;
-  std::shared_ptr<core::ContentObjectManifest> manifest;
   uint32_t manifest_capacity = manifest_max_capacity_;
   bool is_last_manifest = false;
   ParamsBytestream transport_params;
@@ -135,14 +139,8 @@ uint32_t ByteStreamProductionProtocol::produceStream(
     nb_segments++;
   }
 
-  if (manifest_max_capacity_) {
-    nb_manifests = static_cast<uint32_t>(
-        std::ceil(float(nb_segments) / manifest_capacity));
-    final_block_number += nb_segments + nb_manifests - 1;
-    transport_params.final_segment =
-        is_last ? final_block_number : utils::SuffixStrategy::MAX_SUFFIX;
-
-    manifest = ContentObjectManifest::createContentManifest(
+  auto createManifest = [&]() {
+    auto manifest = ContentObjectManifest::createContentManifest(
         manifest_format,
         name.setSuffix(suffix_strategy->getNextManifestSuffix()),
         signature_length);
@@ -151,45 +149,51 @@ uint32_t ByteStreamProductionProtocol::produceStream(
                          name);
     manifest->setParamsBytestream(transport_params);
     manifest->getPacket()->setLifetime(content_object_expiry_time);
+    return manifest;
+  };
+
+  Batch batch;
+  uint32_t batch_capacity = batch_size;
+
+  if (manifest_max_capacity_) {
+    nb_manifests = static_cast<uint32_t>(
+        std::ceil(float(nb_segments) / manifest_capacity));
+    final_block_number += nb_segments + nb_manifests - 1;
+    transport_params.final_segment =
+        is_last ? final_block_number : utils::SuffixStrategy::MAX_SUFFIX;
+
+    batch.manifest = createManifest();
+
+    // A manifest is sent as soon as it can't hold one more entry
+    batch_capacity = 1;
+    while (batch.manifest->Encoder::manifestSize(batch_capacity + 1) <=
+           manifest_free_space) {
+      batch_capacity++;
+    }
+  }
+
+  // Digests and signatures are computed by the worker threads, if any
+  if (producer_threads == 0) {
+    workers_.reset();
+  } else if (!workers_ || workers_->getNThreads() != producer_threads) {
+    workers_ = std::make_unique<utils::ThreadPool>(producer_threads);
+    next_worker_ = 0;
   }
 
   auto self = shared_from_this();
+  std::deque<Batch> in_progress;
   for (unsigned int packaged_segments = 0; packaged_segments < nb_segments;
        packaged_segments++) {
-    if (manifest_max_capacity_) {
-      if (manifest->Encoder::manifestSize(1) > manifest_free_space) {
-        manifest->encode();
-        auto manifest_co =
-            std::dynamic_pointer_cast<ContentObject>(manifest->getPacket());
-
-        signer_->signPacket(manifest_co.get());
-
-        // Send the current manifest
-        passContentObjectToCallbacks(manifest_co, self);
-        DLOG_IF(INFO, VLOG_IS_ON(3))
-            << "Send manifest " << manifest_co->getName();
-
-        // Send content objects stored in the queue
-        while (!content_queue_.empty()) {
-          passContentObjectToCallbacks(content_queue_.front(), self);
-          DLOG_IF(INFO, VLOG_IS_ON(3))
-              << "Send content " << content_queue_.front()->getName();
-          content_queue_.pop();
-        }
-
-        // Create new manifest. The reference to the last manifest has been
-        // acquired in the passContentObjectToCallbacks function, so we can
-        // safely release this reference.
-        manifest = ContentObjectManifest::createContentManifest(
-            manifest_format,
-            name.setSuffix(suffix_strategy->getNextManifestSuffix()),
-            signature_length);
-        manifest->setHeaders(core::ManifestType::INLINE_MANIFEST,
-                             manifest_max_capacity_, hash_algo,
-                             is_last_manifest, name);
-        manifest->setParamsBytestream(transport_params);
-        manifest->getPacket()->setLifetime(content_object_expiry_time);
+    if (batch.contents.size() == batch_capacity) {
+      // Create the next manifest before dispatching the current one, so that
+      // the manifest suffix is taken before the suffixes of its contents.
+      Batch next;
+      if (manifest_max_capacity_) {
+        next.manifest = createManifest();
       }
+
+      dispatchBatch(std::move(batch), hash_algo, in_progress, self);
+      batch = std::move(next);
     }
 
     // Create content object
@@ -221,42 +225,18 @@ uint32_t ByteStreamProductionProtocol::produceStream(
 
     // Set the segmented data as payload
     content_object->appendPayload(std::move(b));
-
-    // Either we sign the content object or we save its hash into the current
-    // manifest
-    if (manifest_max_capacity_) {
-      auth::CryptoHash hash = content_object->computeDigest(hash_algo);
-      manifest->addEntry(content_suffix, hash);
-      content_queue_.push(content_object);
-    } else {
-      signer_->signPacket(content_object.get());
-      passContentObjectToCallbacks(content_object, self);
-      DLOG_IF(INFO, VLOG_IS_ON(3))
-          << "Send content " << content_object->getName();
-    }
+    batch.contents.push_back(std::move(content_object));
   }
 
   // We send the manifest that hasn't been fully filled yet
-  if (manifest_max_capacity_) {
-    if (is_last_manifest) {
-      manifest->setIsLast(is_last_manifest);
-    }
-
-    manifest->encode();
-    auto manifest_co =
-        std::dynamic_pointer_cast<ContentObject>(manifest->getPacket());
-
-    signer_->signPacket(manifest_co.get());
-
-    passContentObjectToCallbacks(manifest_co, self);
-    DLOG_IF(INFO, VLOG_IS_ON(3)) << "Send manifest " << manifest_co->getName();
+  if (is_last_manifest) {
+    batch.manifest->setIsLast(is_last_manifest);
+  }
 
-    while (!content_queue_.empty()) {
-      passContentObjectToCallbacks(content_queue_.front(), self);
-      DLOG_IF(INFO, VLOG_IS_ON(3))
-          << "Send content " << content_queue_.front()->getName();
-      content_queue_.pop();
-    }
+  dispatchBatch(std::move(batch), hash_algo, in_progress, self);
+  while (!in_progress.empty()) {
+    sendBatch(in_progress.front(), self);
+    in_progress.pop_front();
   }
 
   portal_->getThread().add([this, self]() {
@@ -292,6 +272,81 @@ uint32_t ByteStreamProductionProtocol::produceStream(
   return suffix_strategy->getTotalCount();
 }
 
+void ByteStreamProductionProtocol::sealBatch(
+    auth::Signer &signer,
+    const std::shared_ptr<ContentObjectManifest> &manifest,
+    const std::vector<std::shared_ptr<ContentObject>> &contents,
+    auth::CryptoHashType hash_algo) {
+  // Either we sign the content objects or we save their hash into the
+  // manifest, which is then signed
+  if (!manifest) {
+    for (auto &content_object : contents) {
+      signer.signPacket(content_object.get());
+    }
+    return;
+  }
+
+  for (auto &content_object : contents) {
+    manifest->addEntry(content_object->getName().getSuffix(),
+                       content_object->computeDigest(hash_algo));
+  }
+
+  manifest->encode();
+  signer.signPacket(manifest->getPacket().get());
+}
+
+void ByteStreamProductionProtocol::dispatchBatch(
+    Batch &&batch, auth::CryptoHashType hash_algo,
+    std::deque<Batch> &in_progress,
+    const std::shared_ptr<ByteStreamProductionProtocol> &self) {
+  if (!workers_) {
+    sealBatch(*signer_, batch.manifest, batch.contents, hash_algo);
+    sendBatch(batch, self);
+    return;
+  }
+
+  // The batch is sealed by a worker while the next ones are being segmented.
+  // The task holds its own references to the packets, so that it never
+  // outlives them even if the production is interrupted by an exception.
+  auto task = std::make_shared<std::packaged_task<void()>>(
+      [signer = signer_, manifest = batch.manifest, contents = batch.contents,
+       hash_algo]() { sealBatch(*signer, manifest, contents, hash_algo); });
+  batch.sealed = task->get_future();
+  in_progress.push_back(std::move(batch));
+
+  workers_->getWorker(next_worker_).add([task]() { (*task)(); });
+  next_worker_ = (next_worker_ + 1) % workers_->getNThreads();
+
+  // Bound the number of batches in progress, sending the oldest one
+  while (in_progress.size() > batches_per_worker * workers_->getNThreads()) {
+    sendBatch(in_progress.front(), self);
+    in_progress.pop_front();
+  }
+}
+
+void ByteStreamProductionProtocol::sendBatch(
+    Batch &batch, const std::shared_ptr<ByteStreamProductionProtocol> &self) {
+  if (batch.sealed.valid()) {
+    // Rethrow the exceptions raised while hashing or signing
+    batch.sealed.get();
+  }
+
+  if (batch.manifest) {
+    auto manifest_co =
+        std::dynamic_pointer_cast<ContentObject>(batch.manifest->getPacket());
+
+    // Send the manifest before the content objects it references
+    passContentObjectToCallbacks(manifest_co, self);
+    DLOG_IF(INFO, VLOG_IS_ON(3)) << "Send manifest " << manifest_co->getName();
+  }
+
+  for (auto &content_object : batch.contents) {
+    passContentObjectToCallbacks(content_object, self);
+    DLOG_IF(INFO, VLOG_IS_ON(3))
+        << "Send content " << content_object->getName();
+  }
+}
+
 void ByteStreamProductionProtocol::scheduleSendBurst(
     const std::shared_ptr<ByteStreamProductionProtocol> &self) {
   portal_->getThread().add([this, self]() {
@@ -16,10 +16,13 @@
 #pragma once
 
 #include <hicn/transport/utils/ring_buffer.h>
+#include <hicn/transport/utils/thread_pool.h>
 #include <protocols/production_protocol.h>
 
 #include <atomic>
-#include <queue>
+#include <deque>
+#include <future>
+#include <vector>
 
 namespace transport {
 
@@ -29,6 +32,10 @@ using namespace core;
 
 class ByteStreamProductionProtocol : public ProductionProtocol {
   static constexpr uint32_t burst_size = 256;
+  // Number of content objects per batch when manifests are disabled
+  static constexpr uint32_t batch_size = 16;
+  // Number of batches per worker thread which may be in progress
+  static constexpr uint32_t batches_per_worker = 4;
 
  public:
   ByteStreamProductionProtocol(implementation::ProducerSocket *icn_socket);
@@ -58,6 +65,27 @@ class ByteStreamProductionProtocol : public ProductionProtocol {
   void onInterest(core::Interest &i) override;
 
  private:
+  /**
+   * A manifest and the content objects it references or, without manifests,
+   * a few consecutive content objects. Batches are hashed and signed
+   * independently of each other, and then sent in order.
+   */
+  struct Batch {
+    std::shared_ptr<ContentObjectManifest> manifest;
+    std::vector<std::shared_ptr<ContentObject>> contents;
+    std::future<void> sealed;
+  };
+
+  static void sealBatch(
+      auth::Signer &signer,
+      const std::shared_ptr<ContentObjectManifest> &manifest,
+      const std::vector<std::shared_ptr<ContentObject>> &contents,
+      auth::CryptoHashType hash_algo);
+  void dispatchBatch(Batch &&batch, auth::CryptoHashType hash_algo,
+                     std::deque<Batch> &in_progress,
+                     const std::shared_ptr<ByteStreamProductionProtocol> &self);
+  void sendBatch(Batch &batch,
+                 const std::shared_ptr<ByteStreamProductionProtocol> &self);
   void passContentObjectToCallbacks(
       const std::shared_ptr<ContentObject> &content_object,
       const std::shared_ptr<ByteStreamProductionProtocol> &self);
@@ -65,8 +93,10 @@ class ByteStreamProductionProtocol : public ProductionProtocol {
       const std::shared_ptr<ByteStreamProductionProtocol> &self);
 
  private:
-  // While manifests are being built, contents are stored in a queue
-  std::queue<std::shared_ptr<ContentObject>> content_queue_;
+  // Threads hashing and signing the batches, if enabled by the
+  // PRODUCER_THREADS socket option
+  std::unique_ptr<utils::ThreadPool> workers_;
+  std::size_t next_worker_;
   utils::CircularFifo<std::shared_ptr<ContentObject>, 2048>
       object_queue_for_callbacks_;
 };
@@ -36,10 +36,10 @@ RaaqmTransportProtocol::RaaqmTransportProtocol(
       current_window_size_(1),
       interests_in_flight_(0),
       cur_path_(nullptr),
+      schedule_interests_(true),
       t0_(utils::SteadyTime::Clock::now()),
       rate_estimator_(nullptr),
-      dis_(0, 1.0),
-      schedule_interests_(true) {
+      dis_(0, 1.0) {
   init();
 }
 
@@ -447,6 +447,8 @@ void RaaqmTransportProtocol::scheduleNextInterests() {
   core::Name *name;
   socket_->getSocketOption(GeneralTransportOptions::NETWORK_NAME, &name);
 
+  pacer_->setRate(pacingRate());
+
   if (TRANSPORT_EXPECT_FALSE(interests_in_flight_ >= current_window_size_ &&
                              interest_to_retransmit_.size() > 0)) {
     // send at least one interest if there are retransmissions to perform and
@@ -458,8 +460,9 @@ void RaaqmTransportProtocol::scheduleNextInterests() {
 
   uint32_t index = IndexManager::invalid_index;
 
-  // Send the interest needed for filling the window
-  while (interests_in_flight_ < current_window_size_) {
+  // Send the interest needed for filling the window, as fast as the pacer
+  // allows
+  while (interests_in_flight_ < current_window_size_ && pace()) {
     if (interest_to_retransmit_.size() > 0) {
       auto suffix = interest_to_retransmit_.front();
       sendInterest(name->setSuffix(suffix));
@@ -480,6 +483,15 @@ void RaaqmTransportProtocol::scheduleNextInterests() {
   }
 }
 
+double RaaqmTransportProtocol::pacingRate() {
+  double srtt = stats_->getAverageRtt();
+  if (srtt <= 0) {
+    return 0;
+  }
+
+  return pacing_gain * current_window_size_ * 1000. / srtt;
+}
+
 void RaaqmTransportProtocol::onContentReassembled(const std::error_code &ec) {
   rate_estimator_->onDownloadFinished();
   TransportProtocol::onContentReassembled(ec);
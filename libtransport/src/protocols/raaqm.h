@@ -46,6 +46,7 @@ class RaaqmTransportProtocol : public TransportProtocol,
   static constexpr uint32_t buffer_size =
       1 << interface::default_values::log_2_default_buffer_size;
   static constexpr uint16_t mask = buffer_size - 1;
+  static constexpr double pacing_gain = 1.25;
   using PathTable =
       std::unordered_map<uint32_t, std::unique_ptr<RaaqmDataPath>>;
 
@@ -60,6 +61,22 @@ class RaaqmTransportProtocol : public TransportProtocol,
                            const utils::SteadyTime::Microseconds &rtt,
                            utils::SteadyTime::TimePoint &now);
 
+  /**
+   * @brief Rate of the interest pacer, in interests per second. By default
+   * the window is spread over the smoothed RTT, with some headroom so that
+   * pacing does not limit the window growth.
+   */
+  virtual double pacingRate();
+
+  virtual void scheduleNextInterests() override;
+  void sendInterest(const Name &interest_name,
+                    std::array<uint32_t, MAX_AGGREGATED_INTEREST>
+                        *additional_suffixes = nullptr,
+                    uint32_t len = 0) override;
+
+  void onContentReassembled(const std::error_code &ec) override;
+  void updatePathTable(const ContentObject &content_object);
+
  private:
   void init();
 
@@ -69,16 +86,9 @@ class RaaqmTransportProtocol : public TransportProtocol,
                        const std::error_code &reason) override;
   void onReassemblyFailed(std::uint32_t missing_segment) override;
   void onInterestTimeout(Interest::Ptr &i, const Name &n) override;
-  virtual void scheduleNextInterests() override;
-  void sendInterest(const Name &interest_name,
-                    std::array<uint32_t, MAX_AGGREGATED_INTEREST>
-                        *additional_suffixes = nullptr,
-                    uint32_t len = 0) override;
 
-  void onContentReassembled(const std::error_code &ec) override;
   void updateRtt(uint64_t segment);
   void RAAQM();
-  void updatePathTable(const ContentObject &content_object);
   void checkDropProbability();
   void checkForStalePaths();
   void printRtt();
@@ -94,7 +104,6 @@ class RaaqmTransportProtocol : public TransportProtocol,
   std::array<utils::SteadyTime::TimePoint, buffer_size> interest_timepoints_;
   std::queue<uint32_t> interest_to_retransmit_;
 
- private:
   /**
    * Current download path
    */
@@ -105,6 +114,9 @@ class RaaqmTransportProtocol : public TransportProtocol,
    */
   PathTable path_table_;
 
+  bool schedule_interests_;
+
+ private:
   // TimePoints for statistic
   utils::SteadyTime::TimePoint t0_;
 
@@ -126,8 +138,6 @@ class RaaqmTransportProtocol : public TransportProtocol,
   double drop_lte_;
   unsigned int wifi_delay_;
   unsigned int lte_delay_;
-
-  bool schedule_interests_;
 };
 
 }  // end namespace protocol
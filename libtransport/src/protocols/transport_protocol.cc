@@ -43,6 +43,7 @@ TransportProtocol::TransportProtocol(implementation::ConsumerSocket *icn_socket,
       fec_type_(fec::FECType::UNKNOWN) {
   socket_->getSocketOption(GeneralTransportOptions::PORTAL, portal_);
   socket_->getSocketOption(OtherOptions::STATISTICS, &stats_);
+  pacer_ = std::make_unique<InterestPacer>(portal_->getThread().getIoService());
 
   indexer_verifier_->setReassembly(reassembly_.get());
   reassembly->setIndexer(indexer_verifier_.get());
@@ -111,6 +112,7 @@ void TransportProtocol::resume() {
 }
 
 void TransportProtocol::reset() {
+  pacer_->reset();
   reassembly_->reInitialize();
   indexer_verifier_->reset();
   if (fec_decoder_) {
@@ -118,6 +120,26 @@ void TransportProtocol::reset() {
   }
 }
 
+bool TransportProtocol::pace() {
+  if (pacer_->ready()) {
+    return true;
+  }
+
+  std::weak_ptr<TransportProtocol> self = shared_from_this();
+  pacer_->asyncWait([self](const std::error_code &ec) {
+    if (ec) {
+      return;
+    }
+
+    auto ptr = self.lock();
+    if (ptr && ptr->isRunning()) {
+      ptr->scheduleNextInterests();
+    }
+  });
+
+  return false;
+}
+
 void TransportProtocol::onContentReassembled(const std::error_code &ec) {
   stop();
 
@@ -182,6 +204,7 @@ void TransportProtocol::sendInterest(
   bool is_ah = HICN_PACKET_FORMAT_IS_AH(interest->getFormat());
   if (is_ah) signer_->signPacket(interest.get());
 
+  pacer_->consume();
   portal_->sendInterest(interest, lifetime);
 }
 
@@ -22,6 +22,7 @@
 #include <protocols/data_processing_events.h>
 #include <protocols/fec_base.h>
 #include <protocols/indexer.h>
+#include <protocols/interest_pacer.h>
 #include <protocols/protocol.h>
 #include <protocols/reassembly.h>
 
@@ -111,6 +112,12 @@ class TransportProtocol
 
   virtual void reset();
 
+  /**
+   * @brief Tells whether the pacer allows sending an interest now. If not,
+   * scheduleNextInterests() is called again at the next pacer tick.
+   */
+  bool pace();
+
  private:
   // Consumer Callback
   void onContentObject(Interest &i, ContentObject &c) override;
@@ -125,6 +132,7 @@ class TransportProtocol
   // True if it si the first time we schedule an interest
   std::atomic<bool> is_first_;
   interface::TransportStatistics *stats_;
+  std::unique_ptr<InterestPacer> pacer_;
 
   // Callbacks
   interface::ConsumerInterestCallback *on_interest_retransmission_;
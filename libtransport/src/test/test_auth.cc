@@ -20,6 +20,9 @@
 #include <hicn/transport/core/content_object.h>
 #include <openssl/rand.h>
 
+#include <thread>
+#include <vector>
+
 using BN_ptr = std::unique_ptr<BIGNUM, decltype(&::BN_free)>;
 using RSA_ptr = std::unique_ptr<RSA, decltype(&::RSA_free)>;
 using EC_KEY_ptr = std::unique_ptr<EC_KEY, decltype(&::EC_KEY_free)>;
@@ -321,5 +324,43 @@ TEST_F(AuthTest, HMACVerifier) {
   EXPECT_EQ(verifier->verifyPackets(&packet), VerificationPolicy::ACCEPT);
 }
 
+TEST_F(AuthTest, HMACSignConcurrently) {
+  const std::size_t n_threads = 4;
+  const std::size_t n_packets = 256;
+
+  std::shared_ptr<Signer> signer =
+      std::make_shared<SymmetricSigner>(CryptoSuite::HMAC_SHA256, PASSPHRASE);
+  std::shared_ptr<Verifier> verifier =
+      std::make_shared<SymmetricVerifier>(PASSPHRASE);
+
+  // Create content objects with different payloads
+  std::vector<std::unique_ptr<core::ContentObject>> packets;
+  for (std::size_t i = 0; i < n_packets; i++) {
+    packets.push_back(std::make_unique<core::ContentObject>(
+        HICN_PACKET_FORMAT_IPV6_TCP_AH, signer->getSignatureSize()));
+    std::vector<uint8_t> buffer(256, uint8_t(i));
+    packets.back()->appendPayload(buffer.data(), buffer.size());
+  }
+
+  // Sign them from several threads with the same signer
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < n_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (std::size_t i = t; i < n_packets; i += n_threads) {
+        signer->signPacket(packets[i].get());
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (auto &packet : packets) {
+    EXPECT_EQ(verifier->verifyPackets(packet.get()),
+              VerificationPolicy::ACCEPT);
+  }
+}
+
 }  // namespace auth
 }  // namespace transport
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <hicn/transport/interfaces/socket_consumer.h>
+#include <implementation/socket_consumer.h>
+#include <protocols/bbr.h>
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+namespace transport {
+
+namespace protocol {
+
+namespace {
+
+using Clock = utils::SteadyTime::Clock;
+using TimePoint = utils::SteadyTime::TimePoint;
+
+/**
+ * BBR protocol whose interests and data are exchanged by the test instead of
+ * the portal.
+ */
+class TestBbr : public BbrTransportProtocol {
+ public:
+  using BbrTransportProtocol::BbrTransportProtocol;
+  using BbrTransportProtocol::State;
+
+  void send(uint32_t segment, const TimePoint &now) {
+    saveSendState(segment, now);
+    interest_timepoints_[segment & mask] = now;
+    interests_in_flight_++;
+  }
+
+  void receive(uint32_t segment, std::size_t bytes, const TimePoint &now) {
+    interests_in_flight_--;
+    onDelivery(segment, bytes,
+               utils::SteadyTime::getDurationUs(
+                   interest_timepoints_[segment & mask], now),
+               now);
+  }
+
+  State getState() const { return state_; }
+  double getBottleneckBandwidth() const { return btl_bw_; }
+  utils::SteadyTime::Microseconds getMinRtt() const { return min_rtt_; }
+  double getPacingGain() const { return pacing_gain_; }
+  double getPacingRate() { return pacingRate(); }
+  double getWindow() const { return current_window_size_; }
+  uint64_t getInFlight() const { return interests_in_flight_; }
+};
+
+class NullReadCallback : public interface::ConsumerSocket::ReadCallback {
+ public:
+  bool isBufferMovable() noexcept override { return true; }
+  void getReadBuffer(uint8_t **application_buffer,
+                     size_t *max_length) override {}
+  void readDataAvailable(size_t length) noexcept override {}
+  void readError(const std::error_code &ec) noexcept override {}
+  void readSuccess(std::size_t total_size) noexcept override {}
+};
+
+}  // namespace
+
+/**
+ * The consumer downloads over a path made of a bottleneck link followed by a
+ * fixed propagation delay, simulated in virtual time: data are delivered in
+ * the order the interests are sent, and are serialized on the bottleneck.
+ */
+class BbrTest : public ::testing::Test {
+ protected:
+  static constexpr std::size_t kPacketSize = 1000;         // bytes
+  static constexpr double kBottleneckBandwidth = 5000000;  // bytes/s
+  static constexpr std::chrono::microseconds kPropagationDelay{20000};
+  // Propagation delay plus the transmission of a packet on the bottleneck
+  static constexpr std::chrono::microseconds kMinRtt{20200};
+  // Bandwidth-delay product, in packets
+  static constexpr double kBdp =
+      kBottleneckBandwidth * 0.0202 / double(kPacketSize);
+
+  struct Delivery {
+    uint32_t segment;
+    TimePoint time;
+  };
+
+  BbrTest()
+      : socket_(nullptr, interface::TransportProtocolAlgorithms::BBR),
+        now_(Clock::now()),
+        next_send_(now_),
+        link_free_(now_),
+        segment_(0) {
+    socket_.setSocketOption(interface::ConsumerCallbacksOptions::READ_CALLBACK,
+                            &read_callback_);
+    bbr_ = std::make_shared<TestBbr>(&socket_);
+    bbr_->reset();
+    states_.push_back(bbr_->getState());
+  }
+
+  static Clock::duration seconds(double s) {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(s));
+  }
+
+  /**
+   * Send interests as allowed by the window and the pacing rate, and deliver
+   * the data, for the specified time.
+   */
+  void run(Clock::duration duration) {
+    auto end = now_ + duration;
+
+    while (now_ < end) {
+      while (bbr_->getInFlight() < bbr_->getWindow() && now_ >= next_send_) {
+        link_free_ = std::max(now_, link_free_) +
+                     seconds(kPacketSize / kBottleneckBandwidth);
+        in_flight_.push_back({segment_, link_free_ + kPropagationDelay});
+        bbr_->send(segment_++, now_);
+
+        double rate = bbr_->getPacingRate();
+        next_send_ = rate > 0 ? now_ + seconds(1. / rate) : now_;
+      }
+
+      auto next = in_flight_.empty() ? end : in_flight_.front().time;
+      if (bbr_->getInFlight() < bbr_->getWindow()) {
+        next = std::min(next, next_send_);
+      }
+      now_ = std::max(now_, std::min(next, end));
+
+      while (!in_flight_.empty() && in_flight_.front().time <= now_) {
+        bbr_->receive(in_flight_.front().segment, kPacketSize, now_);
+        max_queue_ = std::max(max_queue_, in_flight_.size());
+        in_flight_.pop_front();
+
+        if (bbr_->getState() != states_.back()) {
+          states_.push_back(bbr_->getState());
+        }
+      }
+    }
+  }
+
+  implementation::ConsumerSocket socket_;
+  NullReadCallback read_callback_;
+  std::shared_ptr<TestBbr> bbr_;
+
+  TimePoint now_;
+  TimePoint next_send_;
+  TimePoint link_free_;
+  uint32_t segment_;
+  std::deque<Delivery> in_flight_;
+  std::size_t max_queue_ = 0;
+  std::vector<TestBbr::State> states_;
+};
+
+TEST_F(BbrTest, StartupDrainProbeBw) {
+  using State = TestBbr::State;
+
+  // The pipe is full after a few rounds of exponential growth
+  run(seconds(0.5));
+  ASSERT_GE(states_.size(), 3u);
+  EXPECT_EQ(states_[0], State::STARTUP);
+  EXPECT_EQ(states_[1], State::DRAIN);
+  EXPECT_EQ(states_[2], State::PROBE_BW);
+
+  // The model matches the path
+  EXPECT_NEAR(bbr_->getBottleneckBandwidth(), kBottleneckBandwidth,
+              0.05 * kBottleneckBandwidth);
+  EXPECT_EQ(bbr_->getMinRtt(), kMinRtt);
+
+  // Probing the bandwidth neither stops nor overloads the path
+  max_queue_ = 0;
+  auto delivered = segment_ - in_flight_.size();
+  run(seconds(2));
+  EXPECT_EQ(states_.size(), 3u);
+  EXPECT_EQ(bbr_->getState(), State::PROBE_BW);
+
+  double throughput =
+      (segment_ - in_flight_.size() - delivered) * kPacketSize / 2.;
+  EXPECT_GT(throughput, 0.9 * kBottleneckBandwidth);
+  EXPECT_LE(bbr_->getWindow(), 2 * kBdp + 1);
+  EXPECT_LE(max_queue_, 2 * kBdp + 1);
+}
+
+TEST_F(BbrTest, ProbeRtt) {
+  using State = TestBbr::State;
+
+  // The min RTT expires after 10s
+  run(seconds(11));
+  ASSERT_GE(states_.size(), 5u);
+  EXPECT_EQ(states_[2], State::PROBE_BW);
+  EXPECT_EQ(states_[3], State::PROBE_RTT);
+  EXPECT_EQ(states_[4], State::PROBE_BW);
+  EXPECT_GT(bbr_->getWindow(), 4.);
+
+  EXPECT_NEAR(bbr_->getBottleneckBandwidth(), kBottleneckBandwidth,
+              0.05 * kBottleneckBandwidth);
+}
+
+}  // namespace protocol
+
+}  // namespace transport
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <hicn/transport/core/content_object.h>
+#include <hicn/transport/interfaces/socket_consumer.h>
+#include <implementation/socket_consumer.h>
+#include <protocols/byte_stream_reassembly.h>
+#include <protocols/incremental_indexer_bytestream.h>
+#include <protocols/transport_protocol.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace transport {
+
+namespace protocol {
+
+namespace {
+
+class TestIndexer : public IncrementalIndexer {
+ public:
+  using IncrementalIndexer::IncrementalIndexer;
+
+  void setFinalSuffix(uint32_t suffix) { final_suffix_ = suffix; }
+};
+
+/**
+ * Transport protocol only recording the events raised by the reassembly.
+ */
+class TestTransport : public TransportProtocol {
+ public:
+  TestTransport(implementation::ConsumerSocket *socket)
+      : TransportProtocol(socket, new TestIndexer(socket, this),
+                          new ByteStreamReassembly(socket, this)),
+        reassembled_(0) {}
+
+  void scheduleNextInterests() override {}
+
+  void onContentReassembled(const std::error_code &ec) override {
+    EXPECT_FALSE(ec);
+    reassembled_++;
+  }
+
+  void onPacketDropped(Interest &interest, ContentObject &content_object,
+                       const std::error_code &ec) override {}
+
+  void onReassemblyFailed(std::uint32_t missing_segment) override {}
+
+  Reassembly &getReassembly() { return *reassembly_; }
+
+  TestIndexer &getIndexer() {
+    return static_cast<TestIndexer &>(*indexer_verifier_);
+  }
+
+  unsigned reassembled_;
+
+ protected:
+  void onContentObjectReceived(Interest &i, ContentObject &c,
+                               std::error_code &ec) override {}
+
+  void onInterestTimeout(Interest::Ptr &i, const Name &n) override {}
+};
+
+/**
+ * Application collecting the bytes received, either from the buffers it
+ * provides or from the buffers moved to it.
+ */
+class TestReadCallback : public interface::ConsumerSocket::ReadCallback {
+ public:
+  static constexpr std::size_t kMaxBufferSize = 256;
+  static constexpr std::size_t kApplicationBufferSize = 100;
+
+  TestReadCallback(bool movable) : movable_(movable) {}
+
+  bool isBufferMovable() noexcept override { return movable_; }
+
+  void getReadBuffer(uint8_t **application_buffer,
+                     size_t *max_length) override {
+    buffers_.emplace_back(kApplicationBufferSize);
+    *application_buffer = buffers_.back().data();
+    *max_length = buffers_.back().size();
+  }
+
+  void readDataAvailable(size_t length) noexcept override {
+    // The buffers provided since the last notification are filled in order
+    for (auto &buffer : buffers_) {
+      auto n = std::min(length, buffer.size());
+      data_.insert(data_.end(), buffer.begin(), buffer.begin() + n);
+      length -= n;
+    }
+
+    EXPECT_EQ(length, 0u);
+    buffers_.clear();
+  }
+
+  size_t maxBufferSize() const override { return kMaxBufferSize; }
+
+  void readBufferAvailable(
+      std::unique_ptr<utils::MemBuf> &&buffer) noexcept override {
+    data_.insert(data_.end(), buffer->data(), buffer->tail());
+  }
+
+  void readError(const std::error_code &ec) noexcept override {}
+
+  void readSuccess(std::size_t total_size) noexcept override {}
+
+  std::vector<uint8_t> data_;
+
+ private:
+  bool movable_;
+  std::vector<std::vector<uint8_t>> buffers_;
+};
+
+}  // namespace
+
+class ByteStreamReassemblyTest : public ::testing::TestWithParam<bool> {
+ protected:
+  static constexpr uint32_t kSegments = 100;
+
+  ByteStreamReassemblyTest()
+      : socket_(nullptr, interface::TransportProtocolAlgorithms::RAAQM),
+        read_callback_(GetParam()) {
+    socket_.setSocketOption(interface::ConsumerCallbacksOptions::READ_CALLBACK,
+                            &read_callback_);
+    transport_ = std::make_shared<TestTransport>(&socket_);
+    transport_->getReassembly().reInitialize();
+    transport_->getIndexer().setFinalSuffix(kSegments - 1);
+
+    // Segments of different sizes, so that they do not align with the buffers
+    for (uint32_t i = 0; i < kSegments; i++) {
+      std::vector<uint8_t> payload(100 + i % 7);
+      for (std::size_t j = 0; j < payload.size(); j++) {
+        payload[j] = uint8_t(i * 31 + j);
+      }
+
+      expected_.insert(expected_.end(), payload.begin(), payload.end());
+      payloads_.push_back(std::move(payload));
+    }
+  }
+
+  void receive(uint32_t suffix) {
+    auto content_object = std::make_shared<core::ContentObject>(
+        core::Name("b001::1234", suffix), HICN_PACKET_FORMAT_IPV6_TCP);
+    content_object->appendPayload(payloads_[suffix].data(),
+                                  payloads_[suffix].size());
+    transport_->getReassembly().reassemble(*content_object);
+  }
+
+  implementation::ConsumerSocket socket_;
+  TestReadCallback read_callback_;
+  std::shared_ptr<TestTransport> transport_;
+  std::vector<std::vector<uint8_t>> payloads_;
+  std::vector<uint8_t> expected_;
+};
+
+TEST_P(ByteStreamReassemblyTest, InOrder) {
+  for (uint32_t i = 0; i < kSegments; i++) {
+    receive(i);
+  }
+
+  EXPECT_EQ(transport_->reassembled_, 1u);
+  EXPECT_EQ(read_callback_.data_, expected_);
+}
+
+TEST_P(ByteStreamReassemblyTest, OutOfOrder) {
+  std::vector<uint32_t> order(kSegments);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937(1));
+
+  for (auto suffix : order) {
+    receive(suffix);
+  }
+
+  EXPECT_EQ(transport_->reassembled_, 1u);
+  EXPECT_EQ(read_callback_.data_, expected_);
+}
+
+TEST_P(ByteStreamReassemblyTest, Reversed) {
+  // Nothing can be delivered before the first segment
+  for (uint32_t i = kSegments - 1; i > 0; i--) {
+    receive(i);
+  }
+  EXPECT_TRUE(read_callback_.data_.empty());
+
+  receive(0);
+  EXPECT_EQ(transport_->reassembled_, 1u);
+  EXPECT_EQ(read_callback_.data_, expected_);
+}
+
+TEST_P(ByteStreamReassemblyTest, Duplicates) {
+  // Every segment is received up to 3 times, before and after being
+  // reassembled
+  std::mt19937 gen(2);
+  std::vector<uint32_t> order;
+  for (uint32_t i = 0; i < kSegments; i++) {
+    order.insert(order.end(), 1 + gen() % 3, i);
+  }
+  std::shuffle(order.begin(), order.end(), gen);
+
+  for (auto suffix : order) {
+    receive(suffix);
+  }
+
+  // Retransmissions received once the download is complete
+  receive(0);
+  receive(kSegments - 1);
+
+  EXPECT_EQ(transport_->reassembled_, 1u);
+  EXPECT_EQ(read_callback_.data_, expected_);
+}
+
+INSTANTIATE_TEST_SUITE_P(ByteStreamReassembly, ByteStreamReassemblyTest,
+                         ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool> &info) {
+                           return info.param ? "MovableBuffer"
+                                             : "ApplicationBuffer";
+                         });
+
+}  // namespace protocol
+
+}  // namespace transport
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <protocols/fec/fec.h>
+
+#include <chrono>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace transport {
+namespace protocol {
+
+namespace {
+
+using Block = std::vector<std::vector<gf>>;
+
+Block randomBlock(int k, int n, int size, std::mt19937 &generator) {
+  std::uniform_int_distribution<int> byte(0, 255);
+  Block block(n, std::vector<gf>(size));
+  for (int i = 0; i < k; i++) {
+    for (auto &b : block[i]) {
+      b = gf(byte(generator));
+    }
+  }
+  return block;
+}
+
+void encode(struct fec_parms *code, Block &block, int k, int n) {
+  std::vector<gf *> src(n);
+  for (int i = 0; i < n; i++) {
+    src[i] = block[i].data();
+  }
+
+  for (int i = k; i < n; i++) {
+    fec_encode(code, src.data(), src[i], i, int(block[i].size()));
+  }
+}
+
+}  // namespace
+
+class FecAddmulTest : public ::testing::Test {
+ protected:
+  FecAddmulTest() : generator_(42) {}
+
+  ~FecAddmulTest() override = default;
+
+  void TearDown() override {
+    // Restore the implementation picked on initialization
+    fec_set_addmul(best_);
+  }
+
+  fec_addmul_t best_ = fec_get_addmul();
+  std::mt19937 generator_;
+};
+
+TEST_F(FecAddmulTest, SameAsScalar) {
+  const std::vector<std::pair<int, int>> codes = {{1, 3}, {4, 6}, {10, 20}};
+  const std::vector<int> sizes = {1, 15, 16, 17, 31, 33, 63, 64, 65, 1401};
+
+  for (auto [k, n] : codes) {
+    struct fec_parms *code = fec_new(k, n);
+    for (auto size : sizes) {
+      Block reference = randomBlock(k, n, size, generator_);
+      ASSERT_EQ(fec_set_addmul(FEC_ADDMUL_SCALAR), 0);
+      encode(code, reference, k, n);
+
+      for (int type = 0; type < FEC_ADDMUL_N; type++) {
+        if (fec_set_addmul(fec_addmul_t(type)) < 0) {
+          continue;
+        }
+
+        Block block = reference;
+        for (int i = k; i < n; i++) {
+          std::fill(block[i].begin(), block[i].end(), 0);
+        }
+        encode(code, block, k, n);
+        EXPECT_EQ(block, reference)
+            << fec_addmul_name(fec_addmul_t(type)) << " k=" << k
+            << " n=" << n << " size=" << size;
+      }
+    }
+    fec_free(code);
+  }
+}
+
+TEST_F(FecAddmulTest, Decode) {
+  const int k = 10, n = 20, size = 1400;
+  struct fec_parms *code = fec_new(k, n);
+
+  for (int type = 0; type < FEC_ADDMUL_N; type++) {
+    if (fec_set_addmul(fec_addmul_t(type)) < 0) {
+      continue;
+    }
+
+    Block block = randomBlock(k, n, size, generator_);
+    encode(code, block, k, n);
+
+    // Lose every other source symbol, and recover from repair symbols
+    std::vector<int> index(k);
+    std::vector<gf *> pkt(n);
+    Block recovered(n - k, std::vector<gf>(size));
+    int r = 0;
+    for (int i = 0; i < k; i++) {
+      index[i] = i % 2 ? k + i : i;
+      pkt[i] = block[index[i]].data();
+      if (index[i] >= k) {
+        pkt[k + r] = recovered[r].data();
+        r++;
+      }
+    }
+
+    ASSERT_EQ(fec_decode(code, pkt.data(), index.data(), size), 0);
+    for (int i = 1, j = 0; i < k; i += 2, j++) {
+      EXPECT_EQ(recovered[j], block[i]) << fec_addmul_name(fec_addmul_t(type));
+    }
+  }
+
+  fec_free(code);
+}
+
+/**
+ * Encoding throughput of a few of the codes used by RTC, for each
+ * implementation available.
+ */
+TEST_F(FecAddmulTest, BenchmarkEncode) {
+  const std::vector<std::pair<int, int>> codes = {
+      {1, 3}, {4, 6}, {8, 12}, {10, 20}, {16, 24}};
+  const int size = 1400;
+  const int blocks = 2000;
+
+  for (auto [k, n] : codes) {
+    struct fec_parms *code = fec_new(k, n);
+    Block block = randomBlock(k, n, size, generator_);
+
+    for (int type = 0; type < FEC_ADDMUL_N; type++) {
+      if (fec_set_addmul(fec_addmul_t(type)) < 0) {
+        continue;
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < blocks; i++) {
+        encode(code, block, k, n);
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+      LOG(INFO) << "RS(" << k << "," << n << ") "
+                << fec_addmul_name(fec_addmul_t(type)) << ": "
+                << double(blocks) * k * size / elapsed.count() / 1e6
+                << " MB/s of source data";
+    }
+
+    fec_free(code);
+  }
+}
+
+}  // namespace protocol
+}  // namespace transport
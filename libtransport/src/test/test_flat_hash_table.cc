@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <utils/flat_hash_table.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace utils {
+
+namespace {
+
+// Same layout as a pending interest: a shared pointer and two callbacks
+struct Entry {
+  Entry() = default;
+  explicit Entry(const std::shared_ptr<int> &p) : ptr(p) {}
+
+  std::shared_ptr<int> ptr;
+  std::function<void()> on_data;
+  std::function<void()> on_timeout;
+};
+
+}  // namespace
+
+class FlatHashTableTest : public ::testing::Test {
+ protected:
+  FlatHashTableTest() = default;
+
+  ~FlatHashTableTest() override = default;
+
+  FlatHashTable<Entry> table_;
+};
+
+TEST_F(FlatHashTableTest, InsertFindErase) {
+  auto value = std::make_shared<int>(42);
+
+  EXPECT_TRUE(table_.empty());
+  EXPECT_EQ(table_.find(1), table_.end());
+
+  auto ret = table_.try_emplace(1, value);
+  EXPECT_TRUE(ret.second);
+  EXPECT_EQ(ret.first->first, 1u);
+  EXPECT_EQ(ret.first->second.ptr, value);
+
+  // Existing entries are not overwritten
+  ret = table_.try_emplace(1, std::make_shared<int>(0));
+  EXPECT_FALSE(ret.second);
+  EXPECT_EQ(ret.first->second.ptr, value);
+  EXPECT_EQ(table_.size(), 1u);
+
+  auto it = table_.find(1);
+  ASSERT_NE(it, table_.end());
+  EXPECT_EQ(*it->second.ptr, 42);
+
+  table_.erase(it);
+  EXPECT_TRUE(table_.empty());
+  EXPECT_EQ(table_.find(1), table_.end());
+
+  // The value is released on erase
+  EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST_F(FlatHashTableTest, EraseShiftsCollidingEntries) {
+  table_.reserve(8);
+  std::size_t buckets = table_.bucket_count();
+
+  // Keys colliding at the end of the table wrap around to its beginning
+  uint32_t last = uint32_t(buckets - 1);
+  std::vector<uint32_t> keys = {last, uint32_t(2 * buckets - 1),
+                                uint32_t(3 * buckets - 1), 0, 1};
+  for (auto key : keys) {
+    table_.try_emplace(key);
+  }
+
+  EXPECT_EQ(table_.erase(last), 1u);
+  EXPECT_EQ(table_.erase(last), 0u);
+  EXPECT_EQ(table_.erase(0), 1u);
+
+  for (auto key : {keys[1], keys[2], keys[4]}) {
+    EXPECT_NE(table_.find(key), table_.end()) << key;
+  }
+  EXPECT_EQ(table_.size(), 3u);
+}
+
+TEST_F(FlatHashTableTest, RandomAgainstMap) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<uint32_t> keys(0, 4096);
+  std::map<uint32_t, int> reference;
+
+  for (int i = 0; i < 100000; i++) {
+    uint32_t key = keys(generator);
+    if (generator() % 3) {
+      auto ret = table_.try_emplace(key, std::make_shared<int>(i));
+      auto ref = reference.try_emplace(key, i);
+      EXPECT_EQ(ret.second, ref.second);
+    } else {
+      EXPECT_EQ(table_.erase(key), reference.erase(key));
+    }
+  }
+
+  EXPECT_EQ(table_.size(), reference.size());
+
+  std::size_t count = 0;
+  for (const auto &[key, value] : table_) {
+    auto it = reference.find(key);
+    ASSERT_NE(it, reference.end());
+    EXPECT_EQ(*value.ptr, it->second);
+    count++;
+  }
+  EXPECT_EQ(count, reference.size());
+
+  table_.clear();
+  EXPECT_TRUE(table_.empty());
+  EXPECT_EQ(table_.begin(), table_.end());
+}
+
+/**
+ * Mimic the pending interest table of a consumer: a window of consecutive
+ * suffixes is kept in the table, each data packet removing the oldest
+ * interest and each new interest being inserted at the head of the window.
+ */
+TEST_F(FlatHashTableTest, BenchmarkAgainstUnorderedMap) {
+  const uint32_t window = 1000;
+  const uint32_t n = 2000000;
+  const uint32_t name_hash = 0x5a3c1b07;
+  auto value = std::make_shared<int>(0);
+
+  auto run = [&](auto &table) {
+    table.reserve(1024);
+    for (uint32_t i = 0; i < window; i++) {
+      table.try_emplace(name_hash + i, value);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; i++) {
+      table.erase(table.find(name_hash + i));
+      table.try_emplace(name_hash + i + window, value);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(table.size(), window);
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+        .count();
+  };
+
+  std::unordered_map<uint32_t, Entry> map;
+  auto flat_time = run(table_);
+  auto map_time = run(map);
+
+  LOG(INFO) << "Find/erase/insert of " << n
+            << " entries: flat hash table " << flat_time
+            << "us, unordered_map " << map_time << "us";
+}
+
+}  // namespace utils
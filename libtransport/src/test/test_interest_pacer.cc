@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <hicn/transport/core/asio_wrapper.h>
+#include <protocols/interest_pacer.h>
+
+#include <chrono>
+#include <vector>
+
+namespace transport {
+
+namespace protocol {
+
+namespace {
+using Clock = InterestPacer::Clock;
+}
+
+class InterestPacerTest : public ::testing::Test {
+ protected:
+  InterestPacerTest() : pacer_(io_service_) {}
+
+  ~InterestPacerTest() override = default;
+
+  /**
+   * Send n interests as a window-based protocol does: as many as the pacer
+   * allows, then wait for the next tick. Returns the size of each batch.
+   */
+  std::vector<std::size_t> send(std::size_t n) {
+    std::vector<std::size_t> batches;
+    std::size_t sent = 0;
+
+    std::function<void()> schedule = [&]() {
+      std::size_t batch = 0;
+      while (sent < n && pacer_.ready()) {
+        pacer_.consume();
+        sent++;
+        batch++;
+      }
+
+      batches.push_back(batch);
+      if (sent < n) {
+        pacer_.asyncWait([&](const std::error_code &ec) {
+          if (!ec) {
+            schedule();
+          }
+        });
+      }
+    };
+
+    schedule();
+    io_service_.run();
+    io_service_.restart();
+
+    return batches;
+  }
+
+  asio::io_service io_service_;
+  InterestPacer pacer_;
+};
+
+TEST_F(InterestPacerTest, Disabled) {
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(pacer_.ready());
+    pacer_.consume();
+  }
+
+  auto batches = send(1000);
+  ASSERT_EQ(batches.size(), 1u);
+  EXPECT_EQ(batches[0], 1000u);
+}
+
+TEST_F(InterestPacerTest, Rate) {
+  const double rate = 20000;
+  const std::size_t n = 2000;
+
+  pacer_.setRate(rate);
+  EXPECT_EQ(pacer_.getRate(), rate);
+
+  auto start = Clock::now();
+  auto batches = send(n);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  // The full bucket at start holds 2 batches of 2 interests
+  EXPECT_EQ(batches[0], 4u);
+  EXPECT_GE(elapsed.count(), (n - 4) / rate);
+  EXPECT_LT(elapsed.count(), 1.5 * n / rate);
+}
+
+TEST_F(InterestPacerTest, Batching) {
+  // 100 interests per tick of 100us
+  const double rate = 1000000;
+  const std::size_t n = 100000;
+
+  pacer_.setRate(rate);
+  auto start = Clock::now();
+  auto batches = send(n);
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  // At most a full bucket of 2 batches, plus the few tokens refilled while
+  // sending it
+  for (auto batch : batches) {
+    EXPECT_LE(batch, 205u);
+  }
+
+  // One wake up per tick, not per interest
+  EXPECT_LE(batches.size(), n / 50);
+  EXPECT_GE(elapsed.count(), (n - 200) / rate);
+
+  LOG(INFO) << n << " interests at " << rate << " interests/s in "
+            << elapsed.count() * 1000 << "ms, " << batches.size()
+            << " batches";
+}
+
+TEST_F(InterestPacerTest, Debt) {
+  pacer_.setRate(1000);
+
+  // Interests sent without checking the pacer are paid for later
+  for (int i = 0; i < 10; i++) {
+    pacer_.consume();
+  }
+
+  auto start = Clock::now();
+  send(1);
+  EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(8));
+}
+
+TEST_F(InterestPacerTest, Reset) {
+  pacer_.setRate(10);
+  while (pacer_.ready()) {
+    pacer_.consume();
+  }
+
+  bool aborted = false;
+  pacer_.asyncWait(
+      [&](const std::error_code &ec) { aborted = bool(ec); });
+  pacer_.reset();
+  io_service_.run();
+
+  EXPECT_TRUE(aborted);
+  EXPECT_TRUE(pacer_.ready());
+  EXPECT_EQ(pacer_.getRate(), 0);
+}
+
+}  // namespace protocol
+
+}  // namespace transport
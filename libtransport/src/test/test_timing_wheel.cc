@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <hicn/transport/core/asio_wrapper.h>
+#include <utils/timing_wheel.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace utils {
+
+namespace {
+using Clock = TimingWheel::Clock;
+}
+
+class TimingWheelTest : public ::testing::Test {
+ protected:
+  TimingWheelTest() = default;
+
+  ~TimingWheelTest() override = default;
+
+  void createWheel(
+      Clock::duration resolution = std::chrono::milliseconds(1)) {
+    wheel_ = TimingWheel::createShared(
+        io_service_,
+        [this](uint64_t data) {
+          fired_.push_back(data);
+          fired_at_.push_back(Clock::now());
+        },
+        resolution);
+  }
+
+  asio::io_service io_service_;
+  std::shared_ptr<TimingWheel> wheel_;
+  std::vector<uint64_t> fired_;
+  std::vector<Clock::time_point> fired_at_;
+};
+
+TEST_F(TimingWheelTest, FireInOrder) {
+  createWheel();
+
+  auto start = Clock::now();
+  wheel_->schedule(std::chrono::milliseconds(30), 3);
+  wheel_->schedule(std::chrono::milliseconds(10), 1);
+  wheel_->schedule(std::chrono::milliseconds(20), 2);
+  EXPECT_EQ(wheel_->size(), 3u);
+
+  io_service_.run();
+
+  ASSERT_EQ(fired_.size(), 3u);
+  EXPECT_TRUE(wheel_->empty());
+  for (uint64_t i = 0; i < 3; i++) {
+    EXPECT_EQ(fired_[i], i + 1);
+    EXPECT_GE(fired_at_[i] - start, std::chrono::milliseconds(10 * (i + 1)));
+  }
+}
+
+TEST_F(TimingWheelTest, Cancel) {
+  createWheel();
+
+  auto a = wheel_->schedule(std::chrono::milliseconds(5), 1);
+  auto b = wheel_->schedule(std::chrono::milliseconds(5), 2);
+  EXPECT_TRUE(wheel_->cancel(a));
+  EXPECT_FALSE(wheel_->cancel(a));
+  EXPECT_FALSE(wheel_->cancel(TimingWheel::INVALID_HANDLE));
+
+  io_service_.run();
+
+  ASSERT_EQ(fired_.size(), 1u);
+  EXPECT_EQ(fired_[0], 2u);
+
+  // The handle of a fired timer is stale, even once its entry is reused
+  wheel_->schedule(std::chrono::milliseconds(1), 3);
+  EXPECT_FALSE(wheel_->cancel(b));
+  EXPECT_EQ(wheel_->size(), 1u);
+}
+
+TEST_F(TimingWheelTest, Cascade) {
+  // With a 10us resolution, delays of up to 300ms span the first 3 levels
+  createWheel(std::chrono::microseconds(10));
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> distribution(0, 300000);
+
+  const uint64_t n = 2000;
+  std::vector<Clock::time_point> deadlines;
+  std::vector<TimingWheel::Handle> handles;
+  for (uint64_t i = 0; i < n; i++) {
+    auto delay = std::chrono::microseconds(distribution(generator));
+    deadlines.push_back(Clock::now() + delay);
+    handles.push_back(wheel_->schedule(delay, i));
+  }
+
+  // Cancel one timer out of four
+  for (uint64_t i = 0; i < n; i += 4) {
+    EXPECT_TRUE(wheel_->cancel(handles[i]));
+  }
+
+  io_service_.run();
+
+  ASSERT_EQ(fired_.size(), n - n / 4);
+  for (std::size_t i = 0; i < fired_.size(); i++) {
+    EXPECT_NE(fired_[i] % 4, 0u);
+    EXPECT_GE(fired_at_[i], deadlines[fired_[i]]);
+  }
+}
+
+TEST_F(TimingWheelTest, ScheduleFromCallback) {
+  int count = 0;
+  wheel_ = TimingWheel::createShared(io_service_, [this, &count](uint64_t) {
+    if (++count < 5) {
+      wheel_->schedule(std::chrono::milliseconds(2), 0);
+    }
+  });
+
+  wheel_->schedule(std::chrono::milliseconds(2), 0);
+  io_service_.run();
+
+  EXPECT_EQ(count, 5);
+}
+
+TEST_F(TimingWheelTest, DestroyWithPendingTimers) {
+  createWheel();
+
+  wheel_->schedule(std::chrono::milliseconds(5), 1);
+  wheel_.reset();
+  io_service_.run();
+
+  EXPECT_TRUE(fired_.empty());
+}
+
+/**
+ * Mimic the consumer pattern of the portal, where each interest arms a timer
+ * which is almost always cancelled by the reception of the data, and compare
+ * the wheel with one asio timer per interest.
+ */
+TEST_F(TimingWheelTest, BenchmarkArmCancel) {
+  const std::size_t window = 4096;
+  const std::size_t n = 1000000;
+  const auto lifetime = std::chrono::seconds(1);
+
+  createWheel();
+  std::vector<TimingWheel::Handle> handles(window);
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < n; i++) {
+    auto &handle = handles[i % window];
+    wheel_->cancel(handle);
+    handle = wheel_->schedule(lifetime, i);
+  }
+  auto wheel_time = Clock::now() - start;
+  wheel_->clear();
+
+  std::vector<std::unique_ptr<asio::steady_timer>> timers;
+  for (std::size_t i = 0; i < window; i++) {
+    timers.emplace_back(std::make_unique<asio::steady_timer>(io_service_));
+  }
+  start = Clock::now();
+  for (std::size_t i = 0; i < n; i++) {
+    auto &timer = *timers[i % window];
+    timer.cancel();
+    timer.expires_from_now(lifetime);
+    timer.async_wait([](const std::error_code &) {});
+  }
+  auto asio_time = Clock::now() - start;
+  for (auto &timer : timers) {
+    timer->cancel();
+  }
+  io_service_.run();
+
+  EXPECT_TRUE(fired_.empty());
+
+  LOG(INFO) << "Arm/cancel of " << n << " timers: timing wheel "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                   wheel_time)
+                   .count()
+            << "us, asio timers "
+            << std::chrono::duration_cast<std::chrono::microseconds>(asio_time)
+                   .count()
+            << "us";
+}
+
+}  // namespace utils
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/**
+ * Open-addressing hash table with 32 bit keys and values stored inline.
+ *
+ * The table has a power of two number of buckets and uses linear probing,
+ * keeping the entries of a run of buckets sorted by ideal bucket (Robin Hood
+ * hashing). Keys are used as is to index the buckets: keys which are already
+ * hashes, or which differ in their lower bits like consecutive name suffixes,
+ * end up in consecutive buckets and are found without probing. Deletion
+ * shifts the following displaced entries back instead of leaving tombstones,
+ * so that lookups never degrade as entries come and go.
+ *
+ * No memory is allocated once the table is large enough, which is ensured by
+ * reserve(). Values must be default constructible and movable, as they are
+ * moved when entries are shifted or the table grows. Inserting or erasing an
+ * entry invalidates iterators and references to other entries.
+ *
+ * The interface is a subset of the one of std::unordered_map.
+ */
+template <typename Value>
+class FlatHashTable {
+ public:
+  using key_type = uint32_t;
+  using mapped_type = Value;
+  using value_type = std::pair<key_type, Value>;
+  using size_type = std::size_t;
+
+ private:
+  template <bool Const>
+  class Iterator {
+    friend class FlatHashTable;
+    using Table = std::conditional_t<Const, const FlatHashTable, FlatHashTable>;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatHashTable::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<Const, const value_type &, value_type &>;
+
+    Iterator() : table_(nullptr), index_(0) {}
+
+    // Conversion from iterator to const_iterator
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    Iterator(const Iterator<false> &other)
+        : table_(other.table_), index_(other.index_) {}
+
+    reference operator*() const { return table_->buckets_[index_]; }
+    pointer operator->() const { return &table_->buckets_[index_]; }
+
+    Iterator &operator++() {
+      index_ = table_->nextUsed(index_ + 1);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return index_ == other.index_;
+    }
+
+    bool operator!=(const Iterator &other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    Iterator(Table *table, std::size_t index) : table_(table), index_(index) {}
+
+    Table *table_;
+    std::size_t index_;
+
+    friend class Iterator<true>;
+  };
+
+ public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashTable() : size_(0), mask_(0) {}
+
+  explicit FlatHashTable(size_type count) : FlatHashTable() { reserve(count); }
+
+  size_type size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  size_type bucket_count() const { return buckets_.size(); }
+
+  /**
+   * Make room for at least count entries without further allocation.
+   */
+  void reserve(size_type count) {
+    size_type buckets = kMinBuckets;
+    while (buckets * kMaxLoadNum < count * kMaxLoadDen) {
+      buckets <<= 1;
+    }
+
+    if (buckets > buckets_.size()) {
+      rehash(buckets);
+    }
+  }
+
+  iterator begin() { return iterator(this, nextUsed(0)); }
+  iterator end() { return iterator(this, buckets_.size()); }
+  const_iterator begin() const { return const_iterator(this, nextUsed(0)); }
+  const_iterator end() const { return const_iterator(this, buckets_.size()); }
+
+  iterator find(key_type key) { return iterator(this, lookup(key)); }
+
+  const_iterator find(key_type key) const {
+    return const_iterator(this, lookup(key));
+  }
+
+  /**
+   * Insert a value constructed from args if the key is not in the table.
+   *
+   * @return An iterator to the entry of the key, and whether the value was
+   * inserted.
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(key_type key, Args &&...args) {
+    std::size_t index = lookup(key);
+    if (index != buckets_.size()) {
+      return {iterator(this, index), false};
+    }
+
+    if ((size_ + 1) * kMaxLoadDen > buckets_.size() * kMaxLoadNum) {
+      rehash(buckets_.empty() ? kMinBuckets : buckets_.size() << 1);
+    }
+
+    index = insert(key);
+    buckets_[index].second = Value(std::forward<Args>(args)...);
+
+    return {iterator(this, index), true};
+  }
+
+  void erase(const_iterator it) { eraseIndex(it.index_); }
+
+  size_type erase(key_type key) {
+    std::size_t index = lookup(key);
+    if (index == buckets_.size()) {
+      return 0;
+    }
+
+    eraseIndex(index);
+    return 1;
+  }
+
+  void clear() {
+    for (std::size_t index = 0; index < buckets_.size(); index++) {
+      if (used_[index]) {
+        buckets_[index].second = Value();
+        used_[index] = false;
+      }
+    }
+
+    size_ = 0;
+  }
+
+ private:
+  // Maximum load factor of 3/4
+  static constexpr size_type kMaxLoadNum = 3;
+  static constexpr size_type kMaxLoadDen = 4;
+  static constexpr size_type kMinBuckets = 16;
+
+  // Distance of the entry in a bucket from its ideal bucket
+  std::size_t distance(std::size_t index) const {
+    return (index - buckets_[index].first) & mask_;
+  }
+
+  std::size_t lookup(key_type key) const {
+    if (size_ == 0) {
+      return buckets_.size();
+    }
+
+    // Entries are sorted by ideal bucket: the key can't be found past an
+    // entry closer to its own ideal bucket than the key would be.
+    std::size_t index = key & mask_;
+    for (std::size_t d = 0; used_[index] && distance(index) >= d; d++) {
+      if (buckets_[index].first == key) {
+        return index;
+      }
+      index = (index + 1) & mask_;
+    }
+
+    return buckets_.size();
+  }
+
+  /**
+   * Insert a key which is not in the table, after the entries with the same
+   * or a lower ideal bucket, and return its bucket.
+   */
+  std::size_t insert(key_type key) {
+    std::size_t index = key & mask_;
+    for (std::size_t d = 0; used_[index] && distance(index) >= d; d++) {
+      index = (index + 1) & mask_;
+    }
+
+    // Shift the rest of the run by one bucket
+    std::size_t last = index;
+    while (used_[last]) {
+      last = (last + 1) & mask_;
+    }
+    used_[last] = true;
+
+    while (last != index) {
+      std::size_t prev = (last - 1) & mask_;
+      buckets_[last] = std::move(buckets_[prev]);
+      last = prev;
+    }
+
+    buckets_[index].first = key;
+    size_++;
+    return index;
+  }
+
+  std::size_t nextUsed(std::size_t index) const {
+    while (index < buckets_.size() && !used_[index]) {
+      index++;
+    }
+    return index;
+  }
+
+  void eraseIndex(std::size_t index) {
+    // Shift back the following entries which are not in their ideal bucket
+    std::size_t next = (index + 1) & mask_;
+    while (used_[next] && distance(next) > 0) {
+      buckets_[index] = std::move(buckets_[next]);
+      index = next;
+      next = (next + 1) & mask_;
+    }
+
+    buckets_[index].second = Value();
+    used_[index] = false;
+    size_--;
+  }
+
+  void rehash(size_type count) {
+    std::vector<value_type> buckets(count);
+    std::vector<uint8_t> used(count, 0);
+    std::swap(buckets, buckets_);
+    std::swap(used, used_);
+    mask_ = count - 1;
+    size_ = 0;
+
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+      if (used[i]) {
+        std::size_t index = insert(buckets[i].first);
+        buckets_[index].second = std::move(buckets[i].second);
+      }
+    }
+  }
+
+  std::vector<value_type> buckets_;
+  std::vector<uint8_t> used_;
+  size_type size_;
+  std::size_t mask_;
+};
+
+}  // namespace utils
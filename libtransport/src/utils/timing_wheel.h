@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2022 Cisco and/or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <hicn/transport/core/asio_wrapper.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace utils {
+
+/**
+ * Hierarchical timing wheel, multiplexing a large number of timers over a
+ * single asio timer.
+ *
+ * Time is divided in ticks of fixed resolution. Timers are stored in kLevels
+ * wheels of kSlots slots each: level 0 has one slot per tick, level 1 one slot
+ * per kSlots ticks and so on. A timer is placed in the level corresponding to
+ * the highest group of bits in which its expiry differs from the current tick,
+ * and is moved down one or more levels (cascaded) when the lower wheel wraps
+ * around. Scheduling and cancelling a timer are O(1), and the asio timer is
+ * only armed for the next non-empty tick of level 0 or for the next cascade.
+ *
+ * Timers are referred to by an opaque handle rather than by pointer, so that
+ * the owner of a timer can freely move it. Handles of fired or cancelled
+ * timers are invalidated, and cancelling them again is a no-op.
+ *
+ * All methods must be called from the thread running the io_service, and the
+ * expiry callback may schedule or cancel other timers.
+ */
+class TimingWheel : public std::enable_shared_from_this<TimingWheel> {
+ public:
+  using Handle = uint64_t;
+  using Callback = std::function<void(uint64_t)>;
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr Handle INVALID_HANDLE = std::numeric_limits<Handle>::max();
+
+ private:
+  static constexpr unsigned kLevels = 4;
+  static constexpr unsigned kSlotBits = 8;
+  static constexpr unsigned kSlots = 1 << kSlotBits;
+  static constexpr uint64_t kSlotMask = kSlots - 1;
+  static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+
+  struct Entry {
+    uint64_t data;
+    uint64_t expiry;
+    uint32_t generation;
+    uint32_t slot;
+    uint32_t prev;
+    uint32_t next;
+  };
+
+  TimingWheel(asio::io_service &io_service, Callback &&callback,
+              Clock::duration resolution)
+      : callback_(std::move(callback)),
+        timer_(io_service),
+        start_(Clock::now()),
+        resolution_(resolution),
+        current_(0),
+        size_(0),
+        free_(kNil),
+        armed_(false),
+        armed_tick_(0),
+        advancing_(false) {
+    heads_.fill(kNil);
+    occupied_.fill(0);
+  }
+
+ public:
+  /**
+   * @param callback - Called with the data of each expired timer.
+   * @param resolution - Duration of a tick. Timers fire within one tick after
+   * their expiry.
+   */
+  static std::shared_ptr<TimingWheel> createShared(
+      asio::io_service &io_service, Callback &&callback,
+      Clock::duration resolution = std::chrono::milliseconds(1)) {
+    return std::shared_ptr<TimingWheel>(
+        new TimingWheel(io_service, std::move(callback), resolution));
+  }
+
+  ~TimingWheel() = default;
+
+  /**
+   * Schedule a timer. The callback will be called with data once the delay
+   * has elapsed, unless the timer is cancelled before.
+   */
+  Handle schedule(Clock::duration delay, uint64_t data) {
+    uint64_t now = nowTick();
+    if (size_ == 0 && now > current_) {
+      // Nothing to cascade, skip the idle ticks
+      current_ = now;
+    }
+
+    // Round up, and account for the tick already started
+    uint64_t expiry = now + (delay + resolution_ - Clock::duration(1)) /
+                                resolution_ +
+                      1;
+    if (expiry < current_) {
+      expiry = current_;
+    }
+
+    uint32_t index = allocate();
+    Entry &entry = entries_[index];
+    entry.data = data;
+    entry.expiry = expiry;
+    insert(index);
+    size_++;
+
+    // While advancing, the timer is armed once all expired timers are fired
+    if (!advancing_ && (!armed_ || expiry < armed_tick_)) {
+      arm();
+    }
+
+    return (Handle(entry.generation) << 32) | index;
+  }
+
+  /**
+   * Cancel a timer. Returns false if the timer already fired or was already
+   * cancelled.
+   */
+  bool cancel(Handle handle) {
+    uint32_t index = uint32_t(handle);
+    if (handle == INVALID_HANDLE || index >= entries_.size() ||
+        entries_[index].generation != uint32_t(handle >> 32) ||
+        entries_[index].slot == kNil) {
+      return false;
+    }
+
+    // The asio timer is left armed: a spurious wakeup is cheaper than
+    // recomputing the next deadline on each cancellation.
+    unlink(index);
+    release(index);
+    size_--;
+    return true;
+  }
+
+  /**
+   * Cancel all timers.
+   */
+  void clear() {
+    for (uint32_t index = 0; index < entries_.size(); index++) {
+      if (entries_[index].slot != kNil) {
+        unlink(index);
+        release(index);
+      }
+    }
+
+    size_ = 0;
+  }
+
+  std::size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+ private:
+  uint64_t nowTick() const { return (Clock::now() - start_) / resolution_; }
+
+  uint32_t allocate() {
+    if (free_ != kNil) {
+      uint32_t index = free_;
+      free_ = entries_[index].next;
+      return index;
+    }
+
+    entries_.push_back({0, 0, 0, kNil, kNil, kNil});
+    return uint32_t(entries_.size() - 1);
+  }
+
+  void release(uint32_t index) {
+    Entry &entry = entries_[index];
+    entry.generation++;
+    entry.slot = kNil;
+    entry.next = free_;
+    free_ = index;
+  }
+
+  void insert(uint32_t index) {
+    Entry &entry = entries_[index];
+
+    unsigned level = 0;
+    uint64_t diff = entry.expiry ^ current_;
+    while (level < kLevels - 1 && (diff >> ((level + 1) * kSlotBits)) != 0) {
+      level++;
+    }
+
+    uint32_t slot = level * kSlots +
+                    ((entry.expiry >> (level * kSlotBits)) & kSlotMask);
+    entry.slot = slot;
+    entry.prev = kNil;
+    entry.next = heads_[slot];
+    if (entry.next != kNil) {
+      entries_[entry.next].prev = index;
+    }
+    heads_[slot] = index;
+
+    if (level == 0) {
+      occupied_[slot / 64] |= uint64_t(1) << (slot % 64);
+    }
+  }
+
+  void unlink(uint32_t index) {
+    Entry &entry = entries_[index];
+    if (entry.prev != kNil) {
+      entries_[entry.prev].next = entry.next;
+    } else {
+      heads_[entry.slot] = entry.next;
+    }
+
+    if (entry.next != kNil) {
+      entries_[entry.next].prev = entry.prev;
+    }
+
+    if (entry.slot < kSlots && heads_[entry.slot] == kNil) {
+      occupied_[entry.slot / 64] &= ~(uint64_t(1) << (entry.slot % 64));
+    }
+  }
+
+  /**
+   * Returns the next tick at which the wheel has work to do: either a
+   * non-empty slot of level 0, or the next cascade of the upper levels.
+   */
+  uint64_t nextTick() const {
+    uint64_t base = current_ & ~kSlotMask;
+    unsigned from = unsigned(current_ & kSlotMask);
+
+    for (unsigned word = from / 64; word < kSlots / 64; word++) {
+      uint64_t bits = occupied_[word];
+      if (word == from / 64) {
+        bits &= ~uint64_t(0) << (from % 64);
+      }
+
+      if (bits) {
+        return base + word * 64 + __builtin_ctzll(bits);
+      }
+    }
+
+    return (current_ + kSlotMask) & ~kSlotMask;
+  }
+
+  void arm() {
+    if (size_ == 0) {
+      armed_ = false;
+      return;
+    }
+
+    armed_tick_ = nextTick();
+    armed_ = true;
+    timer_.expires_at(start_ + resolution_ * int64_t(armed_tick_));
+
+    std::weak_ptr<TimingWheel> self = weak_from_this();
+    timer_.async_wait([self](const std::error_code &ec) {
+      if (ec) {
+        return;
+      }
+
+      if (auto ptr = self.lock()) {
+        ptr->onTimer();
+      }
+    });
+  }
+
+  void onTimer() {
+    uint64_t now = nowTick();
+
+    advancing_ = true;
+    while (current_ <= now && size_ > 0) {
+      processTick();
+      current_++;
+    }
+    advancing_ = false;
+
+    if (size_ == 0 && current_ <= now) {
+      current_ = now + 1;
+    }
+
+    arm();
+  }
+
+  void processTick() {
+    // Cascade the upper levels which wrap around at this tick, top-most first
+    // as their timers may land in the slots cascaded next.
+    if ((current_ & kSlotMask) == 0) {
+      unsigned level = 1;
+      while (level < kLevels - 1 &&
+             (current_ & ((uint64_t(1) << ((level + 1) * kSlotBits)) - 1)) ==
+                 0) {
+        level++;
+      }
+
+      for (; level > 0; level--) {
+        uint32_t slot = level * kSlots +
+                        ((current_ >> (level * kSlotBits)) & kSlotMask);
+        uint32_t index = heads_[slot];
+        heads_[slot] = kNil;
+        while (index != kNil) {
+          uint32_t next = entries_[index].next;
+          insert(index);
+          index = next;
+        }
+      }
+    }
+
+    // The callback may schedule or cancel timers, including in this slot
+    uint32_t slot = uint32_t(current_ & kSlotMask);
+    while (heads_[slot] != kNil) {
+      uint32_t index = heads_[slot];
+      uint64_t data = entries_[index].data;
+      unlink(index);
+      release(index);
+      size_--;
+      callback_(data);
+    }
+  }
+
+  Callback callback_;
+  asio::steady_timer timer_;
+  Clock::time_point start_;
+  Clock::duration resolution_;
+
+  // Next tick to be processed
+  uint64_t current_;
+  std::size_t size_;
+
+  std::vector<Entry> entries_;
+  uint32_t free_;
+  std::array<uint32_t, kLevels * kSlots> heads_;
+  std::array<uint64_t, kSlots / 64> occupied_;
+
+  bool armed_;
+  uint64_t armed_tick_;
+  bool advancing_;
+};
+
+}  // namespace utils
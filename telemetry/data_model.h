@@ -26,6 +26,16 @@ data_source_t combined_dsrc[2] = {
     {"bytes", DS_TYPE_DERIVE, 0, NAN},
 };
 
+data_source_t cycles_dsrc[6] = {
+    {"count", DS_TYPE_DERIVE, 0, NAN}, {"mean", DS_TYPE_GAUGE, 0, NAN},
+    {"p50", DS_TYPE_GAUGE, 0, NAN},    {"p90", DS_TYPE_GAUGE, 0, NAN},
+    {"p99", DS_TYPE_GAUGE, 0, NAN},    {"max", DS_TYPE_GAUGE, 0, NAN},
+};
+
+data_source_t verdicts_dsrc[1] = {
+    {"packets", DS_TYPE_DERIVE, 0, NAN},
+};
+
 /************** DATA SETS NODE ****************************/
 data_set_t pkts_processed_ds = {
     "pkts_processed",
@@ -69,6 +79,60 @@ data_set_t cs_expired_count_ds = {
     data_dsrc,
 };
 
+data_set_t pit_reclaimed_count_ds = {
+    "pit_reclaimed_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
+data_set_t cs_reclaimed_count_ds = {
+    "cs_reclaimed_count",
+    STATIC_ARRAY_SIZE(data_dsrc),
+    data_dsrc,
+};
+
+data_set_t pit_full_drop_count_ds = {
+    "pit_full_drop_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
+data_set_t pit_quota_drop_count_ds = {
+    "pit_quota_drop_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
+data_set_t pit_replaced_count_ds = {
+    "pit_replaced_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
+data_set_t cs_hit_count_ds = {
+    "cs_hit_count",
+    STATIC_ARRAY_SIZE(data_dsrc),
+    data_dsrc,
+};
+
+data_set_t cs_miss_count_ds = {
+    "cs_miss_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
+data_set_t fib_cache_hit_count_ds = {
+    "fib_cache_hit_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
+data_set_t fib_cache_miss_count_ds = {
+    "fib_cache_miss_count",
+    STATIC_ARRAY_SIZE(interests_dsrc),
+    interests_dsrc,
+};
+
 data_set_t cs_lru_count_ds = {
     "cs_lru_count",
     STATIC_ARRAY_SIZE(data_dsrc),
@@ -117,6 +181,19 @@ data_set_t cs_entries_ntw_count_ds = {
     data_dsrc,
 };
 
+/************** DATA SETS PROFILE *************************/
+data_set_t stage_cycles_ds = {
+    "stage_cycles",
+    STATIC_ARRAY_SIZE(cycles_dsrc),
+    cycles_dsrc,
+};
+
+data_set_t pkt_cache_verdict_ds = {
+    "pkt_cache_verdict",
+    STATIC_ARRAY_SIZE(verdicts_dsrc),
+    verdicts_dsrc,
+};
+
 /************** DATA SETS FACE ****************************/
 data_set_t irx_ds = {
     "irx",
@@ -60,8 +60,26 @@ static int read_forwarder_global_stats(hc_data_t **pdata, meta_data_t *meta) {
   submit(pit_expired_count_ds.type, values, 1, meta);
   values[0] = (value_t){.gauge = stats.forwarder.countDataExpired};
   submit(cs_expired_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_pit_reclaimed};
+  submit(pit_reclaimed_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_cs_reclaimed};
+  submit(cs_reclaimed_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_pit_full_drops};
+  submit(pit_full_drop_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_pit_quota_drops};
+  submit(pit_quota_drop_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_pit_replacements};
+  submit(pit_replaced_count_ds.type, values, 1, meta);
   values[0] = (value_t){.gauge = stats.pkt_cache.n_lru_evictions};
   submit(cs_lru_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_cs_hits};
+  submit(cs_hit_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.pkt_cache.n_cs_misses};
+  submit(cs_miss_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.forwarder.countFibCacheHits};
+  submit(fib_cache_hit_count_ds.type, values, 1, meta);
+  values[0] = (value_t){.gauge = stats.forwarder.countFibCacheMisses};
+  submit(fib_cache_miss_count_ds.type, values, 1, meta);
   values[0] = (value_t){.gauge = stats.forwarder.countDropped};
   submit(pkts_drop_no_buf_ds.type, values, 1, meta);
   values[0] = (value_t){.gauge = stats.forwarder.countInterestsAggregated};
@@ -114,6 +132,64 @@ static int read_forwarder_per_face_stats(hc_data_t **pdata, meta_data_t *meta) {
   return 0;
 }
 
+static const char *stage_str[] = {
+#define _(x, y) [PROFILE_STAGE_##x] = #y,
+    foreach_profile_stage
+#undef _
+};
+
+static const char *verdict_str[] = {
+#define _(x) [PKT_CACHE_VERDICT_##x] = #x,
+    foreach_kh_verdict
+#undef _
+};
+
+static int read_forwarder_profile(meta_data_t *meta) {
+  // Retrieve receive path profiling from forwarder
+  hc_data_t *data = NULL;
+  int rc = hc_profile_list(s, &data);
+  if (rc < 0) {
+    plugin_log(LOG_ERR, "Could not read profiling data from forwarder");
+    return -1;
+  }
+  const hc_profile_t *profile =
+      (const hc_profile_t *)hc_data_get_buffer(data);
+
+  // Forwarder not built with profiling support, nothing to report
+  if (!profile->enabled) goto END;
+
+  // Submit values
+  for (unsigned i = 0; i < PROFILE_STAGE_N; i++) {
+    rc = meta_data_add_string(meta, "stage", stage_str[i]);
+    assert(rc == 0);
+
+    const histogram_t *histogram = &profile->stages[i];
+    value_t values[6];
+    values[0] = (value_t){.derive = histogram->count};
+    values[1] = (value_t){.gauge = histogram_mean(histogram)};
+    values[2] = (value_t){.gauge = histogram_percentile(histogram, 50)};
+    values[3] = (value_t){.gauge = histogram_percentile(histogram, 90)};
+    values[4] = (value_t){.gauge = histogram_percentile(histogram, 99)};
+    values[5] = (value_t){.gauge = histogram->max};
+    submit(stage_cycles_ds.type, values, 6, meta);
+  }
+  meta_data_delete(meta, "stage");
+
+  for (unsigned i = 0; i < PKT_CACHE_N_VERDICTS; i++) {
+    rc = meta_data_add_string(meta, "verdict", verdict_str[i]);
+    assert(rc == 0);
+
+    value_t values[1];
+    values[0] = (value_t){.derive = profile->verdicts[i]};
+    submit(pkt_cache_verdict_ds.type, values, 1, meta);
+  }
+  meta_data_delete(meta, "verdict");
+
+END:
+  hc_data_free(data);
+  return 0;
+}
+
 static int read_forwarder_stats() {
   // Create metadata
   meta_data_t *meta = meta_data_create();
@@ -123,6 +199,8 @@ static int read_forwarder_stats() {
   hc_data_t *data = NULL;
   rc = read_forwarder_global_stats(&data, meta);
   if (rc < 0) goto READ_ERROR;
+  rc = read_forwarder_profile(meta);
+  if (rc < 0) goto READ_ERROR;
   rc = read_forwarder_per_face_stats(&data, meta);
 
 READ_ERROR:
@@ -180,7 +258,16 @@ void module_register() {
   plugin_register_data_set(&pkts_no_pit_count_ds);
   plugin_register_data_set(&pit_expired_count_ds);
   plugin_register_data_set(&cs_expired_count_ds);
+  plugin_register_data_set(&pit_reclaimed_count_ds);
+  plugin_register_data_set(&cs_reclaimed_count_ds);
+  plugin_register_data_set(&pit_full_drop_count_ds);
+  plugin_register_data_set(&pit_quota_drop_count_ds);
+  plugin_register_data_set(&pit_replaced_count_ds);
   plugin_register_data_set(&cs_lru_count_ds);
+  plugin_register_data_set(&cs_hit_count_ds);
+  plugin_register_data_set(&cs_miss_count_ds);
+  plugin_register_data_set(&fib_cache_hit_count_ds);
+  plugin_register_data_set(&fib_cache_miss_count_ds);
   plugin_register_data_set(&pkts_drop_no_buf_ds);
   plugin_register_data_set(&interests_aggregated_ds);
   plugin_register_data_set(&interests_retx_ds);
@@ -192,6 +279,8 @@ void module_register() {
   plugin_register_data_set(&itx_ds);
   plugin_register_data_set(&drx_ds);
   plugin_register_data_set(&dtx_ds);
+  plugin_register_data_set(&stage_cycles_ds);
+  plugin_register_data_set(&pkt_cache_verdict_ds);
 
   // Callbacks
   plugin_register_init(PLUGIN_NAME, connect_to_forwarder);